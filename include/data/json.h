@@ -8,6 +8,7 @@
 #define ZEPHYR_INCLUDE_DATA_JSON_H_
 
 #include <sys/util.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <sys/types.h>
@@ -711,6 +712,320 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+/**
+ * @brief Token reported by the incremental parser
+ */
+struct json_stream_token {
+	/** JSON_TOK_OBJECT_START, JSON_TOK_LIST_START, their _END
+	 * counterparts, or one of the value tokens.
+	 */
+	enum json_tokens type;
+
+	/** Nesting level of the token, 0 for the top level value */
+	uint8_t depth;
+
+	/** Member name if the token starts or is a value inside an object,
+	 * NULL otherwise. Not NUL-terminated.
+	 */
+	const char *key;
+	size_t key_len;
+
+	/** Contents of strings (without the quotes, escape sequences left
+	 * as they are) and numbers. Not NUL-terminated.
+	 */
+	const char *value;
+	size_t value_len;
+};
+
+/**
+ * @brief Function pointer type receiving the tokens of the incremental
+ * parser
+ *
+ * Key and value only point to valid memory for the duration of the call.
+ *
+ * @param token Token being reported
+ * @param user_data User-provided pointer
+ *
+ * @return 0 to continue parsing, a negative error code to stop it; the
+ * error code is then returned by json_stream_feed().
+ */
+typedef int (*json_stream_cb_t)(const struct json_stream_token *token,
+				void *user_data);
+
+/**
+ * @brief Incremental JSON parser state
+ *
+ * All fields are private.
+ */
+struct json_stream {
+	json_stream_cb_t cb;
+	void *user_data;
+	char *buf;
+	size_t buf_size;
+	size_t key_len;
+	size_t base;
+	size_t len;
+	const char *literal;
+	uint32_t objects;
+	uint8_t depth;
+	uint8_t state;
+	uint8_t expect;
+	uint8_t hex_digits;
+	uint8_t literal_type;
+	bool in_key;
+};
+
+/**
+ * @brief Initializes an incremental JSON parser
+ *
+ * The parser does not allocate memory and does not need the whole
+ * document at once: it is fed with json_stream_feed() in chunks of any
+ * size, e.g. as they are received from a socket, and reports tokens
+ * through @a cb as soon as they are complete. Tokens lying entirely in a
+ * chunk are reported in place; @a buf is only used to hold the current
+ * member name and the part of a string or number that spans chunks.
+ *
+ * As with json_obj_parse(), strings are not unescaped and no UTF-8
+ * validation is performed. The grammar is otherwise enforced, including
+ * the syntax of numbers and the escaping of control characters in
+ * strings. Any value is accepted at the top level and nesting is limited
+ * to CONFIG_JSON_STREAM_MAX_DEPTH levels.
+ *
+ * @param stream Parser to initialize
+ * @param buf Buffer for names and values spanning chunks
+ * @param buf_size Size of @a buf, bounding the length of names and of
+ * values spanning chunks
+ * @param cb Function receiving the tokens
+ * @param user_data Pointer passed to @a cb
+ */
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Feeds the next chunk of the document to an incremental parser
+ *
+ * @param stream Parser
+ * @param data Chunk, which may end in the middle of any token
+ * @param len Length of the chunk
+ *
+ * @return 0 if the chunk has been consumed, -EINVAL if the document is
+ * malformed, -ENOMEM if a name or a value spanning chunks does not fit in
+ * the buffer, -E2BIG if the document is nested too deeply, or the error
+ * returned by the token callback. Errors are sticky.
+ */
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len);
+
+/**
+ * @brief Signals the end of the document to an incremental parser
+ *
+ * Reports a number that was still pending at the end of the last chunk.
+ *
+ * @param stream Parser
+ *
+ * @return 0 if a complete document has been parsed, a negative error code
+ * otherwise (see json_stream_feed()).
+ */
+int json_stream_finish(struct json_stream *stream);
+
+#if defined(CONFIG_JSON_LIBRARY) || defined(__DOXYGEN__)
+/**
+ * @brief Descriptor-driven decoder built on the incremental parser
+ *
+ * All fields are private.
+ */
+struct json_stream_obj {
+	struct json_stream stream;
+	struct json_stream_obj_frame {
+		const struct json_obj_descr *descr;
+		void *val;
+		char *field;
+		ptrdiff_t elem_size;
+		size_t len;
+		uint32_t decoded;
+	} frames[CONFIG_JSON_STREAM_MAX_DEPTH];
+	uint8_t depth;
+	uint8_t skip;
+	int result;
+};
+
+/**
+ * @brief Initializes an incremental descriptor-driven decoder
+ *
+ * Decodes an object into @a val just as json_obj_parse() does, but from a
+ * document fed in chunks with json_stream_obj_feed(). Members missing in
+ * the descriptor are skipped, whatever their type.
+ *
+ * Since chunks do not outlive the call they are fed in, decoded strings
+ * are copied, NUL-terminated, at the start of @a buf, and the rest of it
+ * is used as with json_stream_init(). @a buf therefore has to outlive the
+ * decoded values.
+ *
+ * @param obj Decoder to initialize
+ * @param descr Pointer to the descriptor array
+ * @param descr_len Number of elements in the descriptor array, less than 31
+ * @param val Pointer to the struct to hold the decoded values
+ * @param buf Buffer for the decoded strings and the parser
+ * @param buf_size Size of @a buf
+ */
+void json_stream_obj_init(struct json_stream_obj *obj,
+			  const struct json_obj_descr *descr,
+			  size_t descr_len, void *val,
+			  char *buf, size_t buf_size);
+
+/**
+ * @brief Feeds the next chunk of the document to a descriptor-driven
+ * decoder
+ *
+ * @param obj Decoder
+ * @param data Chunk, which may end in the middle of any token
+ * @param len Length of the chunk
+ *
+ * @return 0 if the chunk has been consumed, or a negative error code as
+ * json_stream_feed() and json_obj_parse() return. Errors are sticky.
+ */
+static inline int json_stream_obj_feed(struct json_stream_obj *obj,
+				       const char *data, size_t len)
+{
+	return json_stream_feed(&obj->stream, data, len);
+}
+
+/**
+ * @brief Signals the end of the document to a descriptor-driven decoder
+ *
+ * @param obj Decoder
+ *
+ * @return < 0 if error, bitmap of decoded fields on success, as
+ * json_obj_parse() returns.
+ */
+int json_stream_obj_finish(struct json_stream_obj *obj);
+#endif /* CONFIG_JSON_LIBRARY */
+
+/**
+ * @brief Incremental JSON encoder state
+ *
+ * All fields are private.
+ */
+struct json_enc {
+	json_append_bytes_t append_bytes;
+	void *data;
+	uint32_t first;
+	uint8_t depth;
+	int err;
+};
+
+/**
+ * @brief Initializes an incremental JSON encoder
+ *
+ * The encoder writes a document value by value through @a append_bytes,
+ * without building it or any part of it in memory: the json_enc_*()
+ * functions take care of separators and escaping, and take the member name
+ * of the value when it is written inside an object (NULL otherwise).
+ *
+ * Errors are sticky: once a call failed, the following ones return the
+ * same error without writing anything.
+ *
+ * @param enc Encoder to initialize
+ * @param append_bytes Function to append bytes to the output
+ * @param data Data pointer to be passed to the append_bytes callback
+ * function.
+ */
+void json_enc_init(struct json_enc *enc, json_append_bytes_t append_bytes,
+		   void *data);
+
+/**
+ * @brief Starts an object
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_obj_start(struct json_enc *enc, const char *key);
+
+/**
+ * @brief Ends the current object
+ *
+ * @param enc Encoder
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_obj_end(struct json_enc *enc);
+
+/**
+ * @brief Starts an array
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_arr_start(struct json_enc *enc, const char *key);
+
+/**
+ * @brief Ends the current array
+ *
+ * @param enc Encoder
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_arr_end(struct json_enc *enc);
+
+/**
+ * @brief Writes a string, escaping it as needed
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ * @param str String to write
+ * @param len Length of @a str
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_str(struct json_enc *enc, const char *key, const char *str,
+		 size_t len);
+
+/**
+ * @brief Writes an integer number
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ * @param num Number to write
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_num(struct json_enc *enc, const char *key, int64_t num);
+
+/**
+ * @brief Writes a boolean
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ * @param value Boolean to write
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_bool(struct json_enc *enc, const char *key, bool value);
+
+/**
+ * @brief Writes null
+ *
+ * @param enc Encoder
+ * @param key Member name, or NULL outside of objects
+ *
+ * @return 0 on success, a negative error code otherwise.
+ */
+int json_enc_null(struct json_enc *enc, const char *key);
+
+/**
+ * @brief Checks that a document has been completely encoded
+ *
+ * @param enc Encoder
+ *
+ * @return 0 if all objects and arrays have been ended, -EINVAL if not, or
+ * the first error that occurred while encoding.
+ */
+int json_enc_finish(struct json_enc *enc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -864,6 +864,58 @@ __syscall void k_thread_resume(k_tid_t thread);
  */
 extern void k_sched_time_slice_set(int32_t slice, int prio);
 
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+/**
+ * @brief Set the time slice of a thread.
+ *
+ * Gives @a thread a time slice of its own, which applies whatever its
+ * priority, instead of the one set with k_sched_time_slice_set().
+ * Once the thread has run for @a slice, other threads of its priority
+ * get a chance to execute.  Cooperative threads are never time sliced.
+ *
+ * Time slices are accounted in hardware cycles, but can only expire
+ * on a tick: a slice lasts at least @a slice, and at most one tick
+ * more.
+ *
+ * @param thread Thread to set the time slice of.
+ * @param slice Time slice length (in milliseconds), or zero to go back
+ *              to the k_sched_time_slice_set() one.  It must fit a
+ *              32-bit count of hardware cycles.
+ *
+ * @return N/A
+ */
+extern void k_thread_time_slice_set(k_tid_t thread, int32_t slice);
+
+/**
+ * @brief Limit the CPU time of a thread.
+ *
+ * Sporadic server style CPU budget: @a thread may run for @a budget
+ * in every period of @a period at its normal priority.  Once it has
+ * used up its budget, it is dropped to @a low_prio, typically a
+ * background priority, until its budget is replenished at the start
+ * of the next period.  This bounds the CPU
+ * time a busy best effort thread takes from other threads, without
+ * raising the tick rate.
+ *
+ * A priority set while the thread is dropped to @a low_prio is only
+ * kept if it is not @a low_prio itself.
+ *
+ * @param thread Preemptible thread to limit.
+ * @param budget CPU budget per period (in milliseconds), or zero to
+ *               remove the limit.
+ * @param period Replenishment period (in milliseconds), at least
+ *               @a budget and at most INT32_MAX hardware cycles (about
+ *               a second at 2 GHz), so that the CPU time used in a
+ *               period fits the 32-bit cycle count.
+ * @param low_prio Preemptible priority to run at once the budget is
+ *                 used up.
+ *
+ * @return N/A
+ */
+extern void k_thread_cpu_budget_set(k_tid_t thread, int32_t budget,
+				    int32_t period, int low_prio);
+#endif
+
 /** @} */
 
 /**
@@ -3660,6 +3712,200 @@ static inline uint32_t z_impl_k_msgq_num_used_get(struct k_msgq *msgq)
 
 /** @} */
 
+/**
+ * @defgroup ringq_apis Lock-free Ring Queue APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Ring Queue Structure
+ *
+ * A ring queue passes fixed-size messages by copy, like a message
+ * queue, but without taking a lock on the put and get paths.  Each
+ * slot carries a sequence number telling the producer and consumer
+ * whether it is free or filled, so the lock (and the scheduler) is
+ * only involved when a caller has to block on a full or empty queue.
+ *
+ * There may only be one consumer.  There may be one producer, or
+ * several if the queue was created with K_RINGQ_FLAG_MULTI_PRODUCER.
+ * Producers may be ISRs.  Ring queues are supervisor-only objects.
+ */
+struct k_ringq {
+	/** Next position to be filled by a producer */
+	atomic_t head;
+	/** Next position to be read by the consumer */
+	atomic_t tail;
+	/** Number of threads and pollers that may need a wakeup */
+	atomic_t waiters;
+	/** Ring size minus one, the ring size is a power of two */
+	uint32_t mask;
+	/** Message size */
+	size_t msg_size;
+	/** Distance between slots in the buffer */
+	size_t stride;
+	/** Slot buffer */
+	char *buffer;
+	/** K_RINGQ_FLAG_* */
+	uint32_t flags;
+	/** Lock, only taken to block or wake up waiters */
+	struct k_spinlock lock;
+	/** Producers waiting for a free slot */
+	_wait_q_t put_wait_q;
+	/** Consumer waiting for a message */
+	_wait_q_t get_wait_q;
+
+	_POLL_EVENT;
+};
+
+/** Allow several producers to put messages concurrently */
+#define K_RINGQ_FLAG_MULTI_PRODUCER	BIT(0)
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#define Z_RINGQ_STRIDE(msg_size) \
+	ROUND_UP(sizeof(atomic_t) + (msg_size), sizeof(atomic_t))
+
+#define Z_RINGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs, q_flags) \
+	{ \
+	.mask = (q_max_msgs) - 1, \
+	.msg_size = q_msg_size, \
+	.stride = Z_RINGQ_STRIDE(q_msg_size), \
+	.buffer = q_buffer, \
+	.flags = q_flags, \
+	.put_wait_q = Z_WAIT_Q_INIT(&obj.put_wait_q), \
+	.get_wait_q = Z_WAIT_Q_INIT(&obj.get_wait_q), \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Size of the buffer needed by a ring queue.
+ *
+ * Each slot holds a message plus a sequence word, padded so the
+ * sequence words stay aligned.
+ *
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Number of slots, a power of two of at least 2.
+ */
+#define K_RINGQ_BUF_SIZE(msg_size, max_msgs) \
+	((max_msgs) * Z_RINGQ_STRIDE(msg_size))
+
+/**
+ * @brief Statically define and initialize a ring queue.
+ *
+ * The ring queue can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_ringq <name>; @endcode
+ *
+ * @param q_name Name of the ring queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Number of slots, a power of two of at least 2.
+ * @param q_flags Zero or K_RINGQ_FLAG_MULTI_PRODUCER.
+ */
+#define K_RINGQ_DEFINE(q_name, q_msg_size, q_max_msgs, q_flags)		\
+	BUILD_ASSERT(((q_max_msgs) >= 2) &&				\
+		     (((q_max_msgs) & ((q_max_msgs) - 1)) == 0),		\
+		     "ring queue size must be a power of two");		\
+	static char __aligned(sizeof(atomic_t))				\
+		_k_ringq_buf_##q_name[K_RINGQ_BUF_SIZE(q_msg_size,	\
+						       q_max_msgs)];	\
+	struct k_ringq q_name =						\
+		Z_RINGQ_INITIALIZER(q_name, _k_ringq_buf_##q_name,	\
+				    q_msg_size, q_max_msgs, q_flags)
+
+/**
+ * @brief Initialize a ring queue.
+ *
+ * This routine initializes a ring queue object, prior to its first use.
+ *
+ * @param q Address of the ring queue.
+ * @param buffer Slot buffer, K_RINGQ_BUF_SIZE(@a msg_size, @a max_msgs)
+ *               bytes aligned to sizeof(atomic_t).
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Number of slots, a power of two of at least 2.
+ * @param flags Zero or K_RINGQ_FLAG_MULTI_PRODUCER.
+ *
+ * @return N/A
+ */
+void k_ringq_init(struct k_ringq *q, char *buffer, size_t msg_size,
+		  uint32_t max_msgs, uint32_t flags);
+
+/**
+ * @brief Send a message to a ring queue.
+ *
+ * This routine copies a message into a free slot.  It only takes the
+ * queue lock if the queue is full and the caller has to wait, or if a
+ * consumer or poller is waiting for the message.
+ *
+ * @note Can be called by ISRs, with @a timeout set to K_NO_WAIT.
+ *
+ * @param q Address of the ring queue.
+ * @param data Pointer to the message.
+ * @param timeout Waiting period to add the message, or one of the special
+ *                values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message sent.
+ * @retval -ENOMSG Returned without waiting, the queue is full.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_ringq_put(struct k_ringq *q, const void *data, k_timeout_t timeout);
+
+/**
+ * @brief Receive a message from a ring queue.
+ *
+ * This routine copies the oldest message out of the queue and frees
+ * its slot.  Only one context may receive from a given queue.
+ *
+ * @note Can be called by ISRs, with @a timeout set to K_NO_WAIT.
+ *
+ * @param q Address of the ring queue.
+ * @param data Address of area to hold the received message.
+ * @param timeout Waiting period to receive the message, or one of the
+ *                special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message received.
+ * @retval -ENOMSG Returned without waiting, the queue is empty.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_ringq_get(struct k_ringq *q, void *data, k_timeout_t timeout);
+
+/**
+ * @brief Get the number of messages in a ring queue.
+ *
+ * With concurrent producers the result is only a snapshot.
+ *
+ * @param q Address of the ring queue.
+ *
+ * @return Number of messages.
+ */
+static inline uint32_t k_ringq_num_used_get(struct k_ringq *q)
+{
+	uint32_t tail = (uint32_t)atomic_get(&q->tail);
+
+	return (uint32_t)atomic_get(&q->head) - tail;
+}
+
+/**
+ * @brief Get the number of free slots in a ring queue.
+ *
+ * @param q Address of the ring queue.
+ *
+ * @return Number of free slots.
+ */
+static inline uint32_t k_ringq_num_free_get(struct k_ringq *q)
+{
+	return q->mask + 1 - k_ringq_num_used_get(q);
+}
+
+/** @} */
+
 /**
  * @defgroup mailbox_apis Mailbox APIs
  * @ingroup kernel_apis
@@ -4028,6 +4274,18 @@ __syscall size_t k_pipe_write_avail(struct k_pipe *pipe);
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+struct z_mem_slab_cache {
+	struct k_spinlock lock;
+	/* Blocks allocated minus blocks freed through this cache,
+	 * negative when they are freed on another CPU
+	 */
+	int32_t num_used;
+	uint32_t count;
+	char *blocks[CONFIG_MEM_SLAB_CPU_CACHE_SIZE];
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	uint32_t num_blocks;
@@ -4038,6 +4296,11 @@ struct k_mem_slab {
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
 #endif
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* Allocations in the slow path, frees bypass the caches */
+	atomic_t waiters;
+	struct z_mem_slab_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 	_OBJECT_TRACING_LINKED_FLAG
@@ -4155,7 +4418,8 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  * @brief Get the number of used blocks in a memory slab.
  *
  * This routine gets the number of memory blocks that are currently
- * allocated in @a slab.
+ * allocated in @a slab.  Free blocks held in per-CPU caches
+ * (CONFIG_MEM_SLAB_CPU_CACHE) are not counted as allocated.
  *
  * @param slab Address of the memory slab.
  *
@@ -4163,7 +4427,17 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	uint32_t used = slab->num_used;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		used += slab->cache[i].num_used;
+	}
+
+	return used;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4198,7 +4472,7 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
@@ -4285,6 +4559,42 @@ static inline void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#ifdef CONFIG_KERNEL_HEAP_TRACE
+/** k_heap operations reported to a trace hook */
+enum k_heap_trace_op {
+	K_HEAP_TRACE_ALLOC,
+	K_HEAP_TRACE_FREE,
+};
+
+/**
+ * @brief k_heap trace hook
+ *
+ * Called with the heap's lock held, after every successful
+ * allocation and before every free of a non-NULL block.  It must be
+ * short and must not call back into any k_heap.
+ *
+ * @param h Heap the operation was performed on
+ * @param op Operation
+ * @param mem Block allocated or about to be freed
+ * @param align Requested alignment for allocations, 0 for frees
+ * @param bytes Requested size for allocations, 0 for frees
+ */
+typedef void (*k_heap_trace_hook_t)(struct k_heap *h,
+				    enum k_heap_trace_op op, void *mem,
+				    size_t align, size_t bytes);
+
+/**
+ * @brief Install a k_heap trace hook
+ *
+ * Starts reporting the operations on every k_heap to @a hook, or
+ * stops reporting them if @a hook is NULL.  Only available with
+ * CONFIG_KERNEL_HEAP_TRACE.
+ *
+ * @param hook Function to call, or NULL
+ */
+void k_heap_trace_hook_set(k_heap_trace_hook_t hook);
+#endif
+
 /**
  * @brief Define a static k_heap
  *
@@ -4401,6 +4711,9 @@ enum _poll_types_bits {
 	/* queue/FIFO/LIFO data availability */
 	_POLL_TYPE_DATA_AVAILABLE,
 
+	/* ring queue data availability */
+	_POLL_TYPE_RINGQ_DATA_AVAILABLE,
+
 	_POLL_NUM_TYPES
 };
 
@@ -4423,6 +4736,9 @@ enum _poll_states_bits {
 	/* queue/FIFO/LIFO wait was cancelled */
 	_POLL_STATE_CANCELLED,
 
+	/* data is available to read on a ring queue */
+	_POLL_STATE_RINGQ_DATA_AVAILABLE,
+
 	_POLL_NUM_STATES
 };
 
@@ -4453,6 +4769,7 @@ enum _poll_states_bits {
 #define K_POLL_TYPE_SEM_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_SEM_AVAILABLE)
 #define K_POLL_TYPE_DATA_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_DATA_AVAILABLE)
 #define K_POLL_TYPE_FIFO_DATA_AVAILABLE K_POLL_TYPE_DATA_AVAILABLE
+#define K_POLL_TYPE_RINGQ_DATA_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_RINGQ_DATA_AVAILABLE)
 
 /* public - polling modes */
 enum k_poll_modes {
@@ -4469,6 +4786,7 @@ enum k_poll_modes {
 #define K_POLL_STATE_DATA_AVAILABLE Z_POLL_STATE_BIT(_POLL_STATE_DATA_AVAILABLE)
 #define K_POLL_STATE_FIFO_DATA_AVAILABLE K_POLL_STATE_DATA_AVAILABLE
 #define K_POLL_STATE_CANCELLED Z_POLL_STATE_BIT(_POLL_STATE_CANCELLED)
+#define K_POLL_STATE_RINGQ_DATA_AVAILABLE Z_POLL_STATE_BIT(_POLL_STATE_RINGQ_DATA_AVAILABLE)
 
 /* public - poll signal object */
 struct k_poll_signal {
@@ -4524,6 +4842,7 @@ struct k_poll_event {
 		struct k_sem *sem;
 		struct k_fifo *fifo;
 		struct k_queue *queue;
+		struct k_ringq *ringq;
 	};
 };
 
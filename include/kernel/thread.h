@@ -100,6 +100,11 @@ struct _thread_base {
 
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU whose ready queue holds this thread while it is queued */
+	uint8_t runq_cpu;
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 	/* "May run on" bits for each CPU */
 	uint8_t cpu_mask;
@@ -113,6 +118,29 @@ struct _thread_base {
 	struct _timeout timeout;
 #endif
 
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	/* time slice length in cycles, 0 for the k_sched_time_slice_set()
+	 * one
+	 */
+	uint32_t slice_cycles;
+
+	/* CPU budget in cycles per replenishment period, 0 for none */
+	uint32_t budget_cycles;
+	uint32_t budget_period;
+
+	/* cycles run in total, and as of the last replenishment */
+	uint32_t budget_used;
+	uint32_t budget_base;
+
+	/* priority while the budget is used up, and the one to restore */
+	int8_t budget_low_prio;
+	int8_t budget_prio;
+	bool budget_throttled;
+
+	/* replenishment timer */
+	struct _timeout budget_timeout;
+#endif
+
 	_wait_q_t join_waiters;
 #if __ASSERT_ON
 	/* For detecting calls to k_thread_create() on threads that are
@@ -118,8 +118,21 @@ struct _cpu {
 #endif
 
 #ifdef CONFIG_TIMESLICING
-	/* number of ticks remaining in current time slice */
+	/* number of ticks until the current time slice (or CPU budget)
+	 * expires, 0 if it doesn't
+	 */
 	int slice_ticks;
+
+	/* cycle count at the start of the current time slice, and its
+	 * length in cycles (0 for no time slice)
+	 */
+	uint32_t slice_start;
+	uint32_t slice_cycles;
+#endif
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	/* cycle count when _current was last charged for its CPU time */
+	uint32_t charge_start;
 #endif
 
 	uint8_t id;
@@ -128,6 +141,11 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	uint8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads queued to run on this CPU (can be big, keep last) */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -203,6 +221,14 @@ extern bool z_priq_rb_lessthan(struct rbnode *a, struct rbnode *b);
 
 #define Z_WAIT_Q_INIT(wait_q) { { { .lessthan_fn = z_priq_rb_lessthan } } }
 
+#elif defined(CONFIG_WAITQ_MULTIQ)
+
+typedef struct {
+	struct _priq_mq waitq;
+} _wait_q_t;
+
+#define Z_WAIT_Q_INIT(wait_q) { { 0 } }
+
 #else
 
 typedef struct {
@@ -219,7 +245,16 @@ struct _timeout;
 typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	union {
+		sys_dnode_t node;
+		struct rbnode rbnode;
+	};
+	/* insertion order, breaks ties between equal expiry ticks */
+	uint32_t order_key;
+#else
 	sys_dnode_t node;
+#endif
 	_timeout_func_t fn;
 #ifdef CONFIG_TIMEOUT_64BIT
 	/* Can't use k_ticks_t for header dependency reasons */
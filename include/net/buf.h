@@ -2366,6 +2366,54 @@ size_t net_buf_append_bytes(struct net_buf *buf, size_t len,
 			    const void *value, k_timeout_t timeout,
 			    net_buf_allocator_cb allocate_cb, void *user_data);
 
+struct base64_encoder;
+
+/**
+ * @brief Append data encoded in base64 to a list of net_buf
+ *
+ * @details Encodes the data straight into the tailroom of the net_buf
+ * chain, adding net_buf as needed like net_buf_append_bytes(), without
+ * an intermediate buffer.  The data can be given in pieces: the last
+ * one or two bytes of a piece are kept in @a enc until the next call or
+ * net_buf_append_base64_finish().  Requires CONFIG_BASE64.
+ *
+ * @param buf Network buffer.
+ * @param enc Encoder state, initialized with base64_encoder_init().
+ * @param len Total length of input data
+ * @param value Data to be encoded and added
+ * @param timeout Timeout is passed to the net_buf allocator callback.
+ * @param allocate_cb When a new net_buf is required, use this callback.
+ * @param user_data A user data pointer to be supplied to the allocate_cb.
+ *
+ * @return Length of input data consumed. This may be less than input
+ *         length if other timeout than K_FOREVER was used, and there
+ *         were no free fragments in a pool to accommodate all data.
+ */
+size_t net_buf_append_base64(struct net_buf *buf, struct base64_encoder *enc,
+			     size_t len, const void *value,
+			     k_timeout_t timeout,
+			     net_buf_allocator_cb allocate_cb, void *user_data);
+
+/**
+ * @brief End data appended with net_buf_append_base64()
+ *
+ * @details Appends the encoding of the bytes kept in @a enc, with
+ * padding.
+ *
+ * @param buf Network buffer.
+ * @param enc Encoder state.
+ * @param timeout Timeout is passed to the net_buf allocator callback.
+ * @param allocate_cb When a new net_buf is required, use this callback.
+ * @param user_data A user data pointer to be supplied to the allocate_cb.
+ *
+ * @return 0 on success, -ENOMEM if no fragment could be added.
+ */
+int net_buf_append_base64_finish(struct net_buf *buf,
+				 struct base64_encoder *enc,
+				 k_timeout_t timeout,
+				 net_buf_allocator_cb allocate_cb,
+				 void *user_data);
+
 /**
  * @brief Skip N number of bytes in a net_buf
  *
@@ -276,6 +276,11 @@ __net_socket struct net_context {
 		struct k_fifo accept_q;
 	};
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** Entries of the epoll instances watching the socket */
+	sys_slist_t epoll_items;
+#endif
+
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -923,6 +928,31 @@ int net_context_send(struct net_context *context,
 		     k_timeout_t timeout,
 		     void *user_data);
 
+/**
+ * @brief Send a chain of network buffers to a peer without copying them.
+ *
+ * @details This function works as net_context_send(), except that the data
+ * is in a chain of buffers the caller has filled, from the TX data pool
+ * with net_pkt_get_reserve_tx_data() for instance. The buffers are handed
+ * over to the stack as they are. Only UDP and TCP contexts support it,
+ * the latter with the TCP2 stack.
+ *
+ * @param context The network context to use.
+ * @param frags The data buffers to send. The stack owns them from then on,
+ * unless the call fails with -EAGAIN or -ENOBUFS, in which case they are
+ * still the caller's so that it can try again.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return Number of bytes sent if ok, < 0 if error
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Send data to a peer specified by address.
  *
@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -392,6 +393,106 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @brief Receive data from a socket without copying it
+ *
+ * @details
+ * @rst
+ * Takes the data of the next received packet off the socket, as the chain
+ * of network buffers it arrived in, positioned at the start of the data.
+ * The caller owns the buffers and gives them back with
+ * :c:func:`zsock_recv_zc_done` once done with the data. Only available
+ * from kernel threads, if :option:`CONFIG_NET_SOCKETS_ZEROCOPY` is
+ * enabled. ``ZSOCK_MSG_PEEK`` is not supported. The buffers count
+ * towards :option:`CONFIG_NET_SOCKETS_ZEROCOPY_MAX_HELD` until given
+ * back: past that the call fails with ``ENOBUFS`` and the data stays
+ * queued.
+ * @endrst
+ *
+ * @param sock file descriptor
+ * @param frags Set to the buffers holding the data
+ * @param flags ``ZSOCK_MSG_DONTWAIT`` or 0
+ *
+ * @return Number of bytes received, 0 at the end of a stream, or -1 with
+ *         errno set on error
+ */
+ssize_t zsock_recv_zc(int sock, struct net_buf **frags, int flags);
+
+/**
+ * @brief Give back the buffers returned by zsock_recv_zc()
+ *
+ * @details
+ * For stream sockets, the receive window grows again by the amount of
+ * data released, unless the socket was closed in the meantime.
+ *
+ * @param sock file descriptor the data was received on
+ * @param frags Buffers returned by zsock_recv_zc()
+ */
+void zsock_recv_zc_done(int sock, struct net_buf *frags);
+
+/**
+ * @brief Send a chain of network buffers without copying it
+ *
+ * @details
+ * @rst
+ * Hands the buffers over to the stack, which sends their data as it is.
+ * The buffers should come from the TX data pool, see
+ * :c:func:`net_pkt_get_reserve_tx_data`. They belong to the stack once
+ * the call succeeds, and are still the caller's if it fails with errno
+ * set to ``EAGAIN``, ``ENOBUFS`` or ``ENOMEM``. Supported on connected
+ * UDP sockets and on TCP sockets with the TCP2 stack, from kernel threads,
+ * if :option:`CONFIG_NET_SOCKETS_ZEROCOPY` is enabled.
+ * @endrst
+ *
+ * @param sock file descriptor
+ * @param frags Buffers holding the data to send
+ * @param flags ``ZSOCK_MSG_DONTWAIT`` or 0
+ *
+ * @return Number of bytes sent, or -1 with errno set on error
+ */
+ssize_t zsock_send_zc(int sock, struct net_buf *frags, int flags);
+
+/**
+ * @brief Receive data from a socket without copying it, by address
+ *
+ * @details
+ * @rst
+ * Works as :c:func:`zsock_recv_zc`, but fills ``iov`` with the address and
+ * length of each piece of data and returns a handle to the held data,
+ * to be given to :c:func:`zsock_recv_zc_release` once done with it.
+ * User threads can only receive this way if they can read the network
+ * buffer data, through a memory partition for instance: the call fails
+ * with ``EACCES`` otherwise and the data stays queued, to be read with
+ * :c:func:`zsock_recv` instead. If the data spans more than ``iovcnt``
+ * pieces, the call fails with ``EMSGSIZE`` and the data stays queued too.
+ * At most :option:`CONFIG_NET_SOCKETS_ZEROCOPY_MAX_HELD` receptions can be
+ * held at once.
+ * @endrst
+ *
+ * @param sock file descriptor
+ * @param iov Array filled with the pieces of data
+ * @param iovcnt Number of entries in iov
+ * @param handle Set to the handle of the held data
+ * @param flags ``ZSOCK_MSG_DONTWAIT`` or 0
+ *
+ * @return Number of pieces of data, or -1 with errno set on error. 0, with
+ *         no data held, at the end of a stream or for an empty datagram.
+ */
+__syscall int zsock_recv_zc_iov(int sock, struct iovec *iov, int iovcnt,
+				int *handle, int flags);
+
+/**
+ * @brief Release data held by zsock_recv_zc_iov()
+ *
+ * @param sock file descriptor the data was received on
+ * @param handle Handle returned by zsock_recv_zc_iov()
+ *
+ * @return 0 on success, or -1 with errno set on error
+ */
+__syscall int zsock_recv_zc_release(int sock, int handle);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
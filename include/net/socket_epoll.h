@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Events, as in zsock_epoll_event.events */
+/** Data can be read */
+#define ZSOCK_EPOLLIN 0x001
+/** Data can be written */
+#define ZSOCK_EPOLLOUT 0x004
+/** Report the events only when they happen (edge-triggered) */
+#define ZSOCK_EPOLLET (1U << 31)
+
+/* Operations of zsock_epoll_ctl() */
+/** Start watching a socket */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** Stop watching a socket */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** Change the events watched on a socket */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** Data returned with the events of a socket */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+/** Events of a socket */
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* event bits */
+	uint32_t events;
+	/** Data given to zsock_epoll_ctl() for the socket */
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux manual page
+ * <https://man7.org/linux/man-pages/man7/epoll.7.html>`__ for the
+ * description of the interface. The instance is a file descriptor, closed
+ * with :c:func:`zsock_close()`. Unlike :c:func:`zsock_poll()`, the sockets
+ * to watch are registered once, and the instance learns about the events
+ * from the network stack as they happen, so that the cost of waiting does
+ * not grow with the number of sockets. Only native sockets can be watched.
+ * This function is also exposed as ``epoll_create1()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param flags Must be 0.
+ *
+ * @return File descriptor of the instance, or -1 with errno set.
+ */
+int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Add, change or remove a socket watched by an epoll instance
+ *
+ * @details
+ * @rst
+ * ``ZSOCK_EPOLLIN`` and ``ZSOCK_EPOLLOUT`` can be watched, the latter
+ * being always reported, as with :c:func:`zsock_poll()`. With
+ * ``ZSOCK_EPOLLET``, an event is reported once each time the socket
+ * receives data, instead of as long as the data is there. Closing a socket
+ * removes it from the instances watching it.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Epoll instance.
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_MOD or ZSOCK_EPOLL_CTL_DEL.
+ * @param fd Socket.
+ * @param event Events to watch and data to report them with, unused with
+ *        ZSOCK_EPOLL_CTL_DEL.
+ *
+ * @return 0, or -1 with errno set.
+ */
+int zsock_epoll_ctl(int epfd, int op, int fd,
+		    struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on the sockets watched by an epoll instance
+ *
+ * @details
+ * @rst
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @param epfd Epoll instance.
+ * @param events Where to store the events.
+ * @param maxevents Most events to return, greater than 0.
+ * @param timeout Timeout in milliseconds, -1 to wait forever.
+ *
+ * @return Number of events stored, 0 on timeout, or -1 with errno set.
+ */
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
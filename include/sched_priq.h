@@ -6,6 +6,7 @@
 #ifndef ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 #define ZEPHYR_INCLUDE_SCHED_PRIQ_H_
 
+#include <zephyr/types.h>
 #include <sys/util.h>
 #include <sys/dlist.h>
 #include <sys/rb.h>
@@ -25,6 +26,9 @@
  * much better O(logN) scaling in the presence of large number of
  * threads.
  *
+ * A third, the "multi-queue", keeps a list per priority and is O(1)
+ * at the cost of RAM for all the list heads.
+ *
  * Each can be used for either the wait_q or system ready queue,
  * configurable at build time.
  */
@@ -44,20 +48,33 @@ void z_priq_rb_add(struct _priq_rb *pq, struct k_thread *thread);
 void z_priq_rb_remove(struct _priq_rb *pq, struct k_thread *thread);
 struct k_thread *z_priq_rb_best(struct _priq_rb *pq);
 
-/* Traditional/textbook "multi-queue" structure.  Separate lists for a
- * small number (max 32 here) of fixed priorities.  This corresponds
- * to the original Zephyr scheduler.  RAM requirements are
- * comparatively high, but performance is very fast.  Won't work with
- * features like deadline scheduling which need large priority spaces
- * to represent their requirements.
+/* Traditional/textbook "multi-queue" structure.  Separate lists for
+ * each of the configured priorities, found in O(1) through a two level
+ * bitmap: bit i of word w in bitmap[] is set when the list of
+ * priority level w * 32 + i is non-empty, and bit w of summary when
+ * bitmap[w] is non-zero.  Bits are numbered from the MSB so that a
+ * count leading zeros instruction finds the best level.  The lists of
+ * empty levels are left uninitialized, so a zeroed structure is an
+ * empty queue.  This corresponds to the original Zephyr scheduler,
+ * without its limit of 32 priorities.  RAM requirements are
+ * comparatively high (a list head per priority), but performance is
+ * very fast at any number of threads.  Won't work with features like
+ * deadline scheduling which need large priority spaces to represent
+ * their requirements.
  */
+#define Z_PRIQ_MQ_LEVELS \
+	(CONFIG_NUM_COOP_PRIORITIES + CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define Z_PRIQ_MQ_WORDS ((Z_PRIQ_MQ_LEVELS + 31) / 32)
+
 struct _priq_mq {
-	sys_dlist_t queues[32];
-	unsigned int bitmask; /* bit 1<<i set if queues[i] is non-empty */
+	uint32_t summary;
+	uint32_t bitmap[Z_PRIQ_MQ_WORDS];
+	sys_dlist_t queues[Z_PRIQ_MQ_LEVELS];
 };
 
 void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
+struct k_thread *z_priq_mq_next(struct _priq_mq *pq, struct k_thread *thread);
 
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
@@ -72,6 +72,68 @@ int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		  size_t slen);
 
+/**
+ * @brief          State of a base64 encoding done in pieces
+ *
+ * Holds the last bytes of the data given so far that don't make a
+ * whole group of three bytes.
+ */
+struct base64_encoder {
+	uint8_t pending[2];
+	uint8_t n_pending;
+};
+
+/**
+ * @brief          Start a base64 encoding done in pieces
+ *
+ * @param enc      encoder state
+ */
+static inline void base64_encoder_init(struct base64_encoder *enc)
+{
+	enc->n_pending = 0U;
+}
+
+/**
+ * @brief          Encode a piece of data into base64 format
+ *
+ * Encodes as many groups of three bytes as fit in the destination
+ * buffer, starting with the bytes kept by the previous call.  Once
+ * all groups are encoded, the last one or two bytes are kept in the
+ * encoder until the next call or base64_encode_finish().  The output
+ * is not null-terminated, so the outputs of successive calls can be
+ * concatenated, and is the same as that of base64_encode() on the
+ * whole data.
+ *
+ * @param enc      encoder state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written, a multiple of 4
+ * @param src      source buffer
+ * @param slen     amount of data to be encoded
+ *
+ * @return         Number of bytes of the source buffer consumed, less
+ *                 than @p slen if the destination buffer is full.
+ */
+size_t base64_encode_update(struct base64_encoder *enc, uint8_t *dst,
+			    size_t dlen, size_t *olen, const uint8_t *src,
+			    size_t slen);
+
+/**
+ * @brief          End a base64 encoding done in pieces
+ *
+ * Encodes the bytes kept by base64_encode_update(), with padding.
+ *
+ * @param enc      encoder state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written, or that would have been
+ *                 written: 0 or 4
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small.
+ */
+int base64_encode_finish(struct base64_encoder *enc, uint8_t *dst,
+			 size_t dlen, size_t *olen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,7 +9,9 @@
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <toolchain.h>
+#include <sys/util.h>
 
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 #include <stdio.h>
@@ -100,6 +102,98 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...);
  */
 int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap);
 
+/** @brief Copy every string argument into the package.
+ *
+ * The package then only refers to the format string, e.g. for rendering
+ * on a host that has the image but not the memory of the target.
+ */
+#define CBPRINTF_PACKAGE_COPY_ALL_STR BIT(0)
+
+/** @brief Copy none of the string arguments into the package.
+ *
+ * The caller guarantees that they outlive the package.
+ */
+#define CBPRINTF_PACKAGE_COPY_NO_STR BIT(1)
+
+/** @brief Required alignment of package buffers. */
+#define CBPRINTF_PACKAGE_ALIGNMENT \
+	MAX(__alignof__(long double), \
+	    MAX(__alignof__(long long), __alignof__(void *)))
+
+/** @brief Capture a formatted output for later rendering.
+ *
+ * Instead of formatting, this stores a pointer to @p format and the raw
+ * values of the arguments in @p packaged, which costs a fraction of the
+ * formatting.  The output is generated later by cbpprintf(), e.g. on a
+ * low priority thread or by a host tool, possibly after copying the
+ * package elsewhere.
+ *
+ * The format string is never copied: it has to outlive the package, as
+ * string literals do.  By default, @c %s arguments located in read-only
+ * memory are captured as pointers and the others are copied into the
+ * package; @p flags can request to copy all (@ref
+ * CBPRINTF_PACKAGE_COPY_ALL_STR) or none (@ref CBPRINTF_PACKAGE_COPY_NO_STR)
+ * of them instead.  Other pointers, e.g. for @c %p, are never dereferenced.
+ *
+ * @note @c %n is not supported, and floating point arguments are only
+ * supported with @option{CONFIG_CBPRINTF_FP_SUPPORT}.
+ *
+ * @param packaged buffer aligned to @ref CBPRINTF_PACKAGE_ALIGNMENT, or
+ * NULL to only compute the size of the package.
+ *
+ * @param len size of @p packaged.
+ *
+ * @param flags @c CBPRINTF_PACKAGE_ flags.
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ... arguments corresponding to the conversion specifications found
+ * within @p format.
+ *
+ * @return the size of the package in bytes, -ENOSPC if it does not fit in
+ * @p len bytes, -EINVAL if @p format cannot be packaged, or -ENOTSUP if it
+ * has floating point conversions that are not supported.
+ */
+__printf_like(4, 5)
+int cbprintf_package(void *packaged, size_t len, uint32_t flags,
+		     const char *format, ...);
+
+/** @brief varargs-aware version of cbprintf_package().
+ *
+ * @param packaged buffer aligned to @ref CBPRINTF_PACKAGE_ALIGNMENT, or
+ * NULL to only compute the size of the package.
+ *
+ * @param len size of @p packaged.
+ *
+ * @param flags @c CBPRINTF_PACKAGE_ flags.
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @return see cbprintf_package().
+ */
+int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
+		      const char *format, va_list ap);
+
+/** @brief Generate the output captured by cbprintf_package().
+ *
+ * This behaves as cbprintf() would have, with the format and the arguments
+ * given to cbprintf_package(), and therefore with its capabilities.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param packaged package generated by cbprintf_package().
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged);
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 /** @brief fprintf using Zephyrs cbprintf infrastructure.
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Open addressing hash map
+ *
+ * A hash map of caller-owned entries, looked up by a key.  The map
+ * only stores pointers to the entries, which contain their key in
+ * whatever form suits them (an integer, a tuple of addresses and
+ * ports, a path...): the map hashes keys with a hash function and
+ * tells entries apart with a match function, both supplied by the
+ * user.
+ *
+ * The table uses open addressing with Robin Hood hashing: an entry
+ * being inserted takes the slot of any entry that is closer to its
+ * own home slot, which keeps probe sequences short and lets lookups of
+ * missing keys stop early.  Removal shifts the following entries back,
+ * so there are no tombstones.  The 32-bit hash of each entry is kept
+ * in its slot, so that most mismatches are rejected without calling
+ * the match function, and entries can be moved without rehashing.
+ *
+ * The table either lives in static storage, whose size is then fixed,
+ * or is allocated through a callback.  An allocated table grows by
+ * doubling when it gets 7/8 full, and its entries are then migrated
+ * to the new table a few at a time by the following inserts and
+ * removals, so that no single operation has to move all of them.
+ *
+ * The map does no locking: concurrent users must serialize their
+ * accesses.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HASHMAP_H_
+#define ZEPHYR_INCLUDE_SYS_HASHMAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup sys_hashmap_apis Hash map APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Hash map hash function
+ *
+ * Returns the hash of a key.  All 32 bits should be usable, as the
+ * low bits select the slot in the table.
+ */
+typedef uint32_t (*sys_hashmap_hash_t)(const void *key);
+
+/**
+ * @brief Hash map match function
+ *
+ * Returns true if the entry has the given key.
+ */
+typedef bool (*sys_hashmap_match_t)(const void *entry, const void *key);
+
+/**
+ * @brief Hash map allocation function
+ *
+ * Returns a block of @p size bytes if @p ptr is NULL, or NULL when
+ * out of memory.  Frees @p ptr if @p size is zero.
+ */
+typedef void *(*sys_hashmap_alloc_t)(void *ptr, size_t size);
+
+/** @brief Hash map visit function, see sys_hashmap_foreach() */
+typedef void (*sys_hashmap_visit_t)(void *entry, void *cookie);
+
+/** @brief Hash map slot, empty if entry is NULL */
+struct sys_hashmap_slot {
+	void *entry;
+	uint32_t hash;
+};
+
+/** @brief Hash map */
+struct sys_hashmap {
+	sys_hashmap_hash_t hash_fn;
+	sys_hashmap_match_t match_fn;
+	/* NULL for static storage */
+	sys_hashmap_alloc_t alloc_fn;
+	struct sys_hashmap_slot *slots;
+	/* Number of slots minus one, a power of 2 minus one */
+	uint32_t mask;
+	/* Number of entries, in both tables while growing */
+	uint32_t size;
+	/* Previous table, while its entries are migrated */
+	struct sys_hashmap_slot *old_slots;
+	uint32_t old_mask;
+	uint32_t old_pos;
+	uint32_t old_left;
+};
+
+/** @cond INTERNAL_HIDDEN */
+#define Z_SYS_HASHMAP_IS_POW2(n) (((n) > 1) && (((n) & ((n) - 1)) == 0))
+/** @endcond */
+
+/**
+ * @brief Statically define and initialize a hash map with static storage
+ *
+ * The map has @p n_slots slots, a power of 2, and holds up to 7/8 of
+ * that many entries.
+ *
+ * @param name Name of the hash map.
+ * @param n_slots Number of slots.
+ * @param hash Hash function.
+ * @param match Match function.
+ */
+#define SYS_HASHMAP_DEFINE_STATIC(name, n_slots, hash, match)		\
+	BUILD_ASSERT(Z_SYS_HASHMAP_IS_POW2(n_slots),			\
+		     "Hash map size must be a power of 2");		\
+	static struct sys_hashmap_slot _sys_hashmap_slots_##name[n_slots]; \
+	struct sys_hashmap name = {					\
+		.hash_fn = hash,					\
+		.match_fn = match,					\
+		.slots = _sys_hashmap_slots_##name,			\
+		.mask = (n_slots) - 1,					\
+	}
+
+/**
+ * @brief Initialize a hash map with allocated storage
+ *
+ * The map starts empty, and allocates its table on the first insert.
+ *
+ * @param map Hash map.
+ * @param hash_fn Hash function.
+ * @param match_fn Match function.
+ * @param alloc_fn Allocation function.
+ */
+void sys_hashmap_init(struct sys_hashmap *map, sys_hashmap_hash_t hash_fn,
+		      sys_hashmap_match_t match_fn,
+		      sys_hashmap_alloc_t alloc_fn);
+
+/**
+ * @brief Initialize a hash map with static storage
+ *
+ * @param map Hash map.
+ * @param hash_fn Hash function.
+ * @param match_fn Match function.
+ * @param slots Storage of the map, which holds up to 7/8 of
+ *              @p n_slots entries.
+ * @param n_slots Number of slots, a power of 2.
+ */
+void sys_hashmap_init_static(struct sys_hashmap *map,
+			     sys_hashmap_hash_t hash_fn,
+			     sys_hashmap_match_t match_fn,
+			     struct sys_hashmap_slot *slots, uint32_t n_slots);
+
+/**
+ * @brief Insert an entry
+ *
+ * @param map Hash map.
+ * @param key Key of the entry, only used during the call.
+ * @param entry Entry, not NULL.
+ *
+ * @retval 0 on success.
+ * @retval -EEXIST if an entry with that key is already in the map.
+ * @retval -ENOSPC if a map with static storage is full.
+ * @retval -ENOMEM if the table could not be grown.
+ */
+int sys_hashmap_insert(struct sys_hashmap *map, const void *key, void *entry);
+
+/**
+ * @brief Look up an entry
+ *
+ * @param map Hash map.
+ * @param key Key of the entry.
+ *
+ * @return The entry with that key, or NULL if there is none.
+ */
+void *sys_hashmap_get(const struct sys_hashmap *map, const void *key);
+
+/**
+ * @brief Remove an entry
+ *
+ * @param map Hash map.
+ * @param key Key of the entry.
+ *
+ * @return The removed entry, or NULL if there was none with that key.
+ */
+void *sys_hashmap_remove(struct sys_hashmap *map, const void *key);
+
+/**
+ * @brief Remove all entries
+ *
+ * A map with allocated storage also frees its table.
+ *
+ * @param map Hash map.
+ */
+void sys_hashmap_clear(struct sys_hashmap *map);
+
+/**
+ * @brief Visit all entries
+ *
+ * The entries are visited in no particular order.  The visit function
+ * must not modify the map.
+ *
+ * @param map Hash map.
+ * @param visit_fn Function called with every entry.
+ * @param cookie Passed to @p visit_fn.
+ */
+void sys_hashmap_foreach(const struct sys_hashmap *map,
+			 sys_hashmap_visit_t visit_fn, void *cookie);
+
+/**
+ * @brief Number of entries in a hash map
+ */
+static inline uint32_t sys_hashmap_size(const struct sys_hashmap *map)
+{
+	return map->size;
+}
+
+/**
+ * @brief Hash a 32-bit integer
+ *
+ * The murmur3 finalizer: every bit of the input affects every bit of
+ * the result.  Suitable for integer keys.
+ */
+static inline uint32_t sys_hash32_u32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+
+	return x;
+}
+
+/**
+ * @brief Hash a buffer
+ *
+ * FNV-1a, finalized with sys_hash32_u32().  Suitable for keys made of
+ * a few fields, which should then be packed without padding bytes.
+ *
+ * @param data Data to hash.
+ * @param len Length of the data.
+ */
+uint32_t sys_hash32(const void *data, size_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HASHMAP_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Hierarchical bitmap allocator
+ *
+ * Allocates indexes in a fixed range, such as page frames or the slots
+ * of an object pool, lowest index first.  Each index is one bit of an
+ * array of 32-bit words, set if the index is free.  Above these leaf
+ * words, each level has one summary bit per word of the level below,
+ * set if that word has any free bit, up to a single top word.  Finding
+ * a free index takes one find-first-set per level instead of a scan of
+ * the whole bitmap: four words for a million indexes.
+ *
+ * All updates are atomic operations on single words: an index is taken
+ * with a compare-and-swap clearing its bit, so the bitmap needs no lock
+ * and allocations can run concurrently with each other and with frees.
+ * The summary bits are only hints while other CPUs update the bitmap,
+ * and searches skip (and fix) those that point to full words.  An
+ * allocation racing with frees may thus fail although an index is
+ * being freed.
+ *
+ * All indexes start allocated: zeroed storage is a valid bitmap, and
+ * the user frees the indexes that are actually available.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HBITMAP_H_
+#define ZEPHYR_INCLUDE_SYS_HBITMAP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/atomic.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup sys_hbitmap_apis Hierarchical bitmap APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/** @cond INTERNAL_HIDDEN */
+
+#define Z_HBITMAP_MAX_LEVELS 5
+
+/* Number of words holding n bits */
+#define Z_HBITMAP_W(n) (((n) + 31U) / 32U)
+
+/* Number of words of the levels above the leaves, up to a single word */
+#define Z_HBITMAP_W1(n) Z_HBITMAP_W(Z_HBITMAP_W(n))
+#define Z_HBITMAP_W2(n) Z_HBITMAP_W(Z_HBITMAP_W1(n))
+#define Z_HBITMAP_W3(n) Z_HBITMAP_W(Z_HBITMAP_W2(n))
+
+#define Z_HBITMAP_LEVELS(n)						\
+	(1U + (Z_HBITMAP_W(n) > 1U) + (Z_HBITMAP_W1(n) > 1U) +		\
+	 (Z_HBITMAP_W2(n) > 1U) + (Z_HBITMAP_W3(n) > 1U))
+
+#define Z_HBITMAP_INIT(words_, n)					\
+	{								\
+		.words = (words_),					\
+		.levels = Z_HBITMAP_LEVELS(n),				\
+		.bits = { (n), Z_HBITMAP_W(n), Z_HBITMAP_W1(n),		\
+			  Z_HBITMAP_W2(n), Z_HBITMAP_W3(n) },		\
+		.offset = { 0U, Z_HBITMAP_W(n),				\
+			    Z_HBITMAP_W(n) + Z_HBITMAP_W1(n),		\
+			    Z_HBITMAP_W(n) + Z_HBITMAP_W1(n) +		\
+			    Z_HBITMAP_W2(n),				\
+			    Z_HBITMAP_W(n) + Z_HBITMAP_W1(n) +		\
+			    Z_HBITMAP_W2(n) + Z_HBITMAP_W3(n) },	\
+	}
+
+/** @endcond */
+
+/**
+ * @brief Largest number of indexes in a hierarchical bitmap
+ */
+#define SYS_HBITMAP_MAX_BITS (1U << (5U * Z_HBITMAP_MAX_LEVELS))
+
+/**
+ * @brief Number of words of storage for a hierarchical bitmap
+ *
+ * @param num_bits Number of indexes.
+ */
+#define SYS_HBITMAP_WORDS(num_bits)					\
+	(Z_HBITMAP_W(num_bits) +					\
+	 ((Z_HBITMAP_W(num_bits) > 1U) ? Z_HBITMAP_W1(num_bits) : 0U) +	\
+	 ((Z_HBITMAP_W1(num_bits) > 1U) ? Z_HBITMAP_W2(num_bits) : 0U) + \
+	 ((Z_HBITMAP_W2(num_bits) > 1U) ? Z_HBITMAP_W3(num_bits) : 0U) + \
+	 ((Z_HBITMAP_W3(num_bits) > 1U) ? 1U : 0U))
+
+/** @brief Hierarchical bitmap */
+struct sys_hbitmap {
+	atomic_t *words;
+	/* Number of levels, the last one being a single word */
+	uint32_t levels;
+	/* Number of bits of each level, leaves first */
+	uint32_t bits[Z_HBITMAP_MAX_LEVELS];
+	/* Index in words of the first word of each level */
+	uint32_t offset[Z_HBITMAP_MAX_LEVELS];
+};
+
+/** @cond INTERNAL_HIDDEN */
+#define Z_HBITMAP_DEFINE(name, num_bits, mod)				\
+	BUILD_ASSERT((num_bits) > 0 &&					\
+		     (num_bits) <= SYS_HBITMAP_MAX_BITS,		\
+		     "Unsupported bitmap size");			\
+	static atomic_t							\
+		_sys_hbitmap_words_##name[SYS_HBITMAP_WORDS(num_bits)];	\
+	mod struct sys_hbitmap name =					\
+		Z_HBITMAP_INIT(_sys_hbitmap_words_##name, num_bits)
+/** @endcond */
+
+/**
+ * @brief Statically define a hierarchical bitmap
+ *
+ * All the indexes of the bitmap start allocated, and it needs no
+ * further initialization.
+ *
+ * @param name Name of the bitmap.
+ * @param num_bits Number of indexes, up to SYS_HBITMAP_MAX_BITS.
+ */
+#define SYS_HBITMAP_DEFINE(name, num_bits)				\
+	Z_HBITMAP_DEFINE(name, num_bits, /* global */)
+
+/**
+ * @brief Statically define a hierarchical bitmap with static scope
+ *
+ * @see SYS_HBITMAP_DEFINE()
+ *
+ * @param name Name of the bitmap.
+ * @param num_bits Number of indexes, up to SYS_HBITMAP_MAX_BITS.
+ */
+#define SYS_HBITMAP_DEFINE_STATIC(name, num_bits)			\
+	Z_HBITMAP_DEFINE(name, num_bits, static)
+
+/**
+ * @brief Initialize a hierarchical bitmap
+ *
+ * All the indexes of the bitmap start allocated.
+ *
+ * @param bm Bitmap.
+ * @param words Storage of SYS_HBITMAP_WORDS(@p num_bits) words.
+ * @param num_bits Number of indexes, up to SYS_HBITMAP_MAX_BITS.
+ */
+void sys_hbitmap_init(struct sys_hbitmap *bm, atomic_t *words,
+		      uint32_t num_bits);
+
+/**
+ * @brief Allocate the lowest free index
+ *
+ * @param bm Bitmap.
+ *
+ * @return The allocated index, or -ENOSPC if all are allocated.
+ */
+int sys_hbitmap_alloc(struct sys_hbitmap *bm);
+
+/**
+ * @brief Allocate the lowest free range of consecutive indexes
+ *
+ * The range is claimed one word at a time, and released again if
+ * another allocation takes one of its indexes in the meantime.
+ *
+ * @param bm Bitmap.
+ * @param count Number of indexes, not zero.
+ *
+ * @return The first index of the range, or -ENOSPC if there is no
+ *         such range.
+ */
+int sys_hbitmap_alloc_range(struct sys_hbitmap *bm, uint32_t count);
+
+/**
+ * @brief Free an index
+ *
+ * @param bm Bitmap.
+ * @param index Allocated index.
+ */
+void sys_hbitmap_free(struct sys_hbitmap *bm, uint32_t index);
+
+/**
+ * @brief Free a range of consecutive indexes
+ *
+ * @param bm Bitmap.
+ * @param index First index of the range.
+ * @param count Number of indexes, all allocated.
+ */
+void sys_hbitmap_free_range(struct sys_hbitmap *bm, uint32_t index,
+			    uint32_t count);
+
+/**
+ * @brief Check whether an index is free
+ *
+ * @param bm Bitmap.
+ * @param index Index.
+ */
+static inline bool sys_hbitmap_is_free(const struct sys_hbitmap *bm,
+				       uint32_t index)
+{
+	return (atomic_get(&bm->words[index / 32U]) &
+		(1U << (index % 32U))) != 0;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HBITMAP_H_ */
@@ -11,6 +11,8 @@
 /* Zephyr Pooled Parallel Preemptible Priority-based Work Queues */
 
 struct k_p4wq_work;
+struct k_p4wq_ws_worker;
+struct k_p4wq_ws_join;
 
 /**
  * P4 Queue handler callback
@@ -37,6 +39,13 @@ struct k_p4wq_work {
 		sys_dlist_t dlnode;
 	};
 	struct k_thread *thread;
+#ifdef CONFIG_P4WQ_WORK_STEALING
+	/* Work stealing pools: worker the item is queued on, and the
+	 * fork/join group it belongs to
+	 */
+	struct k_p4wq_ws_worker *ws_worker;
+	struct k_p4wq_ws_join *ws_join;
+#endif
 };
 
 /**
@@ -160,4 +169,155 @@ void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item);
  */
 bool k_p4wq_cancel(struct k_p4wq *queue, struct k_p4wq_work *item);
 
+/* Work stealing P4 pool.
+ *
+ * A pool of worker threads for CPU-bound batches of small work
+ * items, using the same struct k_p4wq_work items as a P4 queue.
+ * Each worker has its own double ended queue and lock: it takes the
+ * newest items from its own queue first, and when that is empty
+ * steals the oldest ones from the others.  Items run at the priority
+ * of the worker threads (the priority and deadline fields of the
+ * items are ignored), in no particular order.
+ */
+
+struct k_p4wq_ws;
+
+/**
+ * @brief Work stealing pool worker
+ *
+ * Storage for one worker of a work stealing pool.
+ */
+struct k_p4wq_ws_worker {
+	struct k_spinlock lock;
+
+	/* Queued items: the owner works at the head, thieves at the
+	 * tail
+	 */
+	sys_dlist_t deque;
+
+	struct k_p4wq_ws *pool;
+	struct k_thread thread;
+};
+
+/**
+ * @brief Work stealing pool
+ */
+struct k_p4wq_ws {
+	/* Protects waitq */
+	struct k_spinlock lock;
+
+	/* Idle workers */
+	_wait_q_t waitq;
+
+	/* Items queued on all the workers */
+	atomic_t queued;
+
+	/* Workers pending on waitq */
+	atomic_t idle;
+
+	/* Worker picked for the next submission from outside the pool */
+	atomic_t next;
+
+	struct k_p4wq_ws_worker *workers;
+	uint32_t num_workers;
+};
+
+/**
+ * @brief Fork/join group
+ *
+ * Tracks a set of items submitted with k_p4wq_ws_fork(), so that
+ * k_p4wq_ws_join() can wait for all of them to complete.
+ */
+struct k_p4wq_ws_join {
+	atomic_t pending;
+	struct k_sem done;
+};
+
+/**
+ * @brief Initialize a work stealing pool
+ *
+ * @param pool Pool to initialize
+ * @param workers Storage for the workers
+ * @param num_workers Number of workers
+ */
+void k_p4wq_ws_init(struct k_p4wq_ws *pool, struct k_p4wq_ws_worker *workers,
+		    uint32_t num_workers);
+
+/**
+ * @brief Start the worker threads of a work stealing pool
+ *
+ * With CONFIG_SCHED_CPU_MASK, worker i is pinned to CPU
+ * i % CONFIG_MP_NUM_CPUS, otherwise the workers run on any CPU.
+ *
+ * @param pool Pool whose workers to start
+ * @param stacks Array of num_workers thread stacks, as defined by
+ *               K_THREAD_STACK_ARRAY_DEFINE()
+ * @param stack_size Size of each stack, as passed to
+ *                   K_THREAD_STACK_ARRAY_DEFINE()
+ * @param prio Priority of the worker threads
+ */
+void k_p4wq_ws_start(struct k_p4wq_ws *pool, k_thread_stack_t *stacks,
+		     size_t stack_size, int prio);
+
+/**
+ * @brief Submit a work item to a work stealing pool
+ *
+ * Called from a worker of the pool, this queues the item on that
+ * worker, otherwise on the workers in turn.  The item must not be
+ * modified until it has been cancelled or its handler has started.
+ * Items must be zero-initialized before they are first submitted,
+ * e.g. statically or with memset(); they can then be submitted again
+ * once cancelled or once their handler has started.
+ *
+ * @param pool Pool to submit to
+ * @param item Item with its handler set
+ */
+void k_p4wq_ws_submit(struct k_p4wq_ws *pool, struct k_p4wq_work *item);
+
+/**
+ * @brief Cancel a work item submitted to a work stealing pool
+ *
+ * Same semantics as k_p4wq_cancel(): returns true if the item was
+ * still queued and is now removed, false if it was never submitted,
+ * is running or has already run.  A cancelled item counts as complete
+ * for the join group it was forked into.
+ *
+ * @return true if the item was removed
+ */
+bool k_p4wq_ws_cancel(struct k_p4wq_ws *pool, struct k_p4wq_work *item);
+
+/**
+ * @brief Initialize a fork/join group
+ *
+ * @param join Group to initialize
+ */
+void k_p4wq_ws_join_init(struct k_p4wq_ws_join *join);
+
+/**
+ * @brief Submit a work item as part of a fork/join group
+ *
+ * As k_p4wq_ws_submit(), and counts the item in @a join until its
+ * handler returns.  Handlers may themselves fork into any group.
+ *
+ * @param pool Pool to submit to
+ * @param join Group the item is part of
+ * @param item Item with its handler set
+ */
+void k_p4wq_ws_fork(struct k_p4wq_ws *pool, struct k_p4wq_ws_join *join,
+		    struct k_p4wq_work *item);
+
+/**
+ * @brief Wait for all the items of a fork/join group
+ *
+ * Returns once the handlers of all the items forked into @a join
+ * have returned (or the items were cancelled).  Called from a worker
+ * of the pool, this runs queued items (its own first, then stolen
+ * ones) while it waits rather than blocking the worker, so handlers
+ * can safely fork and join recursively.
+ *
+ * @param pool Pool the items were submitted to
+ * @param join Group to wait for
+ */
+void k_p4wq_ws_join(struct k_p4wq_ws *pool, struct k_p4wq_ws_join *join);
+
 #endif /* ZEPHYR_INCLUDE_SYS_P4WQ_H_ */
@@ -37,13 +37,15 @@
  * notably, there is no "parent" pointer stored in the node, the upper
  * structure of the tree being generated dynamically via a stack as
  * the tree is recursed.  So the overall memory overhead of a node is
- * just two pointers, identical with a doubly-linked list.
+ * just two pointers, identical with a doubly-linked list.  The tree
+ * caches its lowest and highest nodes, so getting them is O(1).
  */
 
 #ifndef ZEPHYR_INCLUDE_SYS_RB_H_
 #define ZEPHYR_INCLUDE_SYS_RB_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 struct rbnode {
 	struct rbnode *children[2];
@@ -77,6 +79,8 @@ struct rbtree {
 	struct rbnode *root;
 	rb_lessthan_t lessthan_fn;
 	int max_depth;
+	/* Lowest and highest nodes */
+	struct rbnode *minmax[2];
 #ifdef CONFIG_MISRA_SANE
 	struct rbnode *iter_stack[Z_MAX_RBTREE_DEPTH];
 	unsigned char iter_left[Z_MAX_RBTREE_DEPTH];
@@ -87,9 +91,7 @@ typedef void (*rb_visit_t)(struct rbnode *node, void *cookie);
 
 struct rbnode *z_rb_child(struct rbnode *node, int side);
 int z_rb_is_black(struct rbnode *node);
-#ifndef CONFIG_MISRA_SANE
 void z_rb_walk(struct rbnode *node, rb_visit_t visit_fn, void *cookie);
-#endif
 struct rbnode *z_rb_get_minmax(struct rbtree *tree, int side);
 
 /**
@@ -102,12 +104,22 @@ void rb_insert(struct rbtree *tree, struct rbnode *node);
  */
 void rb_remove(struct rbtree *tree, struct rbnode *node);
 
+/**
+ * @brief Build a tree from sorted nodes
+ *
+ * Replaces the content of the tree with the @p count nodes of the
+ * @p nodes array, which must be sorted according to the tree's
+ * lessthan_fn, in O(N) time.  That is much faster than inserting them
+ * one by one, which also leaves a less balanced tree.
+ */
+void rb_build(struct rbtree *tree, struct rbnode **nodes, size_t count);
+
 /**
  * @brief Returns the lowest-sorted member of the tree
  */
 static inline struct rbnode *rb_get_min(struct rbtree *tree)
 {
-	return z_rb_get_minmax(tree, 0);
+	return tree->minmax[0];
 }
 
 /**
@@ -115,7 +127,7 @@ static inline struct rbnode *rb_get_min(struct rbtree *tree)
  */
 static inline struct rbnode *rb_get_max(struct rbtree *tree)
 {
-	return z_rb_get_minmax(tree, 1);
+	return tree->minmax[1];
 }
 
 /**
@@ -129,21 +141,23 @@ static inline struct rbnode *rb_get_max(struct rbtree *tree)
  */
 bool rb_contains(struct rbtree *tree, struct rbnode *node);
 
-#ifndef CONFIG_MISRA_SANE
 /**
  * @brief Walk/enumerate a rbtree
  *
- * Very simple recursive enumeration.  Low code size, but requiring a
- * separate function can be clumsy for the user and there is no way to
- * break out of the loop early.  See RB_FOR_EACH for an iterative
- * implementation.
+ * Very simple enumeration, which needs neither recursion nor a stack:
+ * it threads the tree on the way down (Morris traversal), and restores
+ * it on the way up.  Low code size, but requiring a separate function
+ * can be clumsy for the user and there is no way to break out of the
+ * loop early.  See RB_FOR_EACH for an alternative.
+ *
+ * The visit function must not modify the tree, nor look at the
+ * children of the nodes.
  */
 static inline void rb_walk(struct rbtree *tree, rb_visit_t visit_fn,
 			   void *cookie)
 {
 	z_rb_walk(tree->root, visit_fn, cookie);
 }
-#endif
 
 struct _rb_foreach {
 	struct rbnode **stack;
@@ -171,11 +185,10 @@ struct rbnode *z_rb_foreach_next(struct rbtree *tree, struct _rb_foreach *f);
 /**
  * @brief Walk a tree in-order without recursing
  *
- * While @ref rb_walk() is very simple, recursing on the C stack can
- * be clumsy for some purposes and on some architectures wastes
- * significant memory in stack frames.  This macro implements a
- * non-recursive "foreach" loop that can iterate directly on the tree,
- * at a moderate cost in code size.
+ * While @ref rb_walk() is very simple, a callback can be clumsy for
+ * some purposes.  This macro implements a "foreach" loop that can
+ * iterate directly on the tree and be broken out of, at a moderate
+ * cost in code size and a stack of the tree's depth.
  *
  * Note that the resulting loop is not safe against modifications to
  * the tree.  Changes to the tree structure during the loop will
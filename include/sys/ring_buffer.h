@@ -28,6 +28,13 @@ extern "C" {
 
 #define RING_BUFFER_SIZE_ASSERT_MSG \
 	"Size too big, if it is the ring buffer test check custom max size"
+
+/* Modulo mask of a ring buffer of the given size, or 0 if the size is not a
+ * power of 2.
+ */
+#define Z_RING_BUF_MASK(size) \
+	((((size) > 1) && (((size) & ((size) - 1)) == 0)) ? ((size) - 1) : 0)
+
 /**
  * @brief A structure to represent a ring buffer
  */
@@ -93,7 +100,8 @@ struct ring_buf {
  * @brief Statically define and initialize a standard ring buffer.
  *
  * This macro establishes a ring buffer of an arbitrary size. A standard
- * ring buffer uses modulo arithmetic operations to maintain itself.
+ * ring buffer uses modulo arithmetic operations to maintain itself, unless
+ * its size happens to be a power of 2.
  *
  * The ring buffer can be accessed outside the module where it is defined
  * using:
@@ -109,13 +117,16 @@ struct ring_buf {
 	static uint32_t _ring_buffer_data_##name[size32]; \
 	struct ring_buf name = { \
 		.size = size32, \
+		.mask = Z_RING_BUF_MASK(size32), \
 		.buf = { .buf32 = _ring_buffer_data_##name} \
 	}
 
 /**
  * @brief Statically define and initialize a ring buffer for byte data.
  *
- * This macro establishes a ring buffer of an arbitrary size.
+ * This macro establishes a ring buffer of an arbitrary size.  As for
+ * item ring buffers, a size that is a power of 2 avoids modulo arithmetic
+ * operations, and the periodic rewinding of the indexes.
  *
  * The ring buffer can be accessed outside the module where it is defined
  * using:
@@ -131,6 +142,7 @@ struct ring_buf {
 	static uint8_t _ring_buffer_data_##name[size8]; \
 	struct ring_buf name = { \
 		.size = size8, \
+		.mask = Z_RING_BUF_MASK(size8), \
 		.buf = { .buf8 = _ring_buffer_data_##name} \
 	}
 
@@ -406,6 +418,191 @@ int ring_buf_get_finish(struct ring_buf *buf, uint32_t size);
  */
 uint32_t ring_buf_get(struct ring_buf *buf, uint8_t *data, uint32_t size);
 
+/**
+ * @brief A structure to represent a multi-producer ring buffer
+ *
+ * This ring buffer stores records of bytes, which any number of producers
+ * can write concurrently without locking, and one consumer reads in the
+ * order in which they were claimed.  Each record takes a 32-bit header word
+ * plus its data rounded up to 32-bit words, and never wraps: a record that
+ * does not fit before the end of the buffer is preceded by padding.  So
+ * only records of up to half of the buffer are sure to fit once it is empty.
+ */
+struct ring_buf_mpsc {
+	atomic_t tail;   /**< Index of the next word to claim */
+	atomic_t head;   /**< Index of the first word of the oldest record */
+	uint32_t mask;   /**< Size of buf in 32-bit words, minus 1 */
+	uint32_t *buf32; /**< Memory region for stored records */
+	atomic_t *committed; /**< One bit per word, set on record headers */
+	atomic_t dropped_put_count; /**< Running tally of the number of
+				     * failed put attempts.
+				     */
+};
+
+/**
+ * @brief Statically define and initialize a multi-producer ring buffer.
+ *
+ * The ring buffer contains 2^pow 32-bit words, where @a pow is the specified
+ * ring buffer size exponent.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct ring_buf_mpsc <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define RING_BUF_MPSC_DECLARE_POW2(name, pow) \
+	BUILD_ASSERT((pow) > 0 && (pow) < 31, RING_BUFFER_SIZE_ASSERT_MSG); \
+	static uint32_t _ring_buffer_data_##name[BIT(pow)]; \
+	static ATOMIC_DEFINE(_ring_buffer_committed_##name, BIT(pow)); \
+	struct ring_buf_mpsc name = { \
+		.mask = BIT(pow) - 1, \
+		.buf32 = _ring_buffer_data_##name, \
+		.committed = _ring_buffer_committed_##name, \
+	}
+
+/**
+ * @brief Size of the committed bitmap of a multi-producer ring buffer.
+ *
+ * @param size32 Ring buffer size (in 32-bit words).
+ *
+ * @return Number of atomic_t variables needed for the bitmap.
+ */
+#define RING_BUF_MPSC_BITMAP_SIZE(size32) (1 + ((size32) - 1) / ATOMIC_BITS)
+
+/**
+ * @brief Initialize a multi-producer ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is only
+ * used for ring buffers not defined using RING_BUF_MPSC_DECLARE_POW2.
+ *
+ * @param buf Address of ring buffer.
+ * @param size32 Ring buffer size (in 32-bit words), a power of 2.
+ * @param data Ring buffer data area (uint32_t data[size32]).
+ * @param committed Bitmap for the ring buffer
+ *		    (atomic_t committed[RING_BUF_MPSC_BITMAP_SIZE(size32)]).
+ */
+static inline void ring_buf_mpsc_init(struct ring_buf_mpsc *buf,
+				      uint32_t size32, uint32_t *data,
+				      atomic_t *committed)
+{
+	__ASSERT(is_power_of_two(size32) && size32 > 1U &&
+		 size32 < RING_BUFFER_MAX_SIZE,
+		 "size must be a power of 2");
+
+	buf->tail = ATOMIC_INIT(0);
+	buf->head = ATOMIC_INIT(0);
+	buf->mask = size32 - 1U;
+	buf->buf32 = data;
+	buf->committed = committed;
+	buf->dropped_put_count = ATOMIC_INIT(0);
+	memset(committed, 0,
+	       RING_BUF_MPSC_BITMAP_SIZE(size32) * sizeof(atomic_t));
+}
+
+/**
+ * @brief Determine if a multi-producer ring buffer is empty.
+ *
+ * Records that are claimed but not yet finished count as stored.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int ring_buf_mpsc_is_empty(struct ring_buf_mpsc *buf)
+{
+	return atomic_get(&buf->head) == atomic_get(&buf->tail);
+}
+
+/**
+ * @brief Allocate a record in a multi-producer ring buffer.
+ *
+ * This reserves contiguous room for a record of @a size bytes, which the
+ * caller fills and then hands over to the consumer with
+ * @ref ring_buf_mpsc_put_finish.  Any number of threads and ISRs can
+ * claim records concurrently.  The consumer cannot see records claimed
+ * after one that is not finished yet, so records should be finished
+ * promptly.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the 32-bit aligned data area of the record.
+ * @param[in]  size Record size (in bytes).
+ *
+ * @retval 0 Record was allocated.
+ * @retval -EMSGSIZE Ring buffer has insufficient free space.
+ */
+int ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, uint8_t **data,
+			    uint32_t size);
+
+/**
+ * @brief Hand a record over to the consumer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Data area of the record, as set by
+ *	       @ref ring_buf_mpsc_put_claim.
+ */
+void ring_buf_mpsc_put_finish(struct ring_buf_mpsc *buf, uint8_t *data);
+
+/**
+ * @brief Write (copy) a record to a multi-producer ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval 0 Record was written.
+ * @retval -EMSGSIZE Ring buffer has insufficient free space.
+ */
+int ring_buf_mpsc_put(struct ring_buf_mpsc *buf, const uint8_t *data,
+		      uint32_t size);
+
+/**
+ * @brief Get the oldest record of a multi-producer ring buffer.
+ *
+ * The record stays in the ring buffer until it is freed with
+ * @ref ring_buf_mpsc_get_finish.
+ *
+ * @warning
+ * There must be only one consumer at a time.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the 32-bit aligned data area of the record.
+ *
+ * @retval -EAGAIN No record is finished yet.
+ * @return Otherwise the size of the record (in bytes).
+ */
+int ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, uint8_t **data);
+
+/**
+ * @brief Free the record obtained with @ref ring_buf_mpsc_get_claim.
+ *
+ * @warning
+ * There must be only one consumer at a time.
+ *
+ * @param buf Address of ring buffer.
+ */
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf);
+
+/**
+ * @brief Read (copy) a record from a multi-producer ring buffer.
+ *
+ * @warning
+ * There must be only one consumer at a time.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Output buffer size (in bytes).
+ *
+ * @retval -EAGAIN No record is finished yet.
+ * @retval -EMSGSIZE The output buffer is too small; the record is left in
+ *	   the ring buffer.
+ * @return Otherwise the size of the record (in bytes).
+ */
+int ring_buf_mpsc_get(struct ring_buf_mpsc *buf, uint8_t *data,
+		      uint32_t size);
+
 /**
  * @}
  */
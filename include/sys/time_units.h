@@ -56,6 +56,77 @@ static TIME_CONSTEXPR inline int sys_clock_hw_cycles_per_sec(void)
 #endif
 }
 
+/* High 64 bits of the 128 bit product of a and b */
+static TIME_CONSTEXPR ALWAYS_INLINE uint64_t z_tmcvt_mulhi64(uint64_t a,
+							    uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+	uint64_t al = (uint32_t)a, ah = a >> 32;
+	uint64_t bl = (uint32_t)b, bh = b >> 32;
+	uint64_t lh = al * bh, hl = ah * bl;
+	uint64_t mid = ((al * bl) >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+	return ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/* Exact n / d, computed as a multiplication by a fixed point reciprocal
+ * of d and a shift, as compilers do for 32 bit divisions by constants
+ * (see Granlund and Montgomery, "Division by Invariant Integers using
+ * Multiplication").  With 2^l < d < 2^(l + 1), the quotient is
+ * (n * m) >> (64 + l) for the reciprocal m = 2^(64 + l) / d + 1 if it
+ * is accurate enough, else for the 65 bit m = 2^(65 + l) / d + 1 with
+ * one more shift, whose top bit is added back as n.
+ *
+ * Meant for a d known at build time: computing m then takes a few
+ * 64 bit divisions, which the compiler does itself.  This spares
+ * 32 bit CPUs a call to the 64 bit division routine of the toolchain,
+ * which takes hundreds of cycles on those without a divide
+ * instruction.
+ */
+static TIME_CONSTEXPR ALWAYS_INLINE uint64_t z_tmcvt_divu64(uint64_t n,
+							   uint32_t d)
+{
+	if ((d & (d - 1U)) == 0U) {
+		return n >> __builtin_ctz(d);
+	}
+
+	/* 2^(64 + l) / d, by long division in 32 bit digits */
+	uint32_t l = 31U - __builtin_clz(d);
+	uint64_t r = ((uint64_t)1U << l) << 32;
+	uint64_t m = (r / d) << 32;
+
+	r = (r % d) << 32;
+	m |= r / d;
+	r %= d;
+
+	if ((d - r) < ((uint64_t)1U << l)) {
+		return z_tmcvt_mulhi64(n, m + 1U) >> l;
+	}
+
+	m = 2U * m + ((2U * r >= d) ? 1U : 0U) + 1U;
+
+	uint64_t q = z_tmcvt_mulhi64(n, m);
+
+	return (((n - q) >> 1) + q) >> l;
+}
+
+/* 64 bit division for z_tmcvt(), by a reciprocal if so configured and
+ * the divisor is known at build time
+ */
+static TIME_CONSTEXPR ALWAYS_INLINE uint64_t z_tmcvt_div(uint64_t n,
+							uint32_t d,
+							bool const_hz)
+{
+	if (IS_ENABLED(CONFIG_TIME_UNITS_RECIPROCAL) && const_hz) {
+		return z_tmcvt_divu64(n, d);
+	}
+
+	return n / d;
+}
+
 /* Time converter generator gadget.  Selects from one of three
  * conversion algorithms: ones that take advantage when the
  * frequencies are an integer ratio (in either direction), or a full
@@ -111,7 +182,7 @@ static TIME_CONSTEXPR ALWAYS_INLINE uint64_t z_tmcvt(uint64_t t, uint32_t from_h
 		if (result32 && (t < BIT64(32))) {
 			return ((uint32_t)t) / (from_hz / to_hz);
 		} else {
-			return t / (from_hz / to_hz);
+			return z_tmcvt_div(t, from_hz / to_hz, const_hz);
 		}
 	} else if (mul_ratio) {
 		if (result32) {
@@ -121,9 +192,10 @@ static TIME_CONSTEXPR ALWAYS_INLINE uint64_t z_tmcvt(uint64_t t, uint32_t from_h
 		}
 	} else {
 		if (result32) {
-			return (uint32_t)((t * to_hz + off) / from_hz);
+			return (uint32_t)z_tmcvt_div(t * to_hz + off, from_hz,
+						     const_hz);
 		} else {
-			return (t * to_hz + off) / from_hz;
+			return z_tmcvt_div(t * to_hz + off, from_hz, const_hz);
 		}
 	}
 }
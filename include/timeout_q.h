@@ -25,6 +25,9 @@ extern "C" {
 static inline void z_init_timeout(struct _timeout *t)
 {
 	sys_dnode_init(&t->node);
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	t->dticks = 0;
+#endif
 }
 
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
@@ -34,7 +37,11 @@ int z_abort_timeout(struct _timeout *to);
 
 static inline bool z_is_inactive_timeout(const struct _timeout *t)
 {
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	return t->dticks == 0;
+#else
 	return !sys_dnode_is_linked(&t->node);
+#endif
 }
 
 static inline void z_init_thread_timeout(struct _thread_base *thread_base)
@@ -32,11 +32,8 @@ int z_vrfy_k_condvar_init(struct k_condvar *condvar)
 int z_impl_k_condvar_signal(struct k_condvar *condvar)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
-	struct k_thread *thread = z_unpend_first_thread(&condvar->wait_q);
 
-	if (thread != NULL) {
-		arch_thread_return_value_set(thread, 0);
-		z_ready_thread(thread);
+	if (z_sched_wake(&condvar->wait_q, 0, NULL)) {
 		z_reschedule(&lock, key);
 	} else {
 		k_spin_unlock(&lock, key);
@@ -55,19 +52,13 @@ int z_vrfy_k_condvar_signal(struct k_condvar *condvar)
 
 int z_impl_k_condvar_broadcast(struct k_condvar *condvar)
 {
-	struct k_thread *pending_thread;
 	k_spinlock_key_t key;
-	int woken = 0;
+	int woken;
 
 	key = k_spin_lock(&lock);
 
-	/* wake up any threads that are waiting to write */
-	while ((pending_thread = z_unpend_first_thread(&condvar->wait_q)) !=
-	       NULL) {
-		arch_thread_return_value_set(pending_thread, 0);
-		z_ready_thread(pending_thread);
-		woken++;
-	}
+	/* wake up all the waiters at once */
+	woken = z_sched_wake_all(&condvar->wait_q, 0, NULL);
 
 	z_reschedule(&lock, key);
 
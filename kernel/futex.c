@@ -27,8 +27,7 @@ static struct z_futex_data *k_futex_find_data(struct k_futex *futex)
 int z_impl_k_futex_wake(struct k_futex *futex, bool wake_all)
 {
 	k_spinlock_key_t key;
-	unsigned int woken = 0;
-	struct k_thread *thread;
+	unsigned int woken;
 	struct z_futex_data *futex_data;
 
 	futex_data = k_futex_find_data(futex);
@@ -38,14 +37,11 @@ int z_impl_k_futex_wake(struct k_futex *futex, bool wake_all)
 
 	key = k_spin_lock(&futex_data->lock);
 
-	do {
-		thread = z_unpend_first_thread(&futex_data->wait_q);
-		if (thread) {
-			z_ready_thread(thread);
-			arch_thread_return_value_set(thread, 0);
-			woken++;
-		}
-	} while (thread && wake_all);
+	if (wake_all) {
+		woken = z_sched_wake_all(&futex_data->wait_q, 0, NULL);
+	} else {
+		woken = z_sched_wake(&futex_data->wait_q, 0, NULL) ? 1 : 0;
+	}
 
 	z_reschedule(&futex_data->lock, key);
 
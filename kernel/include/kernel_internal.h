@@ -121,6 +121,9 @@ extern void smp_timer_init(void);
 
 extern void z_early_boot_rand_get(uint8_t *buf, size_t length);
 
+/* True if the next ring queue slot holds a message, for k_poll() */
+extern bool z_ringq_data_available(struct k_ringq *q);
+
 #if CONFIG_STACK_POINTER_RANDOM
 extern int z_stack_adjust_initialized;
 #endif
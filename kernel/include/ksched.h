@@ -51,6 +51,39 @@ void z_reschedule_irqlock(uint32_t key);
 struct k_thread *z_unpend_first_thread(_wait_q_t *wait_q);
 void z_unpend_thread(struct k_thread *thread);
 int z_unpend_all(_wait_q_t *wait_q);
+
+/**
+ * Wake up the highest priority thread pended on a wait queue
+ *
+ * The thread is unpended, has its timeout cancelled, gets
+ * @a swap_retval as the return value of the z_pend_curr() call it is
+ * blocked in (and @a swap_data as its base.swap_data), and is made
+ * ready, all under one scheduler lock hold.  The caller still has to
+ * reschedule.
+ *
+ * @return true if a thread was woken up
+ */
+bool z_sched_wake(_wait_q_t *wait_q, int swap_retval, void *swap_data);
+
+/**
+ * Wake up every thread pended on a wait queue
+ *
+ * As z_sched_wake(), for all the waiters at once: the whole batch is
+ * made ready under one scheduler lock hold, with a single scheduler
+ * cache update and at most one IPI.
+ *
+ * @return Number of threads woken up
+ */
+int z_sched_wake_all(_wait_q_t *wait_q, int swap_retval, void *swap_data);
+
+/**
+ * Wake up a given pended thread
+ *
+ * As z_sched_wake(), for a thread the caller has already picked.
+ * The thread is only made ready if nothing else (e.g. suspension)
+ * keeps it from running.
+ */
+void z_sched_wake_thread(struct k_thread *thread, int swap_retval);
 void z_thread_priority_set(struct k_thread *thread, int prio);
 bool z_set_prio(struct k_thread *thread, int prio);
 void *z_get_next_switch_handle(void *interrupted);
@@ -58,7 +91,7 @@ struct k_thread *z_find_first_thread_to_unpend(_wait_q_t *wait_q,
 					      struct k_thread *from);
 void idle(void *a, void *b, void *c);
 void z_time_slice(int ticks);
-void z_reset_time_slice(void);
+void z_reset_time_slice(struct k_thread *curr);
 void z_sched_abort(struct k_thread *thread);
 void z_sched_ipi(void);
 void z_sched_start(struct k_thread *thread);
@@ -97,13 +97,8 @@
  * Hence it's necessary to constrain its size as much as possible.
  */
 struct z_page_frame {
-	union {
-		/* If mapped, virtual address this page is mapped to */
-		void *addr;
-
-		/* If unmapped and available, free pages list membership. */
-		sys_snode_t node;
-	};
+	/* If mapped, virtual address this page is mapped to */
+	void *addr;
 
 	/* Z_PAGE_FRAME_* flags */
 	uint8_t flags;
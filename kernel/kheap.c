@@ -26,6 +26,27 @@ static int statics_init(const struct device *unused)
 
 SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
+#ifdef CONFIG_KERNEL_HEAP_TRACE
+static k_heap_trace_hook_t trace_hook;
+
+void k_heap_trace_hook_set(k_heap_trace_hook_t hook)
+{
+	trace_hook = hook;
+}
+
+static inline void trace_op(struct k_heap *h, enum k_heap_trace_op op,
+			    void *mem, size_t align, size_t bytes)
+{
+	k_heap_trace_hook_t hook = trace_hook;
+
+	if ((hook != NULL) && (mem != NULL)) {
+		hook(h, op, mem, align, bytes);
+	}
+}
+#else
+#define trace_op(h, op, mem, align, bytes) do { } while (false)
+#endif
+
 void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			k_timeout_t timeout)
 {
@@ -48,6 +69,7 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 		key = k_spin_lock(&h->lock);
 	}
 
+	trace_op(h, K_HEAP_TRACE_ALLOC, ret, align, bytes);
 	k_spin_unlock(&h->lock, key);
 	return ret;
 }
@@ -56,6 +78,7 @@ void k_heap_free(struct k_heap *h, void *mem)
 {
 	k_spinlock_key_t key = k_spin_lock(&h->lock);
 
+	trace_op(h, K_HEAP_TRACE_FREE, mem, 0, 0);
 	sys_heap_free(&h->heap, mem);
 
 	if (z_unpend_all(&h->wait_q) != 0) {
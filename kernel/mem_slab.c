@@ -14,6 +14,7 @@
 #include <ksched.h>
 #include <init.h>
 #include <sys/check.h>
+#include <string.h>
 
 static struct k_spinlock lock;
 
@@ -93,6 +94,11 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->max_used = 0U;
 #endif
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	slab->waiters = ATOMIC_INIT(0);
+	(void)memset(slab->cache, 0, sizeof(slab->cache));
+#endif
+
 	rc = create_free_list(slab);
 	if (rc < 0) {
 		goto out;
@@ -106,11 +112,130 @@ out:
 	return rc;
 }
 
-int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+
+#define CACHE_BATCH (CONFIG_MEM_SLAB_CPU_CACHE_SIZE / 2)
+
+/* Caches are only a fast path: being migrated between picking one and
+ * locking it just means using another CPU's cache, which is still
+ * correct since it is locked.  Lock order is cache, then slab.
+ */
+static struct z_mem_slab_cache *this_cache(struct k_mem_slab *slab)
+{
+	unsigned int key = arch_irq_lock();
+	struct z_mem_slab_cache *c = &slab->cache[_current_cpu->id];
+
+	arch_irq_unlock(key);
+	return c;
+}
+
+static void cache_refill(struct k_mem_slab *slab, struct z_mem_slab_cache *c)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	while ((c->count < CACHE_BATCH) && (slab->free_list != NULL)) {
+		c->blocks[c->count++] = slab->free_list;
+		slab->free_list = *(char **)(slab->free_list);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+static void cache_drain(struct k_mem_slab *slab, struct z_mem_slab_cache *c,
+			uint32_t n)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	while (n-- > 0U) {
+		char *block = c->blocks[--c->count];
+
+		*(char **)block = slab->free_list;
+		slab->free_list = block;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+static void cache_flush_all(struct k_mem_slab *slab)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_cache *c = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+		cache_drain(slab, c, c->count);
+		k_spin_unlock(&c->lock, key);
+	}
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	struct z_mem_slab_cache *c = this_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+	if (c->count == 0U) {
+		cache_refill(slab, c);
+		if (c->count == 0U) {
+			k_spin_unlock(&c->lock, key);
+			return false;
+		}
+	}
+
+	*mem = c->blocks[--c->count];
+	c->num_used++;
+
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	slab->max_used = MAX(k_mem_slab_num_used_get(slab), slab->max_used);
+#endif
+
+	k_spin_unlock(&c->lock, key);
+	return true;
+}
+
+static bool cache_free(struct k_mem_slab *slab, char *block)
+{
+	struct z_mem_slab_cache *c = this_cache(slab);
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+	/* A waiter raises this before flushing the caches (which takes
+	 * this lock), so either it sees the block or we see it
+	 */
+	if (atomic_get(&slab->waiters) != 0) {
+		k_spin_unlock(&c->lock, key);
+		return false;
+	}
+
+	if (c->count == CONFIG_MEM_SLAB_CPU_CACHE_SIZE) {
+		cache_drain(slab, c, CACHE_BATCH);
+	}
+
+	c->blocks[c->count++] = block;
+	c->num_used--;
+
+	k_spin_unlock(&c->lock, key);
+	return true;
+}
+
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_alloc(slab, mem)) {
+		return 0;
+	}
+
+	/* Blocks may be sitting in other CPUs' caches: keep frees out
+	 * of the caches and collect those before failing or waiting
+	 */
+	atomic_inc(&slab->waiters);
+	cache_flush_all(slab);
+#endif
+
+	key = k_spin_lock(&lock);
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
@@ -118,7 +243,8 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		slab->num_used++;
 
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
-		slab->max_used = MAX(slab->num_used, slab->max_used);
+		slab->max_used = MAX(k_mem_slab_num_used_get(slab),
+				     slab->max_used);
 #endif
 
 		result = 0;
@@ -132,17 +258,29 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
-		return result;
+		goto out;
 	}
 
 	k_spin_unlock(&lock, key);
 
+out:
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	atomic_dec(&slab->waiters);
+#endif
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_free(slab, *mem)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
 
 	if (slab->free_list == NULL) {
 		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
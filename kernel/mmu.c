@@ -10,6 +10,7 @@
 #include <kernel_arch_interface.h>
 #include <spinlock.h>
 #include <mmu.h>
+#include <sys/hbitmap.h>
 #include <init.h>
 #include <kernel_internal.h>
 #include <linker/linker-defs.h>
@@ -200,18 +201,18 @@ static void *virt_region_get(size_t size)
  * Call all of these functions with z_mm_lock held.
  */
 
-/* Linked list of unused and available page frames.
+/* Unused and available page frames, by index in z_page_frames. The lowest
+ * free page frame is handed out first, so that used memory stays packed
+ * at the start of RAM, and ranges of contiguous page frames can be found
+ * without scanning the page frame array.
  *
- * TODO: This is very simple and treats all free page frames as being equal.
- * However, there are use-cases to consolidate free pages such that entire
- * SRAM banks can be switched off to save power, and so obtaining free pages
- * may require a more complex ontology which prefers page frames in RAM banks
- * which are still active.
- *
- * This implies in the future there may be multiple slists managing physical
- * pages. Each page frame will still just have one snode link.
+ * TODO: This treats all free page frames as being equal. However, there
+ * are use-cases to consolidate free pages such that entire SRAM banks can
+ * be switched off to save power, and so obtaining free pages may require
+ * a more complex ontology which prefers page frames in RAM banks which are
+ * still active.
  */
-static sys_slist_t free_page_frame_list;
+SYS_HBITMAP_DEFINE_STATIC(free_page_frames, Z_NUM_PAGE_FRAMES);
 
 /* Number of unused and available free page frames */
 size_t z_free_page_count;
@@ -223,13 +224,13 @@ size_t z_free_page_count;
 /* Get an unused page frame. don't care which one, or NULL if there are none */
 static struct z_page_frame *free_page_frame_list_get(void)
 {
-	sys_snode_t *node;
+	int idx;
 	struct z_page_frame *pf = NULL;
 
-	node = sys_slist_get(&free_page_frame_list);
-	if (node != NULL) {
+	idx = sys_hbitmap_alloc(&free_page_frames);
+	if (idx >= 0) {
 		z_free_page_count--;
-		pf = CONTAINER_OF(node, struct z_page_frame, node);
+		pf = &z_page_frames[idx];
 		PF_ASSERT(pf, z_page_frame_is_available(pf),
 			 "unavailable but somehow on free list");
 	}
@@ -242,15 +243,10 @@ static void free_page_frame_list_put(struct z_page_frame *pf)
 {
 	PF_ASSERT(pf, z_page_frame_is_available(pf),
 		 "unavailable page put on free list");
-	sys_slist_append(&free_page_frame_list, &pf->node);
+	sys_hbitmap_free(&free_page_frames, pf - z_page_frames);
 	z_free_page_count++;
 }
 
-static void free_page_frame_list_init(void)
-{
-	sys_slist_init(&free_page_frame_list);
-}
-
 /*
  * Memory Mapping
  */
@@ -512,8 +508,6 @@ void z_mem_manage_init(void)
 	struct z_page_frame *pf;
 	k_spinlock_key_t key = k_spin_lock(&z_mm_lock);
 
-	free_page_frame_list_init();
-
 #ifdef CONFIG_ARCH_HAS_RESERVED_PAGE_FRAMES
 	/* If some page frames are unavailable for use as memory, arch
 	 * code will mark Z_PAGE_FRAME_RESERVED in their flags
@@ -78,6 +78,12 @@ static inline bool is_condition_met(struct k_poll_event *event, uint32_t *state)
 			return true;
 		}
 		break;
+	case K_POLL_TYPE_RINGQ_DATA_AVAILABLE:
+		if (z_ringq_data_available(event->ringq)) {
+			*state = K_POLL_STATE_RINGQ_DATA_AVAILABLE;
+			return true;
+		}
+		break;
 	case K_POLL_TYPE_IGNORE:
 		break;
 	default:
@@ -134,6 +140,12 @@ static inline void register_event(struct k_poll_event *event,
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		add_event(&event->signal->poll_events, event, poller);
 		break;
+	case K_POLL_TYPE_RINGQ_DATA_AVAILABLE:
+		__ASSERT(event->ringq != NULL, "invalid ring queue\n");
+		add_event(&event->ringq->poll_events, event, poller);
+		/* Producers skip the wakeup path unless this is set */
+		atomic_inc(&event->ringq->waiters);
+		break;
 	case K_POLL_TYPE_IGNORE:
 		/* nothing to do */
 		break;
@@ -165,6 +177,11 @@ static inline void clear_event_registration(struct k_poll_event *event)
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		remove = true;
 		break;
+	case K_POLL_TYPE_RINGQ_DATA_AVAILABLE:
+		__ASSERT(event->ringq != NULL, "invalid ring queue\n");
+		atomic_dec(&event->ringq->waiters);
+		remove = true;
+		break;
 	case K_POLL_TYPE_IGNORE:
 		/* nothing to do */
 		break;
@@ -213,6 +230,17 @@ static inline int register_events(struct k_poll_event *events,
 		} else if (!just_check && poller->is_polling) {
 			register_event(&events[ii], poller);
 			events_registered += 1;
+
+			/* Ring queue producers don't take this lock, so a
+			 * message may have landed before the registration
+			 * became visible to them
+			 */
+			if ((events[ii].type ==
+			     K_POLL_TYPE_RINGQ_DATA_AVAILABLE) &&
+			    is_condition_met(&events[ii], &state)) {
+				set_event_ready(&events[ii], state);
+				poller->is_polling = false;
+			}
 		}
 		k_spin_unlock(&lock, key);
 	}
@@ -234,16 +262,9 @@ static int signal_poller(struct k_poll_event *event, uint32_t state)
 		return -EAGAIN;
 	}
 
-	z_unpend_thread(thread);
-	arch_thread_return_value_set(thread,
+	z_sched_wake_thread(thread,
 		state == K_POLL_STATE_CANCELLED ? -EINTR : 0);
 
-	if (!z_is_thread_ready(thread)) {
-		return 0;
-	}
-
-	z_ready_thread(thread);
-
 	return 0;
 }
 
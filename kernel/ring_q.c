@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free ring queues.
+ *
+ * Each slot carries a sequence word next to the message.  A slot is
+ * free for position "pos" when its sequence equals the lap base of
+ * pos (pos with the index bits cleared) and holds the message for pos
+ * when it equals that plus one; the consumer then advances it to the
+ * base of the next lap.  Comparing against a per-slot sequence rather
+ * than against the other side's index lets several producers claim
+ * positions with a CAS on the head and fill their slots in any order,
+ * and keeps an all-zero buffer a valid empty queue.
+ *
+ * The lock and wait queues are only touched by callers that have to
+ * block, and by the other side when the waiters count says someone
+ * may be waiting.  A blocking caller bumps the count before checking
+ * the queue one last time, and the other side reads it only after
+ * publishing its slot, so one of them always sees the other.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <string.h>
+#include <sys/__assert.h>
+
+struct ringq_slot {
+	atomic_t seq;
+	char data[];
+};
+
+static inline struct ringq_slot *slot_at(struct k_ringq *q, uint32_t pos)
+{
+	return (struct ringq_slot *)&q->buffer[(pos & q->mask) * q->stride];
+}
+
+/* Sequence value of a slot that is free for position pos */
+static inline uint32_t lap(struct k_ringq *q, uint32_t pos)
+{
+	return pos & ~q->mask;
+}
+
+static inline uint32_t slot_seq(struct ringq_slot *slot)
+{
+	return (uint32_t)atomic_get(&slot->seq);
+}
+
+void k_ringq_init(struct k_ringq *q, char *buffer, size_t msg_size,
+		  uint32_t max_msgs, uint32_t flags)
+{
+	__ASSERT((max_msgs >= 2) && ((max_msgs & (max_msgs - 1)) == 0),
+		 "ring queue size must be a power of two");
+	__ASSERT(((uintptr_t)buffer % sizeof(atomic_t)) == 0,
+		 "misaligned ring queue buffer");
+
+	q->head = ATOMIC_INIT(0);
+	q->tail = ATOMIC_INIT(0);
+	q->waiters = ATOMIC_INIT(0);
+	q->mask = max_msgs - 1;
+	q->msg_size = msg_size;
+	q->stride = Z_RINGQ_STRIDE(msg_size);
+	q->buffer = buffer;
+	q->flags = flags;
+	q->lock = (struct k_spinlock) {};
+	z_waitq_init(&q->put_wait_q);
+	z_waitq_init(&q->get_wait_q);
+#ifdef CONFIG_POLL
+	sys_dlist_init(&q->poll_events);
+#endif
+
+	for (uint32_t i = 0; i < max_msgs; i++) {
+		atomic_clear(&slot_at(q, i)->seq);
+	}
+}
+
+static bool try_put(struct k_ringq *q, void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&q->head);
+	struct ringq_slot *slot;
+
+	while (true) {
+		int32_t diff;
+
+		slot = slot_at(q, pos);
+		diff = (int32_t)(slot_seq(slot) - lap(q, pos));
+
+		if (diff < 0) {
+			/* Still holds the message from the previous lap */
+			return false;
+		}
+
+		if (diff == 0) {
+			if ((q->flags & K_RINGQ_FLAG_MULTI_PRODUCER) == 0U) {
+				/* Nobody else writes it, and the slot
+				 * sequence store below orders it
+				 */
+				q->head = pos + 1;
+				break;
+			}
+			if (atomic_cas(&q->head, pos, pos + 1)) {
+				break;
+			}
+		}
+
+		/* Another producer claimed it first */
+		pos = (uint32_t)atomic_get(&q->head);
+	}
+
+	(void)memcpy(slot->data, data, q->msg_size);
+	atomic_set(&slot->seq, lap(q, pos) + 1);
+
+	return true;
+}
+
+static bool try_get(struct k_ringq *q, void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&q->tail);
+	struct ringq_slot *slot = slot_at(q, pos);
+
+	if (slot_seq(slot) != lap(q, pos) + 1) {
+		return false;
+	}
+
+	(void)memcpy(data, slot->data, q->msg_size);
+	/* Single consumer: the tail needs no atomic update */
+	q->tail = pos + 1;
+	atomic_set(&slot->seq, lap(q, pos) + q->mask + 1);
+
+	return true;
+}
+
+bool z_ringq_data_available(struct k_ringq *q)
+{
+	uint32_t pos = (uint32_t)atomic_get(&q->tail);
+
+	return slot_seq(slot_at(q, pos)) == lap(q, pos) + 1;
+}
+
+static int block_on(struct k_ringq *q, _wait_q_t *wait_q,
+		    bool (*op)(struct k_ringq *q, void *data), void *data,
+		    k_timeout_t timeout)
+{
+	int64_t now, end = z_timeout_end_calc(timeout);
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
+	int ret = 0;
+
+	atomic_inc(&q->waiters);
+
+	while (!op(q, data)) {
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			now = z_tick_get();
+			if ((end - now) <= 0) {
+				ret = -EAGAIN;
+				break;
+			}
+			timeout = K_TICKS(end - now);
+		}
+
+		(void) z_pend_curr(&q->lock, key, wait_q, timeout);
+		key = k_spin_lock(&q->lock);
+	}
+
+	atomic_dec(&q->waiters);
+	k_spin_unlock(&q->lock, key);
+
+	return ret;
+}
+
+static void wake(struct k_ringq *q, _wait_q_t *wait_q, bool data_available)
+{
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
+	struct k_thread *thread;
+
+	thread = z_unpend_first_thread(wait_q);
+	if (thread != NULL) {
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+	}
+
+#ifdef CONFIG_POLL
+	if (data_available) {
+		z_handle_obj_poll_events(&q->poll_events,
+					 K_POLL_STATE_RINGQ_DATA_AVAILABLE);
+	}
+#else
+	ARG_UNUSED(data_available);
+#endif
+
+	z_reschedule(&q->lock, key);
+}
+
+int k_ringq_put(struct k_ringq *q, const void *data, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	/* try_put() only reads from data, it is shared with try_get()
+	 * through block_on()
+	 */
+	if (!try_put(q, (void *)data)) {
+		int ret;
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMSG;
+		}
+
+		ret = block_on(q, &q->put_wait_q, try_put, (void *)data,
+			       timeout);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (atomic_get(&q->waiters) != 0) {
+		wake(q, &q->get_wait_q, true);
+	}
+
+	return 0;
+}
+
+int k_ringq_get(struct k_ringq *q, void *data, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	if (!try_get(q, data)) {
+		int ret;
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMSG;
+		}
+
+		ret = block_on(q, &q->get_wait_q, try_get, data, timeout);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (atomic_get(&q->waiters) != 0) {
+		wake(q, &q->put_wait_q, false);
+	}
+
+	return 0;
+}
@@ -16,6 +16,7 @@
 #include <kernel_internal.h>
 #include <logging/log.h>
 #include <sys/atomic.h>
+#include <sys/math_extras.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
 /* Maximum time between the time a self-aborting thread flags itself
@@ -47,6 +48,10 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 #define z_priq_wait_add		z_priq_rb_add
 #define _priq_wait_remove	z_priq_rb_remove
 #define _priq_wait_best		z_priq_rb_best
+#elif defined(CONFIG_WAITQ_MULTIQ)
+#define z_priq_wait_add		z_priq_mq_add
+#define _priq_wait_remove	z_priq_mq_remove
+#define _priq_wait_best		z_priq_mq_best
 #elif defined(CONFIG_WAITQ_DUMB)
 #define z_priq_wait_add		z_priq_dumb_add
 #define _priq_wait_remove	z_priq_dumb_remove
@@ -59,6 +64,7 @@ struct z_kernel _kernel;
 static struct k_spinlock sched_spinlock;
 
 static void update_cache(int);
+static bool set_prio_locked(struct k_thread *thread, int prio);
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -181,6 +187,171 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+static ALWAYS_INLINE bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+	return &_kernel.cpus[thread->base.runq_cpu].ready_q.runq;
+}
+
+static ALWAYS_INLINE void *curr_cpu_runq(void)
+{
+	return &_current_cpu->ready_q.runq;
+}
+
+/* Pick the CPU whose queue a newly runnable thread goes to.  Scanning
+ * starts at the CPU it last ran on (so in the absence of anything
+ * better it stays cache-warm there), takes the first idle CPU found,
+ * and otherwise the CPU running the lowest priority thread that this
+ * one would preempt.  CPUs which have not started yet are skipped.
+ */
+static int runq_select_cpu(struct k_thread *thread)
+{
+	int ret = -1;
+	struct k_thread *victim = NULL;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		int cpu = (thread->base.cpu + i) % CONFIG_MP_NUM_CPUS;
+		struct k_thread *curr = _kernel.cpus[cpu].current;
+
+		if (curr == NULL || !cpu_allowed(thread, cpu)) {
+			continue;
+		}
+
+		if (z_is_idle_thread_object(curr)) {
+			return cpu;
+		}
+
+		if (ret < 0) {
+			ret = cpu;
+		}
+
+		if (z_is_t1_higher_prio_than_t2(thread, curr) &&
+		    (victim == NULL ||
+		     z_is_t1_higher_prio_than_t2(victim, curr))) {
+			victim = curr;
+			ret = cpu;
+		}
+	}
+
+	if (ret < 0) {
+		ret = _current_cpu->id;
+		for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+			if (cpu_allowed(thread, cpu)) {
+				ret = cpu;
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* Best thread of a remote queue that this CPU may run.  The head of
+ * that queue can be pinned to its own CPU while migratable threads
+ * wait behind it, so in that case the queue is walked in priority
+ * order for the first one allowed here.  The dumb backend's best
+ * already skips threads masked off the current CPU.
+ */
+static struct k_thread *runq_remote_best(void *pq)
+{
+	struct k_thread *thread = _priq_run_best(pq);
+
+#if defined(CONFIG_SCHED_CPU_MASK) && !defined(CONFIG_SCHED_DUMB)
+	if (thread == NULL || cpu_allowed(thread, _current_cpu->id)) {
+		return thread;
+	}
+
+# if defined(CONFIG_SCHED_SCALABLE)
+	RB_FOR_EACH_CONTAINER(&((struct _priq_rb *)pq)->tree, thread,
+			      base.qnode_rb) {
+		if (cpu_allowed(thread, _current_cpu->id)) {
+			break;
+		}
+	}
+# elif defined(CONFIG_SCHED_MULTIQ)
+	do {
+		thread = z_priq_mq_next(pq, thread);
+	} while (thread != NULL && !cpu_allowed(thread, _current_cpu->id));
+# endif
+#endif
+	return thread;
+}
+
+/* Work stealing: returns the best thread runnable on this CPU across
+ * all the queues, given the best one from the local queue.  Remote
+ * threads are only taken when they strictly outrank the local
+ * choice, so equal priority work stays where it was placed.
+ */
+static struct k_thread *runq_steal(struct k_thread *best)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+		struct k_thread *thread;
+
+		if (cpu == _current_cpu) {
+			continue;
+		}
+
+		thread = runq_remote_best(&cpu->ready_q.runq);
+		if (thread == NULL) {
+			continue;
+		}
+
+		if (best == NULL || z_is_t1_higher_prio_than_t2(thread, best)) {
+			best = thread;
+		}
+	}
+
+	return best;
+}
+#else
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+
+	return &_kernel.ready_q.runq;
+}
+
+static ALWAYS_INLINE void *curr_cpu_runq(void)
+{
+	return &_kernel.ready_q.runq;
+}
+#endif
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread->base.runq_cpu = runq_select_cpu(thread);
+#endif
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	struct k_thread *thread = _priq_run_best(curr_cpu_runq());
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread = runq_steal(thread);
+#endif
+	return thread;
+}
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
@@ -192,7 +363,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 		return _current_cpu->idle_thread;
 	}
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -262,13 +433,13 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
 
@@ -279,16 +450,21 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
-	_priq_run_add(&_kernel.ready_q.runq, thread);
+	runq_add(thread);
 	z_mark_thread_as_queued(thread);
 	update_cache(thread == _current);
 }
 
 #ifdef CONFIG_TIMESLICING
 
-static int slice_time;
+/* Time slices are accounted in cycles rather than ticks, so that a
+ * slice lasts as long as asked however low the tick rate: the timer
+ * is only used to get back here once the slice (or budget) should
+ * have run out, and z_time_slice() checks with the cycle count.
+ */
+static uint32_t slice_time;
 static int slice_max_prio;
 
 #ifdef CONFIG_SWAP_NONATOMIC
@@ -300,36 +476,234 @@ static int slice_max_prio;
 static struct k_thread *pending_current;
 #endif
 
-void z_reset_time_slice(void)
+static inline bool sliceable(struct k_thread *thread)
+{
+	bool ret = is_preempt(thread)
+		&& !z_is_thread_prevented_from_running(thread)
+		&& !z_is_idle_thread_object(thread);
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	if (thread->base.slice_cycles != 0U) {
+		return ret;
+	}
+#endif
+
+	return ret && (slice_time != 0U)
+		&& !z_is_prio_higher(thread->base.prio, slice_max_prio);
+}
+
+static uint32_t thread_slice(struct k_thread *thread)
+{
+	if (!sliceable(thread)) {
+		return 0;
+	}
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	if (thread->base.slice_cycles != 0U) {
+		return thread->base.slice_cycles;
+	}
+#endif
+	return slice_time;
+}
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+/* Charges _current for the CPU time since it was last charged.  Only
+ * the CPU running a thread updates its budget_used.
+ */
+static void charge_current(uint32_t now)
+{
+	_current->base.budget_used += now - _current_cpu->charge_start;
+	_current_cpu->charge_start = now;
+}
+
+/* Cycles left in the CPU budget of a thread, UINT32_MAX if it has
+ * none to run out of
+ */
+static uint32_t budget_left(struct k_thread *thread)
+{
+	uint32_t used = thread->base.budget_used - thread->base.budget_base;
+
+	if ((thread->base.budget_cycles == 0U) ||
+	    thread->base.budget_throttled ||
+	    z_is_idle_thread_object(thread)) {
+		return UINT32_MAX;
+	}
+	return (used < thread->base.budget_cycles)
+		? (thread->base.budget_cycles - used) : 0;
+}
+
+static void budget_throttle(struct k_thread *thread)
+{
+	thread->base.budget_prio = thread->base.prio;
+	thread->base.budget_throttled = true;
+	(void)set_prio_locked(thread, thread->base.budget_low_prio);
+}
+
+static void budget_unthrottle(struct k_thread *thread)
+{
+	thread->base.budget_throttled = false;
+	if (thread->base.prio == thread->base.budget_low_prio) {
+		(void)set_prio_locked(thread, thread->base.budget_prio);
+	}
+}
+#endif
+
+/* Arms the timer for the end of the time slice or CPU budget of
+ * curr, whichever comes first
+ */
+static void slice_arm(struct k_thread *curr, uint32_t now)
 {
+	uint32_t left = UINT32_MAX;
+	uint32_t used = now - _current_cpu->slice_start;
+
+	if (_current_cpu->slice_cycles != 0U) {
+		left = (used < _current_cpu->slice_cycles)
+			? (_current_cpu->slice_cycles - used) : 0;
+	}
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	left = MIN(left, budget_left(curr));
+#else
+	ARG_UNUSED(curr);
+#endif
+
+	if (left == UINT32_MAX) {
+		_current_cpu->slice_ticks = 0;
+		return;
+	}
+
 	/* Add the elapsed time since the last announced tick to the
 	 * slice count, as we'll see those "expired" ticks arrive in a
 	 * FUTURE z_time_slice() call.
 	 */
-	if (slice_time != 0) {
-		_current_cpu->slice_ticks = slice_time + z_clock_elapsed();
-		z_set_timeout_expiry(slice_time, false);
+	int32_t ticks = MAX(1, (int32_t)k_cyc_to_ticks_ceil32(left));
+
+	_current_cpu->slice_ticks = ticks + z_clock_elapsed();
+	z_set_timeout_expiry(ticks, false);
+}
+
+/* Starts a new time slice for curr, about to run on this CPU */
+void z_reset_time_slice(struct k_thread *curr)
+{
+	if (!IS_ENABLED(CONFIG_TIMESLICE_PER_THREAD) && (slice_time == 0U)) {
+		_current_cpu->slice_cycles = 0U;
+		_current_cpu->slice_ticks = 0;
+		return;
+	}
+
+	uint32_t now = k_cycle_get_32();
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	charge_current(now);
+#endif
+	_current_cpu->slice_start = now;
+	_current_cpu->slice_cycles = thread_slice(curr);
+	slice_arm(curr, now);
+}
+
+/* Picks up a change in whether curr, running on this CPU, can be
+ * sliced (e.g. it unlocked the scheduler or got a new priority).  Its
+ * slice keeps its start, so one that ran out meanwhile ends at the
+ * next tick.
+ */
+static void slice_update(struct k_thread *curr)
+{
+	uint32_t slice = thread_slice(curr);
+
+	if (slice != _current_cpu->slice_cycles) {
+		_current_cpu->slice_cycles = slice;
+		slice_arm(curr, k_cycle_get_32());
 	}
 }
 
 void k_sched_time_slice_set(int32_t slice, int prio)
 {
 	LOCKED(&sched_spinlock) {
-		_current_cpu->slice_ticks = 0;
-		slice_time = k_ms_to_ticks_ceil32(slice);
+		slice_time = k_ms_to_cyc_ceil32(slice);
 		slice_max_prio = prio;
-		z_reset_time_slice();
+		z_reset_time_slice(_current);
 	}
 }
 
-static inline int sliceable(struct k_thread *thread)
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+void k_thread_time_slice_set(k_tid_t thread, int32_t slice)
 {
-	return is_preempt(thread)
-		&& !z_is_thread_prevented_from_running(thread)
-		&& !z_is_prio_higher(thread->base.prio, slice_max_prio)
-		&& !z_is_idle_thread_object(thread);
+	__ASSERT((slice >= 0) && (k_ms_to_cyc_ceil64(slice) <= UINT32_MAX),
+		 "time slice out of range");
+
+	LOCKED(&sched_spinlock) {
+		thread->base.slice_cycles = k_ms_to_cyc_ceil32(slice);
+		if (thread == _current) {
+			z_reset_time_slice(thread);
+		}
+	}
 }
 
+static void budget_replenish(struct _timeout *t)
+{
+	struct k_thread *thread = CONTAINER_OF(t, struct k_thread,
+					       base.budget_timeout);
+
+	LOCKED(&sched_spinlock) {
+		/* Unless k_thread_cpu_budget_set() got in first and has
+		 * already set up the next period (or dropped the budget)
+		 */
+		if (z_is_inactive_timeout(t) &&
+		    (thread->base.budget_cycles != 0U)) {
+			thread->base.budget_base = thread->base.budget_used;
+			if (thread->base.budget_throttled) {
+				budget_unthrottle(thread);
+			}
+			if (thread == _current) {
+				slice_arm(thread, k_cycle_get_32());
+			}
+			z_add_timeout(t, budget_replenish,
+				      K_TICKS(k_cyc_to_ticks_ceil32(
+						      thread->base.budget_period)));
+		}
+	}
+}
+
+void k_thread_cpu_budget_set(k_tid_t thread, int32_t budget,
+			     int32_t period, int low_prio)
+{
+	__ASSERT((budget == 0) || ((budget > 0) && (period >= budget)),
+		 "budget out of range or longer than its period");
+	__ASSERT((budget == 0) ||
+		 (is_preempt(thread) && (low_prio >= 0) &&
+		  (low_prio <= K_LOWEST_APPLICATION_THREAD_PRIO)),
+		 "budgets need preemptible priorities");
+
+	/* The CPU time used in a period is counted in 32-bit cycles */
+	__ASSERT((budget == 0) || (k_ms_to_cyc_ceil64(period) <= INT32_MAX),
+		 "period too long");
+
+	uint32_t budget_cycles = k_ms_to_cyc_ceil32(budget);
+	uint32_t period_cycles = k_ms_to_cyc_ceil32(period);
+
+	LOCKED(&sched_spinlock) {
+		(void)z_abort_timeout(&thread->base.budget_timeout);
+		if (thread->base.budget_throttled) {
+			budget_unthrottle(thread);
+		}
+		thread->base.budget_cycles = budget_cycles;
+		thread->base.budget_period = period_cycles;
+		thread->base.budget_low_prio = low_prio;
+		thread->base.budget_base = thread->base.budget_used;
+
+		if (budget_cycles != 0U) {
+			z_add_timeout(&thread->base.budget_timeout,
+				      budget_replenish,
+				      K_TICKS(k_cyc_to_ticks_ceil32(
+						      period_cycles)));
+		}
+		if (thread == _current) {
+			z_reset_time_slice(thread);
+		}
+	}
+}
+#endif
+
 /* Called out of each timer interrupt */
 void z_time_slice(int ticks)
 {
@@ -341,25 +715,49 @@ void z_time_slice(int ticks)
 	 * normally run with IRQs enabled.
 	 */
 	k_spinlock_key_t key = k_spin_lock(&sched_spinlock);
+	uint32_t now;
+
+	ARG_UNUSED(ticks);
 
 #ifdef CONFIG_SWAP_NONATOMIC
 	if (pending_current == _current) {
-		z_reset_time_slice();
+		z_reset_time_slice(_current);
 		k_spin_unlock(&sched_spinlock, key);
 		return;
 	}
 	pending_current = NULL;
 #endif
 
-	if (slice_time && sliceable(_current)) {
-		if (ticks >= _current_cpu->slice_ticks) {
-			move_thread_to_end_of_prio_q(_current);
-			z_reset_time_slice();
-		} else {
-			_current_cpu->slice_ticks -= ticks;
-		}
+	if (!IS_ENABLED(CONFIG_TIMESLICE_PER_THREAD) && (slice_time == 0U)) {
+		k_spin_unlock(&sched_spinlock, key);
+		return;
+	}
+
+	now = k_cycle_get_32();
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	charge_current(now);
+	if ((budget_left(_current) == 0U) && is_preempt(_current) &&
+	    !z_is_thread_prevented_from_running(_current)) {
+		budget_throttle(_current);
+		z_reset_time_slice(_current);
+		k_spin_unlock(&sched_spinlock, key);
+		return;
+	}
+#endif
+
+	/* A thread that can't be sliced right now (e.g. it locked the
+	 * scheduler) isn't timed until slice_update() sees it can be
+	 */
+	_current_cpu->slice_cycles = thread_slice(_current);
+
+	if ((_current_cpu->slice_cycles != 0U) &&
+	    ((now - _current_cpu->slice_start) >=
+	     _current_cpu->slice_cycles)) {
+		move_thread_to_end_of_prio_q(_current);
+		z_reset_time_slice(_current);
 	} else {
-		_current_cpu->slice_ticks = 0;
+		slice_arm(_current, now);
 	}
 	k_spin_unlock(&sched_spinlock, key);
 }
@@ -391,7 +789,7 @@ static void update_cache(int preempt_ok)
 	if (should_preempt(thread, preempt_ok)) {
 #ifdef CONFIG_TIMESLICING
 		if (thread != _current) {
-			z_reset_time_slice();
+			z_reset_time_slice(thread);
 		}
 #endif
 		update_metairq_preempt(thread);
@@ -411,7 +809,11 @@ static void update_cache(int preempt_ok)
 #endif
 }
 
-static void ready_thread(struct k_thread *thread)
+/* Adds a thread to the run queue without updating the cache or
+ * signaling other CPUs, so that several threads can be readied for
+ * the price of one of each.  Returns true if the thread was queued.
+ */
+static bool queue_thread(struct k_thread *thread)
 {
 #ifdef CONFIG_KERNEL_COHERENCE
 	__ASSERT_NO_MSG(arch_mem_coherent(thread));
@@ -422,12 +824,26 @@ static void ready_thread(struct k_thread *thread)
 	 */
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
-		update_cache(0);
+		return true;
+	}
+	return false;
+}
+
+/* Publishes run queue additions made with queue_thread() */
+static void ready_threads_queued(void)
+{
+	update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
-		arch_sched_ipi();
+	arch_sched_ipi();
 #endif
+}
+
+static void ready_thread(struct k_thread *thread)
+{
+	if (queue_thread(thread)) {
+		ready_threads_queued();
 	}
 }
 
@@ -465,7 +881,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -541,6 +957,9 @@ void z_thread_single_abort(struct k_thread *thread)
 	k_spin_unlock(&sched_spinlock, key);
 
 	(void)z_abort_thread_timeout(thread);
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	(void)z_abort_timeout(&thread->base.budget_timeout);
+#endif
 
 	if (IS_ENABLED(CONFIG_SMP)) {
 		z_sched_abort(thread);
@@ -552,8 +971,7 @@ void z_thread_single_abort(struct k_thread *thread)
 
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -637,7 +1055,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -783,6 +1201,47 @@ void z_unpend_thread(struct k_thread *thread)
 	(void)z_abort_thread_timeout(thread);
 }
 
+/* Sets the priority of a thread and moves it in whatever queue it is
+ * on, with sched_spinlock held.  Returns true if a reschedule is
+ * needed later.
+ */
+static bool set_prio_locked(struct k_thread *thread, int prio)
+{
+	bool need_sched = z_is_thread_ready(thread);
+
+	if (need_sched) {
+		/* Don't requeue on SMP if it's the running thread */
+		if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
+			runq_remove(thread);
+			thread->base.prio = prio;
+			runq_add(thread);
+		} else {
+			thread->base.prio = prio;
+		}
+		update_cache(1);
+#ifdef CONFIG_TIMESLICING
+		if (thread == _current) {
+			slice_update(thread);
+		}
+#endif
+	} else {
+#ifdef CONFIG_WAITQ_MULTIQ
+		/* Wait queues file threads by priority level, so move
+		 * it to its new one
+		 */
+		if (z_is_thread_pending(thread) &&
+		    (thread->base.pended_on != NULL)) {
+			_priq_wait_remove(&pended_on(thread)->waitq, thread);
+			thread->base.prio = prio;
+			z_priq_wait_add(&pended_on(thread)->waitq, thread);
+		}
+#endif
+		thread->base.prio = prio;
+	}
+
+	return need_sched;
+}
+
 /* Priority set utility that does no rescheduling, it just changes the
  * run queue state, returning true if a reschedule is needed later.
  */
@@ -791,21 +1250,7 @@ bool z_set_prio(struct k_thread *thread, int prio)
 	bool need_sched = 0;
 
 	LOCKED(&sched_spinlock) {
-		need_sched = z_is_thread_ready(thread);
-
-		if (need_sched) {
-			/* Don't requeue on SMP if it's the running thread */
-			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
-				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
-			} else {
-				thread->base.prio = prio;
-			}
-			update_cache(1);
-		} else {
-			thread->base.prio = prio;
-		}
+		need_sched = set_prio_locked(thread, prio);
 	}
 	sys_trace_thread_priority_set(thread);
 
@@ -886,6 +1331,9 @@ void k_sched_unlock(void)
 
 		++_current->base.sched_locked;
 		update_cache(0);
+#ifdef CONFIG_TIMESLICING
+		slice_update(_current);
+#endif
 	}
 
 	LOG_DBG("scheduler unlocked (%p:%d)",
@@ -933,9 +1381,10 @@ void *z_get_next_switch_handle(void *interrupted)
 			arch_cohere_stacks(old_thread, interrupted, new_thread);
 
 #ifdef CONFIG_TIMESLICING
-			z_reset_time_slice();
+			z_reset_time_slice(new_thread);
 #endif
 			_current_cpu->swap_ok = 0;
+			new_thread->base.cpu = _current_cpu->id;
 			set_current(new_thread);
 
 #ifdef CONFIG_SPIN_VALIDATE
@@ -1067,18 +1516,40 @@ struct k_thread *z_priq_rb_best(struct _priq_rb *pq)
 	return thread;
 }
 
-#ifdef CONFIG_SCHED_MULTIQ
-# if (K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO) > 31
-# error Too many priorities for multiqueue scheduler (max 32)
-# endif
-#endif
+BUILD_ASSERT((K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO) < Z_PRIQ_MQ_LEVELS,
+	     "multiqueue has too few priority levels");
+
+static ALWAYS_INLINE int priq_mq_level(struct k_thread *thread)
+{
+	return thread->base.prio - K_HIGHEST_THREAD_PRIO;
+}
+
+/* Bit of a level (or of a bitmap word in the summary), from the MSB */
+static ALWAYS_INLINE uint32_t priq_mq_bit(int n)
+{
+	return BIT(31 - (n & 31));
+}
+
+static ALWAYS_INLINE struct k_thread *priq_mq_head(struct _priq_mq *pq,
+						   int level)
+{
+	sys_dnode_t *n = sys_dlist_peek_head(&pq->queues[level]);
+
+	return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+}
 
 ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread)
 {
-	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	int level = priq_mq_level(thread);
+	int word = level / 32;
 
-	sys_dlist_append(&pq->queues[priority_bit], &thread->base.qnode_dlist);
-	pq->bitmask |= BIT(priority_bit);
+	/* Lists of empty levels are not kept initialized */
+	if ((pq->bitmap[word] & priq_mq_bit(level)) == 0U) {
+		sys_dlist_init(&pq->queues[level]);
+		pq->bitmap[word] |= priq_mq_bit(level);
+		pq->summary |= priq_mq_bit(word);
+	}
+	sys_dlist_append(&pq->queues[level], &thread->base.qnode_dlist);
 }
 
 ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread)
@@ -1089,52 +1560,147 @@ ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread
 		return;
 	}
 #endif
-	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	int level = priq_mq_level(thread);
+	int word = level / 32;
 
 	sys_dlist_remove(&thread->base.qnode_dlist);
-	if (sys_dlist_is_empty(&pq->queues[priority_bit])) {
-		pq->bitmask &= ~BIT(priority_bit);
+	if (sys_dlist_is_empty(&pq->queues[level])) {
+		pq->bitmap[word] &= ~priq_mq_bit(level);
+		if (pq->bitmap[word] == 0U) {
+			pq->summary &= ~priq_mq_bit(word);
+		}
 	}
 }
 
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 {
-	if (!pq->bitmask) {
+	if (!pq->summary) {
 		return NULL;
 	}
 
-	struct k_thread *thread = NULL;
-	sys_dlist_t *l = &pq->queues[__builtin_ctz(pq->bitmask)];
-	sys_dnode_t *n = sys_dlist_peek_head(l);
+	int word = u32_count_leading_zeros(pq->summary);
+
+	return priq_mq_head(pq, word * 32 +
+			    u32_count_leading_zeros(pq->bitmap[word]));
+}
+
+/* Next thread after thread in priority order, for _WAIT_Q_FOR_EACH() */
+struct k_thread *z_priq_mq_next(struct _priq_mq *pq, struct k_thread *thread)
+{
+	int level = priq_mq_level(thread);
+	int word = level / 32;
+	sys_dnode_t *n = sys_dlist_peek_next(&pq->queues[level],
+					     &thread->base.qnode_dlist);
+	uint32_t mask;
 
 	if (n != NULL) {
-		thread = CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+		return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
 	}
-	return thread;
+
+	/* Lower priority levels are the lower bits, in this word and
+	 * then in the next non-empty one
+	 */
+	mask = pq->bitmap[word] & (priq_mq_bit(level) - 1U);
+	if (mask == 0U) {
+		uint32_t words = pq->summary & (priq_mq_bit(word) - 1U);
+
+		/* With a single word, there is no next one */
+		if ((Z_PRIQ_MQ_WORDS == 1) || (words == 0U)) {
+			return NULL;
+		}
+		word = u32_count_leading_zeros(words);
+		mask = pq->bitmap[word];
+	}
+
+	return priq_mq_head(pq, word * 32 + u32_count_leading_zeros(mask));
+}
+
+/* Unpends a thread and queues it to run, with the scheduler lock
+ * held.  Returns true if it needs ready_threads_queued().
+ */
+static bool wake_thread_locked(struct k_thread *thread, bool set_retval,
+			       int swap_retval, void *swap_data)
+{
+	unpend_thread_no_timeout(thread);
+	(void)z_abort_thread_timeout(thread);
+	if (set_retval) {
+		arch_thread_return_value_set(thread, swap_retval);
+		thread->base.swap_data = swap_data;
+	}
+	return queue_thread(thread);
+}
+
+/* Wakes every thread on the wait queue under a single hold of the
+ * scheduler lock, with one cache update and at most one IPI for the
+ * whole batch rather than one per thread.
+ */
+static int wake_all(_wait_q_t *wait_q, bool set_retval, int swap_retval,
+		    void *swap_data)
+{
+	struct k_thread *thread;
+	bool queued = false;
+	int woken = 0;
+
+	LOCKED(&sched_spinlock) {
+		while ((thread = _priq_wait_best(&wait_q->waitq)) != NULL) {
+			queued |= wake_thread_locked(thread, set_retval,
+						     swap_retval, swap_data);
+			woken++;
+		}
+		if (queued) {
+			ready_threads_queued();
+		}
+	}
+
+	return woken;
 }
 
 int z_unpend_all(_wait_q_t *wait_q)
 {
-	int need_sched = 0;
+	return (wake_all(wait_q, false, 0, NULL) != 0) ? 1 : 0;
+}
+
+int z_sched_wake_all(_wait_q_t *wait_q, int swap_retval, void *swap_data)
+{
+	return wake_all(wait_q, true, swap_retval, swap_data);
+}
+
+bool z_sched_wake(_wait_q_t *wait_q, int swap_retval, void *swap_data)
+{
 	struct k_thread *thread;
+	bool woken = false;
 
-	while ((thread = z_waitq_head(wait_q)) != NULL) {
-		z_unpend_thread(thread);
-		z_ready_thread(thread);
-		need_sched = 1;
+	LOCKED(&sched_spinlock) {
+		thread = _priq_wait_best(&wait_q->waitq);
+		if (thread != NULL) {
+			if (wake_thread_locked(thread, true, swap_retval,
+					       swap_data)) {
+				ready_threads_queued();
+			}
+			woken = true;
+		}
 	}
 
-	return need_sched;
+	return woken;
 }
 
-void z_sched_init(void)
+void z_sched_wake_thread(struct k_thread *thread, int swap_retval)
+{
+	LOCKED(&sched_spinlock) {
+		if (wake_thread_locked(thread, true, swap_retval, NULL)) {
+			ready_threads_queued();
+		}
+	}
+}
+
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1142,9 +1708,18 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	rq->runq = (struct _priq_mq) { 0 };
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1204,8 +1779,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
+			runq_add(thread);
 		}
 	}
 }
@@ -1234,10 +1809,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1411,7 +1985,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
@@ -822,6 +822,14 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 	/* swap_data does not need to be initialized */
 
 	z_init_thread_timeout(thread_base);
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+	thread_base->slice_cycles = 0U;
+	thread_base->budget_cycles = 0U;
+	thread_base->budget_used = 0U;
+	thread_base->budget_throttled = false;
+	z_init_timeout(&thread_base->budget_timeout);
+#endif
 }
 
 FUNC_NORETURN void k_thread_user_mode_enter(k_thread_entry_t entry,
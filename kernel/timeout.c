@@ -19,8 +19,6 @@
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -41,6 +39,63 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+
+/* Timeouts live in a red/black tree sorted by absolute expiration
+ * tick, which is what dticks holds in this mode (zero means
+ * inactive).  Ties are broken by insertion order so that timeouts
+ * expiring on the same tick still fire in the order they were added,
+ * exactly as with the sorted list.  The tree caches its earliest node,
+ * so the announce and next-expiry paths don't walk it.
+ */
+static bool timeout_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	struct _timeout *ta = CONTAINER_OF(a, struct _timeout, rbnode);
+	struct _timeout *tb = CONTAINER_OF(b, struct _timeout, rbnode);
+
+	if (ta->dticks != tb->dticks) {
+		return ta->dticks < tb->dticks;
+	}
+
+	return (int32_t)(ta->order_key - tb->order_key) < 0;
+}
+
+static struct rbtree timeout_tree = {
+	.lessthan_fn = timeout_lessthan,
+};
+
+static uint32_t next_order_key;
+
+static struct _timeout *first(void)
+{
+	struct rbnode *n = rb_get_min(&timeout_tree);
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, rbnode);
+}
+
+/* Ticks between curr_tick and the expiry of the timeout */
+static k_ticks_t timeout_dticks(const struct _timeout *t)
+{
+	return t->dticks - (k_ticks_t)curr_tick;
+}
+
+static void insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	to->dticks = (k_ticks_t)curr_tick + ticks;
+	to->order_key = next_order_key++;
+	rb_insert(&timeout_tree, &to->rbnode);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	rb_remove(&timeout_tree, &t->rbnode);
+	t->dticks = 0;
+}
+
+#else /* !CONFIG_TIMEOUT_QUEUE_SCALABLE */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -55,6 +110,33 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+/* Ticks between curr_tick and the expiry of the timeout.  The list
+ * stores deltas, so this is only valid for the first entry.
+ */
+static k_ticks_t timeout_dticks(const struct _timeout *t)
+{
+	return t->dticks;
+}
+
+static void insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -64,6 +146,8 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_SCALABLE */
+
 static int32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0U;
@@ -74,7 +158,7 @@ static int32_t next_timeout(void)
 	struct _timeout *to = first();
 	int32_t ticks_elapsed = elapsed();
 	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+		: CLAMP(timeout_dticks(to) - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -101,26 +185,12 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		ticks = Z_TICK_ABS(ticks) - (curr_tick + elapsed());
 	}
 
-	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	__ASSERT(z_is_inactive_timeout(to), "");
 	to->fn = fn;
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to, ticks + elapsed());
 
 		if (to == first()) {
 #if CONFIG_TIMESLICING
@@ -150,7 +220,7 @@ int z_abort_timeout(struct _timeout *to)
 	int ret = -EINVAL;
 
 	LOCKED(&timeout_lock) {
-		if (sys_dnode_is_linked(&to->node)) {
+		if (!z_is_inactive_timeout(to)) {
 			remove_timeout(to);
 			ret = 0;
 		}
@@ -168,12 +238,16 @@ static k_ticks_t timeout_rem(const struct _timeout *timeout)
 		return 0;
 	}
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	ticks = timeout_dticks(timeout);
+#else
 	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 		ticks += t->dticks;
 		if (timeout == t) {
 			break;
 		}
 	}
+#endif
 
 	return ticks - elapsed();
 }
@@ -244,13 +318,16 @@ void z_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL &&
+	       timeout_dticks(first()) <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = timeout_dticks(t);
 
 		curr_tick += dt;
 		announce_remaining -= dt;
+#ifndef CONFIG_TIMEOUT_QUEUE_SCALABLE
 		t->dticks = 0;
+#endif
 		remove_timeout(t);
 
 		k_spin_unlock(&timeout_lock, key);
@@ -258,9 +335,11 @@ void z_clock_announce(int32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
+#ifndef CONFIG_TIMEOUT_QUEUE_SCALABLE
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
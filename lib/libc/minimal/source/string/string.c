@@ -97,6 +97,7 @@ char *strrchr(const char *s, int c)
 	return match;
 }
 
+#ifndef CONFIG_MINIMAL_LIBC_STRING_FAST
 /**
  *
  * @brief Get string length
@@ -115,6 +116,7 @@ size_t strlen(const char *s)
 
 	return n;
 }
+#endif
 
 /**
  *
@@ -230,6 +232,9 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
 	return orig_dest;
 }
 
+/* See string_fast.c for the speed optimized versions of these */
+#ifndef CONFIG_MINIMAL_LIBC_STRING_FAST
+
 /**
  *
  * @brief Compare two memory areas
@@ -238,8 +243,8 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
  */
 int memcmp(const void *m1, const void *m2, size_t n)
 {
-	const char *c1 = m1;
-	const char *c2 = m2;
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
 
 	if (!n) {
 		return 0;
@@ -411,3 +416,4 @@ void *memchr(const void *s, int c, size_t n)
 
 	return NULL;
 }
+#endif /* CONFIG_MINIMAL_LIBC_STRING_FAST */
@@ -0,0 +1,475 @@
+/* string_fast.c - speed optimized memory and string routines */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * These replace the compact versions of string.c, see
+ * CONFIG_MINIMAL_LIBC_STRING_FAST.
+ *
+ * Word loops are unrolled.  When the source and the destination of a
+ * copy are misaligned with respect to each other, the source is still
+ * read a word at a time, every destination word being shifted together
+ * from two source words.  Aligned words never straddle a page or an MPU
+ * region, so reading a whole word is safe as long as it holds at least
+ * one byte of the buffer.
+ *
+ * Where the compiler targets 128-bit vectors (SSE2, NEON), which
+ * also means cheap unaligned accesses, bulk copies, fills and compares
+ * use GCC vector types instead, and short ones overlapping accesses.
+ */
+
+#define WSIZE sizeof(mem_word_t)
+#define WMASK (WSIZE - 1)
+#define WBITS (WSIZE * 8)
+
+typedef mem_word_t __attribute__((__may_alias__)) word_t;
+
+/* 0x0101...01 and 0x8080...80 */
+#define ONES ((mem_word_t)-1 / 0xff)
+#define HIGHS (ONES << 7)
+
+/* Non-zero if any byte of x is zero */
+#define HAS_ZERO(x) (((x) - ONES) & ~(x) & HIGHS)
+
+/* Word made of the bytes of lo from offset sh / 8 on, then of hi */
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MERGE(lo, hi, sh) (((lo) >> (sh)) | ((hi) << (WBITS - (sh))))
+#else
+#define MERGE(lo, hi, sh) (((lo) << (sh)) | ((hi) >> (WBITS - (sh))))
+#endif
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define VSIZE 16
+
+typedef uint8_t __attribute__((__vector_size__(VSIZE))) vec_raw_t;
+typedef vec_raw_t __attribute__((__aligned__(1), __may_alias__)) vec_t;
+typedef uint64_t __attribute__((__vector_size__(VSIZE))) vec64_t;
+typedef uint64_t __attribute__((__aligned__(1), __may_alias__)) u64_u_t;
+typedef uint32_t __attribute__((__aligned__(1), __may_alias__)) u32_u_t;
+#endif
+
+static inline void copy_bytes(unsigned char *d, const unsigned char *s,
+			      size_t n)
+{
+	while (n > 0) {
+		*(d++) = *(s++);
+		n--;
+	}
+}
+
+/**
+ *
+ * @brief Copy bytes in memory
+ *
+ * @return pointer to start of destination buffer
+ */
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	unsigned char *d_byte = d;
+	const unsigned char *s_byte = s;
+
+#ifdef VSIZE
+	if (n < VSIZE) {
+		/* First and last bytes, possibly the same ones */
+		if (n >= 8) {
+			uint64_t a = *(const u64_u_t *)s_byte;
+			uint64_t b = *(const u64_u_t *)(s_byte + n - 8);
+
+			*(u64_u_t *)d_byte = a;
+			*(u64_u_t *)(d_byte + n - 8) = b;
+		} else if (n >= 4) {
+			uint32_t a = *(const u32_u_t *)s_byte;
+			uint32_t b = *(const u32_u_t *)(s_byte + n - 4);
+
+			*(u32_u_t *)d_byte = a;
+			*(u32_u_t *)(d_byte + n - 4) = b;
+		} else {
+			copy_bytes(d_byte, s_byte, n);
+		}
+		return d;
+	}
+
+	for (; n >= 4 * VSIZE; n -= 4 * VSIZE) {
+		const vec_t *sv = (const vec_t *)s_byte;
+		vec_t *dv = (vec_t *)d_byte;
+		vec_raw_t v0 = sv[0], v1 = sv[1], v2 = sv[2], v3 = sv[3];
+
+		dv[0] = v0;
+		dv[1] = v1;
+		dv[2] = v2;
+		dv[3] = v3;
+		d_byte += 4 * VSIZE;
+		s_byte += 4 * VSIZE;
+	}
+
+	for (; n >= VSIZE; n -= VSIZE) {
+		*(vec_t *)d_byte = *(const vec_t *)s_byte;
+		d_byte += VSIZE;
+		s_byte += VSIZE;
+	}
+
+	/* The last block overlaps the ones already copied */
+	if (n > 0) {
+		*(vec_t *)(d_byte + n - VSIZE) =
+			*(const vec_t *)(s_byte + n - VSIZE);
+	}
+#else
+	if (n >= 2 * WSIZE) {
+		word_t *d_word;
+		size_t off;
+
+		/* do byte-sized copying until the destination is aligned */
+
+		while (((uintptr_t)d_byte) & WMASK) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		d_word = (word_t *)d_byte;
+		off = ((uintptr_t)s_byte) & WMASK;
+
+		if (off == 0) {
+			const word_t *s_word = (const word_t *)s_byte;
+
+			for (; n >= 4 * WSIZE; n -= 4 * WSIZE) {
+				d_word[0] = s_word[0];
+				d_word[1] = s_word[1];
+				d_word[2] = s_word[2];
+				d_word[3] = s_word[3];
+				d_word += 4;
+				s_word += 4;
+			}
+
+			for (; n >= WSIZE; n -= WSIZE) {
+				*(d_word++) = *(s_word++);
+			}
+
+			s_byte = (const unsigned char *)s_word;
+		} else {
+			/* Aligned source reads, shifted into place */
+			const word_t *s_word = (const word_t *)(s_byte - off);
+			unsigned int sh = off * 8;
+			mem_word_t lo = *(s_word++);
+
+			for (; n >= WSIZE; n -= WSIZE) {
+				mem_word_t hi = *(s_word++);
+
+				*(d_word++) = MERGE(lo, hi, sh);
+				lo = hi;
+			}
+
+			s_byte = (const unsigned char *)s_word - WSIZE + off;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	copy_bytes(d_byte, s_byte, n);
+#endif
+
+	return d;
+}
+
+/**
+ *
+ * @brief Copy bytes in memory with overlapping areas
+ *
+ * @return pointer to destination buffer <d>
+ */
+
+void *memmove(void *d, const void *s, size_t n)
+{
+	unsigned char *dest = d;
+	const unsigned char *src = s;
+	bool aligned = ((((uintptr_t)dest) ^ ((uintptr_t)src)) & WMASK) == 0;
+
+	if ((((uintptr_t)dest - (uintptr_t)src) >= n) &&
+	    (((uintptr_t)src - (uintptr_t)dest) >= n)) {
+		return memcpy(d, s, n);
+	}
+
+	if (dest < src) {
+		/* Copying forward, every block is read before it's written */
+#ifdef VSIZE
+		for (; n >= VSIZE; n -= VSIZE) {
+			*(vec_t *)dest = *(const vec_t *)src;
+			dest += VSIZE;
+			src += VSIZE;
+		}
+#endif
+		if (aligned) {
+			while ((n > 0) && (((uintptr_t)dest) & WMASK)) {
+				*(dest++) = *(src++);
+				n--;
+			}
+			for (; n >= WSIZE; n -= WSIZE) {
+				*(word_t *)dest = *(const word_t *)src;
+				dest += WSIZE;
+				src += WSIZE;
+			}
+		}
+		copy_bytes(dest, src, n);
+	} else {
+		/*
+		 * The <src> buffer overlaps with the start of the <dest> buffer.
+		 * Copy backwards to prevent the premature corruption of <src>.
+		 */
+		dest += n;
+		src += n;
+#ifdef VSIZE
+		for (; n >= VSIZE; n -= VSIZE) {
+			dest -= VSIZE;
+			src -= VSIZE;
+			*(vec_t *)dest = *(const vec_t *)src;
+		}
+#endif
+		if (aligned) {
+			while ((n > 0) && (((uintptr_t)dest) & WMASK)) {
+				*(--dest) = *(--src);
+				n--;
+			}
+			for (; n >= WSIZE; n -= WSIZE) {
+				dest -= WSIZE;
+				src -= WSIZE;
+				*(word_t *)dest = *(const word_t *)src;
+			}
+		}
+		while (n > 0) {
+			*(--dest) = *(--src);
+			n--;
+		}
+	}
+
+	return d;
+}
+
+/**
+ *
+ * @brief Set bytes in memory
+ *
+ * @return pointer to start of buffer
+ */
+
+void *memset(void *buf, int c, size_t n)
+{
+	unsigned char *d_byte = buf;
+	unsigned char c_byte = (unsigned char)c;
+
+#ifdef VSIZE
+	if (n >= VSIZE) {
+		vec_raw_t v = (vec_raw_t){ 0 } + c_byte;
+
+		for (; n >= 4 * VSIZE; n -= 4 * VSIZE) {
+			vec_t *dv = (vec_t *)d_byte;
+
+			dv[0] = v;
+			dv[1] = v;
+			dv[2] = v;
+			dv[3] = v;
+			d_byte += 4 * VSIZE;
+		}
+
+		for (; n >= VSIZE; n -= VSIZE) {
+			*(vec_t *)d_byte = v;
+			d_byte += VSIZE;
+		}
+
+		/* The last block overlaps the ones already set */
+		if (n > 0) {
+			*(vec_t *)(d_byte + n - VSIZE) = v;
+		}
+
+		return buf;
+	}
+
+	if (n >= 4) {
+		/* First and last bytes, possibly the same ones */
+		uint64_t c_word = 0x0101010101010101ULL * c_byte;
+
+		if (n >= 8) {
+			*(u64_u_t *)d_byte = c_word;
+			*(u64_u_t *)(d_byte + n - 8) = c_word;
+		} else {
+			*(u32_u_t *)d_byte = (uint32_t)c_word;
+			*(u32_u_t *)(d_byte + n - 4) = (uint32_t)c_word;
+		}
+		return buf;
+	}
+#endif
+
+	if (n >= 2 * WSIZE) {
+		mem_word_t c_word = ONES * c_byte;
+		word_t *d_word;
+
+		while (((uintptr_t)d_byte) & WMASK) {
+			*(d_byte++) = c_byte;
+			n--;
+		}
+
+		d_word = (word_t *)d_byte;
+
+		for (; n >= 4 * WSIZE; n -= 4 * WSIZE) {
+			d_word[0] = c_word;
+			d_word[1] = c_word;
+			d_word[2] = c_word;
+			d_word[3] = c_word;
+			d_word += 4;
+		}
+
+		for (; n >= WSIZE; n -= WSIZE) {
+			*(d_word++) = c_word;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = c_byte;
+		n--;
+	}
+
+	return buf;
+}
+
+/**
+ *
+ * @brief Compare two memory areas
+ *
+ * @return negative # if <m1> < <m2>, 0 if <m1> == <m2>, else positive #
+ */
+
+int memcmp(const void *m1, const void *m2, size_t n)
+{
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
+
+	/* Skip the equal blocks, the bytes tell which one is greater */
+#ifdef VSIZE
+	for (; n >= VSIZE; n -= VSIZE) {
+		vec64_t x = (vec64_t)(*(const vec_t *)c1 ^ *(const vec_t *)c2);
+
+		if ((x[0] | x[1]) != 0U) {
+			break;
+		}
+		c1 += VSIZE;
+		c2 += VSIZE;
+	}
+
+	if ((n >= 8) && (*(const u64_u_t *)c1 == *(const u64_u_t *)c2)) {
+		c1 += 8;
+		c2 += 8;
+		n -= 8;
+	}
+#else
+	if ((n >= 2 * WSIZE) &&
+	    (((((uintptr_t)c1) ^ ((uintptr_t)c2)) & WMASK) == 0)) {
+		while (((uintptr_t)c1) & WMASK) {
+			if (*c1 != *c2) {
+				return *c1 - *c2;
+			}
+			c1++;
+			c2++;
+			n--;
+		}
+
+		for (; n >= WSIZE; n -= WSIZE) {
+			if (*(const word_t *)c1 != *(const word_t *)c2) {
+				break;
+			}
+			c1 += WSIZE;
+			c2 += WSIZE;
+		}
+	}
+#endif
+
+	for (; n > 0; n--) {
+		if (*c1 != *c2) {
+			return *c1 - *c2;
+		}
+		c1++;
+		c2++;
+	}
+
+	return 0;
+}
+
+/**
+ *
+ * @brief Scan byte in memory
+ *
+ * @return pointer to start of found byte
+ */
+
+void *memchr(const void *s, int c, size_t n)
+{
+	const unsigned char *p = s;
+	unsigned char c_byte = (unsigned char)c;
+
+	if (n >= 2 * WSIZE) {
+		mem_word_t c_word = ONES * c_byte;
+
+		while (((uintptr_t)p) & WMASK) {
+			if (*p == c_byte) {
+				return (void *)p;
+			}
+			p++;
+			n--;
+		}
+
+		for (; n >= WSIZE; n -= WSIZE) {
+			mem_word_t x = *(const word_t *)p ^ c_word;
+
+			if (HAS_ZERO(x)) {
+				break;
+			}
+			p += WSIZE;
+		}
+	}
+
+	for (; n > 0; n--) {
+		if (*p == c_byte) {
+			return (void *)p;
+		}
+		p++;
+	}
+
+	return NULL;
+}
+
+/**
+ *
+ * @brief Get string length
+ *
+ * @return number of bytes in string <s>
+ */
+
+size_t strlen(const char *s)
+{
+	const char *p = s;
+	const word_t *w;
+
+	while (((uintptr_t)p) & WMASK) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
+	}
+
+	for (w = (const word_t *)p; !HAS_ZERO(*w); w++) {
+	}
+
+	for (p = (const char *)w; *p != '\0'; p++) {
+	}
+
+	return p - s;
+}
@@ -23,8 +23,11 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <sys/base64.h>
+#include <sys/util.h>
 
 static const uint8_t base64_enc_map[64] = {
 	'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J',
@@ -36,6 +39,9 @@ static const uint8_t base64_enc_map[64] = {
 	'8', '9', '+', '/'
 };
 
+/* 127 for invalid characters and 64 for the '=' padding: anything but
+ * a base64 digit has bit 6 set
+ */
 static const uint8_t base64_dec_map[128] = {
 	127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
 	127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
@@ -54,14 +60,45 @@ static const uint8_t base64_dec_map[128] = {
 
 #define BASE64_SIZE_T_MAX	((size_t) -1) /* SIZE_T_MAX is not standard */
 
+/* Encodes whole groups of 3 bytes into 4 characters */
+static void base64_encode_groups(uint8_t *dst, const uint8_t *src,
+				 size_t n_groups)
+{
+	for (; n_groups > 0; n_groups--) {
+		uint32_t x = ((uint32_t)src[0] << 16) |
+			     ((uint32_t)src[1] << 8) | src[2];
+
+		dst[0] = base64_enc_map[x >> 18];
+		dst[1] = base64_enc_map[(x >> 12) & 0x3F];
+		dst[2] = base64_enc_map[(x >> 6) & 0x3F];
+		dst[3] = base64_enc_map[x & 0x3F];
+		src += 3;
+		dst += 4;
+	}
+}
+
+/* Encodes the last 1 or 2 bytes, with padding */
+static void base64_encode_tail(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	uint32_t x = (uint32_t)src[0] << 16;
+
+	if (len > 1) {
+		x |= (uint32_t)src[1] << 8;
+	}
+
+	dst[0] = base64_enc_map[x >> 18];
+	dst[1] = base64_enc_map[(x >> 12) & 0x3F];
+	dst[2] = (len > 1) ? base64_enc_map[(x >> 6) & 0x3F] : '=';
+	dst[3] = '=';
+}
+
 /*
  * Encode a buffer into base64 format
  */
 int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		  size_t slen)
 {
-	size_t i, n;
-	int C1, C2, C3;
+	size_t n;
 	uint8_t *p;
 
 	if (slen == 0) {
@@ -83,41 +120,182 @@ int base64_encode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 		return -ENOMEM;
 	}
 
-	n = (slen / 3) * 3;
-
-	for (i = 0, p = dst; i < n; i += 3) {
-		C1 = *src++;
-		C2 = *src++;
-		C3 = *src++;
+	n = slen / 3;
+	base64_encode_groups(dst, src, n);
+	p = dst + 4 * n;
 
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 &  3) << 4) + (C2 >> 4)) & 0x3F];
-		*p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
-		*p++ = base64_enc_map[C3 & 0x3F];
+	if (slen % 3 != 0) {
+		base64_encode_tail(p, src + 3 * n, slen % 3);
+		p += 4;
 	}
 
-	if (i < slen) {
-		C1 = *src++;
-		C2 = ((i + 1) < slen) ? *src++ : 0;
+	*olen = p - dst;
+	*p = 0U;
 
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 & 3) << 4) + (C2 >> 4)) & 0x3F];
+	return 0;
+}
 
-		if ((i + 1) < slen) {
-			*p++ = base64_enc_map[((C2 & 15) << 2) & 0x3F];
-		} else {
-			*p++ = '=';
+size_t base64_encode_update(struct base64_encoder *enc, uint8_t *dst,
+			    size_t dlen, size_t *olen, const uint8_t *src,
+			    size_t slen)
+{
+	const uint8_t *s = src;
+	uint8_t *p = dst;
+	size_t n;
+
+	/* Complete the group started by the previous call */
+	if (enc->n_pending > 0) {
+		uint8_t group[3];
+
+		if (enc->n_pending + slen < 3) {
+			memcpy(&enc->pending[enc->n_pending], s, slen);
+			enc->n_pending += slen;
+			*olen = 0;
+			return slen;
 		}
 
-		*p++ = '=';
+		if (dlen < 4) {
+			*olen = 0;
+			return 0;
+		}
+
+		n = 3 - enc->n_pending;
+		memcpy(group, enc->pending, enc->n_pending);
+		memcpy(&group[enc->n_pending], s, n);
+		base64_encode_groups(p, group, 1);
+		enc->n_pending = 0;
+		s += n;
+		slen -= n;
+		p += 4;
+		dlen -= 4;
+	}
+
+	n = MIN(slen / 3, dlen / 4);
+	base64_encode_groups(p, s, n);
+	s += 3 * n;
+	slen -= 3 * n;
+	p += 4 * n;
+
+	/* Keep the last bytes for the next call, once all groups fit */
+	if (slen < 3) {
+		memcpy(enc->pending, s, slen);
+		enc->n_pending = slen;
+		s += slen;
 	}
 
 	*olen = p - dst;
-	*p = 0U;
+
+	return s - src;
+}
+
+int base64_encode_finish(struct base64_encoder *enc, uint8_t *dst,
+			 size_t dlen, size_t *olen)
+{
+	if (enc->n_pending == 0) {
+		*olen = 0;
+		return 0;
+	}
+
+	*olen = 4;
+
+	if (dst == NULL || dlen < 4) {
+		return -ENOMEM;
+	}
+
+	base64_encode_tail(dst, enc->pending, enc->n_pending);
+	enc->n_pending = 0;
 
 	return 0;
 }
 
+/* Value of a base64 digit, with bit 6 or 7 set for anything else */
+static inline uint32_t base64_dec_digit(uint8_t c)
+{
+	return base64_dec_map[c & 0x7F] | (c & 0x80);
+}
+
+/* Decodes whole groups of 4 characters into 3 bytes, failing on any
+ * padding, whitespace or invalid character
+ */
+static bool base64_decode_groups(uint8_t *dst, const uint8_t *src,
+				 size_t n_groups)
+{
+	for (; n_groups > 0; n_groups--) {
+		uint32_t a = base64_dec_digit(src[0]);
+		uint32_t b = base64_dec_digit(src[1]);
+		uint32_t c = base64_dec_digit(src[2]);
+		uint32_t d = base64_dec_digit(src[3]);
+		uint32_t x;
+
+		if (((a | b | c | d) & 0xC0) != 0U) {
+			return false;
+		}
+
+		x = (a << 18) | (b << 12) | (c << 6) | d;
+		dst[0] = (uint8_t)(x >> 16);
+		dst[1] = (uint8_t)(x >> 8);
+		dst[2] = (uint8_t)x;
+		src += 4;
+		dst += 3;
+	}
+
+	return true;
+}
+
+/* Decodes input made only of groups of 4 characters, the last one
+ * possibly padded, in a single pass.  Anything else, including
+ * invalid input, is left to the generic decoder.
+ */
+static bool base64_decode_fast(uint8_t *dst, size_t dlen, size_t *olen,
+			       const uint8_t *src, size_t slen)
+{
+	size_t n_groups = slen / 4;
+	size_t pad = 0;
+	size_t n;
+	uint8_t last[3];
+
+	if (slen == 0 || slen % 4 != 0 || dst == NULL) {
+		return false;
+	}
+
+	if (src[slen - 1] == '=') {
+		pad = (src[slen - 2] == '=') ? 2 : 1;
+	}
+
+	n = 3 * n_groups - pad;
+	if (dlen < n) {
+		return false;
+	}
+
+	if (pad == 0) {
+		if (!base64_decode_groups(dst, src, n_groups)) {
+			return false;
+		}
+	} else {
+		uint8_t group[4];
+
+		if (!base64_decode_groups(dst, src, n_groups - 1)) {
+			return false;
+		}
+
+		memcpy(group, &src[slen - 4], 4);
+		group[3] = 'A';
+		if (pad == 2) {
+			group[2] = 'A';
+		}
+
+		if (!base64_decode_groups(last, group, 1)) {
+			return false;
+		}
+
+		memcpy(&dst[n - (3 - pad)], last, 3 - pad);
+	}
+
+	*olen = n;
+
+	return true;
+}
+
 /*
  * Decode a base64-formatted buffer
  */
@@ -128,6 +306,10 @@ int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 	uint32_t j, x;
 	uint8_t *p;
 
+	if (base64_decode_fast(dst, dlen, olen, src, slen)) {
+		return 0;
+	}
+
 	/* First pass: check for validity and get output length */
 	for (i = n = j = 0U; i < slen; i++) {
 		/* Skip spaces before checking for EOL */
@@ -188,6 +370,13 @@ int base64_decode(uint8_t *dst, size_t dlen, size_t *olen, const uint8_t *src,
 	}
 
 	for (j = 3U, n = x = 0U, p = dst; i > 0; i--, src++) {
+		/* Whole groups, between line breaks */
+		if (n == 0U && i >= 4 && base64_decode_groups(p, src, 1)) {
+			p += 3;
+			src += 3;
+			i -= 3;
+			continue;
+		}
 
 		if (*src == '\r' || *src == '\n' || *src == ' ') {
 			continue;
@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <linker/linker-defs.h>
+#include <sys/cbprintf.h>
+#include <sys/util.h>
+
+/* A package is a header followed by the arguments, each at its natural
+ * alignment relative to the start of the package.  A %s argument is
+ * preceded by a tag byte telling whether it is a pointer or an inline
+ * copy of the string.  Rendering walks the format again, so nothing else
+ * needs to be recorded.
+ */
+struct package_hdr {
+	/* Total length of the package */
+	uint16_t len;
+	const char *fmt;
+};
+
+enum str_tag {
+	STR_PTR,
+	STR_INLINE,
+};
+
+/* Argument classes, after default argument promotions.  Integer types
+ * are classified by size: types of the same size travel identically
+ * through varargs.
+ */
+enum package_arg {
+	PKG_NONE,
+	PKG_INT,
+	PKG_LONG,
+	PKG_LONG_LONG,
+	PKG_PTR,
+	PKG_STR,
+	PKG_DOUBLE,
+	PKG_LONG_DOUBLE,
+};
+
+#define INT_CLASS(type) ((sizeof(type) <= sizeof(int)) ? PKG_INT :	\
+			 (sizeof(type) == sizeof(long)) ? PKG_LONG :	\
+			 PKG_LONG_LONG)
+
+struct package_conv {
+	/* After the conversion specifier */
+	const char *end;
+	bool width_star;
+	bool prec_star;
+	/* Explicit precision, or -1 */
+	int prec;
+	enum package_arg cls;
+};
+
+static bool is_rodata(const void *addr)
+{
+#if defined(ZTEST_UNITTEST)
+	const char *start = NULL;
+	const char *end = NULL;
+#elif defined(CONFIG_ARM) || defined(CONFIG_ARC) || defined(CONFIG_X86)
+	const char *start = _image_rodata_start;
+	const char *end = _image_rodata_end;
+#elif defined(CONFIG_NIOS2) || defined(CONFIG_RISCV) || defined(CONFIG_SPARC)
+	const char *start = _image_rom_start;
+	const char *end = _image_rom_end;
+#elif defined(CONFIG_XTENSA)
+	extern char _rodata_start[];
+	extern char _rodata_end[];
+	const char *start = _rodata_start;
+	const char *end = _rodata_end;
+#else
+	const char *start = NULL;
+	const char *end = NULL;
+#endif
+
+	return ((const char *)addr >= start) && ((const char *)addr < end);
+}
+
+/* Parses the conversion specification starting at sp, just after the %.
+ * Returns false if it cannot be packaged.
+ */
+static bool parse_package_conv(const char *sp, struct package_conv *conv)
+{
+	enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T,
+	       LEN_UPPER_L } length = LEN_NONE;
+
+	conv->width_star = false;
+	conv->prec_star = false;
+	conv->prec = -1;
+
+	/* Flags */
+	while (*sp != '\0' && strchr("-+ #0'", *sp) != NULL) {
+		sp++;
+	}
+
+	/* Width */
+	if (*sp == '*') {
+		conv->width_star = true;
+		sp++;
+	} else {
+		while (*sp >= '0' && *sp <= '9') {
+			sp++;
+		}
+	}
+
+	/* Precision */
+	if (*sp == '.') {
+		sp++;
+		if (*sp == '*') {
+			conv->prec_star = true;
+			sp++;
+		} else {
+			conv->prec = 0;
+			while (*sp >= '0' && *sp <= '9') {
+				conv->prec = conv->prec * 10 + (*sp - '0');
+				sp++;
+			}
+		}
+	}
+
+	/* Length */
+	switch (*sp) {
+	case 'h':
+		length = (sp[1] == 'h') ? LEN_HH : LEN_H;
+		break;
+	case 'l':
+		length = (sp[1] == 'l') ? LEN_LL : LEN_L;
+		break;
+	case 'j':
+		length = LEN_J;
+		break;
+	case 'z':
+		length = LEN_Z;
+		break;
+	case 't':
+		length = LEN_T;
+		break;
+	case 'L':
+		length = LEN_UPPER_L;
+		break;
+	}
+
+	if (length == LEN_HH || length == LEN_LL) {
+		sp += 2;
+	} else if (length != LEN_NONE) {
+		sp++;
+	}
+
+	switch (*sp) {
+	case '%':
+		conv->cls = PKG_NONE;
+		break;
+	case 'c':
+		conv->cls = PKG_INT;
+		break;
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		switch (length) {
+		case LEN_L:
+			conv->cls = PKG_LONG;
+			break;
+		case LEN_LL:
+			conv->cls = PKG_LONG_LONG;
+			break;
+		case LEN_J:
+			conv->cls = INT_CLASS(intmax_t);
+			break;
+		case LEN_Z:
+			conv->cls = INT_CLASS(size_t);
+			break;
+		case LEN_T:
+			conv->cls = INT_CLASS(ptrdiff_t);
+			break;
+		case LEN_UPPER_L:
+			return false;
+		default:
+			conv->cls = PKG_INT;
+		}
+		break;
+	case 's':
+		conv->cls = PKG_STR;
+		break;
+	case 'p':
+		conv->cls = PKG_PTR;
+		break;
+	case 'a':
+	case 'A':
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+		conv->cls = (length == LEN_UPPER_L) ? PKG_LONG_DOUBLE :
+						      PKG_DOUBLE;
+		break;
+	default:
+		/* Including %n, whose pointer would be written at render
+		 * time with the count of the renderer
+		 */
+		return false;
+	}
+
+	conv->end = sp + 1;
+
+	return true;
+}
+
+#define PACKAGE_VAL(type, val)						\
+	do {								\
+		type v_ = (val);					\
+									\
+		pos = ROUND_UP(pos, __alignof__(type));			\
+		if (buf != NULL) {					\
+			if (pos + sizeof(type) > len) {			\
+				return -ENOSPC;				\
+			}						\
+			*(type *)(buf + pos) = v_;			\
+		}							\
+		pos += sizeof(type);					\
+	} while (false)
+
+#define PACKAGE_ARG(type) PACKAGE_VAL(type, va_arg(ap, type))
+
+int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
+		      const char *format, va_list ap)
+{
+	uint8_t *buf = packaged;
+	size_t pos = sizeof(struct package_hdr);
+	const char *fp = format;
+	struct package_conv conv;
+
+	if (buf != NULL && len < pos) {
+		return -ENOSPC;
+	}
+
+	while (true) {
+		fp = strchr(fp, '%');
+		if (fp == NULL) {
+			break;
+		}
+
+		if (!parse_package_conv(fp + 1, &conv)) {
+			return -EINVAL;
+		}
+		fp = conv.end;
+
+		if (conv.width_star) {
+			PACKAGE_ARG(int);
+		}
+
+		if (conv.prec_star) {
+			int prec = va_arg(ap, int);
+
+			PACKAGE_VAL(int, prec);
+			/* A negative precision is taken as if omitted */
+			conv.prec = MAX(prec, -1);
+		}
+
+		switch (conv.cls) {
+		case PKG_NONE:
+			break;
+		case PKG_INT:
+			PACKAGE_ARG(int);
+			break;
+		case PKG_LONG:
+			PACKAGE_ARG(long);
+			break;
+		case PKG_LONG_LONG:
+			PACKAGE_ARG(long long);
+			break;
+		case PKG_PTR:
+			PACKAGE_ARG(void *);
+			break;
+		case PKG_STR: {
+			const char *str = va_arg(ap, const char *);
+			bool copy;
+
+			if (flags & CBPRINTF_PACKAGE_COPY_ALL_STR) {
+				copy = true;
+			} else if (flags & CBPRINTF_PACKAGE_COPY_NO_STR) {
+				copy = false;
+			} else {
+				copy = !is_rodata(str);
+			}
+
+			/* NULL is left to the formatter */
+			copy = copy && (str != NULL);
+
+			if (buf != NULL) {
+				if (pos >= len) {
+					return -ENOSPC;
+				}
+				buf[pos] = copy ? STR_INLINE : STR_PTR;
+			}
+			pos++;
+
+			if (copy) {
+				/* With a precision, the array need not be
+				 * terminated and only that much is printed
+				 */
+				size_t n = (conv.prec >= 0) ?
+					   strnlen(str, conv.prec) :
+					   strlen(str);
+
+				if (buf != NULL) {
+					if (pos + n + 1 > len) {
+						return -ENOSPC;
+					}
+					memcpy(buf + pos, str, n);
+					buf[pos + n] = '\0';
+				}
+				pos += n + 1;
+			} else {
+				pos = ROUND_UP(pos, __alignof__(char *));
+				if (buf != NULL) {
+					if (pos + sizeof(char *) > len) {
+						return -ENOSPC;
+					}
+					*(const char **)(buf + pos) = str;
+				}
+				pos += sizeof(char *);
+			}
+			break;
+		}
+#ifdef CONFIG_CBPRINTF_FP_SUPPORT
+		case PKG_DOUBLE:
+			PACKAGE_ARG(double);
+			break;
+		case PKG_LONG_DOUBLE:
+			PACKAGE_ARG(long double);
+			break;
+#endif
+		default:
+			return -ENOTSUP;
+		}
+	}
+
+	if (pos > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	if (buf != NULL) {
+		struct package_hdr *hdr = packaged;
+
+		hdr->len = (uint16_t)pos;
+		hdr->fmt = format;
+	}
+
+	return (int)pos;
+}
+
+int cbprintf_package(void *packaged, size_t len, uint32_t flags,
+		     const char *format, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, format);
+	rc = cbvprintf_package(packaged, len, flags, format, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+#define UNPACKAGE_ARG(type, var)					\
+	do {								\
+		pos = ROUND_UP(pos, __alignof__(type));			\
+		var = *(type const *)(buf + pos);			\
+		pos += sizeof(type);					\
+	} while (false)
+
+/* Appends the decimal representation of a star argument to the spec */
+static char *append_int(char *sp, int value)
+{
+	char digits[sizeof(int) * 3];
+	unsigned int mag = (value < 0) ? -(unsigned int)value : value;
+	int n = 0;
+
+	do {
+		digits[n++] = '0' + mag % 10U;
+		mag /= 10U;
+	} while (mag != 0U);
+
+	if (value < 0) {
+		*sp++ = '-';
+	}
+
+	while (n > 0) {
+		*sp++ = digits[--n];
+	}
+
+	return sp;
+}
+
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged)
+{
+	const uint8_t *buf = packaged;
+	const struct package_hdr *hdr = packaged;
+	size_t pos = sizeof(struct package_hdr);
+	const char *fp = hdr->fmt;
+	struct package_conv conv;
+	int count = 0;
+	int rc;
+
+	while (*fp != '\0') {
+		/* Room for any sensible specification, with resolved stars */
+		char spec[48];
+		const char *sp = fp + 1;
+		char *dp = spec;
+		int width = 0;
+		int prec = 0;
+
+		if (*fp != '%') {
+			rc = out((int)*fp++, ctx);
+			if (rc < 0) {
+				return rc;
+			}
+			count++;
+			continue;
+		}
+
+		/* Packaging succeeded, so this cannot fail */
+		(void)parse_package_conv(sp, &conv);
+
+		if (conv.width_star) {
+			UNPACKAGE_ARG(int, width);
+		}
+
+		if (conv.prec_star) {
+			UNPACKAGE_ARG(int, prec);
+		}
+
+		/* Copy the specification, resolving the stars: a negative
+		 * width is a - flag, a negative precision none at all.
+		 */
+		if ((conv.end - fp) + 2 * (sizeof(int) * 3) >= sizeof(spec)) {
+			return -EINVAL;
+		}
+
+		*dp++ = '%';
+		while (sp < conv.end) {
+			if (*sp == '*') {
+				dp = append_int(dp, width);
+				sp++;
+			} else if (*sp == '.' && conv.prec_star) {
+				if (prec >= 0) {
+					*dp++ = '.';
+					dp = append_int(dp, prec);
+				}
+				sp += 2;
+			} else {
+				*dp++ = *sp++;
+			}
+		}
+		*dp = '\0';
+		fp = conv.end;
+
+		switch (conv.cls) {
+		case PKG_NONE:
+			rc = out('%', ctx);
+			rc = (rc < 0) ? rc : 1;
+			break;
+		case PKG_INT: {
+			int v;
+
+			UNPACKAGE_ARG(int, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+		case PKG_LONG: {
+			long v;
+
+			UNPACKAGE_ARG(long, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+		case PKG_LONG_LONG: {
+			long long v;
+
+			UNPACKAGE_ARG(long long, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+		case PKG_PTR: {
+			void *v;
+
+			UNPACKAGE_ARG(void *, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+		case PKG_STR: {
+			const char *v;
+
+			if (buf[pos++] == STR_INLINE) {
+				v = (const char *)buf + pos;
+				pos += strlen(v) + 1;
+			} else {
+				UNPACKAGE_ARG(const char *, v);
+			}
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+#ifdef CONFIG_CBPRINTF_FP_SUPPORT
+		case PKG_DOUBLE: {
+			double v;
+
+			UNPACKAGE_ARG(double, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+		case PKG_LONG_DOUBLE: {
+			long double v;
+
+			UNPACKAGE_ARG(long double, v);
+			rc = cbprintf(out, ctx, spec, v);
+			break;
+		}
+#endif
+		default:
+			rc = -ENOTSUP;
+		}
+
+		if (rc < 0) {
+			return rc;
+		}
+		count += rc;
+	}
+
+	return count;
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/hashmap.h>
+#include <sys/__assert.h>
+#include <errno.h>
+#include <string.h>
+
+/* Size of the first allocated table */
+#define MIN_SLOTS 8U
+
+/* Number of slots of the previous table migrated per insert or removal
+ * while growing.  The new table has room for as many inserts as there
+ * are slots in the previous one: anything over one is enough for the
+ * previous table to be empty before the new one needs to grow.
+ */
+#define MIGRATE_STEP 8U
+
+/* Entries a table of n slots can hold: 7/8 of it, always leaving at
+ * least one empty slot so that probing ends.
+ */
+static inline uint32_t max_load(uint32_t n_slots)
+{
+	return n_slots - (n_slots + 7U) / 8U;
+}
+
+static inline uint32_t table_size(const struct sys_hashmap *map)
+{
+	return (map->slots != NULL) ? map->mask + 1U : 0U;
+}
+
+/* Distance of the entry in slot i from its home slot */
+static inline uint32_t distance(uint32_t i, uint32_t hash, uint32_t mask)
+{
+	return (i - hash) & mask;
+}
+
+static struct sys_hashmap_slot *find(const struct sys_hashmap *map,
+				     struct sys_hashmap_slot *slots,
+				     uint32_t mask, uint32_t hash,
+				     const void *key)
+{
+	if (slots == NULL) {
+		return NULL;
+	}
+
+	for (uint32_t i = hash & mask, dist = 0U; ;
+	     i = (i + 1U) & mask, dist++) {
+		struct sys_hashmap_slot *s = &slots[i];
+
+		/* Past where the key would have been placed */
+		if (s->entry == NULL || distance(i, s->hash, mask) < dist) {
+			return NULL;
+		}
+
+		if (s->hash == hash && map->match_fn(s->entry, key)) {
+			return s;
+		}
+	}
+}
+
+/* Places an entry, which is known not to be in the table yet, taking
+ * the slots of entries that are closer to their home.
+ */
+static void place(struct sys_hashmap_slot *slots, uint32_t mask,
+		  void *entry, uint32_t hash)
+{
+	for (uint32_t i = hash & mask, dist = 0U; ;
+	     i = (i + 1U) & mask, dist++) {
+		struct sys_hashmap_slot *s = &slots[i];
+		uint32_t s_dist;
+
+		if (s->entry == NULL) {
+			s->entry = entry;
+			s->hash = hash;
+			return;
+		}
+
+		s_dist = distance(i, s->hash, mask);
+		if (s_dist < dist) {
+			struct sys_hashmap_slot tmp = *s;
+
+			s->entry = entry;
+			s->hash = hash;
+			entry = tmp.entry;
+			hash = tmp.hash;
+			dist = s_dist;
+		}
+	}
+}
+
+/* Empties a slot, shifting back the following entries that are not in
+ * their home slot.
+ */
+static void erase(struct sys_hashmap_slot *slots, uint32_t mask, uint32_t i)
+{
+	for (;;) {
+		uint32_t next = (i + 1U) & mask;
+		struct sys_hashmap_slot *s = &slots[next];
+
+		if (s->entry == NULL || distance(next, s->hash, mask) == 0U) {
+			slots[i].entry = NULL;
+			return;
+		}
+
+		slots[i] = *s;
+		i = next;
+	}
+}
+
+/* Moves entries of the previous table to the current one.  Entries are
+ * moved a cluster (a run of full slots) at a time: emptying the first
+ * slots of a cluster would end the probes for the others too early,
+ * while probes never cross an empty slot, so a lookup in the previous
+ * table stays valid between calls.  Starts right after an empty slot,
+ * so that the first cluster is moved whole too.
+ */
+static void migrate(struct sys_hashmap *map, uint32_t budget)
+{
+	uint32_t done = 0U;
+
+	while (map->old_slots != NULL) {
+		struct sys_hashmap_slot *s;
+
+		if (map->old_left == 0U) {
+			map->alloc_fn(map->old_slots, 0);
+			map->old_slots = NULL;
+			break;
+		}
+
+		s = &map->old_slots[map->old_pos];
+		if (s->entry != NULL) {
+			place(map->slots, map->mask, s->entry, s->hash);
+			s->entry = NULL;
+		} else if (done >= budget) {
+			break;
+		}
+
+		map->old_pos = (map->old_pos + 1U) & map->old_mask;
+		map->old_left--;
+		done++;
+	}
+}
+
+static int grow(struct sys_hashmap *map)
+{
+	uint32_t n = (map->slots != NULL) ? 2U * table_size(map) : MIN_SLOTS;
+	struct sys_hashmap_slot *slots;
+
+	/* Only happens if the entries were not migrated fast enough */
+	migrate(map, UINT32_MAX);
+
+	slots = map->alloc_fn(NULL, n * sizeof(*slots));
+	if (slots == NULL) {
+		return -ENOMEM;
+	}
+
+	(void)memset(slots, 0, n * sizeof(*slots));
+
+	if (map->slots != NULL) {
+		uint32_t i = 0U;
+
+		while (map->slots[i].entry != NULL) {
+			i++;
+		}
+
+		map->old_slots = map->slots;
+		map->old_mask = map->mask;
+		map->old_pos = i;
+		map->old_left = map->mask + 1U;
+	}
+
+	map->slots = slots;
+	map->mask = n - 1U;
+
+	return 0;
+}
+
+void sys_hashmap_init(struct sys_hashmap *map, sys_hashmap_hash_t hash_fn,
+		      sys_hashmap_match_t match_fn,
+		      sys_hashmap_alloc_t alloc_fn)
+{
+	*map = (struct sys_hashmap) {
+		.hash_fn = hash_fn,
+		.match_fn = match_fn,
+		.alloc_fn = alloc_fn,
+	};
+}
+
+void sys_hashmap_init_static(struct sys_hashmap *map,
+			     sys_hashmap_hash_t hash_fn,
+			     sys_hashmap_match_t match_fn,
+			     struct sys_hashmap_slot *slots, uint32_t n_slots)
+{
+	__ASSERT(Z_SYS_HASHMAP_IS_POW2(n_slots),
+		 "Hash map size must be a power of 2");
+
+	*map = (struct sys_hashmap) {
+		.hash_fn = hash_fn,
+		.match_fn = match_fn,
+		.slots = slots,
+		.mask = n_slots - 1U,
+	};
+
+	(void)memset(slots, 0, n_slots * sizeof(*slots));
+}
+
+int sys_hashmap_insert(struct sys_hashmap *map, const void *key, void *entry)
+{
+	uint32_t hash = map->hash_fn(key);
+
+	__ASSERT_NO_MSG(entry != NULL);
+
+	if (find(map, map->slots, map->mask, hash, key) != NULL ||
+	    find(map, map->old_slots, map->old_mask, hash, key) != NULL) {
+		return -EEXIST;
+	}
+
+	if (map->size >= max_load(table_size(map))) {
+		int ret;
+
+		if (map->alloc_fn == NULL) {
+			return -ENOSPC;
+		}
+
+		ret = grow(map);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	migrate(map, MIGRATE_STEP);
+	place(map->slots, map->mask, entry, hash);
+	map->size++;
+
+	return 0;
+}
+
+void *sys_hashmap_get(const struct sys_hashmap *map, const void *key)
+{
+	uint32_t hash = map->hash_fn(key);
+	struct sys_hashmap_slot *s;
+
+	s = find(map, map->slots, map->mask, hash, key);
+	if (s == NULL) {
+		s = find(map, map->old_slots, map->old_mask, hash, key);
+	}
+
+	return (s != NULL) ? s->entry : NULL;
+}
+
+void *sys_hashmap_remove(struct sys_hashmap *map, const void *key)
+{
+	uint32_t hash = map->hash_fn(key);
+	struct sys_hashmap_slot *s;
+	void *entry;
+
+	s = find(map, map->slots, map->mask, hash, key);
+	if (s != NULL) {
+		entry = s->entry;
+		erase(map->slots, map->mask, s - map->slots);
+	} else {
+		s = find(map, map->old_slots, map->old_mask, hash, key);
+		if (s == NULL) {
+			return NULL;
+		}
+
+		entry = s->entry;
+		erase(map->old_slots, map->old_mask, s - map->old_slots);
+	}
+
+	map->size--;
+	migrate(map, MIGRATE_STEP);
+
+	return entry;
+}
+
+void sys_hashmap_clear(struct sys_hashmap *map)
+{
+	if (map->alloc_fn == NULL) {
+		(void)memset(map->slots, 0,
+			     table_size(map) * sizeof(*map->slots));
+	} else {
+		if (map->old_slots != NULL) {
+			map->alloc_fn(map->old_slots, 0);
+			map->old_slots = NULL;
+		}
+
+		if (map->slots != NULL) {
+			map->alloc_fn(map->slots, 0);
+			map->slots = NULL;
+			map->mask = 0U;
+		}
+	}
+
+	map->size = 0U;
+}
+
+static void visit_table(struct sys_hashmap_slot *slots, uint32_t n,
+			sys_hashmap_visit_t visit_fn, void *cookie)
+{
+	for (uint32_t i = 0U; i < n; i++) {
+		if (slots[i].entry != NULL) {
+			visit_fn(slots[i].entry, cookie);
+		}
+	}
+}
+
+void sys_hashmap_foreach(const struct sys_hashmap *map,
+			 sys_hashmap_visit_t visit_fn, void *cookie)
+{
+	visit_table(map->slots, table_size(map), visit_fn, cookie);
+
+	if (map->old_slots != NULL) {
+		visit_table(map->old_slots, map->old_mask + 1U, visit_fn,
+			    cookie);
+	}
+}
+
+uint32_t sys_hash32(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint32_t h = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		h = (h ^ p[i]) * 16777619U;
+	}
+
+	return sys_hash32_u32(h);
+}
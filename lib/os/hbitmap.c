@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/hbitmap.h>
+#include <sys/__assert.h>
+#include <sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+static inline atomic_t *word(const struct sys_hbitmap *bm, uint32_t level,
+			     uint32_t i)
+{
+	return &bm->words[bm->offset[level] + i];
+}
+
+/* Bits i % 32 and up of a word */
+static inline uint32_t mask_from(uint32_t i)
+{
+	return UINT32_MAX << (i % 32U);
+}
+
+/* Bits of a word in the range [i, i + count) */
+static inline uint32_t range_mask(uint32_t i, uint32_t count)
+{
+	uint32_t end = i % 32U + count;
+
+	return mask_from(i) & ((end >= 32U) ? UINT32_MAX : BIT(end) - 1U);
+}
+
+/* Sets the summary bits of a word that got a free bit, going up while
+ * the summary words were empty
+ */
+static void mark_nonempty(struct sys_hbitmap *bm, uint32_t level,
+			  uint32_t i)
+{
+	uint32_t old = 0U;
+
+	for (; old == 0U && level + 1U < bm->levels; level++, i /= 32U) {
+		old = (uint32_t)atomic_or(word(bm, level + 1U, i / 32U),
+					  BIT(i % 32U));
+	}
+}
+
+/* Clears the summary bits of a word that was seen empty, going up
+ * while the summary words get empty too.  A word may get a free bit
+ * again while its summary bit is being cleared: the bit is then set
+ * back, along with those above it that got cleared meanwhile.
+ */
+static void mark_empty(struct sys_hbitmap *bm, uint32_t level, uint32_t i)
+{
+	for (; level + 1U < bm->levels; level++, i /= 32U) {
+		atomic_t *parent = word(bm, level + 1U, i / 32U);
+		uint32_t bit = BIT(i % 32U);
+		uint32_t old = (uint32_t)atomic_and(parent, ~bit);
+
+		if (atomic_get(word(bm, level, i)) != 0) {
+			mark_nonempty(bm, level, i);
+			return;
+		}
+
+		if (old != bit) {
+			return;
+		}
+	}
+}
+
+/* Sets bits of a word, and the summary bits if it was empty */
+static void set_bits(struct sys_hbitmap *bm, uint32_t i, uint32_t mask)
+{
+	uint32_t old = (uint32_t)atomic_or(word(bm, 0U, i), mask);
+
+	__ASSERT((old & mask) == 0U, "freeing free bits %x of word %u",
+		 old & mask, i);
+
+	if (old == 0U) {
+		mark_nonempty(bm, 0U, i);
+	}
+}
+
+/* Clears bits of a word if they are all set */
+static bool claim_bits(struct sys_hbitmap *bm, uint32_t i, uint32_t mask)
+{
+	atomic_t *w = word(bm, 0U, i);
+	uint32_t old = (uint32_t)atomic_get(w);
+
+	while ((old & mask) == mask) {
+		if (atomic_cas(w, (atomic_val_t)old,
+			       (atomic_val_t)(old & ~mask))) {
+			if (old == mask) {
+				mark_empty(bm, 0U, i);
+			}
+			return true;
+		}
+		old = (uint32_t)atomic_get(w);
+	}
+
+	return false;
+}
+
+/* Lowest free index at or after pos, or the size of the bitmap.  Goes
+ * up the levels while the words have no free bit after pos, and down
+ * again through the first summary bit found.  Summary bits of empty
+ * words are cleared on the way.
+ */
+static uint32_t find_free(struct sys_hbitmap *bm, uint32_t pos)
+{
+	uint32_t level = 0U;
+	bool descending = false;
+
+	while (pos < bm->bits[level]) {
+		uint32_t i = pos / 32U;
+		uint32_t w = (uint32_t)atomic_get(word(bm, level, i));
+
+		if (descending && w == 0U) {
+			mark_empty(bm, level, i);
+		}
+
+		w &= mask_from(pos);
+		if (w != 0U) {
+			pos = i * 32U + __builtin_ctz(w);
+			if (level == 0U) {
+				return pos;
+			}
+			level--;
+			pos *= 32U;
+			descending = true;
+		} else if (level + 1U < bm->levels) {
+			level++;
+			pos = i + 1U;
+			descending = false;
+		} else {
+			break;
+		}
+	}
+
+	return bm->bits[0];
+}
+
+/* End of the run of free indexes at pos, up to limit */
+static uint32_t free_run_end(const struct sys_hbitmap *bm, uint32_t pos,
+			     uint32_t limit)
+{
+	while (pos < limit) {
+		uint32_t mask = range_mask(pos, limit - pos);
+		uint32_t used = ~(uint32_t)atomic_get(&bm->words[pos / 32U]) &
+				mask;
+
+		if (used != 0U) {
+			return (pos & ~31U) + __builtin_ctz(used);
+		}
+		pos = (pos | 31U) + 1U;
+	}
+
+	return limit;
+}
+
+void sys_hbitmap_init(struct sys_hbitmap *bm, atomic_t *words,
+		      uint32_t num_bits)
+{
+	__ASSERT(num_bits > 0U && num_bits <= SYS_HBITMAP_MAX_BITS,
+		 "Unsupported bitmap size");
+
+	*bm = (struct sys_hbitmap)Z_HBITMAP_INIT(words, num_bits);
+
+	(void)memset(words, 0, SYS_HBITMAP_WORDS(num_bits) * sizeof(*words));
+}
+
+int sys_hbitmap_alloc(struct sys_hbitmap *bm)
+{
+	uint32_t pos = 0U;
+
+	for (;;) {
+		pos = find_free(bm, pos);
+		if (pos >= bm->bits[0]) {
+			return -ENOSPC;
+		}
+
+		if (claim_bits(bm, pos / 32U, BIT(pos % 32U))) {
+			return (int)pos;
+		}
+	}
+}
+
+int sys_hbitmap_alloc_range(struct sys_hbitmap *bm, uint32_t count)
+{
+	uint32_t pos = 0U;
+
+	__ASSERT_NO_MSG(count > 0U);
+
+	for (;;) {
+		uint32_t end, i;
+
+		pos = find_free(bm, pos);
+		if (pos >= bm->bits[0] || count > bm->bits[0] - pos) {
+			return -ENOSPC;
+		}
+
+		end = free_run_end(bm, pos, pos + count);
+		if (end < pos + count) {
+			pos = end;
+			continue;
+		}
+
+		for (i = pos; i < end; i = (i | 31U) + 1U) {
+			if (!claim_bits(bm, i / 32U, range_mask(i, end - i))) {
+				break;
+			}
+		}
+
+		if (i >= end) {
+			return (int)pos;
+		}
+
+		/* Lost part of the range to another allocation */
+		if (i > pos) {
+			sys_hbitmap_free_range(bm, pos, i - pos);
+		}
+	}
+}
+
+void sys_hbitmap_free(struct sys_hbitmap *bm, uint32_t index)
+{
+	__ASSERT(index < bm->bits[0], "index %u out of range", index);
+
+	set_bits(bm, index / 32U, BIT(index % 32U));
+}
+
+void sys_hbitmap_free_range(struct sys_hbitmap *bm, uint32_t index,
+			    uint32_t count)
+{
+	uint32_t end = index + count;
+
+	__ASSERT(end <= bm->bits[0] && end >= index,
+		 "range %u+%u out of range", index, count);
+
+	for (uint32_t i = index; i < end; i = (i | 31U) + 1U) {
+		set_bits(bm, i / 32U, range_mask(i, end - i));
+	}
+}
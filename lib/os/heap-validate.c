@@ -89,6 +89,24 @@ bool sys_heap_validate(struct sys_heap *heap)
 		return false;  /* Should have exactly consumed the buffer */
 	}
 
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	/* Quick list chunks are still marked used, so the passes below
+	 * treat them as allocated.  Just check they are sane, tagged
+	 * and of the right size, and that the lists are not cyclic.
+	 */
+	for (int i = 0; i < Z_HEAP_QUICK_LISTS; i++) {
+		size_t n = 0;
+
+		for (c = h->quick[i]; c != 0; c = next_free_chunk(h, c)) {
+			VALIDATE(valid_chunk(h, c));
+			VALIDATE(chunk_used(h, c));
+			VALIDATE(prev_free_chunk(h, c) == c);
+			VALIDATE(chunk_size(h, c) == (size_t)i + 1);
+			VALIDATE(++n < h->len);
+		}
+	}
+#endif
+
 	/* Check the free lists: entry count should match, empty bit
 	 * should be correct, and all chunk entries should point into
 	 * valid unused chunks.  Mark those chunks USED, temporarily.
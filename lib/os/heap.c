@@ -127,6 +127,79 @@ static void free_chunk(struct z_heap *h, chunkid_t c)
 	free_list_add(h, c);
 }
 
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+
+static inline bool quick_chunk_size(size_t sz)
+{
+	return sz <= Z_HEAP_QUICK_LISTS;
+}
+
+/* Cached chunks stay marked used, so they are tagged by pointing
+ * FREE_PREV at themselves instead.  That field is user memory in an
+ * allocated chunk and may hold anything, so a match is only a hint
+ * which is confirmed by walking the list.
+ */
+static void quick_push(struct z_heap *h, chunkid_t c)
+{
+	size_t sz = chunk_size(h, c);
+
+	set_prev_free_chunk(h, c, c);
+	set_next_free_chunk(h, c, h->quick[sz - 1]);
+	h->quick[sz - 1] = c;
+}
+
+static chunkid_t quick_pop(struct z_heap *h, size_t sz)
+{
+	chunkid_t c = h->quick[sz - 1];
+
+	if (c != 0U) {
+		h->quick[sz - 1] = next_free_chunk(h, c);
+		set_prev_free_chunk(h, c, 0);
+	}
+	return c;
+}
+
+#if __ASSERT_ON
+static bool quick_listed(struct z_heap *h, chunkid_t c)
+{
+	size_t sz = chunk_size(h, c);
+
+	if (!quick_chunk_size(sz) || prev_free_chunk(h, c) != c) {
+		return false;
+	}
+
+	for (chunkid_t n = h->quick[sz - 1]; n != 0U;
+	     n = next_free_chunk(h, n)) {
+		if (n == c) {
+			return true;
+		}
+	}
+	return false;
+}
+#endif
+
+/* Merge every cached chunk back into the heap.  Returns false if
+ * there were none, i.e. retrying a failed allocation is pointless.
+ */
+static bool quick_flush(struct z_heap *h)
+{
+	bool flushed = false;
+
+	for (int i = 0; i < Z_HEAP_QUICK_LISTS; i++) {
+		chunkid_t c;
+
+		while ((c = h->quick[i]) != 0U) {
+			h->quick[i] = next_free_chunk(h, c);
+			set_chunk_used(h, c, false);
+			free_chunk(h, c);
+			flushed = true;
+		}
+	}
+	return flushed;
+}
+
+#endif /* CONFIG_SYS_HEAP_QUICK_LISTS */
+
 /*
  * Return the closest chunk ID corresponding to given memory pointer.
  * Here "closest" is only meaningful in the context of sys_heap_aligned_alloc()
@@ -153,6 +226,10 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 	 */
 	__ASSERT(chunk_used(h, c),
 		 "unexpected heap state (double-free?) for memory at %p", mem);
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	__ASSERT(!quick_listed(h, c),
+		 "unexpected heap state (double-free?) for memory at %p", mem);
+#endif
 
 	/*
 	 * It is easy to catch many common memory overflow cases with
@@ -163,11 +240,18 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 		 "corrupted heap bounds (buffer overflow?) for memory at %p",
 		 mem);
 
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	if (quick_chunk_size(chunk_size(h, c))) {
+		quick_push(h, c);
+		return;
+	}
+#endif
+
 	set_chunk_used(h, c, false);
 	free_chunk(h, c);
 }
 
-static chunkid_t alloc_chunk(struct z_heap *h, size_t sz)
+static chunkid_t alloc_bucket_chunk(struct z_heap *h, size_t sz)
 {
 	int bi = bucket_idx(h, sz);
 	struct z_heap_bucket *b = &h->buckets[bi];
@@ -221,6 +305,19 @@ static chunkid_t alloc_chunk(struct z_heap *h, size_t sz)
 	return 0;
 }
 
+static chunkid_t alloc_chunk(struct z_heap *h, size_t sz)
+{
+	chunkid_t c = alloc_bucket_chunk(h, sz);
+
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	/* Cached chunks may be hiding the space we need */
+	if ((c == 0U) && quick_flush(h)) {
+		c = alloc_bucket_chunk(h, sz);
+	}
+#endif
+	return c;
+}
+
 void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
@@ -230,7 +327,18 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	size_t chunk_sz = bytes_to_chunksz(h, bytes);
-	chunkid_t c = alloc_chunk(h, chunk_sz);
+	chunkid_t c;
+
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	if (quick_chunk_size(chunk_sz)) {
+		c = quick_pop(h, chunk_sz);
+		if (c != 0U) {
+			return chunk_mem(h, c);
+		}
+	}
+#endif
+
+	c = alloc_chunk(h, chunk_sz);
 	if (c == 0U) {
 		return NULL;
 	}
@@ -411,6 +519,12 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 		h->buckets[i].next = 0;
 	}
 
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	for (int i = 0; i < Z_HEAP_QUICK_LISTS; i++) {
+		h->quick[i] = 0;
+	}
+#endif
+
 	/* chunk containing our struct z_heap */
 	set_chunk_size(h, 0, chunk0_size);
 	set_chunk_used(h, 0, true);
@@ -57,10 +57,26 @@ struct z_heap_bucket {
 	chunkid_t next;
 };
 
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+/* One quick list per chunk size up to the largest cached block,
+ * counting the biggest (8 byte) header
+ */
+#define Z_HEAP_QUICK_LISTS \
+	((8U + CONFIG_SYS_HEAP_QUICK_MAX_BYTES + CHUNK_UNIT - 1U) / CHUNK_UNIT)
+#endif
+
 struct z_heap {
 	uint64_t chunk0_hdr_area;  /* matches the largest header */
 	uint32_t len;
 	uint32_t avail_buckets;
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	/* Heads of the lists of freed chunks of each size (index is
+	 * size - 1), linked through FREE_NEXT.  These chunks stay
+	 * marked used until they are merged back, and point FREE_PREV
+	 * at themselves so double frees can still be detected.
+	 */
+	uint32_t quick[Z_HEAP_QUICK_LISTS];
+#endif
 	struct z_heap_bucket buckets[0];
 };
 
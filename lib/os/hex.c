@@ -9,31 +9,45 @@
 #include <errno.h>
 #include <sys/util.h>
 
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Values of the hexadecimal digits, with bit 4 set; 0 for anything else */
+static const uint8_t hex_dec_map[256] = {
+	['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13,
+	['4'] = 0x14, ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17,
+	['8'] = 0x18, ['9'] = 0x19,
+	['a'] = 0x1a, ['b'] = 0x1b, ['c'] = 0x1c, ['d'] = 0x1d,
+	['e'] = 0x1e, ['f'] = 0x1f,
+	['A'] = 0x1a, ['B'] = 0x1b, ['C'] = 0x1c, ['D'] = 0x1d,
+	['E'] = 0x1e, ['F'] = 0x1f,
+};
+
+static inline uint8_t hex_dec(char c)
+{
+	return hex_dec_map[(uint8_t)c];
+}
+
 int char2hex(char c, uint8_t *x)
 {
-	if (c >= '0' && c <= '9') {
-		*x = c - '0';
-	} else if (c >= 'a' && c <= 'f') {
-		*x = c - 'a' + 10;
-	} else if (c >= 'A' && c <= 'F') {
-		*x = c - 'A' + 10;
-	} else {
+	uint8_t d = hex_dec(c);
+
+	if (d == 0U) {
 		return -EINVAL;
 	}
 
+	*x = d & 0xf;
+
 	return 0;
 }
 
 int hex2char(uint8_t x, char *c)
 {
-	if (x <= 9) {
-		*c = x + '0';
-	} else  if (x <= 15) {
-		*c = x - 10 + 'a';
-	} else {
+	if (x > 15) {
 		return -EINVAL;
 	}
 
+	*c = hex_digits[x];
+
 	return 0;
 }
 
@@ -44,12 +58,10 @@ size_t bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen)
 	}
 
 	for (size_t i = 0; i < buflen; i++) {
-		if (hex2char(buf[i] >> 4, &hex[2 * i]) < 0) {
-			return 0;
-		}
-		if (hex2char(buf[i] & 0xf, &hex[2 * i + 1]) < 0) {
-			return 0;
-		}
+		uint8_t b = buf[i];
+
+		hex[2 * i] = hex_digits[b >> 4];
+		hex[2 * i + 1] = hex_digits[b & 0xf];
 	}
 
 	hex[2 * buflen] = '\0';
@@ -58,7 +70,7 @@ size_t bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen)
 
 size_t hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen)
 {
-	uint8_t dec;
+	uint8_t hi, lo;
 
 	if (buflen < hexlen / 2 + hexlen % 2) {
 		return 0;
@@ -66,25 +78,23 @@ size_t hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen)
 
 	/* if hexlen is uneven, insert leading zero nibble */
 	if (hexlen % 2) {
-		if (char2hex(hex[0], &dec) < 0) {
+		lo = hex_dec(hex[0]);
+		if (lo == 0U) {
 			return 0;
 		}
-		buf[0] = dec;
+		buf[0] = lo & 0xf;
 		hex++;
 		buf++;
 	}
 
-	/* regular hex conversion */
+	/* regular hex conversion, checking both digits at once */
 	for (size_t i = 0; i < hexlen / 2; i++) {
-		if (char2hex(hex[2 * i], &dec) < 0) {
-			return 0;
-		}
-		buf[i] = dec << 4;
-
-		if (char2hex(hex[2 * i + 1], &dec) < 0) {
+		hi = hex_dec(hex[2 * i]);
+		lo = hex_dec(hex[2 * i + 1]);
+		if ((hi & lo & 0x10) == 0U) {
 			return 0;
 		}
-		buf[i] += dec;
+		buf[i] = (hi << 4) | (lo & 0xf);
 	}
 
 	return hexlen / 2 + hexlen % 2;
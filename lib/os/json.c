@@ -599,6 +599,686 @@ int json_obj_parse(char *payload, size_t len,
 	return obj_parse(&obj, descr, descr_len, val);
 }
 
+/* Incremental parser: a state machine consuming one chunk at a time */
+enum {
+	STREAM_BETWEEN,
+	STREAM_STRING,
+	STREAM_ESCAPE,
+	STREAM_UNICODE,
+	STREAM_NUMBER,
+	STREAM_LITERAL,
+	STREAM_DONE,
+	STREAM_ERROR,
+};
+
+/* What the grammar allows next when between tokens */
+enum {
+	EXPECT_VALUE,
+	EXPECT_VALUE_OR_END,
+	EXPECT_KEY,
+	EXPECT_KEY_OR_END,
+	EXPECT_COLON,
+	EXPECT_COMMA_OR_END,
+};
+
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data)
+{
+	*stream = (struct json_stream) {
+		.cb = cb,
+		.user_data = user_data,
+		.buf = buf,
+		.buf_size = buf_size,
+		.state = STREAM_BETWEEN,
+		.expect = EXPECT_VALUE,
+	};
+}
+
+static bool stream_in_object(const struct json_stream *stream)
+{
+	return stream->depth > 0 &&
+	       (stream->objects & BIT(stream->depth - 1)) != 0U;
+}
+
+static int stream_emit(struct json_stream *stream, enum json_tokens type,
+		       const char *value, size_t value_len)
+{
+	struct json_stream_token token = {
+		.type = type,
+		.depth = stream->depth,
+		.value = value,
+		.value_len = value_len,
+	};
+
+	if (type != JSON_TOK_OBJECT_END && type != JSON_TOK_LIST_END &&
+	    stream_in_object(stream)) {
+		token.key = stream->buf;
+		token.key_len = stream->key_len;
+	}
+
+	return stream->cb(&token, stream->user_data);
+}
+
+static void stream_value_done(struct json_stream *stream)
+{
+	if (stream->depth == 0) {
+		stream->state = STREAM_DONE;
+	} else {
+		stream->state = STREAM_BETWEEN;
+		stream->expect = EXPECT_COMMA_OR_END;
+	}
+}
+
+/* Keeps the part of the current token that is in the chunk being fed */
+static int stream_spill(struct json_stream *stream, const char *start,
+			const char *end)
+{
+	size_t len = end - start;
+
+	if (len > stream->buf_size - stream->base - stream->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(stream->buf + stream->base + stream->len, start, len);
+	stream->len += len;
+
+	return 0;
+}
+
+static bool number_char(char chr)
+{
+	return isdigit((unsigned char)chr) || chr == '.' || chr == '-' ||
+	       chr == '+' || chr == 'e' || chr == 'E';
+}
+
+static const char *skip_digits(const char *str, const char *end)
+{
+	while (str < end && isdigit((unsigned char)*str)) {
+		str++;
+	}
+
+	return str;
+}
+
+/* Checks a number against the grammar:
+ * -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+static bool number_valid(const char *str, size_t len)
+{
+	const char *end = str + len;
+	const char *digits;
+
+	if (str < end && *str == '-') {
+		str++;
+	}
+
+	digits = str;
+	str = skip_digits(str, end);
+	if (str == digits || (*digits == '0' && str - digits > 1)) {
+		return false;
+	}
+
+	if (str < end && *str == '.') {
+		digits = ++str;
+		str = skip_digits(str, end);
+		if (str == digits) {
+			return false;
+		}
+	}
+
+	if (str < end && (*str == 'e' || *str == 'E')) {
+		str++;
+		if (str < end && (*str == '+' || *str == '-')) {
+			str++;
+		}
+
+		digits = str;
+		str = skip_digits(str, end);
+		if (str == digits) {
+			return false;
+		}
+	}
+
+	return str == end;
+}
+
+/* Completes a string or a number, whose part in the chunk being fed lies
+ * between start and end. It is reported in place unless earlier parts of
+ * it had to be spilled.
+ */
+static int stream_token_end(struct json_stream *stream,
+			    enum json_tokens type,
+			    const char *start, const char *end)
+{
+	const char *value = start;
+	size_t len = end - start;
+	int ret;
+
+	if (stream->len > 0) {
+		ret = stream_spill(stream, start, end);
+		if (ret < 0) {
+			return ret;
+		}
+
+		value = stream->buf + stream->base;
+		len = stream->len;
+	}
+
+	if (stream->in_key) {
+		if (value != stream->buf) {
+			if (len > stream->buf_size) {
+				return -ENOMEM;
+			}
+
+			memcpy(stream->buf, value, len);
+		}
+
+		stream->key_len = len;
+		stream->in_key = false;
+		stream->state = STREAM_BETWEEN;
+		stream->expect = EXPECT_COLON;
+
+		return 0;
+	}
+
+	if (type == JSON_TOK_NUMBER && !number_valid(value, len)) {
+		return -EINVAL;
+	}
+
+	ret = stream_emit(stream, type, value, len);
+	stream_value_done(stream);
+
+	return ret;
+}
+
+static void stream_token_start(struct json_stream *stream, bool key)
+{
+	stream->in_key = key;
+	stream->base = (!key && stream_in_object(stream)) ? stream->key_len : 0;
+	stream->len = 0;
+}
+
+static int stream_literal_start(struct json_stream *stream,
+				enum json_tokens type, const char *rest)
+{
+	stream->state = STREAM_LITERAL;
+	stream->literal_type = type;
+	stream->literal = rest;
+
+	return 0;
+}
+
+/* Handles a character found between tokens */
+static int stream_between(struct json_stream *stream, char chr)
+{
+	bool value = stream->expect == EXPECT_VALUE ||
+		     stream->expect == EXPECT_VALUE_OR_END;
+	int ret;
+
+	switch (chr) {
+	case ' ':
+	case '\t':
+	case '\n':
+	case '\r':
+		return 0;
+	case '{':
+	case '[':
+		if (!value) {
+			return -EINVAL;
+		}
+
+		if (stream->depth == CONFIG_JSON_STREAM_MAX_DEPTH) {
+			return -E2BIG;
+		}
+
+		ret = stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+
+		WRITE_BIT(stream->objects, stream->depth, chr == '{');
+		stream->depth++;
+		stream->expect = (chr == '{') ? EXPECT_KEY_OR_END :
+						EXPECT_VALUE_OR_END;
+
+		return ret;
+	case '}':
+	case ']':
+		if (stream->depth == 0 ||
+		    (chr == '}') != stream_in_object(stream)) {
+			return -EINVAL;
+		}
+
+		if (stream->expect != EXPECT_COMMA_OR_END &&
+		    stream->expect != ((chr == '}') ? EXPECT_KEY_OR_END :
+						      EXPECT_VALUE_OR_END)) {
+			return -EINVAL;
+		}
+
+		stream->depth--;
+		ret = stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+		stream_value_done(stream);
+
+		return ret;
+	case ',':
+		if (stream->expect != EXPECT_COMMA_OR_END) {
+			return -EINVAL;
+		}
+
+		stream->expect = stream_in_object(stream) ? EXPECT_KEY :
+							    EXPECT_VALUE;
+		return 0;
+	case ':':
+		if (stream->expect != EXPECT_COLON) {
+			return -EINVAL;
+		}
+
+		stream->expect = EXPECT_VALUE;
+		return 0;
+	case '"':
+		if (stream->expect == EXPECT_KEY ||
+		    stream->expect == EXPECT_KEY_OR_END) {
+			stream_token_start(stream, true);
+		} else if (value) {
+			stream_token_start(stream, false);
+		} else {
+			return -EINVAL;
+		}
+
+		stream->state = STREAM_STRING;
+		return 0;
+	}
+
+	if (!value) {
+		return -EINVAL;
+	}
+
+	switch (chr) {
+	case 't':
+		return stream_literal_start(stream, JSON_TOK_TRUE, "rue");
+	case 'f':
+		return stream_literal_start(stream, JSON_TOK_FALSE, "alse");
+	case 'n':
+		return stream_literal_start(stream, JSON_TOK_NULL, "ull");
+	case '-':
+		break;
+	default:
+		if (!isdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+	}
+
+	stream_token_start(stream, false);
+	stream->state = STREAM_NUMBER;
+
+	return 0;
+}
+
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len)
+{
+	const char *pos = data;
+	const char *end = data + len;
+	/* Start of the current string or number in this chunk */
+	const char *start = data;
+	int ret = 0;
+
+	while (pos < end) {
+		char chr = *pos;
+
+		switch (stream->state) {
+		case STREAM_BETWEEN:
+			ret = stream_between(stream, chr);
+			pos++;
+			if (stream->state == STREAM_STRING) {
+				start = pos;
+			} else if (stream->state == STREAM_NUMBER) {
+				start = pos - 1;
+			}
+			break;
+		case STREAM_STRING:
+			while (chr != '"' && chr != '\\' &&
+			       (unsigned char)chr >= ' ') {
+				if (++pos == end) {
+					goto out;
+				}
+				chr = *pos;
+			}
+
+			if (chr == '\\') {
+				stream->state = STREAM_ESCAPE;
+			} else if (chr == '"') {
+				ret = stream_token_end(stream, JSON_TOK_STRING,
+						       start, pos);
+			} else {
+				/* Control characters have to be escaped */
+				ret = -EINVAL;
+			}
+			pos++;
+			break;
+		case STREAM_ESCAPE:
+			switch (chr) {
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+				stream->state = STREAM_STRING;
+				break;
+			case 'u':
+				stream->state = STREAM_UNICODE;
+				stream->hex_digits = 4U;
+				break;
+			default:
+				ret = -EINVAL;
+			}
+			pos++;
+			break;
+		case STREAM_UNICODE:
+			if (!isxdigit((unsigned char)chr)) {
+				ret = -EINVAL;
+			} else if (--stream->hex_digits == 0U) {
+				stream->state = STREAM_STRING;
+			}
+			pos++;
+			break;
+		case STREAM_NUMBER:
+			while (number_char(chr)) {
+				if (++pos == end) {
+					goto out;
+				}
+				chr = *pos;
+			}
+
+			/* The character ending the number is handled next */
+			ret = stream_token_end(stream, JSON_TOK_NUMBER, start,
+					       pos);
+			break;
+		case STREAM_LITERAL:
+			if (chr != *stream->literal) {
+				ret = -EINVAL;
+			} else if (*++stream->literal == '\0') {
+				ret = stream_emit(stream, stream->literal_type,
+						  NULL, 0);
+				stream_value_done(stream);
+			}
+			pos++;
+			break;
+		case STREAM_DONE:
+			if (!isspace((unsigned char)chr)) {
+				ret = -EINVAL;
+			}
+			pos++;
+			break;
+		default:
+			return -EINVAL;
+		}
+
+		if (ret < 0) {
+			stream->state = STREAM_ERROR;
+			return ret;
+		}
+	}
+
+out:
+	switch (stream->state) {
+	case STREAM_STRING:
+	case STREAM_ESCAPE:
+	case STREAM_UNICODE:
+	case STREAM_NUMBER:
+		ret = stream_spill(stream, start, end);
+		if (ret < 0) {
+			stream->state = STREAM_ERROR;
+			return ret;
+		}
+		break;
+	case STREAM_ERROR:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int json_stream_finish(struct json_stream *stream)
+{
+	const char *spilled = stream->buf + stream->base + stream->len;
+	int ret = -EINVAL;
+
+	if (stream->state == STREAM_NUMBER) {
+		ret = stream_token_end(stream, JSON_TOK_NUMBER, spilled,
+				       spilled);
+	} else if (stream->state == STREAM_DONE) {
+		ret = 0;
+	}
+
+	if (ret < 0) {
+		stream->state = STREAM_ERROR;
+	}
+
+	return ret;
+}
+
+static int stream_decode_num(const char *str, size_t len, int32_t *num)
+{
+	char buf[sizeof("-2147483648")];
+	char *endptr;
+	long value;
+
+	if (len >= sizeof(buf)) {
+		return -ERANGE;
+	}
+
+	memcpy(buf, str, len);
+	buf[len] = '\0';
+
+	errno = 0;
+	value = strtol(buf, &endptr, 10);
+
+	if (errno != 0) {
+		return -errno;
+	}
+
+	if (endptr != buf + len) {
+		return -EINVAL;
+	}
+
+	if (value < INT32_MIN || value > INT32_MAX) {
+		return -ERANGE;
+	}
+
+	*num = (int32_t)value;
+
+	return 0;
+}
+
+/* Strings are moved to the start of the buffer, which then shrinks */
+static int stream_decode_str(struct json_stream *stream,
+			     const struct json_stream_token *token, char **str)
+{
+	size_t len = token->value_len;
+
+	if (len >= stream->buf_size) {
+		return -ENOMEM;
+	}
+
+	memmove(stream->buf, token->value, len);
+	stream->buf[len] = '\0';
+	*str = stream->buf;
+
+	stream->buf += len + 1;
+	stream->buf_size -= len + 1;
+
+	return 0;
+}
+
+static int stream_decode_value(struct json_stream_obj *obj,
+			       const struct json_obj_descr *descr,
+			       const struct json_stream_token *token,
+			       void *field, void *val)
+{
+	struct json_stream_obj_frame *frame;
+
+	if (!equivalent_types(token->type, descr->type)) {
+		return -EINVAL;
+	}
+
+	switch (descr->type) {
+	case JSON_TOK_OBJECT_START:
+		frame = &obj->frames[obj->depth++];
+		frame->descr = descr->object.sub_descr;
+		frame->len = descr->object.sub_descr_len;
+		frame->val = field;
+		frame->decoded = 0U;
+
+		return 0;
+	case JSON_TOK_LIST_START:
+		frame = &obj->frames[obj->depth++];
+		frame->descr = descr->array.element_descr;
+		frame->len = descr->array.n_elements;
+		frame->val = val;
+		frame->field = field;
+		frame->elem_size = get_elem_size(frame->descr);
+		frame->decoded = 0U;
+
+		__ASSERT_NO_MSG(frame->elem_size > 0);
+
+		*(size_t *)((char *)val + frame->descr->offset) = 0;
+
+		return 0;
+	case JSON_TOK_FALSE:
+	case JSON_TOK_TRUE: {
+		bool *v = field;
+
+		*v = token->type == JSON_TOK_TRUE;
+
+		return 0;
+	}
+	case JSON_TOK_NUMBER:
+		return stream_decode_num(token->value, token->value_len, field);
+	case JSON_TOK_STRING:
+		return stream_decode_str(&obj->stream, token, field);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int stream_obj_token(const struct json_stream_token *token,
+			    void *user_data)
+{
+	struct json_stream_obj *obj = user_data;
+	struct json_stream_obj_frame *frame;
+	bool start = token->type == JSON_TOK_OBJECT_START ||
+		     token->type == JSON_TOK_LIST_START;
+	bool end = token->type == JSON_TOK_OBJECT_END ||
+		   token->type == JSON_TOK_LIST_END;
+	size_t i;
+	int ret;
+
+	/* Inside a value missing in the descriptors */
+	if (obj->skip > 0U) {
+		if (start) {
+			obj->skip++;
+		} else if (end) {
+			obj->skip--;
+		}
+
+		return 0;
+	}
+
+	/* The top level object, described by frames[0] at init */
+	if (obj->depth == 0U) {
+		if (token->type != JSON_TOK_OBJECT_START) {
+			return -EINVAL;
+		}
+
+		obj->depth = 1U;
+
+		return 0;
+	}
+
+	frame = &obj->frames[obj->depth - 1U];
+
+	if (end) {
+		obj->depth--;
+		if (obj->depth == 0U) {
+			obj->result = frame->decoded;
+		}
+
+		return 0;
+	}
+
+	if (token->key == NULL) {
+		if (frame->decoded == frame->len) {
+			return -ENOSPC;
+		}
+
+		ret = stream_decode_value(obj, frame->descr, token,
+					  frame->field +
+					  frame->elem_size * frame->decoded,
+					  frame->val);
+
+		frame->decoded++;
+		*(size_t *)((char *)frame->val + frame->descr->offset) =
+			frame->decoded;
+
+		return ret;
+	}
+
+	for (i = 0; i < frame->len; i++) {
+		const struct json_obj_descr *descr = &frame->descr[i];
+
+		if (frame->decoded & BIT(i)) {
+			continue;
+		}
+
+		if (token->key_len != descr->field_name_len ||
+		    memcmp(token->key, descr->field_name, token->key_len)) {
+			continue;
+		}
+
+		frame->decoded |= BIT(i);
+
+		return stream_decode_value(obj, descr, token,
+					   (char *)frame->val + descr->offset,
+					   frame->val);
+	}
+
+	if (start) {
+		obj->skip = 1U;
+	}
+
+	return 0;
+}
+
+void json_stream_obj_init(struct json_stream_obj *obj,
+			  const struct json_obj_descr *descr,
+			  size_t descr_len, void *val,
+			  char *buf, size_t buf_size)
+{
+	__ASSERT_NO_MSG(descr_len < (sizeof(obj->result) * CHAR_BIT - 1));
+
+	json_stream_init(&obj->stream, buf, buf_size, stream_obj_token, obj);
+
+	obj->frames[0].descr = descr;
+	obj->frames[0].len = descr_len;
+	obj->frames[0].val = val;
+	obj->frames[0].decoded = 0U;
+	obj->depth = 0U;
+	obj->skip = 0U;
+	obj->result = 0;
+}
+
+int json_stream_obj_finish(struct json_stream_obj *obj)
+{
+	int ret = json_stream_finish(&obj->stream);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return obj->result;
+}
+
 static char escape_as(char chr)
 {
 	switch (chr) {
@@ -621,26 +1301,49 @@ static char escape_as(char chr)
 	return 0;
 }
 
-static int json_escape_internal(const char *str,
-				json_append_bytes_t append_bytes,
-				void *data)
+/* Appends runs of characters needing no escape with a single call */
+static int escape_append(const char *str, size_t len,
+			 json_append_bytes_t append_bytes, void *data)
 {
-	const char *cur;
-	int ret = 0;
+	const char *run = str;
+	const char *end = str + len;
+	int ret;
 
-	for (cur = str; ret == 0 && *cur; cur++) {
-		char escaped = escape_as(*cur);
+	for (; str < end; str++) {
+		char escaped = escape_as(*str);
+		char bytes[2] = { '\\', escaped };
 
-		if (escaped) {
-			char bytes[2] = { '\\', escaped };
+		if (!escaped) {
+			continue;
+		}
 
-			ret = append_bytes(bytes, 2, data);
-		} else {
-			ret = append_bytes(cur, 1, data);
+		if (str > run) {
+			ret = append_bytes(run, str - run, data);
+			if (ret < 0) {
+				return ret;
+			}
 		}
+
+		ret = append_bytes(bytes, 2, data);
+		if (ret < 0) {
+			return ret;
+		}
+
+		run = str + 1;
 	}
 
-	return ret;
+	if (str > run) {
+		return append_bytes(run, str - run, data);
+	}
+
+	return 0;
+}
+
+static int json_escape_internal(const char *str,
+				json_append_bytes_t append_bytes,
+				void *data)
+{
+	return escape_append(str, strlen(str), append_bytes, data);
 }
 
 size_t json_calc_escaped_len(const char *str, size_t len)
@@ -936,3 +1639,195 @@ ssize_t json_calc_encoded_len(const struct json_obj_descr *descr,
 
 	return total;
 }
+
+void json_enc_init(struct json_enc *enc, json_append_bytes_t append_bytes,
+		   void *data)
+{
+	*enc = (struct json_enc) {
+		.append_bytes = append_bytes,
+		.data = data,
+	};
+}
+
+static int enc_check(struct json_enc *enc, int ret)
+{
+	if (ret < 0) {
+		enc->err = ret;
+	}
+
+	return ret;
+}
+
+/* Writes the separator and the member name preceding a value */
+static int enc_prefix(struct json_enc *enc, const char *key)
+{
+	int ret;
+
+	if (enc->err < 0) {
+		return enc->err;
+	}
+
+	if (enc->depth > 0U) {
+		if (enc->first & BIT(enc->depth - 1U)) {
+			enc->first &= ~BIT(enc->depth - 1U);
+		} else {
+			ret = enc->append_bytes(",", 1, enc->data);
+			if (ret < 0) {
+				return enc_check(enc, ret);
+			}
+		}
+	}
+
+	if (key == NULL) {
+		return 0;
+	}
+
+	ret = enc->append_bytes("\"", 1, enc->data);
+	if (ret < 0) {
+		return enc_check(enc, ret);
+	}
+
+	ret = json_escape_internal(key, enc->append_bytes, enc->data);
+	if (ret < 0) {
+		return enc_check(enc, ret);
+	}
+
+	return enc_check(enc, enc->append_bytes("\":", 2, enc->data));
+}
+
+static int enc_start(struct json_enc *enc, const char *key, const char *chr)
+{
+	int ret;
+
+	if (enc->err < 0) {
+		return enc->err;
+	}
+
+	if (enc->depth == sizeof(enc->first) * CHAR_BIT) {
+		return enc_check(enc, -E2BIG);
+	}
+
+	ret = enc_prefix(enc, key);
+	if (ret < 0) {
+		return ret;
+	}
+
+	enc->first |= BIT(enc->depth);
+	enc->depth++;
+
+	return enc_check(enc, enc->append_bytes(chr, 1, enc->data));
+}
+
+static int enc_end(struct json_enc *enc, const char *chr)
+{
+	if (enc->err < 0) {
+		return enc->err;
+	}
+
+	if (enc->depth == 0U) {
+		return enc_check(enc, -EINVAL);
+	}
+
+	enc->depth--;
+	enc->first &= ~BIT(enc->depth);
+
+	return enc_check(enc, enc->append_bytes(chr, 1, enc->data));
+}
+
+int json_enc_obj_start(struct json_enc *enc, const char *key)
+{
+	return enc_start(enc, key, "{");
+}
+
+int json_enc_obj_end(struct json_enc *enc)
+{
+	return enc_end(enc, "}");
+}
+
+int json_enc_arr_start(struct json_enc *enc, const char *key)
+{
+	return enc_start(enc, key, "[");
+}
+
+int json_enc_arr_end(struct json_enc *enc)
+{
+	return enc_end(enc, "]");
+}
+
+int json_enc_str(struct json_enc *enc, const char *key, const char *str,
+		 size_t len)
+{
+	int ret = enc_prefix(enc, key);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = enc->append_bytes("\"", 1, enc->data);
+	if (ret < 0) {
+		return enc_check(enc, ret);
+	}
+
+	ret = escape_append(str, len, enc->append_bytes, enc->data);
+	if (ret < 0) {
+		return enc_check(enc, ret);
+	}
+
+	return enc_check(enc, enc->append_bytes("\"", 1, enc->data));
+}
+
+int json_enc_num(struct json_enc *enc, const char *key, int64_t num)
+{
+	char buf[sizeof("-9223372036854775808") - 1];
+	char *pos = buf + sizeof(buf);
+	uint64_t mag = (num < 0) ? -(uint64_t)num : (uint64_t)num;
+	int ret = enc_prefix(enc, key);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	do {
+		*--pos = '0' + (char)(mag % 10U);
+		mag /= 10U;
+	} while (mag != 0U);
+
+	if (num < 0) {
+		*--pos = '-';
+	}
+
+	return enc_check(enc, enc->append_bytes(pos, buf + sizeof(buf) - pos,
+						enc->data));
+}
+
+int json_enc_bool(struct json_enc *enc, const char *key, bool value)
+{
+	int ret = enc_prefix(enc, key);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return enc_check(enc, bool_encode(&value, enc->append_bytes,
+					  enc->data));
+}
+
+int json_enc_null(struct json_enc *enc, const char *key)
+{
+	int ret = enc_prefix(enc, key);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return enc_check(enc, enc->append_bytes("null", 4, enc->data));
+}
+
+int json_enc_finish(struct json_enc *enc)
+{
+	if (enc->err < 0) {
+		return enc->err;
+	}
+
+	return (enc->depth == 0U) ? 0 : -EINVAL;
+}
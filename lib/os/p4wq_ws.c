@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/p4wq.h>
+#include <wait_q.h>
+#include <ksched.h>
+
+/* Work stealing P4 pools.  Every worker has a deque of items behind
+ * its own lock.  Items submitted by a worker go to the head of its
+ * own deque and it takes them back from there, most recent first,
+ * which keeps the data of a fork/join tree hot in its cache.  Idle
+ * workers steal from the tail of the others' deques, i.e. the
+ * oldest, usually biggest, pieces of work.  The pool lock is only
+ * taken to put a worker to sleep or wake one up.
+ */
+
+static struct k_p4wq_ws_worker *current_worker(struct k_p4wq_ws *pool)
+{
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		if (&pool->workers[i].thread == _current) {
+			return &pool->workers[i];
+		}
+	}
+	return NULL;
+}
+
+static void push(struct k_p4wq_ws_worker *w, struct k_p4wq_work *item)
+{
+	k_spinlock_key_t k = k_spin_lock(&w->lock);
+
+	sys_dlist_prepend(&w->deque, &item->dlnode);
+	item->ws_worker = w;
+
+	k_spin_unlock(&w->lock, k);
+}
+
+static struct k_p4wq_work *take(struct k_p4wq_ws_worker *w, bool steal)
+{
+	struct k_p4wq_work *item = NULL;
+	k_spinlock_key_t k = k_spin_lock(&w->lock);
+	sys_dnode_t *n;
+
+	n = steal ? sys_dlist_peek_tail(&w->deque)
+		  : sys_dlist_peek_head(&w->deque);
+	if (n != NULL) {
+		sys_dlist_remove(n);
+		item = CONTAINER_OF(n, struct k_p4wq_work, dlnode);
+		item->ws_worker = NULL;
+		atomic_dec(&w->pool->queued);
+	}
+
+	k_spin_unlock(&w->lock, k);
+	return item;
+}
+
+static struct k_p4wq_work *find_work(struct k_p4wq_ws *pool,
+				     struct k_p4wq_ws_worker *self)
+{
+	uint32_t idx = self - pool->workers;
+	struct k_p4wq_work *item = take(self, false);
+
+	for (uint32_t i = 1; (item == NULL) && (i < pool->num_workers); i++) {
+		item = take(&pool->workers[(idx + i) % pool->num_workers],
+			    true);
+	}
+	return item;
+}
+
+static void complete(struct k_p4wq_ws_join *join)
+{
+	if ((join != NULL) && (atomic_dec(&join->pending) == 1)) {
+		k_sem_give(&join->done);
+	}
+}
+
+static void run(struct k_p4wq_work *item)
+{
+	/* The handler may resubmit or free the item */
+	struct k_p4wq_ws_join *join = item->ws_join;
+
+	item->handler(item);
+	complete(join);
+}
+
+static FUNC_NORETURN void ws_loop(void *p0, void *p1, void *p2)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	struct k_p4wq_ws_worker *self = p0;
+	struct k_p4wq_ws *pool = self->pool;
+
+	while (true) {
+		struct k_p4wq_work *item = find_work(pool, self);
+
+		if (item != NULL) {
+			run(item);
+			continue;
+		}
+
+		/* Submitters bump queued before they check idle, we
+		 * bump idle before we check queued, so one of us sees
+		 * the other
+		 */
+		k_spinlock_key_t k = k_spin_lock(&pool->lock);
+
+		atomic_inc(&pool->idle);
+		if (atomic_get(&pool->queued) == 0) {
+			z_pend_curr(&pool->lock, k, &pool->waitq, K_FOREVER);
+		} else {
+			atomic_dec(&pool->idle);
+			k_spin_unlock(&pool->lock, k);
+		}
+	}
+}
+
+void k_p4wq_ws_init(struct k_p4wq_ws *pool, struct k_p4wq_ws_worker *workers,
+		    uint32_t num_workers)
+{
+	__ASSERT_NO_MSG(num_workers > 0);
+
+	memset(pool, 0, sizeof(*pool));
+	z_waitq_init(&pool->waitq);
+	pool->workers = workers;
+	pool->num_workers = num_workers;
+
+	for (uint32_t i = 0; i < num_workers; i++) {
+		memset(&workers[i], 0, sizeof(workers[i]));
+		sys_dlist_init(&workers[i].deque);
+		workers[i].pool = pool;
+	}
+}
+
+void k_p4wq_ws_start(struct k_p4wq_ws *pool, k_thread_stack_t *stacks,
+		     size_t stack_size, int prio)
+{
+	uintptr_t ssz = K_THREAD_STACK_LEN(stack_size);
+
+	for (uint32_t i = 0; i < pool->num_workers; i++) {
+		struct k_thread *th = &pool->workers[i].thread;
+
+		k_thread_create(th, &((struct z_thread_stack_element *)stacks)[ssz * i],
+				stack_size, ws_loop, &pool->workers[i], NULL,
+				NULL, prio, 0, K_FOREVER);
+#ifdef CONFIG_SCHED_CPU_MASK
+		(void)k_thread_cpu_mask_clear(th);
+		(void)k_thread_cpu_mask_enable(th, i % CONFIG_MP_NUM_CPUS);
+#endif
+		k_thread_start(th);
+	}
+}
+
+static void submit(struct k_p4wq_ws *pool, struct k_p4wq_work *item)
+{
+	struct k_p4wq_ws_worker *w = current_worker(pool);
+
+	__ASSERT_NO_MSG(item->ws_worker == NULL);
+
+	if (w == NULL) {
+		uint32_t next = (uint32_t)atomic_inc(&pool->next);
+
+		w = &pool->workers[next % pool->num_workers];
+	}
+
+	push(w, item);
+	atomic_inc(&pool->queued);
+
+	if (atomic_get(&pool->idle) == 0) {
+		return;
+	}
+
+	k_spinlock_key_t k = k_spin_lock(&pool->lock);
+
+	if (z_sched_wake(&pool->waitq, 0, NULL)) {
+		atomic_dec(&pool->idle);
+		z_reschedule(&pool->lock, k);
+	} else {
+		k_spin_unlock(&pool->lock, k);
+	}
+}
+
+void k_p4wq_ws_submit(struct k_p4wq_ws *pool, struct k_p4wq_work *item)
+{
+	item->ws_join = NULL;
+	submit(pool, item);
+}
+
+bool k_p4wq_ws_cancel(struct k_p4wq_ws *pool, struct k_p4wq_work *item)
+{
+	struct k_p4wq_ws_worker *w;
+	bool ret = false;
+
+	/* The item can be taken, and even resubmitted elsewhere,
+	 * until we hold the lock of the deque it is on
+	 */
+	while (!ret && ((w = item->ws_worker) != NULL)) {
+		k_spinlock_key_t k = k_spin_lock(&w->lock);
+
+		if (item->ws_worker == w) {
+			sys_dlist_remove(&item->dlnode);
+			item->ws_worker = NULL;
+			atomic_dec(&pool->queued);
+			ret = true;
+		}
+
+		k_spin_unlock(&w->lock, k);
+	}
+
+	if (ret) {
+		complete(item->ws_join);
+	}
+	return ret;
+}
+
+void k_p4wq_ws_join_init(struct k_p4wq_ws_join *join)
+{
+	/* The joiner holds a reference of its own until it waits */
+	atomic_set(&join->pending, 1);
+	k_sem_init(&join->done, 0, 1);
+}
+
+void k_p4wq_ws_fork(struct k_p4wq_ws *pool, struct k_p4wq_ws_join *join,
+		    struct k_p4wq_work *item)
+{
+	atomic_inc(&join->pending);
+	item->ws_join = join;
+	submit(pool, item);
+}
+
+void k_p4wq_ws_join(struct k_p4wq_ws *pool, struct k_p4wq_ws_join *join)
+{
+	struct k_p4wq_ws_worker *self = current_worker(pool);
+
+	/* A worker must not just block: the items it waits for may
+	 * be sitting in its own deque
+	 */
+	if (self != NULL) {
+		while (atomic_get(&join->pending) > 1) {
+			struct k_p4wq_work *item = find_work(pool, self);
+
+			if (item == NULL) {
+				break;
+			}
+			run(item);
+		}
+	}
+
+	/* Drop our own reference.  If items are still running, the
+	 * last one to complete signals us.
+	 */
+	if (atomic_dec(&join->pending) != 1) {
+		k_sem_take(&join->done, K_FOREVER);
+	}
+
+	atomic_set(&join->pending, 1);
+}
@@ -64,9 +64,9 @@ static void set_color(struct rbnode *n, enum rb_color color)
 {
 	CHECK(n);
 
-	uintptr_t *p = (void *) &n->children[0];
+	uintptr_t p = (uintptr_t) n->children[0];
 
-	*p = (*p & ~1UL) | (uint8_t)color;
+	n->children[0] = (void *) ((p & ~1UL) | (uint8_t)color);
 }
 
 /* Searches the tree down to a node that is either identical with the
@@ -221,6 +221,8 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 	if (tree->root == NULL) {
 		tree->root = node;
 		tree->max_depth = 1;
+		tree->minmax[0] = node;
+		tree->minmax[1] = node;
 		set_color(node, BLACK);
 		return;
 	}
@@ -240,6 +242,11 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 	set_child(parent, side, node);
 	set_color(node, RED);
 
+	/* A new extreme can only hang below the previous one */
+	if (parent == tree->minmax[side]) {
+		tree->minmax[side] = node;
+	}
+
 	stack[stacksz++] = node;
 	fix_extra_red(stack, stacksz);
 
@@ -377,6 +384,20 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 		return;
 	}
 
+	/* An extreme has at most one child, on the inner side (which is
+	 * then its neighbor, as that child must be a red leaf), or else
+	 * its neighbor is its parent.
+	 */
+	for (int side = 0; side < 2; side++) {
+		if (node == tree->minmax[side]) {
+			tmp = get_child(node, side == 0 ? 1 : 0);
+			if (tmp == NULL && stacksz > 1) {
+				tmp = stack[stacksz - 2];
+			}
+			tree->minmax[side] = tmp;
+		}
+	}
+
 	/* We can only remove a node with zero or one child, if we
 	 * have two then pick the "biggest" child of side 0 (smallest
 	 * of 1 would work too) and swap our spot in the tree with
@@ -493,16 +514,101 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 	tree->root = stack[0];
 }
 
-#ifndef CONFIG_MISRA_SANE
+/* Morris traversal: before descending into the left subtree of a
+ * node, the right pointer of its predecessor (which is always NULL) is
+ * pointed back at the node.  Reaching the node again through that
+ * thread means its left subtree is done, so the thread is removed and
+ * the walk goes on to the right.  Only the right pointers are touched,
+ * so the color bits are left alone.
+ */
 void z_rb_walk(struct rbnode *node, rb_visit_t visit_fn, void *cookie)
 {
-	if (node != NULL) {
-		z_rb_walk(get_child(node, 0), visit_fn, cookie);
-		visit_fn(node, cookie);
-		z_rb_walk(get_child(node, 1), visit_fn, cookie);
+	struct rbnode *pred;
+
+	while (node != NULL) {
+		pred = get_child(node, 0);
+		if (pred == NULL) {
+			visit_fn(node, cookie);
+			node = get_child(node, 1);
+			continue;
+		}
+
+		while (get_child(pred, 1) != NULL &&
+		       get_child(pred, 1) != node) {
+			pred = get_child(pred, 1);
+		}
+
+		if (get_child(pred, 1) == NULL) {
+			set_child(pred, 1, node);
+			node = get_child(node, 0);
+		} else {
+			set_child(pred, 1, NULL);
+			visit_fn(node, cookie);
+			node = get_child(node, 1);
+		}
 	}
 }
-#endif
+
+/* Moves "count" nodes of the right-leaning chain (vine) below "root"
+ * to the left, one every other node, so that each becomes the left
+ * child of its former successor.
+ */
+static void compress(struct rbnode *root, size_t count, bool leaves)
+{
+	struct rbnode *scanner = root;
+
+	for (size_t i = 0; i < count; i++) {
+		struct rbnode *child = get_child(scanner, 1);
+
+		set_child(scanner, 1, get_child(child, 1));
+		scanner = get_child(scanner, 1);
+		set_child(child, 1, get_child(scanner, 0));
+		set_child(scanner, 0, child);
+		if (leaves) {
+			set_color(child, RED);
+		}
+	}
+}
+
+/* Day-Stout-Warren: the sorted nodes are chained into a vine, which
+ * is then folded into a complete tree by compressions.  All its
+ * levels are full except for the bottom one, whose nodes are colored
+ * red and all others black.  Iterative, and only needs one dummy node
+ * of memory.
+ */
+void rb_build(struct rbtree *tree, struct rbnode **nodes, size_t count)
+{
+	struct rbnode pseudo_root = { 0 };
+	size_t full = 1;
+	int depth = 0;
+
+	set_child(&pseudo_root, 1, count > 0 ? nodes[0] : NULL);
+	for (size_t i = 0; i < count; i++) {
+		set_child(nodes[i], 0, NULL);
+		set_color(nodes[i], BLACK);
+		set_child(nodes[i], 1, i + 1 < count ? nodes[i + 1] : NULL);
+	}
+
+	/* Number of nodes of the largest perfect tree that fits */
+	while (full * 2 + 1 <= count) {
+		full = full * 2 + 1;
+		depth++;
+	}
+
+	if (count > full) {
+		compress(&pseudo_root, count - full, true);
+		depth++;
+	}
+
+	for (size_t n = full; n > 1; n /= 2) {
+		compress(&pseudo_root, n / 2, false);
+	}
+
+	tree->root = get_child(&pseudo_root, 1);
+	tree->max_depth = count > 0 ? depth + 1 : 0;
+	tree->minmax[0] = count > 0 ? nodes[0] : NULL;
+	tree->minmax[1] = count > 0 ? nodes[count - 1] : NULL;
+}
 
 struct rbnode *z_rb_child(struct rbnode *node, int side)
 {
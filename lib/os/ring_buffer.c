@@ -37,14 +37,16 @@ static uint32_t mod(struct ring_buf *buf, uint32_t val)
 }
 
 /* Check if indexes did not progress too far (too close to 32-bit wrapping).
- * If so, then reduce all indexes by an arbitrary value.
+ * If so, then reduce all indexes by an arbitrary value.  Indexes of power of
+ * 2 sized buffers are used modulo the size, which divides 2^32, so they can
+ * wrap freely.
  */
 static void item_indexes_rewind(struct ring_buf *buf)
 {
 	uint32_t rewind;
 	uint32_t threshold = ring_buf_get_rewind_threshold();
 
-	if (buf->head < threshold) {
+	if (likely(buf->mask) || buf->head < threshold) {
 		return;
 	}
 
@@ -59,7 +61,8 @@ static void item_indexes_rewind(struct ring_buf *buf)
 
 /* Check if indexes did not progresses too far (too close to 32-bit wrapping).
  * If so, then rewind all indexes by an arbitrary value. For byte mode temporary
- * indexes must also be reduced.
+ * indexes must also be reduced.  As in item mode, there is nothing to do for
+ * power of 2 sized buffers.
  */
 static void byte_indexes_rewind(struct ring_buf *buf)
 {
@@ -67,7 +70,7 @@ static void byte_indexes_rewind(struct ring_buf *buf)
 	uint32_t threshold = ring_buf_get_rewind_threshold();
 
 	/* Checking head since it is the smallest index. */
-	if (buf->head < threshold) {
+	if (likely(buf->mask) || buf->head < threshold) {
 		return;
 	}
 
@@ -195,7 +198,8 @@ uint32_t ring_buf_put_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 
 int ring_buf_put_finish(struct ring_buf *buf, uint32_t size)
 {
-	if ((buf->tail + size) > (buf->head + buf->size)) {
+	/* Differences of indexes stay valid when they wrap */
+	if (size > (buf->head + buf->size) - buf->tail) {
 		return -EINVAL;
 	}
 
@@ -248,7 +252,7 @@ uint32_t ring_buf_get_claim(struct ring_buf *buf, uint8_t **data, uint32_t size)
 
 int ring_buf_get_finish(struct ring_buf *buf, uint32_t size)
 {
-	if ((buf->head + size) > buf->tail) {
+	if (size > buf->tail - buf->head) {
 		return -EINVAL;
 	}
 
@@ -280,3 +284,146 @@ uint32_t ring_buf_get(struct ring_buf *buf, uint8_t *data, uint32_t size)
 
 	return total_size;
 }
+
+/* Records of multi-producer ring buffers start with a header word holding
+ * the size of the data in bytes, or for padding up to the end of the buffer,
+ * the number of words to skip with the padding flag set.
+ *
+ * Producers claim space by advancing the tail with a CAS, fill the record,
+ * and then set the bit of its header in the committed bitmap.  The consumer
+ * only reads a record once that bit is set, and clears it before freeing the
+ * record by advancing the head.  So a bit is only set on a header written in
+ * the current lap, whatever the words that were there before held.
+ */
+#define MPSC_PADDING BIT(31)
+
+static inline uint32_t mpsc_record_words(uint32_t size)
+{
+	return 1U + ceiling_fraction(size, sizeof(uint32_t));
+}
+
+int ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, uint8_t **data,
+			    uint32_t size)
+{
+	uint32_t words = mpsc_record_words(size);
+	uint32_t head, tail, offset, padding, used;
+
+	if (size >= MPSC_PADDING || words > buf->mask + 1U) {
+		atomic_inc(&buf->dropped_put_count);
+		return -EMSGSIZE;
+	}
+
+	do {
+		/* The head is read first: it never passes the tail, so
+		 * the tail read after it can't be behind it
+		 */
+		head = (uint32_t)atomic_get(&buf->head);
+		tail = (uint32_t)atomic_get(&buf->tail);
+		offset = tail & buf->mask;
+		padding = (offset + words > buf->mask + 1U) ?
+			  buf->mask + 1U - offset : 0U;
+
+		used = tail - head;
+		if (used + padding + words > buf->mask + 1U) {
+			atomic_inc(&buf->dropped_put_count);
+			return -EMSGSIZE;
+		}
+	} while (!atomic_cas(&buf->tail, tail, tail + padding + words));
+
+	if (padding != 0U) {
+		buf->buf32[offset] = MPSC_PADDING | padding;
+		atomic_set_bit(buf->committed, offset);
+		offset = 0U;
+	}
+
+	buf->buf32[offset] = size;
+	*data = (uint8_t *)&buf->buf32[offset + 1U];
+
+	return 0;
+}
+
+void ring_buf_mpsc_put_finish(struct ring_buf_mpsc *buf, uint8_t *data)
+{
+	uint32_t offset = (uint32_t *)data - buf->buf32 - 1U;
+
+	__ASSERT_NO_MSG(offset <= buf->mask);
+
+	/* The atomic operation orders the writes to the record before it */
+	atomic_set_bit(buf->committed, offset);
+}
+
+int ring_buf_mpsc_put(struct ring_buf_mpsc *buf, const uint8_t *data,
+		      uint32_t size)
+{
+	uint8_t *dst;
+	int err;
+
+	err = ring_buf_mpsc_put_claim(buf, &dst, size);
+	if (err == 0) {
+		memcpy(dst, data, size);
+		ring_buf_mpsc_put_finish(buf, dst);
+	}
+
+	return err;
+}
+
+int ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, uint8_t **data)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t offset = head & buf->mask;
+	uint32_t header;
+
+	if (!atomic_test_bit(buf->committed, offset)) {
+		return -EAGAIN;
+	}
+
+	header = buf->buf32[offset];
+	if (header & MPSC_PADDING) {
+		/* Skip the padding, the record follows at the start */
+		atomic_clear_bit(buf->committed, offset);
+		head += header & ~MPSC_PADDING;
+		atomic_set(&buf->head, head);
+
+		if (!atomic_test_bit(buf->committed, 0)) {
+			return -EAGAIN;
+		}
+
+		offset = 0U;
+		header = buf->buf32[0];
+	}
+
+	*data = (uint8_t *)&buf->buf32[offset + 1U];
+
+	return (int)header;
+}
+
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t offset = head & buf->mask;
+
+	__ASSERT(atomic_test_bit(buf->committed, offset), "no record claimed");
+
+	atomic_clear_bit(buf->committed, offset);
+	atomic_set(&buf->head, head + mpsc_record_words(buf->buf32[offset]));
+}
+
+int ring_buf_mpsc_get(struct ring_buf_mpsc *buf, uint8_t *data, uint32_t size)
+{
+	uint8_t *src;
+	int len;
+
+	len = ring_buf_mpsc_get_claim(buf, &src);
+	if (len < 0) {
+		return len;
+	}
+
+	if ((uint32_t)len > size) {
+		return -EMSGSIZE;
+	}
+
+	memcpy(data, src, len);
+	ring_buf_mpsc_get_finish(buf);
+
+	return len;
+}
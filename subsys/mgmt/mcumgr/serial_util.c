@@ -155,23 +155,12 @@ struct net_buf *mcumgr_serial_process_frag(
 	return nb;
 }
 
-/**
- * Base64-encodes a small chunk of data and transmits it.  The data must be no
- * larger than three bytes.
+/* Data bytes of a frame: the frame is made of the 2 byte header and of
+ * the base64 encoding of its data, the last group of which may overflow
+ * MCUMGR_SERIAL_MAX_FRAME - 4 by up to 8 characters.
  */
-static int mcumgr_serial_tx_small(const void *data, int len,
-				  mcumgr_serial_tx_cb cb, void *arg)
-{
-	uint8_t b64[4 + 1]; /* +1 required for null terminator. */
-	size_t dst_len;
-	int rc;
-
-	rc = base64_encode(b64, sizeof(b64), &dst_len, data, len);
-	__ASSERT_NO_MSG(rc == 0);
-	__ASSERT_NO_MSG(dst_len == 4);
-
-	return cb(b64, 4, arg);
-}
+#define MCUMGR_SERIAL_MAX_FRAME_RAW \
+	(((MCUMGR_SERIAL_MAX_FRAME - 2) / 4 + 2) * 3)
 
 /**
  * @brief Transmits a single mcumgr frame over serial.
@@ -194,8 +183,12 @@ int mcumgr_serial_tx_frame(const uint8_t *data, bool first, int len,
 			   uint16_t crc, mcumgr_serial_tx_cb cb, void *arg,
 			   int *out_data_bytes_txed)
 {
-	uint8_t raw[3];
+	/* The frame data is gathered and then encoded in one go. */
+	uint8_t raw[MCUMGR_SERIAL_MAX_FRAME_RAW];
+	uint8_t b64[MCUMGR_SERIAL_MAX_FRAME_RAW / 3 * 4 + 1];
+	size_t b64_len;
 	uint16_t u16;
+	int raw_len;
 	int dst_off;
 	int src_off;
 	int rem;
@@ -203,6 +196,7 @@ int mcumgr_serial_tx_frame(const uint8_t *data, bool first, int len,
 
 	src_off = 0;
 	dst_off = 0;
+	raw_len = 0;
 
 	if (first) {
 		u16 = sys_cpu_to_be16(MCUMGR_SERIAL_HDR_PKT);
@@ -218,14 +212,9 @@ int mcumgr_serial_tx_frame(const uint8_t *data, bool first, int len,
 
 	/* Only the first fragment contains the packet length. */
 	if (first) {
-		u16 = sys_cpu_to_be16(len);
-		memcpy(raw, &u16, sizeof(u16));
+		sys_put_be16(len, raw);
 		raw[2] = data[0];
-
-		rc = mcumgr_serial_tx_small(raw, 3, cb, arg);
-		if (rc != 0) {
-			return rc;
-		}
+		raw_len = 3;
 
 		src_off++;
 		dst_off += 4;
@@ -241,58 +230,31 @@ int mcumgr_serial_tx_frame(const uint8_t *data, bool first, int len,
 		 * and send the CRC.
 		 */
 		rem = len - src_off;
-		if (rem == 0) {
-			raw[0] = (crc & 0xff00) >> 8;
-			raw[1] = crc & 0x00ff;
-			rc = mcumgr_serial_tx_small(raw, 2, cb, arg);
-			if (rc != 0) {
-				return rc;
-			}
-			break;
-		}
+		if (rem <= 2) {
+			memcpy(&raw[raw_len], data + src_off, rem);
+			raw_len += rem;
+			src_off += rem;
 
-		if (rem == 1) {
-			raw[0] = data[src_off];
-			src_off++;
-
-			raw[1] = (crc & 0xff00) >> 8;
-			raw[2] = crc & 0x00ff;
-			rc = mcumgr_serial_tx_small(raw, 3, cb, arg);
-			if (rc != 0) {
-				return rc;
-			}
-			break;
-		}
-
-		if (rem == 2) {
-			raw[0] = data[src_off];
-			raw[1] = data[src_off + 1];
-			src_off += 2;
-
-			raw[2] = (crc & 0xff00) >> 8;
-			rc = mcumgr_serial_tx_small(raw, 3, cb, arg);
-			if (rc != 0) {
-				return rc;
-			}
-
-			raw[0] = crc & 0x00ff;
-			rc = mcumgr_serial_tx_small(raw, 1, cb, arg);
-			if (rc != 0) {
-				return rc;
-			}
+			sys_put_be16(crc, &raw[raw_len]);
+			raw_len += 2;
 			break;
 		}
 
 		/* Otherwise, just encode payload data. */
-		memcpy(raw, data + src_off, 3);
-		rc = mcumgr_serial_tx_small(raw, 3, cb, arg);
-		if (rc != 0) {
-			return rc;
-		}
+		memcpy(&raw[raw_len], data + src_off, 3);
+		raw_len += 3;
 		src_off += 3;
 		dst_off += 4;
 	}
 
+	rc = base64_encode(b64, sizeof(b64), &b64_len, raw, raw_len);
+	__ASSERT_NO_MSG(rc == 0);
+
+	rc = cb(b64, b64_len, arg);
+	if (rc != 0) {
+		return rc;
+	}
+
 	rc = cb("\n", 1, arg);
 	if (rc != 0) {
 		return rc;
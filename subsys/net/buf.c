@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <stddef.h>
 #include <string.h>
 #include <sys/byteorder.h>
+#include <sys/base64.h>
 
 #include <net/buf.h>
 
@@ -726,6 +727,33 @@ size_t net_buf_linearize(void *dst, size_t dst_len, struct net_buf *src,
 	return copied;
 }
 
+/* Adds a fragment for len more bytes at the end of buf */
+static struct net_buf *append_frag(struct net_buf *buf, size_t len,
+				   k_timeout_t timeout,
+				   net_buf_allocator_cb allocate_cb,
+				   void *user_data)
+{
+	struct net_buf *frag;
+
+	if (allocate_cb) {
+		frag = allocate_cb(timeout, user_data);
+	} else {
+		struct net_buf_pool *pool;
+
+		/* Allocate from the original pool if no callback has
+		 * been provided.
+		 */
+		pool = net_buf_pool_get(buf->pool_id);
+		frag = net_buf_alloc_len(pool, len, timeout);
+	}
+
+	if (frag) {
+		net_buf_frag_add(buf, frag);
+	}
+
+	return frag;
+}
+
 /* This helper routine will append multiple bytes, if there is no place for
  * the data in current fragment then create new fragment and add it to
  * the buffer. It assumes that the buffer has at least one fragment.
@@ -750,28 +778,85 @@ size_t net_buf_append_bytes(struct net_buf *buf, size_t len,
 			return added_len;
 		}
 
-		if (allocate_cb) {
-			frag = allocate_cb(timeout, user_data);
-		} else {
-			struct net_buf_pool *pool;
+		frag = append_frag(buf, len, timeout, allocate_cb, user_data);
+		if (!frag) {
+			return added_len;
+		}
+	} while (1);
+
+	/* Unreachable */
+	return 0;
+}
 
-			/* Allocate from the original pool if no callback has
-			 * been provided.
-			 */
-			pool = net_buf_pool_get(buf->pool_id);
-			frag = net_buf_alloc_len(pool, len, timeout);
+#if defined(CONFIG_BASE64)
+size_t net_buf_append_base64(struct net_buf *buf, struct base64_encoder *enc,
+			     size_t len, const void *value,
+			     k_timeout_t timeout,
+			     net_buf_allocator_cb allocate_cb, void *user_data)
+{
+	struct net_buf *frag = net_buf_frag_last(buf);
+	const uint8_t *value8 = value;
+	size_t added_len = 0;
+
+	do {
+		size_t room = net_buf_tailroom(frag);
+		struct net_buf *next;
+		uint8_t group[4];
+		size_t count, olen;
+
+		count = base64_encode_update(enc, net_buf_tail(frag), room,
+					     &olen, value8, len);
+		net_buf_add(frag, olen);
+		len -= count;
+		added_len += count;
+		value8 += count;
+
+		if (len == 0) {
+			return added_len;
 		}
 
-		if (!frag) {
+		/* The fragment is full, up to a partial group */
+		next = append_frag(buf, (len + 2) / 3 * 4, timeout,
+				   allocate_cb, user_data);
+		if (!next) {
 			return added_len;
 		}
 
-		net_buf_frag_add(buf, frag);
-	} while (1);
+		room -= olen;
+		if (room > 0) {
+			count = base64_encode_update(enc, group, sizeof(group),
+						     &olen, value8, len);
+			net_buf_add_mem(frag, group, room);
+			net_buf_add_mem(next, &group[room], olen - room);
+			len -= count;
+			added_len += count;
+			value8 += count;
+		}
+
+		frag = next;
+	} while (len > 0);
+
+	return added_len;
+}
+
+int net_buf_append_base64_finish(struct net_buf *buf,
+				 struct base64_encoder *enc,
+				 k_timeout_t timeout,
+				 net_buf_allocator_cb allocate_cb,
+				 void *user_data)
+{
+	uint8_t group[4];
+	size_t olen;
+
+	(void)base64_encode_finish(enc, group, sizeof(group), &olen);
+	if (net_buf_append_bytes(buf, olen, group, timeout, allocate_cb,
+				 user_data) != olen) {
+		return -ENOMEM;
+	}
 
-	/* Unreachable */
 	return 0;
 }
+#endif /* CONFIG_BASE64 */
 
 #if defined(CONFIG_NET_BUF_SIMPLE_LOG)
 #define NET_BUF_SIMPLE_DBG(fmt, ...) NET_BUF_DBG(fmt, ##__VA_ARGS__)
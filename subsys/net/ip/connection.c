@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #include <errno.h>
 #include <sys/util.h>
+#include <sys/hashmap.h>
 
 #include <net/net_core.h>
 #include <net/net_pkt.h>
@@ -59,6 +60,31 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* Lookup tables of the used UDP and TCP connections, by local port and,
+ * for those with a remote end point, by remote address and port. The
+ * connections without a local port, or of other protocols, are kept in
+ * conn_other. Like conn_used, all these lists have the latest registered
+ * connection first.
+ */
+static sys_slist_t conn_bound[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_connected[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_other;
+
+/* Number of connections in conn_connected */
+static int conn_connected_count;
+
+/* Registration counter */
+static uint32_t conn_seq;
+
+/* Connections to match a packet against, in registration order, from
+ * up to three lookup lists.
+ */
+struct conn_iter {
+	sys_snode_t *next[3];
+	/* Walk all the used connections instead */
+	bool all;
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -113,6 +139,90 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+static uint32_t conn_hash_port(uint16_t proto, uint16_t local_port)
+{
+	return sys_hash32_u32(((uint32_t)proto << 16) | local_port);
+}
+
+static uint32_t conn_hash_remote(uint32_t hash, sa_family_t family,
+				 const void *addr, uint16_t remote_port)
+{
+	const uint8_t *p = addr;
+	size_t len = (family == AF_INET6) ? sizeof(struct in6_addr) :
+					    sizeof(struct in_addr);
+
+	hash ^= remote_port;
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = sys_hash32_u32(hash ^
+				      UNALIGNED_GET((const uint32_t *)&p[i]));
+	}
+
+	return hash;
+}
+
+static bool conn_addr_is_specified(const struct sockaddr *addr)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		return !net_ipv6_is_addr_unspecified(
+						&net_sin6(addr)->sin6_addr);
+	}
+
+	return net_sin(addr)->sin_addr.s_addr != 0U;
+}
+
+/* Lookup list of the connections with these end points, ports in
+ * network byte order.
+ */
+static sys_slist_t *conn_index_list(uint16_t proto, uint8_t family,
+				    const struct sockaddr *remote_addr,
+				    uint16_t remote_port,
+				    uint16_t local_port)
+{
+	uint32_t hash;
+
+	if ((proto != IPPROTO_UDP && proto != IPPROTO_TCP) ||
+	    (family != AF_INET && family != AF_INET6 && family != AF_UNSPEC) ||
+	    local_port == 0U) {
+		return &conn_other;
+	}
+
+	hash = conn_hash_port(proto, local_port);
+
+	if (remote_addr == NULL || remote_port == 0U ||
+	    (remote_addr->sa_family != AF_INET &&
+	     remote_addr->sa_family != AF_INET6) ||
+	    !conn_addr_is_specified(remote_addr)) {
+		return &conn_bound[hash % CONFIG_NET_CONN_HASH_SIZE];
+	}
+
+	if (remote_addr->sa_family == AF_INET6) {
+		hash = conn_hash_remote(hash, AF_INET6,
+					&net_sin6(remote_addr)->sin6_addr,
+					remote_port);
+	} else {
+		hash = conn_hash_remote(hash, AF_INET,
+					&net_sin(remote_addr)->sin_addr,
+					remote_port);
+	}
+
+	return &conn_connected[hash % CONFIG_NET_CONN_HASH_SIZE];
+}
+
+static sys_slist_t *conn_list(struct net_conn *conn)
+{
+	return conn_index_list(conn->proto, conn->family,
+			       (conn->flags & NET_CONN_REMOTE_ADDR_SET) ?
+			       &conn->remote_addr : NULL,
+			       net_sin(&conn->remote_addr)->sin_port,
+			       net_sin(&conn->local_addr)->sin_port);
+}
+
+static bool conn_list_is_connected(sys_slist_t *list)
+{
+	return list >= conn_connected &&
+	       list < conn_connected + ARRAY_SIZE(conn_connected);
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -129,9 +239,17 @@ static struct net_conn *conn_get_unused(void)
 
 static void conn_set_used(struct net_conn *conn)
 {
+	sys_slist_t *list = conn_list(conn);
+
 	conn->flags |= NET_CONN_IN_USE;
+	conn->seq = ++conn_seq;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(list, &conn->hash_node);
+
+	if (conn_list_is_connected(list)) {
+		conn_connected_count++;
+	}
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -148,10 +266,13 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t remote_port,
 					  uint16_t local_port)
 {
+	sys_slist_t *list = conn_index_list(proto, family, remote_addr,
+					    htons(remote_port),
+					    htons(local_port));
 	struct net_conn *conn;
-	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	/* An identical handler would be in the same lookup list */
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -366,6 +487,7 @@ error:
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	sys_slist_t *list;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
 		return -EINVAL;
@@ -377,7 +499,13 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	NET_DBG("Connection handler %p removed", conn);
 
+	list = conn_list(conn);
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(list, &conn->hash_node);
+
+	if (conn_list_is_connected(list)) {
+		conn_connected_count--;
+	}
 
 	conn_set_unused(conn);
 
@@ -544,6 +672,102 @@ static enum net_verdict conn_raw_socket(struct net_pkt *pkt,
 	return NET_CONTINUE;
 }
 
+/* A unicast UDP or TCP packet can only match the connections bound to
+ * its destination port, those connected from its source, and the ones
+ * without a local port. Any other packet is matched against all of the
+ * connections, as is a multicast one, which goes to all that match.
+ */
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, uint8_t proto,
+			   uint16_t src_port, uint16_t dst_port,
+			   bool is_mcast_pkt)
+{
+	sa_family_t family = net_pkt_family(pkt);
+	uint32_t hash;
+
+	iter->next[1] = NULL;
+	iter->next[2] = NULL;
+
+	if ((proto != IPPROTO_UDP && proto != IPPROTO_TCP) || is_mcast_pkt ||
+	    (family != AF_INET && family != AF_INET6)) {
+		iter->all = true;
+		iter->next[0] = sys_slist_peek_head(&conn_used);
+		return;
+	}
+
+	iter->all = false;
+
+	hash = conn_hash_port(proto, dst_port);
+	iter->next[0] = sys_slist_peek_head(
+				&conn_bound[hash % CONFIG_NET_CONN_HASH_SIZE]);
+	iter->next[2] = sys_slist_peek_head(&conn_other);
+
+	if (conn_connected_count == 0) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		hash = conn_hash_remote(hash, AF_INET6, &ip_hdr->ipv6->src,
+					src_port);
+	} else {
+		hash = conn_hash_remote(hash, AF_INET, &ip_hdr->ipv4->src,
+					src_port);
+	}
+
+	iter->next[1] = sys_slist_peek_head(
+			&conn_connected[hash % CONFIG_NET_CONN_HASH_SIZE]);
+}
+
+/* Latest registered connection of the lookup lists not returned yet */
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn = NULL;
+	int from = 0;
+
+	if (iter->all) {
+		if (iter->next[0] == NULL) {
+			return NULL;
+		}
+
+		conn = CONTAINER_OF(iter->next[0], struct net_conn, node);
+		iter->next[0] = sys_slist_peek_next(iter->next[0]);
+
+		return conn;
+	}
+
+	/* Usually a single list is left */
+	if (iter->next[1] == NULL && iter->next[2] == NULL) {
+		if (iter->next[0] == NULL) {
+			return NULL;
+		}
+
+		conn = CONTAINER_OF(iter->next[0], struct net_conn, hash_node);
+		iter->next[0] = sys_slist_peek_next(iter->next[0]);
+
+		return conn;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(iter->next); i++) {
+		struct net_conn *c;
+
+		if (iter->next[i] == NULL) {
+			continue;
+		}
+
+		c = CONTAINER_OF(iter->next[i], struct net_conn, hash_node);
+		if (conn == NULL || (int32_t)(c->seq - conn->seq) > 0) {
+			conn = c;
+			from = i;
+		}
+	}
+
+	if (conn != NULL) {
+		iter->next[from] = sys_slist_peek_next(iter->next[from]);
+	}
+
+	return conn;
+}
+
 enum net_verdict net_conn_input(struct net_pkt *pkt,
 				union net_ip_header *ip_hdr,
 				uint8_t proto,
@@ -556,6 +780,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -621,7 +846,10 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&iter, pkt, ip_hdr, proto, src_port, dst_port,
+		       is_mcast_pkt);
+
+	while ((conn = conn_iter_next(&iter)) != NULL) {
 		/* For packet socket data, the proto is set to ETH_P_ALL but
 		 * the listener might have a specific protocol set. This is ok
 		 * and let the packet pass this check in this case.
@@ -834,6 +1062,12 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_other);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_bound[i]);
+		sys_slist_init(&conn_connected[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -50,6 +50,12 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Internal slist node, for the lookup tables */
+	sys_snode_t hash_node;
+
+	/** Registration order, the latest registered being the highest */
+	uint32_t seq;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -1800,6 +1800,116 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+	size_t len = net_buf_frags_len(frags);
+	struct net_buf *last = NULL;
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!net_context_is_used(context)) {
+		ret = -EBADF;
+		goto drop;
+	}
+
+	if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+	    !net_sin(&context->remote)->sin_port) {
+		ret = -EDESTADDRREQ;
+		goto drop;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
+		ret = -EOPNOTSUPP;
+		goto drop;
+	}
+
+	context->send_cb = cb;
+	context->user_data = user_data;
+
+	if (IS_ENABLED(CONFIG_NET_UDP) &&
+	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
+		/* Room for the headers only, the data follows them */
+		pkt = context_alloc_pkt(context, 0, PKT_WAIT_TIME);
+		if (!pkt) {
+			ret = -ENOBUFS;
+			goto unlock;
+		}
+
+		ret = context_setup_udp_packet(context, pkt, NULL, 0, NULL,
+					       &context->remote,
+					       sizeof(context->remote));
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			goto drop;
+		}
+
+		last = net_buf_frag_last(pkt->buffer);
+		net_pkt_append_buffer(pkt, frags);
+
+		context_finalize_packet(context, pkt);
+
+		ret = net_send_data(pkt);
+		if (ret < 0) {
+			if (ret == -ENOBUFS) {
+				last->frags = NULL;
+			}
+
+			net_pkt_unref(pkt);
+			goto unlock;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_TCP2) &&
+		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		/* The connection queues the data buffers as they are */
+		pkt = net_pkt_alloc(PKT_WAIT_TIME);
+		if (!pkt) {
+			ret = -ENOBUFS;
+			goto unlock;
+		}
+
+		net_pkt_set_context(pkt, context);
+		net_pkt_append_buffer(pkt, frags);
+
+		ret = net_tcp_queue_data(context, pkt);
+		if (ret < 0) {
+			/* The buffers are back in the packet if the
+			 * connection did not keep them.
+			 */
+			if (ret == -EAGAIN || ret == -ENOBUFS) {
+				pkt->buffer = NULL;
+			}
+
+			net_pkt_unref(pkt);
+			goto unlock;
+		}
+
+		ret = net_tcp_send_data(context, cb, user_data);
+		if (ret < 0) {
+			goto unlock;
+		}
+	} else {
+		ret = -EPROTONOSUPPORT;
+		goto drop;
+	}
+
+	k_mutex_unlock(&context->lock);
+
+	return len;
+
+drop:
+	net_buf_unref(frags);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
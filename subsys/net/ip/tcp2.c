@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include <stdlib.h>
 #include <zephyr.h>
 #include <random/rand32.h>
+#include <sys/hashmap.h>
 #include <net/net_pkt.h>
 #include <net/net_context.h>
 #include <net/udp.h>
@@ -30,11 +31,21 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
 static int tcp_window = NET_IPV6_MTU;
+static const struct tcp_cc_ops *tcp_cc =
+	IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CUBIC) ? &tcp_cc_cubic :
+						      &tcp_cc_newreno;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
 static K_MUTEX_DEFINE(tcp_lock);
 
+/* Connections with their end points set, hashed by them, oldest first.
+ * The table has its own lock, so that the lookup of the connection of
+ * a received segment does not wait for tcp_lock.
+ */
+static sys_slist_t tcp_conn_table[CONFIG_NET_CONN_HASH_SIZE];
+static struct k_spinlock tcp_conn_table_lock;
+
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
@@ -345,6 +356,48 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
+/* Lookup list of the connections with these end points */
+static sys_slist_t *tcp_conn_table_list(const union tcp_endpoint *local,
+					const union tcp_endpoint *remote)
+{
+	bool ipv6 = remote->sa.sa_family == AF_INET6;
+	const uint32_t *addr = ipv6 ?
+			       (const uint32_t *)&remote->sin6.sin6_addr :
+			       (const uint32_t *)&remote->sin.sin_addr;
+	size_t words = ipv6 ? sizeof(struct in6_addr) / sizeof(uint32_t) : 1;
+	uint32_t hash;
+
+	hash = sys_hash32_u32(((uint32_t)local->sin.sin_port << 16) |
+			      remote->sin.sin_port);
+
+	for (size_t i = 0; i < words; i++) {
+		hash = sys_hash32_u32(hash ^ UNALIGNED_GET(&addr[i]));
+	}
+
+	return &tcp_conn_table[hash % CONFIG_NET_CONN_HASH_SIZE];
+}
+
+/* Makes the connection found by tcp_conn_search(), once its end points
+ * are set
+ */
+static void tcp_conn_table_add(struct tcp *conn)
+{
+	sys_slist_t *list = tcp_conn_table_list(&conn->src, &conn->dst);
+	k_spinlock_key_t key = k_spin_lock(&tcp_conn_table_lock);
+
+	sys_slist_append(list, &conn->hash_node);
+	k_spin_unlock(&tcp_conn_table_lock, key);
+}
+
+static void tcp_conn_table_remove(struct tcp *conn)
+{
+	sys_slist_t *list = tcp_conn_table_list(&conn->src, &conn->dst);
+	k_spinlock_key_t key = k_spin_lock(&tcp_conn_table_lock);
+
+	(void)sys_slist_find_and_remove(list, &conn->hash_node);
+	k_spin_unlock(&tcp_conn_table_lock, key);
+}
+
 static int tcp_conn_unref(struct tcp *conn)
 {
 	int ref_count = atomic_get(&conn->ref_count);
@@ -406,6 +459,7 @@ static int tcp_conn_unref(struct tcp *conn)
 	k_delayed_work_cancel(&conn->timewait_timer);
 	k_delayed_work_cancel(&conn->fin_timer);
 
+	tcp_conn_table_remove(conn);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
 
 	memset(conn, 0, sizeof(*conn));
@@ -594,9 +648,6 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
-
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
 
@@ -639,9 +690,37 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = MIN(options[2],
+						   TCP_MAX_WINDOW_SHIFT);
 			recv_options->wnd_found = true;
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_SACK:
+			if ((opt_len - 2) % sizeof(struct tcp_sack_block)) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_count < TCP_MAX_SACK_BLOCKS;
+			     i += sizeof(struct tcp_sack_block)) {
+				struct tcp_sack_block *block;
+
+				block = &recv_options->sack[
+					recv_options->sack_count++];
+				block->left = ntohl(UNALIGNED_GET(
+					(uint32_t *)(options + i)));
+				block->right = ntohl(UNALIGNED_GET(
+					(uint32_t *)(options + i + 4)));
+			}
+			break;
 		default:
 			continue;
 		}
@@ -736,8 +815,55 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Options of an outgoing segment: the window scale and SACK permitted
+ * options on SYN, the out-of-order data held on a pure ACK. Returns the
+ * length of the options, a multiple of 4.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags,
+				uint8_t *options)
+{
+	size_t len = 0;
+
+	if (flags & SYN) {
+		/* An active open offers, a passive one only answers */
+		bool offer = !(flags & ACK);
+
+		if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+		    (offer || conn->window_scale)) {
+			/* The receive window fits in 16 bits, no scaling */
+			options[len++] = TCPOPT_NOP;
+			options[len++] = TCPOPT_WINDOW;
+			options[len++] = 3U;
+			options[len++] = 0U;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_TCP_SACK) && (offer || conn->sack)) {
+			options[len++] = TCPOPT_NOP;
+			options[len++] = TCPOPT_NOP;
+			options[len++] = TCPOPT_SACK_PERM;
+			options[len++] = 2U;
+		}
+	} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT && flags == ACK &&
+		   conn->sack && !net_pkt_is_empty(conn->queue_recv_data)) {
+		uint32_t left = tcp_get_seq(conn->queue_recv_data->buffer);
+		uint32_t right = left + net_pkt_get_len(conn->queue_recv_data);
+
+		options[len++] = TCPOPT_NOP;
+		options[len++] = TCPOPT_NOP;
+		options[len++] = TCPOPT_SACK;
+		options[len++] = 2U + sizeof(struct tcp_sack_block);
+		UNALIGNED_PUT(htonl(left), (uint32_t *)&options[len]);
+		len += sizeof(uint32_t);
+		UNALIGNED_PUT(htonl(right), (uint32_t *)&options[len]);
+		len += sizeof(uint32_t);
+	}
+
+	return len;
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *options,
+			  size_t options_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
@@ -751,7 +877,7 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + options_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
 	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
@@ -760,7 +886,11 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	if (net_pkt_set_data(pkt, &tcp_access) < 0) {
+		return -ENOBUFS;
+	}
+
+	return options_len ? net_pkt_write(pkt, options, options_len) : 0;
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -783,33 +913,38 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	/* Room for the SYN options or one SACK block */
+	uint8_t options[4 + sizeof(struct tcp_sack_block)];
+	size_t options_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	options_len = tcp_options_build(conn, flags, options);
+
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + options_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
 	}
 
-	if (data) {
-		/* Append the data buffer to the pkt */
-		net_pkt_append_buffer(pkt, data->buffer);
-		data->buffer = NULL;
-	}
-
 	ret = ip_header_add(conn, pkt);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, options, options_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
 	}
 
+	if (data) {
+		/* Append the data buffer to the pkt */
+		net_pkt_append_buffer(pkt, data->buffer);
+		data->buffer = NULL;
+	}
+
 	ret = tcp_finalize_pkt(pkt);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
@@ -869,9 +1004,25 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* Data allowed in flight: the peer's window, within the congestion
+ * window of RFC 5681
+ */
+static uint32_t tcp_send_window(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cwnd == 0U) {
+		/* Initial window, RFC 6928 */
+		conn->cwnd = MIN(10U * mss, MAX(2U * mss, 14600U));
+		conn->ssthresh = UINT32_MAX;
+	}
+
+	return MIN(conn->send_win, conn->cwnd);
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !(conn->unacked_len < tcp_send_window(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -896,17 +1047,14 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Sends len bytes of the send_data at pos, without accounting them as
+ * in flight
+ */
+static int tcp_send_segment(struct tcp *conn, int pos, int len)
 {
 	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
@@ -921,7 +1069,28 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
+
+	/* The data we want to send, has been moved to the send queue so we
+	 * can unref the head net_pkt. If there was an error, we need to remove
+	 * the packet anyway.
+	 */
+	tcp_pkt_unref(pkt);
+
+ out:
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret;
+	int len;
+
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   (int)tcp_send_window(conn) - conn->unacked_len,
+		   conn_mss(conn));
+
+	ret = tcp_send_segment(conn, conn->unacked_len, len);
 	if (ret == 0) {
 		conn->unacked_len += len;
 
@@ -934,15 +1103,8 @@ static int tcp_send_data(struct tcp *conn)
 		}
 	}
 
-	/* The data we want to send, has been moved to the send queue so we
-	 * can unref the head net_pkt. If there was an error, we need to remove
-	 * the packet anyway.
-	 */
-	tcp_pkt_unref(pkt);
-
 	conn_send_data_dump(conn);
 
- out:
 	return ret;
 }
 
@@ -994,6 +1156,219 @@ static int tcp_send_queued_data(struct tcp *conn)
 	return ret;
 }
 
+/* Adds a block the peer holds to the scoreboard, merging the blocks it
+ * overlaps. With the scoreboard full, the highest block is forgotten,
+ * which at worst costs a needless retransmission.
+ */
+static void tcp_sacked_add(struct tcp *conn, uint32_t left, uint32_t right)
+{
+	struct tcp_sack_block *sacked = conn->sacked;
+	int i;
+
+	for (i = 0; i < conn->sacked_count &&
+	     net_tcp_seq_cmp(sacked[i].right, left) < 0; i++) {
+	}
+
+	if (i < conn->sacked_count &&
+	    net_tcp_seq_cmp(sacked[i].left, right) <= 0) {
+		if (net_tcp_seq_greater(sacked[i].left, left)) {
+			sacked[i].left = left;
+		}
+
+		if (net_tcp_seq_greater(right, sacked[i].right)) {
+			sacked[i].right = right;
+		}
+
+		while (i + 1 < conn->sacked_count &&
+		       net_tcp_seq_cmp(sacked[i + 1].left,
+				       sacked[i].right) <= 0) {
+			if (net_tcp_seq_greater(sacked[i + 1].right,
+						sacked[i].right)) {
+				sacked[i].right = sacked[i + 1].right;
+			}
+
+			memmove(&sacked[i + 1], &sacked[i + 2],
+				(conn->sacked_count - i - 2) * sizeof(*sacked));
+			conn->sacked_count--;
+		}
+
+		return;
+	}
+
+	if (conn->sacked_count == TCP_MAX_SACK_BLOCKS) {
+		if (i == TCP_MAX_SACK_BLOCKS) {
+			return;
+		}
+
+		conn->sacked_count--;
+	}
+
+	memmove(&sacked[i + 1], &sacked[i],
+		(conn->sacked_count - i) * sizeof(*sacked));
+	sacked[i].left = left;
+	sacked[i].right = right;
+	conn->sacked_count++;
+}
+
+/* Drops what the cumulative ACK covers from the scoreboard and adds the
+ * SACK blocks of the segment received
+ */
+static void tcp_sacked_update(struct tcp *conn)
+{
+	uint32_t end = conn->seq + conn->unacked_len;
+	int drop = 0;
+
+	while (drop < conn->sacked_count &&
+	       net_tcp_seq_cmp(conn->sacked[drop].right, conn->seq) <= 0) {
+		drop++;
+	}
+
+	if (drop) {
+		conn->sacked_count -= drop;
+		memmove(&conn->sacked[0], &conn->sacked[drop],
+			conn->sacked_count * sizeof(conn->sacked[0]));
+	}
+
+	if (conn->sacked_count &&
+	    net_tcp_seq_greater(conn->seq, conn->sacked[0].left)) {
+		conn->sacked[0].left = conn->seq;
+	}
+
+	if (!conn->sack) {
+		return;
+	}
+
+	for (int i = 0; i < conn->recv_options.sack_count; i++) {
+		struct tcp_sack_block *block = &conn->recv_options.sack[i];
+
+		/* Ignore D-SACK and blocks outside of the data in flight */
+		if (!net_tcp_seq_greater(block->left, conn->seq) ||
+		    !net_tcp_seq_greater(block->right, block->left) ||
+		    net_tcp_seq_greater(block->right, end)) {
+			continue;
+		}
+
+		tcp_sacked_add(conn, block->left, block->right);
+	}
+}
+
+/* Retransmits a segment of the data the peer is missing, from
+ * conn->rexmit_next on. With SACK, this is the next hole below the
+ * highest block the peer holds (RFC 6675), otherwise only the first
+ * segment in flight once (RFC 6582).
+ */
+static void tcp_retransmit_hole(struct tcp *conn)
+{
+	uint32_t start = conn->rexmit_next;
+	uint32_t limit = conn->seq + conn->unacked_len;
+	int len;
+
+	if (net_tcp_seq_greater(conn->seq, start)) {
+		start = conn->seq;
+	}
+
+	if (conn->sacked_count) {
+		int i;
+
+		for (i = 0; i < conn->sacked_count; i++) {
+			if (net_tcp_seq_greater(conn->sacked[i].left, start)) {
+				break;
+			}
+
+			if (net_tcp_seq_greater(conn->sacked[i].right, start)) {
+				start = conn->sacked[i].right;
+			}
+		}
+
+		if (i == conn->sacked_count) {
+			return;
+		}
+
+		limit = conn->sacked[i].left;
+	} else if (start != conn->seq) {
+		return;
+	}
+
+	len = MIN(limit - start, conn_mss(conn));
+	if (len <= 0 || tcp_send_segment(conn, start - conn->seq, len) < 0) {
+		return;
+	}
+
+	conn->rexmit_next = start + len;
+
+	net_stats_update_tcp_resent(conn->iface, len);
+	net_stats_update_tcp_seg_rexmit(conn->iface);
+}
+
+/* Congestion control on new data acknowledged, conn->seq being moved */
+static void tcp_cc_ack(struct tcp *conn, uint32_t len_acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	conn->dup_acks = 0U;
+	tcp_sacked_update(conn);
+
+	if (conn->in_recovery) {
+		if (!net_tcp_seq_greater(conn->recover, conn->seq)) {
+			conn->cwnd = conn->ssthresh;
+			conn->in_recovery = false;
+			return;
+		}
+
+		/* Partial ACK: the next hole is lost too, RFC 6582 */
+		tcp_retransmit_hole(conn);
+
+		conn->cwnd -= MIN(conn->cwnd, len_acked);
+		if (len_acked >= mss) {
+			conn->cwnd += mss;
+		}
+
+		conn->cwnd = MAX(conn->cwnd, mss);
+		return;
+	}
+
+	/* Only grow a window the peer lets us use */
+	if (tcp_send_window(conn) < conn->send_win) {
+		tcp_cc->acked(conn, len_acked);
+	}
+}
+
+/* Duplicate ACK: fast retransmit on the third one, then fast recovery,
+ * RFC 5681
+ */
+static void tcp_dup_ack(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	tcp_sacked_update(conn);
+
+	if (conn->dup_acks < UINT8_MAX) {
+		conn->dup_acks++;
+	}
+
+	if (conn->in_recovery) {
+		conn->cwnd += mss;
+
+		if (conn->sack) {
+			tcp_retransmit_hole(conn);
+		}
+	} else if (conn->dup_acks == 3U) {
+		NET_DBG("conn: %p fast retransmit (%s)", conn, tcp_cc->name);
+
+		conn->ssthresh = tcp_cc->ssthresh(conn);
+		conn->cwnd = conn->ssthresh + 3U * mss;
+		conn->recover = conn->seq + conn->unacked_len;
+		conn->rexmit_next = conn->seq;
+		conn->in_recovery = true;
+
+		tcp_retransmit_hole(conn);
+	} else {
+		return;
+	}
+
+	(void)tcp_send_queued_data(conn);
+}
+
 static void tcp_cleanup_recv_queue(struct k_work *work)
 {
 	struct tcp *conn = CONTAINER_OF(work, struct tcp, recv_queue_timer);
@@ -1026,6 +1401,18 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	if (conn->data_mode == TCP_DATA_MODE_SEND) {
+		/* Loss detected by the timer: restart from one segment and
+		 * forget what the peer said it holds, RFC 5681 and 2018
+		 */
+		conn->ssthresh = tcp_cc->ssthresh(conn);
+		conn->cwnd = conn_mss(conn);
+		conn->cwnd_cnt = 0U;
+		conn->in_recovery = false;
+		conn->dup_acks = 0U;
+		conn->sacked_count = 0U;
+	}
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1188,39 +1575,35 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	union tcp_endpoint local, remote;
+	struct tcp *conn, *found = NULL;
+	k_spinlock_key_t key;
+	sys_slist_t *list;
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
+	if (tcp_endpoint_set(&local, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&remote, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
+	list = tcp_conn_table_list(&local, &remote);
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
-}
+	key = k_spin_lock(&tcp_conn_table_lock);
 
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
-{
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
-
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
-
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
+		if (!memcmp(&conn->src, &local,
+			    tcp_endpoint_len(local.sa.sa_family)) &&
+		    !memcmp(&conn->dst, &remote,
+			    tcp_endpoint_len(remote.sa.sa_family))) {
+			found = conn;
 			break;
 		}
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&tcp_conn_table_lock, key);
+
+	return found;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1299,6 +1682,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_table_add(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1500,6 +1885,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	uint32_t prev_send_win = 0U;
 	size_t len;
 	int ret;
 
@@ -1531,6 +1917,13 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th) {
+		/* Only the MSS, sent with SYN, outlives its segment */
+		conn->recv_options.wnd_found = false;
+		conn->recv_options.sack_perm_found = false;
+		conn->recv_options.sack_count = 0U;
+	}
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1542,7 +1935,23 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	if (th) {
 		size_t max_win;
 
-		conn->send_win = ntohs(th_win(th));
+		prev_send_win = conn->send_win;
+
+		if (fl & SYN) {
+			/* The window of a SYN is never scaled, RFC 7323 */
+			conn->window_scale =
+				IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+				conn->recv_options.wnd_found;
+			conn->send_win_shift = conn->window_scale ?
+				conn->recv_options.window : 0U;
+			conn->sack = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+				conn->recv_options.sack_perm_found;
+
+			conn->send_win = ntohs(th_win(th));
+		} else {
+			conn->send_win = (uint32_t)ntohs(th_win(th)) <<
+				conn->send_win_shift;
+		}
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
@@ -1692,6 +2101,8 @@ next_state:
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			tcp_cc_ack(conn, len_acked);
+
 			conn_send_data_dump(conn);
 
 			if (!k_delayed_work_remaining_get(&conn->send_data_timer)) {
@@ -1722,6 +2133,12 @@ next_state:
 				conn_state(conn, TCP_CLOSED);
 				break;
 			}
+		} else if (th && FL(&fl, ==, ACK) && len == 0 &&
+			   th_ack(th) == conn->seq && conn->unacked_len > 0 &&
+			   conn->send_win == prev_send_win &&
+			   conn->data_mode == TCP_DATA_MODE_SEND) {
+			/* A window update is not a duplicate, RFC 5681 */
+			tcp_dup_ack(conn);
 		}
 
 		if (th && len) {
@@ -1736,6 +2153,11 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+
+				/* Tell a SACK capable peer what we hold */
+				if (conn->sack) {
+					tcp_out(conn, ACK);
+				}
 			}
 		}
 		break;
@@ -2014,6 +2436,11 @@ int net_tcp_connect(struct net_context *context,
 	conn = context->tcp;
 	conn->iface = net_context_get_iface(context);
 
+	/* The table is hashed on the end points about to be rewritten,
+	 * in case this connection was filed under earlier ones
+	 */
+	tcp_conn_table_remove(conn);
+
 	switch (net_context_get_family(context)) {
 		const struct in_addr *ip4;
 		const struct in6_addr *ip6;
@@ -2080,6 +2507,8 @@ int net_tcp_connect(struct net_context *context,
 		goto out;
 	}
 
+	tcp_conn_table_add(conn);
+
 	/* Input of a (nonexistent) packet with no flags set will cause
 	 * a TCP connection to be established
 	 */
@@ -2255,6 +2684,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_table_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -2544,6 +2974,28 @@ uint16_t net_tcp_get_recv_mss(const struct tcp *conn)
 	return 0;
 }
 
+/* Largest segment to send: the peer's MSS, or the default one, within
+ * the largest packet net_pkt allocates for the interface
+ */
+uint16_t tcp_conn_mss(struct tcp *conn)
+{
+	uint16_t mss = conn->recv_options.mss_found ?
+		conn->recv_options.mss : (uint16_t)NET_IPV6_MTU;
+	struct net_if *iface = net_context_get_iface(conn->context);
+	uint16_t mtu = iface ? net_if_get_mtu(iface) : 0U;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    net_context_get_family(conn->context) == AF_INET) {
+		mss = MIN(mss, MAX(mtu, NET_IPV4_MTU) - NET_IPV4TCPH_LEN);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   !IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT) &&
+		   net_context_get_family(conn->context) == AF_INET6) {
+		mss = MIN(mss, MAX(mtu, NET_IPV6_MTU) - NET_IPV6TCPH_LEN);
+	}
+
+	return mss;
+}
+
 const char *net_tcp_state_str(enum tcp_state state)
 {
 	return tcp_state_to_str(state, false);
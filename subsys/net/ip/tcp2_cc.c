@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* TCP congestion control algorithms, see struct tcp_cc_ops */
+
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "tcp2_priv.h"
+
+/* Slow start, common to the algorithms: one MSS per ACK at most */
+static void tcp_cc_slow_start(struct tcp *conn, uint32_t len)
+{
+	conn->cwnd += MIN(len, conn_mss(conn));
+}
+
+/* NewReno: one MSS per window of acknowledged data */
+static void newreno_acked(struct tcp *conn, uint32_t len)
+{
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, len);
+		return;
+	}
+
+	conn->cwnd_cnt += len;
+	if (conn->cwnd_cnt >= conn->cwnd) {
+		conn->cwnd_cnt -= conn->cwnd;
+		conn->cwnd += conn_mss(conn);
+	}
+}
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	return MAX((uint32_t)conn->unacked_len / 2U, 2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.acked = newreno_acked,
+	.ssthresh = newreno_ssthresh,
+};
+
+/* CUBIC, RFC 8312, with C = 0.4 and beta = 0.7. The window follows
+ *
+ *   W(t) = C * (t - K)^3 + W_max
+ *
+ * in segments and seconds, t being the time since the start of the
+ * epoch and K the time W takes to grow back to W_max. Times are kept in
+ * ms, windows in bytes. The TCP-friendly region is left out, as it needs
+ * an RTT estimate the stack does not keep.
+ */
+#define CUBIC_BETA_NUM 7
+#define CUBIC_BETA_DEN 10
+
+/* Longest time from K computed with, so that the cube fits */
+#define CUBIC_MAX_DT_MS 100000
+
+/* Integer cube root, rounded down */
+static uint32_t cubic_cbrt(uint64_t x)
+{
+	uint64_t y = 0U;
+
+	for (int s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		y *= 2U;
+		b = 3U * y * (y + 1U) + 1U;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static void cubic_acked(struct tcp *conn, uint32_t len)
+{
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	int64_t dt, offset;
+	uint32_t origin;
+	uint64_t target;
+
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, len);
+		return;
+	}
+
+	if (conn->cubic.epoch == 0U) {
+		conn->cubic.epoch = now | 1U;
+
+		if (conn->cwnd < conn->cubic.w_max) {
+			/* K = cbrt((W_max - cwnd) / C), in ms */
+			conn->cubic.k = cubic_cbrt(
+				(uint64_t)(conn->cubic.w_max - conn->cwnd) *
+				2500000000ULL / mss);
+		} else {
+			conn->cubic.k = 0U;
+		}
+	}
+
+	origin = MAX(conn->cubic.w_max, conn->cwnd);
+
+	dt = (int64_t)(now - conn->cubic.epoch) - conn->cubic.k;
+	dt = CLAMP(dt, -CUBIC_MAX_DT_MS, CUBIC_MAX_DT_MS);
+
+	/* C * dt^3 in thousandths of a segment, then in bytes */
+	offset = (dt * dt * dt * 4) / 10000000;
+	offset = offset * mss / 1000;
+
+	if (offset < 0 && (uint64_t)-offset >= origin) {
+		target = 0U;
+	} else {
+		target = origin + offset;
+	}
+
+	/* Never more than half a window of growth per window */
+	target = MIN(target, (uint64_t)conn->cwnd * 3U / 2U);
+
+	if (target > conn->cwnd) {
+		conn->cwnd_cnt += (target - conn->cwnd) * len / conn->cwnd;
+	} else {
+		/* Plateau around W_max: grow by 1% of a segment per ACK */
+		conn->cwnd_cnt += len / 100U;
+	}
+
+	if (conn->cwnd_cnt >= mss) {
+		conn->cwnd += conn->cwnd_cnt / mss * mss;
+		conn->cwnd_cnt %= mss;
+	}
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	/* Fast convergence: give up bandwidth to newer flows */
+	if (conn->cwnd < conn->cubic.w_max) {
+		conn->cubic.w_max = conn->cwnd *
+				    (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+				    (2U * CUBIC_BETA_DEN);
+	} else {
+		conn->cubic.w_max = conn->cwnd;
+	}
+
+	conn->cubic.epoch = 0U;
+
+	return MAX(conn->cwnd / CUBIC_BETA_DEN * CUBIC_BETA_NUM,
+		   2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.acked = cubic_acked,
+	.ssthresh = cubic_ssthresh,
+};
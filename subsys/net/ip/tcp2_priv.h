@@ -110,9 +110,7 @@
 #define conn_ack(_conn, _req) (_conn)->ack += (_req)
 #endif
 
-#define conn_mss(_conn)					\
-	((_conn)->recv_options.mss_found ?		\
-	 (_conn)->recv_options.mss : (uint16_t)NET_IPV6_MTU)
+#define conn_mss(_conn) tcp_conn_mss(_conn)
 
 #define conn_state(_conn, _s)						\
 ({									\
@@ -125,7 +123,7 @@
 #define conn_send_data_dump(_conn)					\
 ({									\
 	NET_DBG("conn: %p total=%zd, unacked_len=%d, "			\
-		"send_win=%hu, mss=%hu",				\
+		"send_win=%u, mss=%hu",					\
 		(_conn), net_pkt_get_len((_conn)->send_data),		\
 		conn->unacked_len, conn->send_win,			\
 		(uint16_t)conn_mss((_conn)));				\
@@ -139,6 +137,14 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+/* Largest window shift (RFC 7323) and number of SACK blocks that fit in
+ * the options of a segment without timestamps (RFC 2018)
+ */
+#define TCP_MAX_WINDOW_SHIFT	14
+#define TCP_MAX_SACK_BLOCKS	4
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -200,15 +206,44 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+/* Sequence numbers of a range of data held by the receiver */
+struct tcp_sack_block {
+	uint32_t left;
+	uint32_t right;
+};
+
 struct tcp_options {
 	uint16_t mss;
-	uint16_t window;
+	uint16_t window; /* window shift */
+	struct tcp_sack_block sack[TCP_MAX_SACK_BLOCKS];
+	uint8_t sack_count;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+};
+
+struct tcp;
+
+/* Congestion control algorithm. The stack handles the window reduction
+ * and fast recovery, the algorithm grows the congestion window and
+ * chooses the slow start threshold after a loss.
+ */
+struct tcp_cc_ops {
+	const char *name;
+	/* Called with new data acknowledged, outside of loss recovery */
+	void (*acked)(struct tcp *conn, uint32_t len);
+	/* Called on a loss, returns the new slow start threshold */
+	uint32_t (*ssthresh)(struct tcp *conn);
 };
 
+uint16_t tcp_conn_mss(struct tcp *conn);
+
+extern const struct tcp_cc_ops tcp_cc_newreno;
+extern const struct tcp_cc_ops tcp_cc_cubic;
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_node; /* in the lookup table, by end points */
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -246,11 +281,30 @@ struct tcp { /* TCP connection */
 	uint32_t seq;
 	uint32_t ack;
 	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t send_win;
+	/* Congestion control state, in bytes */
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t cwnd_cnt; /* acked bytes not yet turned into cwnd growth */
+	uint32_t recover; /* end of the data in flight at the last loss */
+	uint32_t rexmit_next; /* where the next retransmission may start */
+	struct {
+		uint32_t w_max;
+		uint32_t k; /* time to grow back to w_max, in ms */
+		uint32_t epoch; /* start of the current epoch, in ms */
+	} cubic;
+	/* Data held by the peer past conn->seq, sorted */
+	struct tcp_sack_block sacked[TCP_MAX_SACK_BLOCKS];
+	uint8_t sacked_count;
+	uint8_t dup_acks;
+	uint8_t send_win_shift;
 	uint8_t send_data_retries;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool in_recovery : 1;
+	bool window_scale : 1; /* RFC 7323 negotiated */
+	bool sack : 1; /* RFC 2018 negotiated */
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -104,6 +104,10 @@ static void zsock_received_cb(struct net_context *ctx,
 			      int status,
 			      void *user_data);
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static void zsock_recv_zc_release_all(struct net_context *ctx);
+#endif
+
 static inline int k_fifo_wait_non_empty(struct k_fifo *fifo,
 					k_timeout_t timeout)
 {
@@ -239,6 +243,11 @@ int zsock_close_ctx(struct net_context *ctx)
 	}
 
 	zsock_flush_queue(ctx);
+	zsock_epoll_remove_ctx(ctx);
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	zsock_recv_zc_release_all(ctx);
+#endif
 
 	SET_ERRNO(net_context_put(ctx));
 
@@ -309,6 +318,7 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_fifo_init(&new_ctx->recv_q);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_epoll_notify(parent);
 	}
 }
 
@@ -338,6 +348,8 @@ static void zsock_received_cb(struct net_context *ctx,
 			net_pkt_set_eof(last_pkt, true);
 			NET_DBG("Set EOF flag on pkt %p", last_pkt);
 		}
+
+		zsock_epoll_notify(ctx);
 		return;
 	}
 
@@ -351,6 +363,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	zsock_epoll_notify(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -1173,6 +1186,457 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Data held by zsock_recv_zc_iov(), handles being the index of the entry
+ * and a generation count, so that a stale handle is not taken for a newer
+ * one. Chains lent out by zsock_recv_zc() are recorded too, so that
+ * zsock_recv_zc_done() finds the socket they came from: the caller owns
+ * those buffers, and closing the socket only forgets the entry.
+ */
+struct zsock_zc_held {
+	struct net_context *ctx;
+	struct net_buf *frags;
+	uint8_t gen;
+	bool lent;
+};
+
+static struct zsock_zc_held zc_held[CONFIG_NET_SOCKETS_ZEROCOPY_MAX_HELD];
+static K_MUTEX_DEFINE(zc_held_lock);
+
+/* Free entry of zc_held[], or -1 with errno set. Called with
+ * zc_held_lock held.
+ */
+static int zsock_zc_held_slot(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(zc_held); i++) {
+		if (zc_held[i].ctx == NULL) {
+			return i;
+		}
+	}
+
+	errno = ENOBUFS;
+	return -1;
+}
+
+static struct net_context *get_native_ctx(int sock)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = ENOTSUP;
+		return NULL;
+	}
+
+	return ctx;
+}
+
+/* Waits for a packet with data at the head of the queue, and returns it
+ * without taking it off. Returns NULL with errno set on error, or with
+ * errno set to 0 at the end of a stream.
+ */
+static struct net_pkt *zsock_recv_zc_wait(struct net_context *ctx, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	int res;
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (net_context_get_type(ctx) == SOCK_STREAM &&
+	    net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		errno = ENOTCONN;
+		return NULL;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	while (1) {
+		if (sock_is_eof(ctx)) {
+			errno = 0;
+			return NULL;
+		}
+
+		res = k_fifo_wait_non_empty(&ctx->recv_q, timeout);
+		/* EAGAIN when timeout expired, EINTR when cancelled */
+		if (res && res != -EAGAIN && res != -EINTR) {
+			errno = -res;
+			return NULL;
+		}
+
+		pkt = k_fifo_peek_head(&ctx->recv_q);
+		if (!pkt) {
+			errno = sock_is_eof(ctx) ? 0 : EAGAIN;
+			return NULL;
+		}
+
+		/* An empty datagram is still one */
+		if (net_context_get_type(ctx) != SOCK_STREAM ||
+		    net_pkt_remaining_data(pkt) > 0) {
+			return pkt;
+		}
+
+		k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+		if (net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+
+		net_pkt_unref(pkt);
+	}
+}
+
+/* First fragment with data from the cursor of the packet on, and the
+ * offset of the data in it
+ */
+static struct net_buf *zsock_pkt_data(struct net_pkt *pkt, size_t *pos)
+{
+	struct net_buf *buf = pkt->cursor.buf;
+
+	*pos = buf ? pkt->cursor.pos - buf->data : 0;
+
+	while (buf && *pos == buf->len) {
+		buf = buf->frags;
+		*pos = 0;
+	}
+
+	return buf;
+}
+
+/* Takes the packet off the queue and returns its data fragments, the
+ * fragments holding the headers going away with the packet.
+ */
+static struct net_buf *zsock_recv_zc_take(struct net_context *ctx,
+					  struct net_pkt *pkt)
+{
+	struct net_buf *frags, *buf;
+	size_t pos;
+
+	k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	frags = zsock_pkt_data(pkt, &pos);
+	if (frags == pkt->buffer) {
+		pkt->buffer = NULL;
+	} else if (frags) {
+		for (buf = pkt->buffer; buf->frags != frags; buf = buf->frags) {
+		}
+
+		buf->frags = NULL;
+	}
+
+	net_pkt_unref(pkt);
+
+	if (frags) {
+		net_buf_pull(frags, pos);
+	}
+
+	return frags;
+}
+
+static void zsock_recv_zc_done_ctx(struct net_context *ctx,
+				   struct net_buf *frags)
+{
+	if (net_context_get_type(ctx) == SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, net_buf_frags_len(frags));
+	}
+
+	net_buf_unref(frags);
+}
+
+ssize_t zsock_recv_zc(int sock, struct net_buf **frags, int flags)
+{
+	struct net_context *ctx = get_native_ctx(sock);
+	struct net_pkt *pkt;
+	int i;
+
+	*frags = NULL;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	pkt = zsock_recv_zc_wait(ctx, flags);
+	if (!pkt) {
+		return errno ? -1 : 0;
+	}
+
+	k_mutex_lock(&zc_held_lock, K_FOREVER);
+
+	i = zsock_zc_held_slot();
+	if (i >= 0) {
+		*frags = zsock_recv_zc_take(ctx, pkt);
+	}
+
+	if (*frags) {
+		zc_held[i].ctx = ctx;
+		zc_held[i].frags = *frags;
+		zc_held[i].gen++;
+		zc_held[i].lent = true;
+	}
+
+	k_mutex_unlock(&zc_held_lock);
+
+	if (i < 0) {
+		return -1;
+	}
+
+	return *frags ? net_buf_frags_len(*frags) : 0;
+}
+
+void zsock_recv_zc_done(int sock, struct net_buf *frags)
+{
+	ARG_UNUSED(sock);
+
+	if (frags == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&zc_held_lock, K_FOREVER);
+
+	/* No entry if the socket was closed since, the buffers are
+	 * released all the same. Closing waits for the lock, so the
+	 * context is still that socket while the window is updated.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(zc_held); i++) {
+		if (zc_held[i].ctx != NULL && zc_held[i].lent &&
+		    zc_held[i].frags == frags) {
+			zsock_recv_zc_done_ctx(zc_held[i].ctx, frags);
+			zc_held[i].ctx = NULL;
+			zc_held[i].frags = NULL;
+			frags = NULL;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&zc_held_lock);
+
+	if (frags) {
+		net_buf_unref(frags);
+	}
+}
+
+int z_impl_zsock_recv_zc_iov(int sock, struct iovec *iov, int iovcnt,
+			     int *handle, int flags)
+{
+	struct net_context *ctx = get_native_ctx(sock);
+	struct net_buf *frags, *buf;
+	struct net_pkt *pkt;
+	size_t pos;
+	int i, n;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	*handle = -1;
+
+	pkt = zsock_recv_zc_wait(ctx, flags);
+	if (!pkt) {
+		return errno ? -1 : 0;
+	}
+
+	k_mutex_lock(&zc_held_lock, K_FOREVER);
+
+	i = zsock_zc_held_slot();
+	if (i < 0) {
+		goto fail;
+	}
+
+	/* The data stays queued unless it can all be handed out */
+	n = 0;
+	for (buf = zsock_pkt_data(pkt, &pos); buf; buf = buf->frags) {
+		if (n == iovcnt) {
+			errno = EMSGSIZE;
+			goto fail;
+		}
+
+#ifdef CONFIG_USERSPACE
+		if (z_is_in_user_syscall() &&
+		    arch_buffer_validate(buf->data + pos, buf->len - pos, 0)) {
+			errno = EACCES;
+			goto fail;
+		}
+#endif
+
+		iov[n].iov_base = buf->data + pos;
+		iov[n].iov_len = buf->len - pos;
+		pos = 0;
+		n++;
+	}
+
+	frags = zsock_recv_zc_take(ctx, pkt);
+	if (frags) {
+		zc_held[i].ctx = ctx;
+		zc_held[i].frags = frags;
+		zc_held[i].gen++;
+		zc_held[i].lent = false;
+		*handle = (zc_held[i].gen << 8) | i;
+	}
+
+	k_mutex_unlock(&zc_held_lock);
+
+	return n;
+
+fail:
+	k_mutex_unlock(&zc_held_lock);
+
+	return -1;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recv_zc_iov(int sock, struct iovec *iov,
+					   int iovcnt, int *handle, int flags)
+{
+	Z_OOPS(Z_SYSCALL_VERIFY(iovcnt >= 0));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(iov, iovcnt,
+					    sizeof(struct iovec)));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(handle, sizeof(*handle)));
+
+	return z_impl_zsock_recv_zc_iov(sock, iov, iovcnt, handle, flags);
+}
+#include <syscalls/zsock_recv_zc_iov_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_recv_zc_release(int sock, int handle)
+{
+	struct net_context *ctx = get_native_ctx(sock);
+	struct net_buf *frags = NULL;
+	int i = handle & 0xff;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	k_mutex_lock(&zc_held_lock, K_FOREVER);
+
+	if (handle >= 0 && i < ARRAY_SIZE(zc_held) &&
+	    zc_held[i].ctx == ctx && !zc_held[i].lent &&
+	    zc_held[i].gen == (handle >> 8)) {
+		frags = zc_held[i].frags;
+		zc_held[i].ctx = NULL;
+		zc_held[i].frags = NULL;
+	}
+
+	k_mutex_unlock(&zc_held_lock);
+
+	if (frags == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	zsock_recv_zc_done_ctx(ctx, frags);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recv_zc_release(int sock, int handle)
+{
+	return z_impl_zsock_recv_zc_release(sock, handle);
+}
+#include <syscalls/zsock_recv_zc_release_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static void zsock_recv_zc_release_all(struct net_context *ctx)
+{
+	k_mutex_lock(&zc_held_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(zc_held); i++) {
+		if (zc_held[i].ctx == ctx) {
+			if (!zc_held[i].lent) {
+				net_buf_unref(zc_held[i].frags);
+			}
+
+			zc_held[i].ctx = NULL;
+			zc_held[i].frags = NULL;
+		}
+	}
+
+	k_mutex_unlock(&zc_held_lock);
+}
+
+ssize_t zsock_send_zc(int sock, struct net_buf *frags, int flags)
+{
+	struct net_context *ctx = get_native_ctx(sock);
+	k_timeout_t timeout = K_FOREVER;
+	uint64_t buf_timeout = 0;
+	int status;
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		buf_timeout = z_timeout_end_calc(MAX_WAIT_BUFS);
+	}
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	while (1) {
+		status = net_context_send_buf(ctx, frags, NULL, timeout,
+					      ctx->user_data);
+		if (status >= 0) {
+			break;
+		}
+
+		if (((status == -ENOBUFS) || (status == -EAGAIN)) &&
+		    K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			/* Same as zsock_sendto_ctx(), the buffers are still
+			 * ours to try again.
+			 */
+			int64_t remaining = buf_timeout - z_tick_get();
+
+			if (remaining <= 0) {
+				if (status == -ENOBUFS) {
+					errno = ENOMEM;
+				} else {
+					errno = ENOBUFS;
+				}
+
+				return -1;
+			}
+
+			k_sleep(WAIT_BUFS);
+			continue;
+		}
+
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
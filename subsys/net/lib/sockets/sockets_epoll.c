@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* epoll-like event notification. Each socket keeps the list of the
+ * entries watching it, and the reception callbacks of the socket put
+ * these entries on the ready list of their instance, so that
+ * zsock_epoll_wait() only ever looks at the sockets with events.
+ */
+
+#include <kernel.h>
+#include <net/socket.h>
+#include <net/net_context.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
+struct epoll_instance;
+
+/* A socket watched by an instance */
+struct epoll_item {
+	/* In the list of the socket */
+	sys_snode_t ctx_node;
+	/* In the list of the instance */
+	sys_dnode_t node;
+	/* In the ready list of the instance, while linked */
+	sys_dnode_t ready_node;
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	struct zsock_epoll_event event;
+};
+
+struct epoll_instance {
+	sys_dlist_t items;
+	sys_dlist_t ready;
+	/* Given when an item is put on the ready list */
+	struct k_sem ready_sem;
+	bool in_use;
+};
+
+static struct epoll_instance epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+static K_MEM_SLAB_DEFINE(epoll_items_slab, sizeof(struct epoll_item),
+			 CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS, 4);
+
+/* Protects the instances and the lists of items of the sockets */
+static K_MUTEX_DEFINE(epoll_lock);
+
+static const struct socket_op_vtable epoll_fd_op_vtable;
+
+/* Events watched by the item which the socket has at the moment */
+static uint32_t epoll_item_events(struct epoll_item *item)
+{
+	/* For now, assume that socket is always writable, as poll() does */
+	uint32_t events = ZSOCK_EPOLLOUT;
+
+	if (!k_fifo_is_empty(&item->ctx->recv_q) || sock_is_eof(item->ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	return events & item->event.events;
+}
+
+static void epoll_item_ready(struct epoll_item *item)
+{
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+		k_sem_give(&item->ep->ready_sem);
+	}
+}
+
+static struct epoll_item *epoll_item_find(struct epoll_instance *ep,
+					  struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->ep == ep) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+static struct epoll_item *epoll_item_alloc(struct epoll_instance *ep,
+					   struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	if (k_mem_slab_alloc(&epoll_items_slab, (void **)&item,
+			     K_NO_WAIT) < 0) {
+		return NULL;
+	}
+
+	item->ep = ep;
+	item->ctx = ctx;
+	sys_dnode_init(&item->ready_node);
+	sys_dlist_append(&ep->items, &item->node);
+	sys_slist_append(&ctx->epoll_items, &item->ctx_node);
+
+	return item;
+}
+
+static void epoll_item_free(struct epoll_item *item)
+{
+	(void)sys_slist_find_and_remove(&item->ctx->epoll_items,
+					&item->ctx_node);
+	sys_dlist_remove(&item->node);
+
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	k_mem_slab_free(&epoll_items_slab, (void **)&item);
+}
+
+/* Sets the events to watch, and reports those the socket already has */
+static void epoll_item_set(struct epoll_item *item,
+			   const struct zsock_epoll_event *event)
+{
+	item->event = *event;
+
+	if (epoll_item_events(item) != 0U) {
+		epoll_item_ready(item);
+	}
+}
+
+void zsock_epoll_notify(struct net_context *ctx)
+{
+	struct epoll_item *item;
+
+	/* Most sockets are not watched */
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->event.events & ZSOCK_EPOLLIN) {
+			epoll_item_ready(item);
+		}
+	}
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+void zsock_epoll_remove_ctx(struct net_context *ctx)
+{
+	struct epoll_item *item, *next;
+
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx->epoll_items, item, next,
+					  ctx_node) {
+		epoll_item_free(item);
+	}
+
+	k_mutex_unlock(&epoll_lock);
+}
+
+int zsock_epoll_create1(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	int fd, i;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].in_use) {
+			ep = &epolls[i];
+			ep->in_use = true;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&epoll_lock);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	sys_dlist_init(&ep->items);
+	sys_dlist_init(&ep->ready);
+	k_sem_init(&ep->ready_sem, 0, 1);
+
+	z_finalize_fd(fd, ep, (const struct fd_op_vtable *)&epoll_fd_op_vtable);
+
+	return fd;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd,
+		    struct zsock_epoll_event *event)
+{
+	struct epoll_instance *ep;
+	struct net_context *ctx;
+	struct epoll_item *item;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	/* Only the sockets of the stack have the callbacks to notify from */
+	ctx = z_get_fd_obj(fd, (const struct fd_op_vtable *)&sock_fd_op_vtable,
+			   EPERM);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	item = epoll_item_find(ep, ctx);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		item = epoll_item_alloc(ep, ctx);
+		if (item == NULL) {
+			ret = -ENOSPC;
+			break;
+		}
+
+		epoll_item_set(item, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_set(item, event);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_free(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&epoll_lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Reports the events of the items on the ready list. The items which
+ * lost their events since they were queued are dropped, the
+ * level-triggered ones are queued again at the end of the list, for the
+ * next call to check if they still have events.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	sys_dlist_t reported;
+	struct epoll_item *item;
+	sys_dnode_t *node;
+	int n = 0;
+
+	sys_dlist_init(&reported);
+
+	while (n < maxevents && (node = sys_dlist_get(&ep->ready)) != NULL) {
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+
+		events[n].events = epoll_item_events(item);
+		if (events[n].events == 0U) {
+			continue;
+		}
+
+		events[n].data = item->event.data;
+		n++;
+
+		if (!(item->event.events & ZSOCK_EPOLLET)) {
+			sys_dlist_append(&reported, node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&reported)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	return n;
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	struct epoll_instance *ep;
+	k_timeout_t wait;
+	uint64_t end;
+	int n;
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		wait = K_FOREVER;
+	} else {
+		wait = K_MSEC(timeout);
+	}
+
+	end = z_timeout_end_calc(wait);
+
+	while (true) {
+		(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+		n = epoll_collect(ep, events, maxevents);
+		k_mutex_unlock(&epoll_lock);
+
+		if (n > 0 || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			return n;
+		}
+
+		/* The semaphore may have been given for items reported
+		 * already, so check the list again when it is taken
+		 */
+		if (k_sem_take(&ep->ready_sem, wait) < 0) {
+			return 0;
+		}
+
+		if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - z_tick_get();
+
+			if (remaining <= 0) {
+				wait = K_NO_WAIT;
+			} else {
+				wait = Z_TIMEOUT_TICKS(remaining);
+			}
+		}
+	}
+}
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(count);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	struct epoll_item *item, *next;
+
+	(void)k_mutex_lock(&epoll_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->items, item, next, node) {
+		epoll_item_free(item);
+	}
+
+	ep->in_use = false;
+
+	k_mutex_unlock(&epoll_lock);
+
+	return 0;
+}
+
+static const struct socket_op_vtable epoll_fd_op_vtable = {
+	.fd_vtable = {
+		.read = epoll_read_vmeth,
+		.write = epoll_write_vmeth,
+		.close = epoll_close_vmeth,
+		.ioctl = epoll_ioctl_vmeth,
+	},
+};
@@ -33,6 +33,7 @@
 #define CONFIG_ZTEST_ASSERT_VERBOSE 1
 #define CONFIG_ZTEST_MOCKING
 #define CONFIG_NUM_COOP_PRIORITIES 16
+#define CONFIG_NUM_PREEMPT_PRIORITIES 15
 #define CONFIG_COOP_ENABLED 1
 #define CONFIG_PREEMPT_ENABLED 1
 #define CONFIG_MP_NUM_CPUS 1
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/base64.h>
+#include <sys/util.h>
+#include <net/buf.h>
+#include <timing/timing.h>
+
+/* Base64 and hex throughput benchmark: see README.rst */
+
+#define MAX_LEN 4096
+#define BYTES_PER_RUN (256 * 1024)
+#define ROUNDS 5
+#define LINE_LEN 76
+
+/* Encoded sizes, with room for the line breaks and the terminator */
+#define ENC_LEN (MAX_LEN / 3 * 4 + 4 + 1)
+#define LINES_LEN (ENC_LEN + ENC_LEN / LINE_LEN * 2 + 2)
+
+NET_BUF_POOL_FIXED_DEFINE(bench_pool, ENC_LEN / 128 + 2, 128, NULL);
+
+static uint8_t bin[MAX_LEN];
+static uint8_t out[MAX_LEN];
+static uint8_t enc[ENC_LEN];
+static uint8_t lines[LINES_LEN];
+static char hex[2 * MAX_LEN + 1];
+static const size_t lens[] = { 16, 64, 256, 1024, 4096 };
+
+/* Encoded input, as prepared by prepare() */
+static size_t enc_len, lines_len;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static void prepare(size_t len)
+{
+	size_t n = 0;
+
+	(void)base64_encode(enc, sizeof(enc), &enc_len, bin, len);
+
+	for (size_t i = 0; i < enc_len; i++) {
+		lines[n++] = enc[i];
+		if (i % LINE_LEN == LINE_LEN - 1) {
+			lines[n++] = '\r';
+			lines[n++] = '\n';
+		}
+	}
+
+	lines_len = n;
+	(void)bin2hex(bin, len, hex, sizeof(hex));
+}
+
+static int bench_encode(size_t len)
+{
+	size_t olen;
+
+	return base64_encode(enc, sizeof(enc), &olen, bin, len);
+}
+
+static int bench_decode(size_t len)
+{
+	size_t olen;
+
+	return base64_decode(out, sizeof(out), &olen, enc, enc_len);
+}
+
+static int bench_decode_lines(size_t len)
+{
+	size_t olen;
+
+	return base64_decode(out, sizeof(out), &olen, lines, lines_len);
+}
+
+static int bench_net_buf(size_t len)
+{
+	struct net_buf *buf = net_buf_alloc(&bench_pool, K_NO_WAIT);
+	struct base64_encoder state;
+	int ret = 0;
+
+	base64_encoder_init(&state);
+	if (net_buf_append_base64(buf, &state, len, bin, K_NO_WAIT, NULL,
+				  NULL) != len ||
+	    net_buf_append_base64_finish(buf, &state, K_NO_WAIT, NULL,
+					 NULL) != 0) {
+		ret = -ENOMEM;
+	}
+
+	net_buf_unref(buf);
+
+	return ret;
+}
+
+static int bench_bin2hex(size_t len)
+{
+	return (bin2hex(bin, len, hex, sizeof(hex)) == 2 * len) ? 0 : -EINVAL;
+}
+
+static int bench_hex2bin(size_t len)
+{
+	return (hex2bin(hex, 2 * len, out, sizeof(out)) == len) ? 0 : -EINVAL;
+}
+
+static const struct {
+	const char *name;
+	int (*fn)(size_t len);
+} funcs[] = {
+	{ "base64_encode", bench_encode },
+	{ "base64_decode", bench_decode },
+	{ "decode lines", bench_decode_lines },
+	{ "net_buf_base64", bench_net_buf },
+	{ "bin2hex", bench_bin2hex },
+	{ "hex2bin", bench_hex2bin },
+};
+
+/* Best throughput over a few rounds, in units of 10 KB/s */
+static uint32_t measure(int (*fn)(size_t len), size_t len)
+{
+	uint64_t best = UINT64_MAX;
+	size_t runs = BYTES_PER_RUN / len;
+
+	prepare(len);
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		int err = 0;
+
+		for (size_t i = 0; i < runs; i++) {
+			err |= fn(len);
+		}
+
+		best = MIN(best, now_ns() - t0);
+		if (err != 0) {
+			printk("ERROR: failed on %zu bytes\n", len);
+			return 0;
+		}
+	}
+
+	return (uint32_t)((100000ULL * runs * len) / MAX(best, 1));
+}
+
+void main(void)
+{
+	uint32_t x = 1;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	for (size_t i = 0; i < sizeof(bin); i++) {
+		x = x * 1103515245U + 12345U;
+		bin[i] = x >> 24;
+	}
+
+	printk("Base64 and hex benchmark, throughput in MB/s\n");
+	printk("%-15s", "bytes");
+	for (int l = 0; l < ARRAY_SIZE(lens); l++) {
+		printk(" %9zu", lens[l]);
+	}
+	printk("\n");
+
+	for (int f = 0; f < ARRAY_SIZE(funcs); f++) {
+		printk("%-15s", funcs[f].name);
+		for (int l = 0; l < ARRAY_SIZE(lens); l++) {
+			uint32_t rate = measure(funcs[f].fn, lens[l]);
+
+			printk(" %6u.%02u", rate / 100, rate % 100);
+		}
+		printk("\n");
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/cbprintf.h>
+#include <string.h>
+#include <timing/timing.h>
+
+/* Deferred versus immediate formatting benchmark: see README.rst */
+
+#define CALLS 20000
+#define ROUNDS 5
+
+static uint8_t package[128] __aligned(CBPRINTF_PACKAGE_ALIGNMENT);
+static char ram_str[] = "eth0";
+
+/* Changes at every call, so that nothing is hoisted out of the loops */
+static unsigned int seq;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static int discard(int c, void *ctx)
+{
+	return c;
+}
+
+struct collector {
+	char buf[128];
+	size_t len;
+};
+
+static int collect(int c, void *ctx)
+{
+	struct collector *col = ctx;
+
+	if (col->len < sizeof(col->buf)) {
+		col->buf[col->len++] = (char)c;
+	}
+
+	return c;
+}
+
+/* Defines a case formatting through out and one packaging */
+#define BENCH_CASE(name, fmt, ...)					\
+	static int name##_format(cbprintf_cb out, void *ctx)		\
+	{								\
+		seq++;							\
+		return cbprintf(out, ctx, fmt, __VA_ARGS__);		\
+	}								\
+									\
+	static int name##_package(cbprintf_cb out, void *ctx)		\
+	{								\
+		seq++;							\
+		return cbprintf_package(package, sizeof(package), 0,	\
+					fmt, __VA_ARGS__);		\
+	}
+
+BENCH_CASE(d, "%d", (int)seq)
+BENCH_CASE(u_x, "%u %x", seq, seq * 7U)
+BENCH_CASE(x08, "%08x", seq)
+BENCH_CASE(p, "%p", (void *)&package[seq & 7U])
+BENCH_CASE(s, "%s", ram_str)
+BENCH_CASE(s_d, "%s: %d", "rx errors", (int)seq)
+BENCH_CASE(dddd, "%d %d %d %d", (int)seq, 2, -3, (int)seq * 4)
+BENCH_CASE(lld, "%lld", (long long)seq << 32)
+BENCH_CASE(f, "%.3f", seq * 0.5)
+
+#define CASE(name, fmt) { fmt, name##_format, name##_package }
+
+static const struct {
+	const char *fmt;
+	int (*format)(cbprintf_cb out, void *ctx);
+	int (*package)(cbprintf_cb out, void *ctx);
+} cases[] = {
+	CASE(d, "%d"),
+	CASE(u_x, "%u %x"),
+	CASE(x08, "%08x"),
+	CASE(p, "%p"),
+	CASE(s, "%s"),
+	CASE(s_d, "%s: %d"),
+	CASE(dddd, "%d %d %d %d"),
+	CASE(lld, "%lld"),
+	CASE(f, "%.3f"),
+};
+
+static volatile int sink;
+
+static int render(cbprintf_cb out, void *ctx)
+{
+	return cbpprintf(out, ctx, package);
+}
+
+/* Best time per call over a few rounds, in hundredths of ns */
+static uint32_t measure(int (*fn)(cbprintf_cb out, void *ctx))
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		int acc = 0;
+
+		for (int i = 0; i < CALLS; i++) {
+			acc += fn(discard, NULL);
+		}
+
+		best = MIN(best, now_ns() - t0);
+		sink = acc;
+	}
+
+	return (uint32_t)((100U * best) / CALLS);
+}
+
+/* Checks that rendering the package matches immediate formatting */
+static bool check(int c)
+{
+	struct collector expected = { .len = 0 };
+	struct collector rendered = { .len = 0 };
+	int rc;
+
+	seq = 0;
+	rc = cases[c].format(collect, &expected);
+	seq = 0;
+	if (cases[c].package(NULL, NULL) <= 0) {
+		return false;
+	}
+
+	return render(collect, &rendered) == rc &&
+	       rendered.len == expected.len &&
+	       memcmp(rendered.buf, expected.buf, expected.len) == 0;
+}
+
+static void print_ns(uint32_t ns)
+{
+	printk(" %7u.%02u", ns / 100, ns % 100);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	printk("cbprintf benchmark, ns per call\n");
+	printk("%-14s %10s %10s %10s\n", "format", "cbprintf", "package",
+	       "render");
+
+	for (int c = 0; c < ARRAY_SIZE(cases); c++) {
+		if (!check(c)) {
+			printk("ERROR: %s renders differently\n", cases[c].fmt);
+			continue;
+		}
+
+		printk("%-14s", cases[c].fmt);
+		print_ns(measure(cases[c].format));
+		print_ns(measure(cases[c].package));
+		print_ns(measure(render));
+		printk("\n");
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
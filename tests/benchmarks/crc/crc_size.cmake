@@ -0,0 +1,30 @@
+# SPDX-License-Identifier: Apache-2.0
+
+# Sums up the sizes of the crc* symbols of ELF, as code and as
+# read-only data, using NM
+
+execute_process(
+  COMMAND ${NM} --print-size ${ELF}
+  OUTPUT_VARIABLE symbols
+  RESULT_VARIABLE result
+  )
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${NM} failed on ${ELF}")
+endif()
+
+set(code 0)
+set(data 0)
+string(REPLACE "\n" ";" symbols "${symbols}")
+foreach(line ${symbols})
+  if(line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) ([tTrR]) (crc[0-9a-z_]*)$")
+    math(EXPR size "0x${CMAKE_MATCH_1}")
+    if(CMAKE_MATCH_2 MATCHES "[tT]")
+      math(EXPR code "${code} + ${size}")
+    else()
+      math(EXPR data "${data} + ${size}")
+    endif()
+    message(STATUS "  ${CMAKE_MATCH_3}: ${size}")
+  endif()
+endforeach()
+
+message(STATUS "CRC routines: ${code} bytes of code, ${data} bytes of tables")
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+#include <timing/timing.h>
+
+/* CRC engine throughput benchmark: see README.rst */
+
+#define MAX_LEN 4096
+#define BYTES_PER_RUN (256 * 1024)
+#define ROUNDS 5
+
+#if defined(CONFIG_CRC_ENGINE_HW)
+#define ENGINE "hw"
+#elif defined(CONFIG_CRC_ENGINE_SLICE_BY_8)
+#define ENGINE "slice-by-8"
+#elif defined(CONFIG_CRC_ENGINE_TABLE)
+#define ENGINE "table"
+#else
+#define ENGINE "nibble"
+#endif
+
+static uint8_t buf[MAX_LEN];
+static const size_t lens[] = { 16, 64, 256, 1024, 4096 };
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* Every call is seeded with the result of the previous one, so that
+ * calls on short buffers can't overlap in the pipeline, nor branches
+ * be predicted from the previous calls on the same data
+ */
+static uint32_t bench_crc32_ieee(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc32_ieee_update(seed, p, len);
+}
+
+static uint32_t bench_crc16(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc16(p, len, 0x8005, seed, true);
+}
+
+static uint32_t bench_crc16_ccitt(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc16_ccitt(seed, p, len);
+}
+
+static uint32_t bench_crc16_itu_t(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc16_itu_t(seed, p, len);
+}
+
+static uint32_t bench_crc8(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc8(p, len, 0x07, seed, false);
+}
+
+static uint32_t bench_crc8_ccitt(uint32_t seed, const uint8_t *p, size_t len)
+{
+	return crc8_ccitt(seed, p, len);
+}
+
+static const struct {
+	const char *name;
+	uint32_t (*fn)(uint32_t seed, const uint8_t *p, size_t len);
+} funcs[] = {
+	{ "crc32_ieee", bench_crc32_ieee },
+	{ "crc16", bench_crc16 },
+	{ "crc16_ccitt", bench_crc16_ccitt },
+	{ "crc16_itu_t", bench_crc16_itu_t },
+	{ "crc8", bench_crc8 },
+	{ "crc8_ccitt", bench_crc8_ccitt },
+};
+
+static volatile uint32_t sink;
+
+/* Best throughput over a few rounds, in units of 10 KB/s */
+static uint32_t measure(uint32_t (*fn)(uint32_t seed, const uint8_t *p,
+				       size_t len), size_t len)
+{
+	uint64_t best = UINT64_MAX;
+	size_t runs = BYTES_PER_RUN / len;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		uint32_t acc = 0;
+
+		for (size_t i = 0; i < runs; i++) {
+			acc = fn(acc, buf, len);
+		}
+
+		best = MIN(best, now_ns() - t0);
+		sink = acc;
+	}
+
+	return (uint32_t)((100000ULL * runs * len) / MAX(best, 1));
+}
+
+void main(void)
+{
+	uint32_t x = 1;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		x = x * 1103515245U + 12345U;
+		buf[i] = x >> 24;
+	}
+
+	if (crc32_ieee((const uint8_t *)"123456789", 9) != 0xcbf43926) {
+		printk("ERROR: wrong crc32_ieee result\n");
+	}
+
+	printk("CRC benchmark, %s engine, throughput in MB/s\n", ENGINE);
+	printk("%-12s", "bytes");
+	for (int l = 0; l < ARRAY_SIZE(lens); l++) {
+		printk(" %9zu", lens[l]);
+	}
+	printk("\n");
+
+	for (int f = 0; f < ARRAY_SIZE(funcs); f++) {
+		printk("%-12s", funcs[f].name);
+		for (int l = 0; l < ARRAY_SIZE(lens); l++) {
+			uint32_t rate = measure(funcs[f].fn, lens[l]);
+
+			printk(" %6u.%02u", rate / 100, rate % 100);
+		}
+		printk("\n");
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
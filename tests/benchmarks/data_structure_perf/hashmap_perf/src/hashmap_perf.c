@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/slist.h>
+#include <sys/dlist.h>
+#include <sys/rb.h>
+#include <sys/hashmap.h>
+#include <timing/timing.h>
+
+/* Lookups by key in the containers of lib/os, for a few sizes: the
+ * lists are scanned, the rbtree is descended and the hash map probed.
+ */
+
+#define MAX_ITEMS 512
+#define OPS 20000
+
+struct item {
+	sys_snode_t snode;
+	sys_dnode_t dnode;
+	struct rbnode rbnode;
+	uint32_t key;
+};
+
+static struct item items[MAX_ITEMS];
+static uint32_t lookup_keys[OPS];
+
+static sys_slist_t slist;
+static sys_dlist_t dlist;
+static struct rbtree tree;
+
+static uint32_t hash_key(const void *key)
+{
+	return sys_hash32_u32(*(const uint32_t *)key);
+}
+
+static bool match_key(const void *entry, const void *key)
+{
+	return ((const struct item *)entry)->key == *(const uint32_t *)key;
+}
+
+SYS_HASHMAP_DEFINE_STATIC(map, 2 * MAX_ITEMS, hash_key, match_key);
+
+static bool key_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct item, rbnode)->key <
+	       CONTAINER_OF(b, struct item, rbnode)->key;
+}
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static struct item *slist_find(uint32_t key)
+{
+	struct item *it;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&slist, it, snode) {
+		if (it->key == key) {
+			return it;
+		}
+	}
+
+	return NULL;
+}
+
+static struct item *dlist_find(uint32_t key)
+{
+	struct item *it;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&dlist, it, dnode) {
+		if (it->key == key) {
+			return it;
+		}
+	}
+
+	return NULL;
+}
+
+static struct item *rbtree_find(uint32_t key)
+{
+	struct rbnode *n = tree.root;
+
+	while (n != NULL) {
+		struct item *it = CONTAINER_OF(n, struct item, rbnode);
+
+		if (it->key == key) {
+			return it;
+		}
+
+		n = z_rb_child(n, it->key < key);
+	}
+
+	return NULL;
+}
+
+static struct item *hashmap_find(uint32_t key)
+{
+	return sys_hashmap_get(&map, &key);
+}
+
+/* Removal by key, then insertion back, as when a connection closes
+ * and another one opens
+ */
+static struct item *slist_cycle(uint32_t key)
+{
+	struct item *it = slist_find(key);
+
+	sys_slist_find_and_remove(&slist, &it->snode);
+	sys_slist_prepend(&slist, &it->snode);
+
+	return it;
+}
+
+static struct item *dlist_cycle(uint32_t key)
+{
+	struct item *it = dlist_find(key);
+
+	sys_dlist_remove(&it->dnode);
+	sys_dlist_prepend(&dlist, &it->dnode);
+
+	return it;
+}
+
+static struct item *rbtree_cycle(uint32_t key)
+{
+	struct item *it = rbtree_find(key);
+
+	rb_remove(&tree, &it->rbnode);
+	rb_insert(&tree, &it->rbnode);
+
+	return it;
+}
+
+static struct item *hashmap_cycle(uint32_t key)
+{
+	struct item *it = sys_hashmap_remove(&map, &key);
+
+	(void)sys_hashmap_insert(&map, &key, it);
+
+	return it;
+}
+
+static const struct {
+	const char *name;
+	struct item *(*find)(uint32_t key);
+	struct item *(*cycle)(uint32_t key);
+} containers[] = {
+	{ "slist", slist_find, slist_cycle },
+	{ "dlist", dlist_find, dlist_cycle },
+	{ "rbtree", rbtree_find, rbtree_cycle },
+	{ "hashmap", hashmap_find, hashmap_cycle },
+};
+
+static void fill(int n)
+{
+	static uint32_t state = 12345U;
+
+	sys_slist_init(&slist);
+	sys_dlist_init(&dlist);
+	(void)memset(&tree, 0, sizeof(tree));
+	tree.lessthan_fn = key_lessthan;
+	sys_hashmap_clear(&map);
+
+	for (int i = 0; i < n; i++) {
+		sys_slist_prepend(&slist, &items[i].snode);
+		sys_dlist_prepend(&dlist, &items[i].dnode);
+		rb_insert(&tree, &items[i].rbnode);
+		zassert_ok(sys_hashmap_insert(&map, &items[i].key, &items[i]),
+			   NULL);
+	}
+
+	for (int i = 0; i < OPS; i++) {
+		state = state * 1664525U + 1013904223U;
+		lookup_keys[i] = items[(state >> 8) % n].key;
+	}
+}
+
+/* Time per call, in hundredths of ns */
+static uint32_t measure(struct item *(*fn)(uint32_t key))
+{
+	uint64_t t0 = now_ns();
+	int found = 0;
+
+	for (int i = 0; i < OPS; i++) {
+		found += (fn(lookup_keys[i]) != NULL) ? 1 : 0;
+	}
+
+	t0 = now_ns() - t0;
+	zassert_equal(found, OPS, "lost items");
+
+	return (uint32_t)((100U * t0) / OPS);
+}
+
+static void print_ns(uint32_t ns)
+{
+	TC_PRINT(" %7u.%02u", ns / 100, ns % 100);
+}
+
+/**
+ * @brief Compare the cost of lookups in the lib/os containers
+ *
+ * @details Reports the time of a lookup by key, and of a removal by
+ * key followed by an insertion, in singly and doubly linked lists, in
+ * a red/black tree and in a hash map, for a few numbers of items.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see sys_hashmap_get(), sys_hashmap_insert(), sys_hashmap_remove()
+ */
+void test_hashmap_perf(void)
+{
+	static const int sizes[] = { 4, 16, 64, 256, MAX_ITEMS };
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		/* Spread the keys, as they would be in real maps */
+		items[i].key = i * 2654435761U;
+	}
+
+	TC_PRINT("ns per operation\n%-14s", "items");
+	for (int c = 0; c < ARRAY_SIZE(containers); c++) {
+		TC_PRINT(" %10s", containers[c].name);
+	}
+	TC_PRINT("\n");
+
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		fill(sizes[s]);
+
+		TC_PRINT("%4d lookup   ", sizes[s]);
+		for (int c = 0; c < ARRAY_SIZE(containers); c++) {
+			print_ns(measure(containers[c].find));
+		}
+		TC_PRINT("\n%4d rm+insert", sizes[s]);
+		for (int c = 0; c < ARRAY_SIZE(containers); c++) {
+			print_ns(measure(containers[c].cycle));
+		}
+		TC_PRINT("\n");
+	}
+
+	timing_stop();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hashmap,
+			 ztest_unit_test(test_hashmap_perf)
+			 );
+	ztest_run_test_suite(hashmap);
+}
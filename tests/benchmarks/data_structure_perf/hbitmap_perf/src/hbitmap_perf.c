@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <spinlock.h>
+#include <sys/hbitmap.h>
+#include <timing/timing.h>
+
+/* Allocation of the lowest free index among 64k, at a few occupancies:
+ * with a linear scan of a bitmap under a spinlock, as kernel pools do,
+ * and with the hierarchical bitmap.
+ */
+
+#define N_BITS (64 * 1024)
+#define OPS 20000
+
+struct allocator {
+	const char *name;
+	void (*reset)(void);
+	int (*alloc)(void);
+	void (*free)(uint32_t idx);
+};
+
+static uint32_t scan_words[N_BITS / 32];
+static struct k_spinlock scan_lock;
+
+SYS_HBITMAP_DEFINE_STATIC(hbm, N_BITS);
+
+/* Allocated indexes, one of which is freed after each allocation */
+static uint32_t held[N_BITS];
+static uint32_t victims[OPS];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static uint32_t rand_state = 123456789;
+
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return rand_state >> 8;
+}
+
+static void scan_reset(void)
+{
+	(void)memset(scan_words, 0, sizeof(scan_words));
+}
+
+static int scan_alloc(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&scan_lock);
+	int ret = -ENOSPC;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(scan_words); i++) {
+		if (scan_words[i] != 0U) {
+			uint32_t bit = find_lsb_set(scan_words[i]) - 1;
+
+			scan_words[i] &= ~BIT(bit);
+			ret = i * 32 + bit;
+			break;
+		}
+	}
+
+	k_spin_unlock(&scan_lock, key);
+
+	return ret;
+}
+
+static void scan_free(uint32_t idx)
+{
+	k_spinlock_key_t key = k_spin_lock(&scan_lock);
+
+	scan_words[idx / 32] |= BIT(idx % 32);
+	k_spin_unlock(&scan_lock, key);
+}
+
+static void hbitmap_reset(void)
+{
+	sys_hbitmap_init(&hbm, hbm.words, N_BITS);
+}
+
+static int hbitmap_alloc(void)
+{
+	return sys_hbitmap_alloc(&hbm);
+}
+
+static void hbitmap_free(uint32_t idx)
+{
+	sys_hbitmap_free(&hbm, idx);
+}
+
+static const struct allocator allocators[] = {
+	{ "linear scan", scan_reset, scan_alloc, scan_free },
+	{ "hbitmap", hbitmap_reset, hbitmap_alloc, hbitmap_free },
+};
+
+/* Allocates n_used indexes, leaving free ones spread at random */
+static void fill(const struct allocator *a, uint32_t n_used)
+{
+	for (uint32_t i = 0; i < N_BITS; i++) {
+		held[i] = i;
+	}
+
+	/* Shuffle the same way for all allocators, and free all but the
+	 * first n_used of them
+	 */
+	rand_state = n_used;
+	for (uint32_t i = N_BITS - 1; i > 0; i--) {
+		uint32_t j = next_rand() % (i + 1);
+		uint32_t tmp = held[i];
+
+		held[i] = held[j];
+		held[j] = tmp;
+	}
+
+	a->reset();
+	for (uint32_t i = n_used; i < N_BITS; i++) {
+		a->free(held[i]);
+	}
+}
+
+/* Time of an allocation plus the free of a random allocated index,
+ * keeping the occupancy, in hundredths of ns
+ */
+static uint32_t measure(const struct allocator *a, uint32_t n_used)
+{
+	uint64_t t0;
+	int failed = 0;
+
+	fill(a, n_used);
+
+	t0 = now_ns();
+	for (int i = 0; i < OPS; i++) {
+		int idx = a->alloc();
+
+		if (idx < 0) {
+			failed++;
+			continue;
+		}
+
+		a->free(held[victims[i]]);
+		held[victims[i]] = idx;
+	}
+
+	t0 = now_ns() - t0;
+	zassert_equal(failed, 0, "%s: allocations failed", a->name);
+
+	return (uint32_t)((100U * t0) / OPS);
+}
+
+/**
+ * @brief Compare the cost of allocating indexes from a bitmap
+ *
+ * @details Reports the time of an allocation of the lowest free index
+ * followed by the free of a random allocated one, among 64k indexes of
+ * which 50%, 90% and 99% are allocated, with a linear scan and with
+ * the hierarchical bitmap.
+ *
+ * @ingroup lib_hbitmap_tests
+ *
+ * @see sys_hbitmap_alloc(), sys_hbitmap_free()
+ */
+void test_hbitmap_perf(void)
+{
+	static const int percents[] = { 50, 90, 99 };
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	TC_PRINT("ns per allocation and free, %u indexes\n%-10s", N_BITS,
+		 "allocated");
+	for (int a = 0; a < ARRAY_SIZE(allocators); a++) {
+		TC_PRINT(" %12s", allocators[a].name);
+	}
+	TC_PRINT("\n");
+
+	for (int p = 0; p < ARRAY_SIZE(percents); p++) {
+		uint32_t n_used = N_BITS / 100 * percents[p];
+
+		for (int i = 0; i < OPS; i++) {
+			victims[i] = next_rand() % n_used;
+		}
+
+		TC_PRINT("%9d%%", percents[p]);
+		for (int a = 0; a < ARRAY_SIZE(allocators); a++) {
+			uint32_t ns = measure(&allocators[a], n_used);
+
+			TC_PRINT(" %9u.%02u", ns / 100, ns % 100);
+		}
+		TC_PRINT("\n");
+	}
+
+	timing_stop();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hbitmap,
+			 ztest_unit_test(test_hbitmap_perf)
+			 );
+	ztest_run_test_suite(hbitmap);
+}
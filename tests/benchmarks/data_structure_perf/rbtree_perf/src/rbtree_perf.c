@@ -6,6 +6,7 @@
 
 #include <ztest.h>
 #include <sys/rb.h>
+#include <timing/timing.h>
 
 #define TREE_SIZE 512
 /* zephyr can't do floating-point arithmetic,
@@ -207,11 +208,179 @@ void test_rbtree_perf(void)
 	verify_rbtree_perf(root, test);
 }
 
+/* Cost measurements: the tree is filled and emptied ROUNDS times in
+ * each way, and the time per operation is reported.
+ */
+#define ROUNDS 20
+
+static struct rbnode *order[TREE_SIZE];
+static struct rbnode *sorted[TREE_SIZE];
+static volatile uintptr_t sink;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static void report(const char *what, uint64_t ns, uint32_t ops)
+{
+	uint32_t centi_ns = (uint32_t)((100U * ns) / ops);
+
+	TC_PRINT("%-28s %6u.%02u ns/op\n", what, centi_ns / 100,
+		 centi_ns % 100);
+}
+
+static void shuffle(struct rbnode **arr)
+{
+	static uint32_t state = 12345U;
+
+	for (int i = 0; i < TREE_SIZE; i++) {
+		arr[i] = &nodes[i];
+	}
+
+	for (int i = TREE_SIZE - 1; i > 0; i--) {
+		struct rbnode *tmp = arr[i];
+		int j;
+
+		state = state * 1664525U + 1013904223U;
+		j = (state >> 8) % (i + 1);
+		arr[i] = arr[j];
+		arr[j] = tmp;
+	}
+}
+
+static void fill(struct rbnode **arr)
+{
+	(void)memset(&tree, 0, sizeof(tree));
+	tree.lessthan_fn = node_lessthan;
+	for (int i = 0; i < TREE_SIZE; i++) {
+		rb_insert(&tree, arr[i]);
+	}
+}
+
+static void count_node(struct rbnode *node, void *cookie)
+{
+	(*(uint32_t *)cookie)++;
+}
+
+/**
+ * @brief Measure the cost of the rbtree operations
+ *
+ * @details Reports the time taken by insertions and removals in random
+ * order, by getting the lowest node (cached by the tree, or looked up
+ * by descending it as rb_get_min() used to), by popping the lowest
+ * node as schedulers and timeout queues do, by building a tree from
+ * sorted nodes and by walking it.
+ *
+ * @ingroup lib_rbtree_tests
+ *
+ * @see rb_insert(), rb_remove(), rb_get_min(), rb_build(), rb_walk()
+ */
+void test_rbtree_costs(void)
+{
+	uint32_t ops = ROUNDS * TREE_SIZE;
+	uint64_t t0, t_insert = 0, t_remove = 0, t_pop = 0;
+	uint64_t t_seq = 0, t_build = 0;
+	uintptr_t acc = 0;
+	uint32_t count = 0;
+	struct rbnode *n;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	shuffle(order);
+	for (int i = 0; i < TREE_SIZE; i++) {
+		sorted[i] = &nodes[i];
+	}
+
+	for (int r = 0; r < ROUNDS; r++) {
+		t0 = now_ns();
+		fill(order);
+		t_insert += now_ns() - t0;
+
+		t0 = now_ns();
+		for (int i = 0; i < TREE_SIZE; i++) {
+			rb_remove(&tree, order[TREE_SIZE - 1 - i]);
+		}
+		t_remove += now_ns() - t0;
+		zassert_is_null(tree.root, NULL);
+
+		fill(order);
+		t0 = now_ns();
+		while ((n = rb_get_min(&tree)) != NULL) {
+			rb_remove(&tree, n);
+		}
+		t_pop += now_ns() - t0;
+
+		t0 = now_ns();
+		fill(sorted);
+		t_seq += now_ns() - t0;
+
+		t0 = now_ns();
+		rb_build(&tree, sorted, TREE_SIZE);
+		t_build += now_ns() - t0;
+	}
+
+	report("insert (random order)", t_insert, ops);
+	report("remove (random order)", t_remove, ops);
+	report("remove min until empty", t_pop, ops);
+	report("insert (sorted)", t_seq, ops);
+	report("rb_build (sorted)", t_build, ops);
+
+	t0 = now_ns();
+	for (int i = 0; i < ops; i++) {
+		acc += (uintptr_t)z_rb_get_minmax(&tree, i & 1);
+	}
+	report("min/max lookup (descend)", now_ns() - t0, ops);
+
+	t0 = now_ns();
+	for (int i = 0; i < ops; i++) {
+		acc += (uintptr_t)(i & 1 ? rb_get_max(&tree) :
+				   rb_get_min(&tree));
+	}
+	report("min/max lookup (cached)", now_ns() - t0, ops);
+
+	t0 = now_ns();
+	for (int r = 0; r < ROUNDS; r++) {
+		rb_walk(&tree, count_node, &count);
+	}
+	report("rb_walk, per node", now_ns() - t0, ops);
+	zassert_equal(count, ops, NULL);
+
+	t0 = now_ns();
+	for (int r = 0; r < ROUNDS; r++) {
+		RB_FOR_EACH(&tree, n) {
+			acc += (uintptr_t)n;
+		}
+	}
+	report("RB_FOR_EACH, per node", now_ns() - t0, ops);
+
+	sink = acc;
+	timing_stop();
+}
+
 void test_main(void)
 {
 	ztest_test_suite(rbtree,
 			 ztest_unit_test(test_rbtree_container),
-			 ztest_unit_test(test_rbtree_perf)
+			 ztest_unit_test(test_rbtree_perf),
+			 ztest_unit_test(test_rbtree_costs)
 			 );
 	ztest_run_test_suite(rbtree);
 }
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+#include <timing/timing.h>
+#include "trace.h"
+
+/* Heap allocator trace replay benchmark: see README.rst */
+
+#define HEAP_SIZE (32 * 1024)
+#define ROUNDS 20
+
+static char heap_mem[HEAP_SIZE];
+static struct sys_heap heap;
+static void *slots[TRACE_MAX_SLOTS];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static uint32_t replay(struct trace *t)
+{
+	uint32_t fail = 0;
+
+	for (size_t i = 0; i < t->n_ops; i++) {
+		struct trace_op *op = &t->ops[i];
+		void *p;
+
+		switch (op->type) {
+		case TRACE_ALLOC:
+			slots[op->slot] = (op->align != 0U)
+				? sys_heap_aligned_alloc(&heap, op->align, op->size)
+				: sys_heap_alloc(&heap, op->size);
+			fail += (slots[op->slot] == NULL);
+			break;
+		case TRACE_FREE:
+			sys_heap_free(&heap, slots[op->slot]);
+			slots[op->slot] = NULL;
+			break;
+		case TRACE_REALLOC:
+			/* On failure the old block stays valid */
+			p = sys_heap_aligned_realloc(&heap, slots[op->slot],
+						     op->align, op->size);
+			if (p != NULL) {
+				slots[op->slot] = p;
+			} else {
+				fail++;
+			}
+			break;
+		}
+	}
+
+	return fail;
+}
+
+/* Largest block that can still be allocated: a measure of how
+ * fragmented the trace left the heap
+ */
+static size_t largest_free(void)
+{
+	size_t lo = 0, hi = HEAP_SIZE;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi + 1) / 2;
+		void *p = sys_heap_alloc(&heap, mid);
+
+		if (p != NULL) {
+			sys_heap_free(&heap, p);
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return lo;
+}
+
+static void run(struct trace *t)
+{
+	uint64_t ns = 0;
+	uint32_t fail = 0;
+	size_t largest = 0;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0;
+
+		sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+		t0 = now_ns();
+		fail += replay(t);
+		ns += now_ns() - t0;
+
+		largest = largest_free();
+
+		for (int s = 0; s < t->n_slots; s++) {
+			sys_heap_free(&heap, slots[s]);
+			slots[s] = NULL;
+		}
+	}
+
+	if (!sys_heap_validate(&heap)) {
+		printk("ERROR: heap corrupted after trace %s\n", t->name);
+	}
+
+	printk("%-8s ops %6u ns/op %5u fail %5u largest %6u\n", t->name,
+	       (uint32_t)t->n_ops, (uint32_t)(ns / (ROUNDS * t->n_ops)),
+	       fail / ROUNDS, (uint32_t)largest);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	traces_record();
+
+	printk("Heap trace replay benchmark, %u byte heap (%s)\n", HEAP_SIZE,
+	       IS_ENABLED(CONFIG_SYS_HEAP_QUICK_LISTS) ? "quick lists"
+						       : "buckets only");
+
+	for (int i = 0; i < n_traces; i++) {
+		run(&traces[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/* An allocation trace is a flat list of operations on numbered
+ * "slots", each of which holds at most one live block.  Replaying
+ * by slot rather than by address lets the same trace run against
+ * any heap layout.  A non-zero align makes an allocation or
+ * reallocation an aligned one; it is passed through as is, so it
+ * may carry a rewind value (see sys_heap_aligned_alloc()).
+ */
+enum trace_op_type {
+	TRACE_ALLOC,
+	TRACE_FREE,
+	TRACE_REALLOC,
+};
+
+struct trace_op {
+	uint8_t type;
+	uint16_t slot;
+	uint16_t align;
+	uint32_t size;
+};
+
+struct trace {
+	const char *name;
+	struct trace_op *ops;
+	size_t n_ops;
+	uint16_t n_slots;
+};
+
+#define TRACE_MAX_OPS 8000
+#define TRACE_MAX_SLOTS 512
+
+extern struct trace traces[];
+extern const int n_traces;
+
+void traces_record(void);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include "trace.h"
+
+/* Synthetic traces, recorded once at startup from simple models of
+ * the allocation patterns we see in practice, so that every heap
+ * configuration replays exactly the same sequence.  A trace ends
+ * with blocks still live; the replay frees them.
+ */
+
+static struct trace_op kmalloc_ops[TRACE_MAX_OPS];
+static struct trace_op net_ops[TRACE_MAX_OPS];
+static struct trace_op realloc_ops[TRACE_MAX_OPS];
+static struct trace_op aligned_ops[TRACE_MAX_OPS];
+
+struct trace traces[] = {
+	{ .name = "kmalloc", .ops = kmalloc_ops, .n_slots = 256 },
+	{ .name = "net", .ops = net_ops, .n_slots = 128 },
+	{ .name = "realloc", .ops = realloc_ops, .n_slots = 128 },
+	{ .name = "aligned", .ops = aligned_ops, .n_slots = 128 },
+};
+
+const int n_traces = ARRAY_SIZE(traces);
+
+static struct trace *cur;
+static uint32_t sizes[TRACE_MAX_SLOTS];
+static uint32_t rand_state;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32 */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static uint32_t rand_range(uint32_t lo, uint32_t hi)
+{
+	return lo + next_rand() % (hi - lo + 1);
+}
+
+static bool full(void)
+{
+	return cur->n_ops >= TRACE_MAX_OPS;
+}
+
+static void record_aligned(uint8_t type, int slot, uint32_t size,
+			   uint16_t align)
+{
+	cur->ops[cur->n_ops++] = (struct trace_op) {
+		.type = type, .slot = slot, .align = align, .size = size,
+	};
+	sizes[slot] = (type == TRACE_FREE) ? 0 : size;
+}
+
+static void record(uint8_t type, int slot, uint32_t size)
+{
+	record_aligned(type, slot, size, 0);
+}
+
+/* Random slot that is (or isn't) live, -1 if there is none */
+static int pick_slot(bool live)
+{
+	int start = next_rand() % cur->n_slots;
+
+	for (int i = 0; i < cur->n_slots; i++) {
+		int s = (start + i) % cur->n_slots;
+
+		if ((sizes[s] != 0) == live) {
+			return s;
+		}
+	}
+	return -1;
+}
+
+static void begin(struct trace *t, uint32_t seed)
+{
+	cur = t;
+	cur->n_ops = 0;
+	rand_state = seed;
+	memset(sizes, 0, sizeof(sizes));
+}
+
+/* k_malloc() style traffic: mostly 16-128 byte objects with random
+ * lifetimes, some larger ones
+ */
+static uint32_t kmalloc_size(void)
+{
+	uint32_t r = next_rand() % 100;
+
+	if (r < 70) {
+		return rand_range(16, 64);
+	} else if (r < 95) {
+		return rand_range(65, 128);
+	}
+	return rand_range(129, 1024);
+}
+
+static void record_kmalloc(void)
+{
+	begin(&traces[0], 0x5eed0001);
+
+	while (!full()) {
+		int s = pick_slot(false);
+		int l = pick_slot(true);
+
+		if ((s >= 0) && ((l < 0) || ((next_rand() % 100) < 52))) {
+			record(TRACE_ALLOC, s, kmalloc_size());
+		} else {
+			record(TRACE_FREE, l, 0);
+		}
+	}
+}
+
+/* Network style traffic: packets of a small header plus a payload
+ * buffer, released in arrival order after a varying queueing
+ * delay, mixed with short-lived small context objects
+ */
+static void record_net(void)
+{
+	int fifo[64];
+	int head = 0, tail = 0;
+
+	begin(&traces[1], 0x5eed0002);
+
+	while (TRACE_MAX_OPS - cur->n_ops >= 4) {
+		int depth = (tail - head) / 2;
+		int s;
+
+		if ((depth > 0) && ((depth >= 24) ||
+				    ((next_rand() % 100) < 40))) {
+			record(TRACE_FREE, fifo[head++ % ARRAY_SIZE(fifo)], 0);
+			record(TRACE_FREE, fifo[head++ % ARRAY_SIZE(fifo)], 0);
+		} else if (((s = pick_slot(false)) >= 0)) {
+			record(TRACE_ALLOC, s, 64);
+			fifo[tail++ % ARRAY_SIZE(fifo)] = s;
+			s = pick_slot(false);
+			record(TRACE_ALLOC, s, rand_range(128, 1536));
+			fifo[tail++ % ARRAY_SIZE(fifo)] = s;
+		}
+
+		/* Short-lived context objects (slots never used by the
+		 * packet queue are plenty)
+		 */
+		s = pick_slot(false);
+		if ((s >= 0) && (next_rand() % 2)) {
+			record(TRACE_ALLOC, s, rand_range(24, 48));
+			record(TRACE_FREE, s, 0);
+		}
+	}
+}
+
+/* Growing buffers: blocks that are repeatedly reallocated to twice
+ * their size, next to small static-ish allocations
+ */
+static void record_realloc(void)
+{
+	begin(&traces[2], 0x5eed0003);
+
+	while (!full()) {
+		uint32_t r = next_rand() % 100;
+		int s;
+
+		if (r < 40) {
+			s = pick_slot(true);
+			if (s < 0) {
+				continue;
+			}
+			if (sizes[s] >= 2048) {
+				record(TRACE_FREE, s, 0);
+			} else {
+				record(TRACE_REALLOC, s, sizes[s] * 2);
+			}
+		} else if (r < 70) {
+			s = pick_slot(false);
+			if (s >= 0) {
+				record(TRACE_ALLOC, s, rand_range(24, 96));
+			}
+		} else {
+			s = pick_slot(true);
+			if (s >= 0) {
+				record(TRACE_FREE, s, 0);
+			}
+		}
+	}
+}
+
+/* DMA style buffers: 32 or 64 byte aligned blocks, some of which
+ * are later grown with an aligned realloc, next to unaligned small
+ * objects
+ */
+static void record_aligned_bufs(void)
+{
+	static uint16_t aligns[TRACE_MAX_SLOTS];
+
+	begin(&traces[3], 0x5eed0004);
+
+	while (!full()) {
+		uint32_t r = next_rand() % 100;
+		int s;
+
+		if (r < 25) {
+			s = pick_slot(false);
+			if (s >= 0) {
+				aligns[s] = (next_rand() % 2) ? 32 : 64;
+				record_aligned(TRACE_ALLOC, s, rand_range(64, 384),
+					       aligns[s]);
+			}
+		} else if (r < 35) {
+			s = pick_slot(true);
+			if ((s >= 0) && (aligns[s] != 0U) && (sizes[s] < 1024)) {
+				record_aligned(TRACE_REALLOC, s,
+					       sizes[s] + sizes[s] / 2,
+					       aligns[s]);
+			}
+		} else if (r < 55) {
+			s = pick_slot(false);
+			if (s >= 0) {
+				aligns[s] = 0;
+				record(TRACE_ALLOC, s, rand_range(16, 64));
+			}
+		} else {
+			s = pick_slot(true);
+			if (s >= 0) {
+				record(TRACE_FREE, s, 0);
+			}
+		}
+	}
+}
+
+void traces_record(void)
+{
+	record_kmalloc();
+	record_net();
+	record_realloc();
+	record_aligned_bufs();
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "capture.h"
+
+/* Records a trace through the k_heap trace hook while a small
+ * message passing workload runs on the k_malloc() pool.  The same
+ * hook can be installed in any application to capture its own
+ * traces.
+ */
+
+#define N_MSGS 2000
+#define N_REPLIES 8
+#define STACK_SIZE 1024
+
+struct msg {
+	void *fifo_reserved;
+	uint32_t seq;
+	uint32_t len;
+	uint8_t data[];
+};
+
+static struct trace_op captured_ops[TRACE_MAX_OPS];
+struct trace captured = { .name = "captured", .ops = captured_ops };
+
+/* Address of the live block in each slot */
+static void *live[TRACE_MAX_SLOTS];
+
+/* Tells the consumer there are no more messages */
+static struct msg last_msg;
+
+static K_FIFO_DEFINE(msgs);
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_thread consumer_thread;
+
+static int find_slot(void *mem)
+{
+	for (int s = 0; s < TRACE_MAX_SLOTS; s++) {
+		if (live[s] == mem) {
+			return s;
+		}
+	}
+	return -1;
+}
+
+static void capture_hook(struct k_heap *h, enum k_heap_trace_op op,
+			 void *mem, size_t align, size_t bytes)
+{
+	struct trace_op *t = &captured.ops[captured.n_ops];
+	int s;
+
+	ARG_UNUSED(h);
+
+	if (captured.n_ops >= TRACE_MAX_OPS) {
+		return;
+	}
+
+	/* Blocks that didn't get a slot are left out of the trace,
+	 * allocation and free alike
+	 */
+	s = find_slot((op == K_HEAP_TRACE_ALLOC) ? NULL : mem);
+	if (s < 0) {
+		return;
+	}
+
+	if (op == K_HEAP_TRACE_ALLOC) {
+		live[s] = mem;
+		*t = (struct trace_op) {
+			.type = TRACE_ALLOC, .slot = s,
+			.align = align, .size = bytes,
+		};
+	} else {
+		live[s] = NULL;
+		*t = (struct trace_op) { .type = TRACE_FREE, .slot = s };
+	}
+
+	captured.n_ops++;
+	captured.n_slots = MAX(captured.n_slots, s + 1);
+}
+
+static uint32_t rand_state = 0x5eed0005;
+
+static uint32_t next_rand(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	for (uint32_t i = 0; i < N_MSGS; i++) {
+		uint32_t len = 8 + next_rand() % 248;
+		struct msg *m = k_malloc(sizeof(*m) + len);
+
+		if (m == NULL) {
+			k_yield();
+			continue;
+		}
+		m->seq = i;
+		m->len = len;
+		k_fifo_put(&msgs, m);
+
+		/* Let the consumer drain the queue now and then */
+		if ((next_rand() % 4) == 0) {
+			k_yield();
+		}
+	}
+	k_fifo_put(&msgs, &last_msg);
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	void *replies[N_REPLIES] = { 0 };
+	void *dma = NULL;
+
+	while (true) {
+		struct msg *msg = k_fifo_get(&msgs, K_FOREVER);
+
+		if (msg == &last_msg) {
+			break;
+		}
+
+		/* Keep a few replies around for a while */
+		k_free(replies[msg->seq % N_REPLIES]);
+		replies[msg->seq % N_REPLIES] = k_calloc(1, msg->len / 2 + 16);
+
+		/* Now and then, an aligned buffer for "hardware" */
+		if ((msg->seq % 16) == 0) {
+			k_free(dma);
+			dma = k_aligned_alloc(32, 256 + msg->len);
+		}
+
+		k_free(msg);
+	}
+
+	for (int i = 0; i < N_REPLIES; i++) {
+		k_free(replies[i]);
+	}
+	k_free(dma);
+}
+
+void capture_trace(void)
+{
+	k_heap_trace_hook_set(capture_hook);
+
+	k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+			consumer, NULL, NULL, NULL, K_PRIO_PREEMPT(2), 0,
+			K_NO_WAIT);
+	k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+			producer, NULL, NULL, NULL, K_PRIO_PREEMPT(2), 0,
+			K_NO_WAIT);
+
+	k_thread_join(&producer_thread, K_FOREVER);
+	k_thread_join(&consumer_thread, K_FOREVER);
+
+	k_heap_trace_hook_set(NULL);
+}
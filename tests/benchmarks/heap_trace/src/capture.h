@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include "trace.h"
+
+/* Trace recorded by capture_trace() */
+extern struct trace captured;
+
+void capture_trace(void);
+
+#endif /* CAPTURE_H_ */
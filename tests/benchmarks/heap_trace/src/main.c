@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+#include <timing/timing.h>
+#include <string.h>
+#include "heap.h"
+#include "capture.h"
+
+/* Heap trace replay and fragmentation benchmark: see README.rst */
+
+#define HEAP_SIZE (32 * 1024)
+#define ROUNDS 10
+#define SAMPLE_OPS 100
+#define REPORT_OPS 1000
+
+static char heap_mem[HEAP_SIZE];
+static struct sys_heap heap;
+static void *slots[TRACE_MAX_SLOTS];
+
+/* Cost of each operation of the trace, lowest seen over the rounds */
+static uint32_t op_cycles[TRACE_MAX_OPS];
+
+static timing_t timing_base;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+#if defined(CONFIG_ARCH_POSIX) && (defined(__x86_64__) || defined(__i386__))
+/* Simulated cycles don't advance with the work being measured, so
+ * count the host's instead
+ */
+static inline uint64_t cycles(void)
+{
+	return __builtin_ia32_rdtsc();
+}
+#else
+static inline uint64_t cycles(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_get(&timing_base, &t);
+}
+#endif
+
+struct usage {
+	size_t free;
+	size_t largest;
+};
+
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+static uint32_t quick_map[HEAP_SIZE / CHUNK_UNIT / 32];
+
+static bool in_quick_list(chunkid_t c)
+{
+	return (quick_map[c / 32] & BIT(c % 32)) != 0U;
+}
+#endif
+
+/* Walks the heap to find how many bytes are free, and the largest
+ * block that could be allocated assuming a complete search of the
+ * free lists.  Chunks cached in quick lists count as free, as they
+ * would be merged back before an allocation fails.  Unlike probing
+ * with allocations, this doesn't change the state of the heap.
+ */
+static void heap_usage(struct usage *u)
+{
+	struct z_heap *h = heap.heap;
+	size_t run = 0, largest = 0;
+	chunkid_t c;
+
+	u->free = 0;
+
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+	memset(quick_map, 0, sizeof(quick_map));
+	for (int i = 0; i < Z_HEAP_QUICK_LISTS; i++) {
+		for (c = h->quick[i]; c != 0; c = next_free_chunk(h, c)) {
+			quick_map[c / 32] |= BIT(c % 32);
+		}
+	}
+#endif
+
+	for (c = right_chunk(h, 0); c < h->len; c = right_chunk(h, c)) {
+		bool is_free = !chunk_used(h, c);
+
+#ifdef CONFIG_SYS_HEAP_QUICK_LISTS
+		is_free = is_free || in_quick_list(c);
+#endif
+		if (is_free) {
+			run += chunk_size(h, c);
+			u->free += chunk_size(h, c) * CHUNK_UNIT;
+		} else {
+			largest = MAX(largest, run);
+			run = 0;
+		}
+	}
+	largest = MAX(largest, run);
+
+	u->largest = (largest > 0)
+		? (largest * CHUNK_UNIT - chunk_header_bytes(h)) : 0;
+}
+
+static uint32_t frag_percent(struct usage *u)
+{
+	return (u->free > 0) ? (100U - (100U * u->largest) / u->free) : 0;
+}
+
+static bool do_op(struct trace_op *op)
+{
+	void *p;
+
+	switch (op->type) {
+	case TRACE_ALLOC:
+		slots[op->slot] = (op->align != 0U)
+			? sys_heap_aligned_alloc(&heap, op->align, op->size)
+			: sys_heap_alloc(&heap, op->size);
+		return slots[op->slot] != NULL;
+	case TRACE_FREE:
+		sys_heap_free(&heap, slots[op->slot]);
+		slots[op->slot] = NULL;
+		return true;
+	case TRACE_REALLOC:
+		/* On failure the old block stays valid */
+		p = sys_heap_aligned_realloc(&heap, slots[op->slot],
+					     op->align, op->size);
+		if (p == NULL) {
+			return false;
+		}
+		slots[op->slot] = p;
+		return true;
+	}
+	return false;
+}
+
+static void reset(struct trace *t)
+{
+	for (int s = 0; s < t->n_slots; s++) {
+		sys_heap_free(&heap, slots[s]);
+		slots[s] = NULL;
+	}
+}
+
+/* Untimed pass that follows fragmentation as the trace goes on */
+static void profile(struct trace *t)
+{
+	uint32_t peak_frag = 0, fail = 0;
+	size_t min_largest = HEAP_SIZE;
+	struct usage u;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	for (size_t i = 0; i < t->n_ops; i++) {
+		fail += !do_op(&t->ops[i]);
+
+		if (((i + 1) % SAMPLE_OPS) != 0) {
+			continue;
+		}
+
+		heap_usage(&u);
+		peak_frag = MAX(peak_frag, frag_percent(&u));
+		min_largest = MIN(min_largest, u.largest);
+
+		if (((i + 1) % REPORT_OPS) == 0) {
+			printk("%-8s op %5u free %6u largest %6u frag %3u%%\n",
+			       t->name, (uint32_t)(i + 1), (uint32_t)u.free,
+			       (uint32_t)u.largest, frag_percent(&u));
+		}
+	}
+
+	reset(t);
+	if (!sys_heap_validate(&heap)) {
+		printk("ERROR: heap corrupted after trace %s\n", t->name);
+	}
+
+	printk("%-8s peak frag %3u%% min largest %6u fail %4u\n", t->name,
+	       peak_frag, (uint32_t)min_largest, fail);
+}
+
+/* Timed passes.  Every round replays the same operations on the
+ * same heap state, so keeping the lowest cost of each operation
+ * over the rounds filters out interrupts and, on native_posix, host
+ * scheduling noise, which would otherwise be all the worst case
+ * shows.
+ */
+static void measure(struct trace *t)
+{
+	uint32_t worst[3] = { 0 };
+	uint64_t ns = 0, ops_per_sec;
+
+	memset(op_cycles, 0xff, sizeof(op_cycles));
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0;
+
+		sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+		t0 = now_ns();
+		for (size_t i = 0; i < t->n_ops; i++) {
+			uint64_t c0 = cycles();
+
+			(void)do_op(&t->ops[i]);
+			op_cycles[i] = MIN(op_cycles[i],
+					   (uint32_t)(cycles() - c0));
+		}
+		ns += now_ns() - t0;
+
+		reset(t);
+	}
+
+	for (size_t i = 0; i < t->n_ops; i++) {
+		uint8_t type = t->ops[i].type;
+
+		worst[type] = MAX(worst[type], op_cycles[i]);
+	}
+
+	ops_per_sec = ((uint64_t)t->n_ops * ROUNDS * NSEC_PER_SEC) / ns;
+
+	printk("%-8s ops/s %9u worst alloc %6u free %6u realloc %6u cycles\n",
+	       t->name, (uint32_t)ops_per_sec, worst[TRACE_ALLOC],
+	       worst[TRACE_FREE], worst[TRACE_REALLOC]);
+}
+
+static void run(struct trace *t)
+{
+	printk("%s: %u ops on %u slots\n", t->name, (uint32_t)t->n_ops,
+	       t->n_slots);
+	profile(t);
+	measure(t);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+	timing_base = timing_counter_get();
+
+	traces_record();
+	capture_trace();
+
+	printk("Heap trace replay benchmark, %u byte heap (%s)\n", HEAP_SIZE,
+	       IS_ENABLED(CONFIG_SYS_HEAP_QUICK_LISTS) ? "quick lists"
+						       : "buckets only");
+
+	for (int i = 0; i < n_traces; i++) {
+		run(&traces[i]);
+	}
+	run(&captured);
+
+	timing_stop();
+	printk("fin\n");
+}
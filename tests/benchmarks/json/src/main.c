@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <data/json.h>
+#include <timing/timing.h>
+
+/* JSON parser and encoder throughput benchmark: see README.rst */
+
+#define ELEMENTS 32
+#define CHUNK 64
+#define BYTES_PER_RUN (1024 * 1024)
+#define ROUNDS 5
+
+struct device_info {
+	const char *name;
+	int32_t id;
+};
+
+struct fleet {
+	const char *version;
+	struct device_info devices[ELEMENTS];
+	size_t devices_len;
+	int32_t rssi[ELEMENTS];
+	size_t rssi_len;
+	bool active[ELEMENTS];
+	size_t active_len;
+	int32_t total;
+};
+
+static const struct json_obj_descr device_info_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct device_info, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct device_info, id, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr fleet_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct fleet, version, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct fleet, devices, ELEMENTS, devices_len,
+				 device_info_descr,
+				 ARRAY_SIZE(device_info_descr)),
+	JSON_OBJ_DESCR_ARRAY(struct fleet, rssi, ELEMENTS, rssi_len,
+			     JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_ARRAY(struct fleet, active, ELEMENTS, active_len,
+			     JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_PRIM(struct fleet, total, JSON_TOK_NUMBER),
+};
+
+#define ALL_FIELDS ((1 << ARRAY_SIZE(fleet_descr)) - 1)
+
+static const char *const names[] = {
+	"sensor-node \"alpha\"", "gateway", "thermostat-livingroom",
+	"door\tlock", "smart-meter-0042", "irrigation valve",
+};
+
+static struct fleet fleet;
+static struct fleet decoded;
+static char doc[4096];
+static size_t doc_len;
+static char work[sizeof(doc)];
+static char out[sizeof(doc)];
+static char strings[2048];
+static struct json_stream_obj obj;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+struct appender {
+	char *buf;
+	size_t len;
+	size_t size;
+};
+
+static int append_bytes(const char *bytes, size_t len, void *data)
+{
+	struct appender *appender = data;
+
+	if (len > appender->size - appender->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(appender->buf + appender->len, bytes, len);
+	appender->len += len;
+
+	return 0;
+}
+
+/* The descriptor parser works in place, so it gets a fresh copy */
+static int bench_obj_parse(void)
+{
+	memcpy(work, doc, doc_len);
+
+	return json_obj_parse(work, doc_len, fleet_descr,
+			      ARRAY_SIZE(fleet_descr), &decoded);
+}
+
+static int count_token(const struct json_stream_token *token, void *user_data)
+{
+	(*(int *)user_data)++;
+
+	return 0;
+}
+
+static int stream_tokens(size_t chunk)
+{
+	struct json_stream stream;
+	char buf[64];
+	int tokens = 0;
+	int ret = 0;
+
+	json_stream_init(&stream, buf, sizeof(buf), count_token, &tokens);
+	for (size_t pos = 0; pos < doc_len && ret == 0; pos += chunk) {
+		ret = json_stream_feed(&stream, doc + pos,
+				       MIN(chunk, doc_len - pos));
+	}
+
+	if (ret == 0) {
+		ret = json_stream_finish(&stream);
+	}
+
+	return (ret < 0) ? ret : tokens;
+}
+
+static int bench_stream(void)
+{
+	return stream_tokens(doc_len);
+}
+
+static int bench_stream_chunked(void)
+{
+	return stream_tokens(CHUNK);
+}
+
+static int stream_obj(size_t chunk)
+{
+	int ret = 0;
+
+	json_stream_obj_init(&obj, fleet_descr, ARRAY_SIZE(fleet_descr),
+			     &decoded, strings, sizeof(strings));
+	for (size_t pos = 0; pos < doc_len && ret == 0; pos += chunk) {
+		ret = json_stream_obj_feed(&obj, doc + pos,
+					   MIN(chunk, doc_len - pos));
+	}
+
+	return (ret < 0) ? ret : json_stream_obj_finish(&obj);
+}
+
+static int bench_stream_obj(void)
+{
+	return stream_obj(doc_len);
+}
+
+static int bench_stream_obj_chunked(void)
+{
+	return stream_obj(CHUNK);
+}
+
+static int bench_obj_encode(void)
+{
+	struct appender appender = { .buf = out, .size = sizeof(out) };
+	int ret;
+
+	ret = json_obj_encode(fleet_descr, ARRAY_SIZE(fleet_descr), &fleet,
+			      append_bytes, &appender);
+
+	return (ret < 0) ? ret : appender.len;
+}
+
+static int enc_fleet(json_append_bytes_t append, void *data)
+{
+	struct json_enc enc;
+
+	json_enc_init(&enc, append, data);
+	json_enc_obj_start(&enc, NULL);
+	json_enc_str(&enc, "version", fleet.version, strlen(fleet.version));
+	json_enc_arr_start(&enc, "devices");
+	for (size_t i = 0; i < fleet.devices_len; i++) {
+		const struct device_info *dev = &fleet.devices[i];
+
+		json_enc_obj_start(&enc, NULL);
+		json_enc_str(&enc, "name", dev->name, strlen(dev->name));
+		json_enc_num(&enc, "id", dev->id);
+		json_enc_obj_end(&enc);
+	}
+	json_enc_arr_end(&enc);
+	json_enc_arr_start(&enc, "rssi");
+	for (size_t i = 0; i < fleet.rssi_len; i++) {
+		json_enc_num(&enc, NULL, fleet.rssi[i]);
+	}
+	json_enc_arr_end(&enc);
+	json_enc_arr_start(&enc, "active");
+	for (size_t i = 0; i < fleet.active_len; i++) {
+		json_enc_bool(&enc, NULL, fleet.active[i]);
+	}
+	json_enc_arr_end(&enc);
+	json_enc_num(&enc, "total", fleet.total);
+	json_enc_obj_end(&enc);
+
+	return json_enc_finish(&enc);
+}
+
+static int bench_enc(void)
+{
+	struct appender appender = { .buf = out, .size = sizeof(out) };
+	int ret = enc_fleet(append_bytes, &appender);
+
+	return (ret < 0) ? ret : appender.len;
+}
+
+static const struct {
+	const char *name;
+	int (*fn)(void);
+} benches[] = {
+	{ "json_obj_parse", bench_obj_parse },
+	{ "json_stream", bench_stream },
+	{ "json_stream/" STRINGIFY(CHUNK), bench_stream_chunked },
+	{ "json_stream_obj", bench_stream_obj },
+	{ "json_stream_obj/" STRINGIFY(CHUNK), bench_stream_obj_chunked },
+	{ "json_obj_encode", bench_obj_encode },
+	{ "json_enc", bench_enc },
+};
+
+static volatile int sink;
+
+/* Best throughput over a few rounds, in units of 10 KB/s */
+static uint32_t measure(int (*fn)(void))
+{
+	uint64_t best = UINT64_MAX;
+	size_t runs = BYTES_PER_RUN / doc_len;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		int acc = 0;
+
+		for (size_t i = 0; i < runs; i++) {
+			acc += fn();
+		}
+
+		best = MIN(best, now_ns() - t0);
+		sink = acc;
+	}
+
+	return (uint32_t)((100000ULL * runs * doc_len) / MAX(best, 1));
+}
+
+/* Checks that every variant sees the same document */
+static bool check(void)
+{
+	int tokens = bench_stream();
+
+	if (bench_obj_parse() != ALL_FIELDS ||
+	    decoded.devices_len != ELEMENTS || decoded.total != ELEMENTS) {
+		return false;
+	}
+
+	memset(&decoded, 0, sizeof(decoded));
+	if (bench_stream_obj_chunked() != ALL_FIELDS ||
+	    decoded.rssi[5] != fleet.rssi[5] ||
+	    strcmp(decoded.devices[3].name, "door\\tlock") != 0) {
+		return false;
+	}
+
+	/* Per device the object, its end and 2 members, plus an element
+	 * in each of the two arrays; then the top level object, its 5
+	 * members and the ends of the 4 containers
+	 */
+	return tokens == ELEMENTS * 6 + 6 + 4 &&
+	       bench_obj_encode() == doc_len && bench_enc() == doc_len &&
+	       memcmp(out, doc, doc_len) == 0;
+}
+
+void main(void)
+{
+	struct appender appender = { .buf = doc, .size = sizeof(doc) };
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	fleet.version = "2.6.99-rc1";
+	for (int i = 0; i < ELEMENTS; i++) {
+		fleet.devices[i].name = names[i % ARRAY_SIZE(names)];
+		fleet.devices[i].id = 100000 + i * 7919;
+		fleet.rssi[i] = -40 - (i * 13) % 50;
+		fleet.active[i] = (i % 3) != 0;
+	}
+	fleet.devices_len = ELEMENTS;
+	fleet.rssi_len = ELEMENTS;
+	fleet.active_len = ELEMENTS;
+	fleet.total = ELEMENTS;
+
+	if (enc_fleet(append_bytes, &appender) < 0) {
+		printk("ERROR: cannot encode the document\n");
+		return;
+	}
+	doc_len = appender.len;
+
+	if (!check()) {
+		printk("ERROR: parsers disagree\n");
+	}
+
+	printk("JSON benchmark, %zu byte document, throughput in MB/s\n",
+	       doc_len);
+
+	for (int b = 0; b < ARRAY_SIZE(benches); b++) {
+		uint32_t rate = measure(benches[b].fn);
+
+		printk("%-20s %6u.%02u\n", benches[b].name, rate / 100,
+		       rate % 100);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
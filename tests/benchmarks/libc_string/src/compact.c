@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* The compact routines of the minimal libc, whatever the config */
+#undef CONFIG_MINIMAL_LIBC_STRING_FAST
+
+#define VARIANT(name) compact_##name
+#include "variant.h"
+#include "../../../../lib/libc/minimal/source/string/string.c"
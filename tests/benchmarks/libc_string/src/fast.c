@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* The speed optimized routines of the minimal libc */
+#define VARIANT(name) fast_##name
+#include "variant.h"
+#include "../../../../lib/libc/minimal/source/string/string_fast.c"
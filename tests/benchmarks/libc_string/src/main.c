@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <timing/timing.h>
+
+/* Memory routine throughput benchmark: see README.rst */
+
+#define MAX_LEN 4096
+#define BYTES_PER_RUN (4 * 1024 * 1024)
+#define ROUNDS 5
+
+struct variant {
+	const char *name;
+	void *(*memcpy)(void *d, const void *s, size_t n);
+	void *(*memmove)(void *d, const void *s, size_t n);
+	void *(*memset)(void *buf, int c, size_t n);
+	int (*memcmp)(const void *m1, const void *m2, size_t n);
+	void *(*memchr)(const void *s, int c, size_t n);
+	size_t (*strlen)(const char *s);
+};
+
+#define VARIANT_DECLARE(prefix)						\
+	void *prefix##memcpy(void *d, const void *s, size_t n);		\
+	void *prefix##memmove(void *d, const void *s, size_t n);	\
+	void *prefix##memset(void *buf, int c, size_t n);		\
+	int prefix##memcmp(const void *m1, const void *m2, size_t n);	\
+	void *prefix##memchr(const void *s, int c, size_t n);		\
+	size_t prefix##strlen(const char *s)
+
+#define VARIANT_ENTRY(label, prefix)					\
+	{ label, prefix##memcpy, prefix##memmove, prefix##memset,	\
+	  prefix##memcmp, prefix##memchr, prefix##strlen }
+
+VARIANT_DECLARE(compact_);
+VARIANT_DECLARE(fast_);
+
+static const struct variant variants[] = {
+	VARIANT_ENTRY("compact", compact_),
+	VARIANT_ENTRY("fast", fast_),
+	VARIANT_ENTRY("libc", ),
+};
+
+enum op { OP_MEMCPY, OP_MEMMOVE, OP_MEMSET, OP_MEMCMP, OP_MEMCHR, OP_STRLEN };
+
+static const char *const op_names[] = {
+	"memcpy", "memmove", "memset", "memcmp", "memchr", "strlen",
+};
+
+static const size_t lens[] = { 8, 64, 256, 1024, 4096 };
+
+/* Source and destination misalignments */
+static const struct {
+	uint8_t src, dst;
+} aligns[] = {
+	{ 0, 0 }, { 3, 3 }, { 1, 6 },
+};
+
+static uint8_t __aligned(64) src_buf[MAX_LEN + 64];
+static uint8_t __aligned(64) dst_buf[MAX_LEN + 64];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static volatile uintptr_t sink;
+
+static uintptr_t run_op(const struct variant *v, enum op op, uint8_t *dst,
+			uint8_t *src, size_t len)
+{
+	switch (op) {
+	case OP_MEMCPY:
+		return (uintptr_t)v->memcpy(dst, src, len);
+	case OP_MEMMOVE:
+		/* Overlapping, shifting the buffer down by a few bytes */
+		return (uintptr_t)v->memmove(dst, dst + 5, len);
+	case OP_MEMSET:
+		return (uintptr_t)v->memset(dst, 0x5a, len);
+	case OP_MEMCMP:
+		return v->memcmp(dst, src, len);
+	case OP_MEMCHR:
+		return (uintptr_t)v->memchr(src, 0, len);
+	default:
+		return v->strlen((const char *)src);
+	}
+}
+
+/* Sets the buffers up so that compares run to the end, and checks the
+ * result of the last call
+ */
+static bool setup_and_check(const struct variant *v, enum op op,
+			    uint8_t *dst, uint8_t *src, size_t len)
+{
+	uintptr_t ret;
+
+	for (size_t i = 0; i < len + 8; i++) {
+		src[i] = 1 + (i * 7) % 255;
+		dst[i] = src[i];
+	}
+	src[len] = 0;
+
+	ret = run_op(v, op, dst, src, len);
+
+	switch (op) {
+	case OP_MEMCPY:
+		return (ret == (uintptr_t)dst) && (memcmp(dst, src, len) == 0);
+	case OP_MEMMOVE:
+		for (size_t i = 0; i < len; i++) {
+			if (dst[i] != 1 + ((i + 5) * 7) % 255) {
+				return false;
+			}
+		}
+		return true;
+	case OP_MEMSET:
+		for (size_t i = 0; i < len; i++) {
+			if (dst[i] != 0x5a) {
+				return false;
+			}
+		}
+		return true;
+	case OP_MEMCMP:
+		return ret == 0;
+	case OP_MEMCHR:
+		return ret == 0;
+	default:
+		return ret == len;
+	}
+}
+
+/* Best throughput over a few rounds, in units of 10 KB/s */
+static uint32_t measure(const struct variant *v, enum op op, uint8_t *dst,
+			uint8_t *src, size_t len)
+{
+	uint64_t best = UINT64_MAX;
+	size_t runs = BYTES_PER_RUN / len;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		uintptr_t acc = 0;
+
+		for (size_t i = 0; i < runs; i++) {
+			acc += run_op(v, op, dst, src, len);
+		}
+
+		best = MIN(best, now_ns() - t0);
+		sink = acc;
+	}
+
+	return (uint32_t)((100000ULL * runs * len) / MAX(best, 1));
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	printk("Memory routine benchmark, throughput in MB/s\n");
+	printk("%-8s %5s %3s %3s", "op", "bytes", "src", "dst");
+	for (int v = 0; v < ARRAY_SIZE(variants); v++) {
+		printk(" %10s", variants[v].name);
+	}
+	printk("\n");
+
+	for (enum op op = OP_MEMCPY; op <= OP_STRLEN; op++) {
+		for (int l = 0; l < ARRAY_SIZE(lens); l++) {
+			for (int a = 0; a < ARRAY_SIZE(aligns); a++) {
+				uint8_t *src = src_buf + aligns[a].src;
+				uint8_t *dst = dst_buf + aligns[a].dst;
+
+				printk("%-8s %5zu  +%u  +%u", op_names[op],
+				       lens[l], aligns[a].src, aligns[a].dst);
+
+				for (int v = 0; v < ARRAY_SIZE(variants); v++) {
+					const struct variant *var = &variants[v];
+					uint32_t rate;
+
+					if (!setup_and_check(var, op, dst, src,
+							     lens[l])) {
+						printk("\nERROR: %s %s\n",
+						       var->name, op_names[op]);
+					}
+
+					rate = measure(var, op, dst, src,
+						       lens[l]);
+					printk(" %7u.%02u", rate / 100,
+					       rate % 100);
+				}
+				printk("\n");
+			}
+		}
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Renames the routines of the minimal libc sources included after
+ * this with VARIANT(), so that both versions can be linked into one
+ * image next to whatever libc the build uses
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef __mem_word_t_defined
+#define __mem_word_t_defined
+typedef uintptr_t mem_word_t;
+#define Z_MEM_WORD_T_WIDTH __INTPTR_WIDTH__
+#endif
+
+#ifndef _MLIBC_RESTRICT
+#define _MLIBC_RESTRICT __restrict
+#endif
+
+#define strcpy VARIANT(strcpy)
+#define strncpy VARIANT(strncpy)
+#define strchr VARIANT(strchr)
+#define strrchr VARIANT(strrchr)
+#define strlen VARIANT(strlen)
+#define strnlen VARIANT(strnlen)
+#define strcmp VARIANT(strcmp)
+#define strncmp VARIANT(strncmp)
+#define strtok_r VARIANT(strtok_r)
+#define strcat VARIANT(strcat)
+#define strncat VARIANT(strncat)
+#define memcmp VARIANT(memcmp)
+#define memmove VARIANT(memmove)
+#define memcpy VARIANT(memcpy)
+#define memset VARIANT(memset)
+#define memchr VARIANT(memchr)
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP memory slab throughput benchmark: see README.rst */
+
+#define N_THREADS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+#define BATCH 4
+#define BLOCK_SIZE 64
+/* Aborted workers leak the blocks they hold, leave room for that */
+#define NUM_BLOCKS (N_THREADS * BATCH * 8)
+#define SETTLE_MS 100
+#define WINDOW_MS 1000
+
+K_MEM_SLAB_DEFINE(slab, BLOCK_SIZE, NUM_BLOCKS, 8);
+
+struct worker {
+	struct k_thread thread;
+	volatile uint32_t pairs;
+};
+
+static struct worker workers[N_THREADS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_THREADS, STACK_SIZE);
+
+static void worker_fn(void *arg1, void *arg2, void *arg3)
+{
+	struct worker *w = arg1;
+	void *blocks[BATCH];
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		for (int i = 0; i < BATCH; i++) {
+			if (k_mem_slab_alloc(&slab, &blocks[i], K_NO_WAIT) != 0) {
+				printk("ERROR: slab exhausted\n");
+				return;
+			}
+			*(volatile uint32_t *)blocks[i] = w->pairs;
+		}
+		for (int i = 0; i < BATCH; i++) {
+			k_mem_slab_free(&slab, &blocks[i]);
+		}
+		w->pairs += BATCH;
+	}
+}
+
+static void run(int nthreads)
+{
+	uint64_t total = 0U;
+
+	for (int i = 0; i < nthreads; i++) {
+		workers[i].pairs = 0U;
+		k_thread_create(&workers[i].thread, stacks[i], STACK_SIZE,
+				worker_fn, &workers[i], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(SETTLE_MS);
+
+	for (int i = 0; i < nthreads; i++) {
+		workers[i].pairs = 0U;
+	}
+
+	k_msleep(WINDOW_MS);
+
+	for (int i = 0; i < nthreads; i++) {
+		total += workers[i].pairs;
+	}
+
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_abort(&workers[i].thread);
+	}
+
+	printk("cpus %d threads %d pairs/s %u\n", CONFIG_MP_NUM_CPUS,
+	       nthreads, (uint32_t)((total * MSEC_PER_SEC) / WINDOW_MS));
+}
+
+void main(void)
+{
+	/* Stay cooperative so the workers never preempt the
+	 * measurement control logic
+	 */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	printk("SMP memory slab benchmark (%s)\n",
+	       IS_ENABLED(CONFIG_MEM_SLAB_CPU_CACHE) ? "per-CPU caches"
+						     : "shared free list");
+
+	for (int nthreads = 1; nthreads <= N_THREADS; nthreads++) {
+		run(nthreads);
+	}
+
+	printk("fin\n");
+}
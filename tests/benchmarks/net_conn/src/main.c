@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+#include <timing/timing.h>
+
+#include "ipv4.h"
+#include "ipv6.h"
+#include "connection.h"
+#include "udp_internal.h"
+
+/* Cost of finding the socket of a received UDP packet among many,
+ * measured by feeding the same packet to net_conn_input() with
+ * random destination ports.
+ */
+
+#define PKTS 100000
+#define ROUNDS 3
+#define BASE_PORT 5000
+#define PEER_PORT 5683
+
+static const int counts[] = { 1, 16, 64, 256 };
+
+static struct net_conn_handle *handles[256];
+
+static struct in6_addr my_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+static struct in_addr my_addr4 = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr4 = { { { 192, 0, 2, 2 } } };
+
+static uint32_t received;
+
+static int bench_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int bench_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_conn_bench, "net_conn_bench", bench_dev_init,
+		device_pm_control_nop, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* Delivery only counts the packets, which are reused */
+static enum net_verdict bench_recv(struct net_conn *conn,
+				   struct net_pkt *pkt,
+				   union net_ip_header *ip_hdr,
+				   union net_proto_header *proto_hdr,
+				   void *user_data)
+{
+	received++;
+
+	return NET_OK;
+}
+
+static struct net_pkt *build(struct net_if *iface, sa_family_t family)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 8, family, IPPROTO_UDP,
+					K_FOREVER);
+	if (pkt == NULL) {
+		return NULL;
+	}
+
+	if (family == AF_INET6) {
+		ret = net_ipv6_create(pkt, &peer_addr6, &my_addr6);
+	} else {
+		ret = net_ipv4_create(pkt, &peer_addr4, &my_addr4);
+	}
+
+	if (ret == 0) {
+		ret = net_udp_create(pkt, htons(PEER_PORT), htons(BASE_PORT));
+	}
+
+	if (ret == 0) {
+		ret = net_pkt_memset(pkt, 0, 8);
+	}
+
+	if (ret != 0) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	net_pkt_cursor_init(pkt);
+	if (family == AF_INET6) {
+		net_ipv6_finalize(pkt, IPPROTO_UDP);
+	} else {
+		net_ipv4_finalize(pkt, IPPROTO_UDP);
+	}
+
+	return pkt;
+}
+
+/* Time of the lookup and delivery of a packet to one of the n sockets
+ * at random, best of a few rounds, in hundredths of ns, or 0 on failure
+ */
+static uint32_t measure(struct net_if *iface, sa_family_t family, int n)
+{
+	union net_ip_header ip_hdr;
+	union net_proto_header proto_hdr;
+	uint64_t best = UINT64_MAX;
+	struct net_pkt *pkt;
+	uint32_t x = 1;
+
+	pkt = build(iface, family);
+	if (pkt == NULL) {
+		printk("ERROR: cannot build packet\n");
+		return 0;
+	}
+
+	/* The headers are in the first fragment */
+	ip_hdr.ipv6 = (struct net_ipv6_hdr *)pkt->buffer->data;
+	proto_hdr.udp = (struct net_udp_hdr *)(pkt->buffer->data +
+					       net_pkt_ip_hdr_len(pkt));
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0, t;
+
+		received = 0;
+		t0 = now_ns();
+		for (int i = 0; i < PKTS; i++) {
+			x = x * 1103515245U + 12345U;
+			proto_hdr.udp->dst_port =
+				htons(BASE_PORT + (x >> 16) % n);
+			(void)net_conn_input(pkt, &ip_hdr, IPPROTO_UDP,
+					     &proto_hdr);
+		}
+		t = now_ns() - t0;
+
+		if (received != PKTS) {
+			printk("ERROR: %u packets of %u delivered\n",
+			       received, PKTS);
+			net_pkt_unref(pkt);
+			return 0;
+		}
+
+		best = MIN(best, t);
+	}
+
+	net_pkt_unref(pkt);
+
+	return (uint32_t)((100U * best) / PKTS);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int registered = 0;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	(void)net_if_ipv6_addr_add(iface, &my_addr6, NET_ADDR_MANUAL, 0);
+	(void)net_if_ipv4_addr_add(iface, &my_addr4, NET_ADDR_MANUAL, 0);
+
+	printk("UDP demultiplexing, %d buckets, ns per packet\n",
+	       CONFIG_NET_CONN_HASH_SIZE);
+	printk("%-8s %10s %10s\n", "sockets", "IPv4", "IPv6");
+
+	for (int c = 0; c < ARRAY_SIZE(counts); c++) {
+		uint32_t ns4, ns6;
+
+		/* Sockets bound to a port each, on any address */
+		while (registered < counts[c]) {
+			if (net_udp_register(AF_UNSPEC, NULL, NULL, 0,
+					     BASE_PORT + registered,
+					     bench_recv, NULL,
+					     &handles[registered]) != 0) {
+				printk("ERROR: cannot register socket %d\n",
+				       registered);
+				return;
+			}
+			registered++;
+		}
+
+		ns4 = measure(iface, AF_INET, counts[c]);
+		ns6 = measure(iface, AF_INET6, counts[c]);
+		printk("%-8d %7u.%02u %7u.%02u\n", counts[c],
+		       ns4 / 100, ns4 % 100, ns6 / 100, ns6 % 100);
+	}
+
+	for (int i = 0; i < registered; i++) {
+		(void)net_udp_unregister(handles[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
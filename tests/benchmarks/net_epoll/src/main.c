@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <timing/timing.h>
+
+/* Cost of waiting for a datagram on one of many UDP sockets over the
+ * loopback interface, with poll() and with the epoll-like API: see
+ * README.rst
+ */
+
+#define MAX_SOCKS 500
+#define BASE_PORT 5000
+#define EVENTS 500
+#define ROUNDS 3
+
+static const int counts[] = { 10, 100, 500 };
+
+static int socks[MAX_SOCKS];
+static struct pollfd pollfds[MAX_SOCKS];
+static uint8_t buf[8];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* Sends a datagram to one of the n sockets at random */
+static int send_random(int client, struct sockaddr_in *addr, int n,
+		       uint32_t *x)
+{
+	*x = *x * 1103515245U + 12345U;
+	addr->sin_port = htons(BASE_PORT + (*x >> 16) % n);
+
+	if (sendto(client, buf, sizeof(buf), 0, (struct sockaddr *)addr,
+		   sizeof(*addr)) != sizeof(buf)) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* The application finds the socket to read in the whole set */
+static int wait_poll(int n)
+{
+	if (poll(pollfds, n, -1) != 1) {
+		return -EIO;
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (pollfds[i].revents & POLLIN) {
+			return recv(pollfds[i].fd, buf, sizeof(buf), 0) ==
+			       sizeof(buf) ? 0 : -EIO;
+		}
+	}
+
+	return -EIO;
+}
+
+/* The socket to read comes with the event */
+static int wait_epoll(int ep)
+{
+	struct epoll_event ev;
+
+	if (epoll_wait(ep, &ev, 1, -1) != 1) {
+		return -EIO;
+	}
+
+	return recv(ev.data.fd, buf, sizeof(buf), 0) == sizeof(buf) ?
+	       0 : -EIO;
+}
+
+/* Time to find and read the datagram sent to one of the n sockets at
+ * random, once it is queued on the socket, best of a few rounds, in
+ * hundredths of us, or 0 on failure
+ */
+static uint32_t measure(int client, struct sockaddr_in *addr, int n, int ep)
+{
+	uint64_t best = UINT64_MAX;
+	uint32_t x = 1;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t total = 0U;
+
+		for (int i = 0; i < EVENTS; i++) {
+			uint64_t t0;
+
+			if (send_random(client, addr, n, &x) != 0) {
+				return 0;
+			}
+
+			/* Let the stack deliver the datagram */
+			k_msleep(1);
+
+			t0 = now_ns();
+			if ((ep < 0 ? wait_poll(n) : wait_epoll(ep)) != 0) {
+				return 0;
+			}
+			total += now_ns() - t0;
+		}
+
+		best = MIN(best, total);
+	}
+
+	return (uint32_t)(best / (10U * EVENTS));
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	struct epoll_event ev = {
+		.events = EPOLLIN,
+	};
+	int client, ep, opened = 0;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	ep = epoll_create1(0);
+	if (client < 0 || ep < 0) {
+		printk("ERROR: cannot create sockets: %d\n", errno);
+		return;
+	}
+
+	printk("UDP over loopback, us to find and read a datagram\n");
+	printk("%-8s %10s %10s\n", "sockets", "poll", "epoll");
+
+	for (int c = 0; c < ARRAY_SIZE(counts); c++) {
+		uint32_t poll_us, epoll_us;
+
+		while (opened < counts[c]) {
+			socks[opened] = socket(AF_INET, SOCK_DGRAM,
+					       IPPROTO_UDP);
+			addr.sin_port = htons(BASE_PORT + opened);
+			ev.data.fd = socks[opened];
+
+			if (socks[opened] < 0 ||
+			    bind(socks[opened], (struct sockaddr *)&addr,
+				 sizeof(addr)) < 0 ||
+			    epoll_ctl(ep, EPOLL_CTL_ADD, socks[opened],
+				      &ev) < 0) {
+				printk("ERROR: cannot open socket %d: %d\n",
+				       opened, errno);
+				return;
+			}
+
+			pollfds[opened].fd = socks[opened];
+			pollfds[opened].events = POLLIN;
+			opened++;
+		}
+
+		poll_us = measure(client, &addr, counts[c], -1);
+		epoll_us = measure(client, &addr, counts[c], ep);
+		if (poll_us == 0 || epoll_us == 0) {
+			printk("ERROR: reception failed on %d sockets\n",
+			       counts[c]);
+			return;
+		}
+
+		printk("%-8d %7u.%02u %7u.%02u\n", counts[c],
+		       poll_us / 100, poll_us % 100,
+		       epoll_us / 100, epoll_us % 100);
+	}
+
+	for (int i = 0; i < opened; i++) {
+		(void)close(socks[i]);
+	}
+
+	(void)close(ep);
+	(void)close(client);
+
+	timing_stop();
+	printk("fin\n");
+}
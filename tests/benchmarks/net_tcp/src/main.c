@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <timing/timing.h>
+
+/* Aggregate TCP throughput over the loopback interface, with data
+ * flowing on several connections at once: see README.rst
+ */
+
+#define MAX_CONNS 32
+#define PORT 4242
+#define CHUNK 512
+#define TOTAL (4 * 1024 * 1024)
+#define ROUNDS 3
+
+static const int counts[] = { 1, 8, 32 };
+
+static int clients[MAX_CONNS];
+static int servers[MAX_CONNS];
+static uint8_t buf[CHUNK];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static int open_conns(int listener, const struct sockaddr_in *addr, int n)
+{
+	for (int i = 0; i < n; i++) {
+		clients[i] = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (clients[i] < 0) {
+			return -errno;
+		}
+
+		if (connect(clients[i], (const struct sockaddr *)addr,
+			    sizeof(*addr)) < 0) {
+			return -errno;
+		}
+
+		servers[i] = accept(listener, NULL, NULL);
+		if (servers[i] < 0) {
+			return -errno;
+		}
+	}
+
+	return 0;
+}
+
+static void close_conns(int n)
+{
+	for (int i = 0; i < n; i++) {
+		(void)close(clients[i]);
+		(void)close(servers[i]);
+	}
+}
+
+static int send_chunk(int sock)
+{
+	size_t len = 0;
+
+	while (len < CHUNK) {
+		ssize_t ret = send(sock, buf + len, CHUNK - len, 0);
+
+		if (ret <= 0) {
+			return -EIO;
+		}
+		len += ret;
+	}
+
+	return 0;
+}
+
+static int recv_chunk(int sock)
+{
+	size_t len = 0;
+
+	while (len < CHUNK) {
+		ssize_t ret = recv(sock, buf + len, CHUNK - len, 0);
+
+		if (ret <= 0) {
+			return -EIO;
+		}
+		len += ret;
+	}
+
+	return 0;
+}
+
+/* Sends a chunk on each connection in turn, then receives them, since
+ * the receive window of a connection is not much larger than a chunk.
+ * Returns the best time of a few rounds, or 0 on failure.
+ */
+static uint64_t measure(int n)
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+
+		for (int done = 0; done < TOTAL; done += n * CHUNK) {
+			for (int i = 0; i < n; i++) {
+				if (send_chunk(clients[i]) != 0) {
+					return 0;
+				}
+			}
+
+			for (int i = 0; i < n; i++) {
+				if (recv_chunk(servers[i]) != 0) {
+					return 0;
+				}
+			}
+		}
+
+		best = MIN(best, now_ns() - t0);
+	}
+
+	return best;
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	int listener;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, MAX_CONNS) < 0) {
+		printk("ERROR: cannot listen: %d\n", errno);
+		return;
+	}
+
+	printk("TCP over loopback, %d KiB in chunks of %d bytes\n",
+	       TOTAL / 1024, CHUNK);
+	printk("%-12s %10s\n", "connections", "MB/s");
+
+	for (int c = 0; c < ARRAY_SIZE(counts); c++) {
+		uint64_t ns;
+		int ret;
+
+		ret = open_conns(listener, &addr, counts[c]);
+		if (ret < 0) {
+			printk("ERROR: cannot open %d connections: %d\n",
+			       counts[c], ret);
+			return;
+		}
+
+		ns = measure(counts[c]);
+		close_conns(counts[c]);
+
+		if (ns == 0) {
+			printk("ERROR: transfer failed on %d connections\n",
+			       counts[c]);
+			return;
+		}
+
+		/* MB/s in hundredths */
+		ns = (100000ULL * TOTAL) / ns;
+		printk("%-12d %7u.%02u\n", counts[c], (uint32_t)(ns / 100),
+		       (uint32_t)(ns % 100));
+
+		/* Let the closed connections go away */
+		k_sleep(K_SECONDS(2));
+	}
+
+	(void)close(listener);
+
+	timing_stop();
+	printk("fin\n");
+}
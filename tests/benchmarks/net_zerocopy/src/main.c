@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/net_pkt.h>
+#include <timing/timing.h>
+
+/* TCP throughput over the loopback interface, with the data copied in
+ * and out of the network buffers by send() and recv(), and with the
+ * buffers handed over by zsock_send_zc() and zsock_recv_zc(): see
+ * README.rst
+ */
+
+#define PORT 4242
+#define MAX_CHUNK 1024
+#define TOTAL (4 * 1024 * 1024)
+#define ROUNDS 3
+
+static const int chunks[] = { 256, 1024 };
+
+static uint8_t pattern[MAX_CHUNK];
+static uint8_t buf[MAX_CHUNK];
+static uint32_t sum;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* The receiver looks at every byte, as an application would */
+static void consume(const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		sum += data[i];
+	}
+}
+
+static int copy_chunk(int client, int server, int chunk)
+{
+	ssize_t ret;
+	size_t len;
+
+	memcpy(buf, pattern, chunk);
+
+	for (len = 0; len < chunk; len += ret) {
+		ret = send(client, buf + len, chunk - len, 0);
+		if (ret <= 0) {
+			return -EIO;
+		}
+	}
+
+	for (len = 0; len < chunk; len += ret) {
+		ret = recv(server, buf, chunk - len, 0);
+		if (ret <= 0) {
+			return -EIO;
+		}
+
+		consume(buf, ret);
+	}
+
+	return 0;
+}
+
+static int zerocopy_chunk(int client, int server, int chunk)
+{
+	struct net_buf *frags = NULL, *last = NULL, *frag;
+	ssize_t ret;
+	size_t len;
+
+	/* The data is written in the buffers it is sent from */
+	for (len = 0; len < chunk; len += frag->len) {
+		frag = net_pkt_get_reserve_tx_data(K_FOREVER);
+		if (frag == NULL) {
+			return -ENOMEM;
+		}
+
+		net_buf_add_mem(frag, pattern + len,
+				MIN(net_buf_tailroom(frag), chunk - len));
+
+		if (last) {
+			net_buf_frag_insert(last, frag);
+		} else {
+			frags = frag;
+		}
+
+		last = frag;
+	}
+
+	if (zsock_send_zc(client, frags, 0) != chunk) {
+		return -EIO;
+	}
+
+	for (len = 0; len < chunk; len += ret) {
+		ret = zsock_recv_zc(server, &frags, 0);
+		if (ret <= 0) {
+			return -EIO;
+		}
+
+		for (frag = frags; frag; frag = frag->frags) {
+			consume(frag->data, frag->len);
+		}
+
+		zsock_recv_zc_done(server, frags);
+	}
+
+	return 0;
+}
+
+/* Best time of a few rounds to move TOTAL bytes, or 0 on failure */
+static uint64_t measure(int (*xfer)(int, int, int), int client, int server,
+			int chunk)
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+
+		for (int done = 0; done < TOTAL; done += chunk) {
+			if (xfer(client, server, chunk) != 0) {
+				return 0;
+			}
+		}
+
+		best = MIN(best, now_ns() - t0);
+	}
+
+	return best;
+}
+
+static void report(const char *mode, int chunk, uint64_t ns)
+{
+	/* MB/s in hundredths */
+	uint64_t rate = (100000ULL * TOTAL) / ns;
+
+	printk("%-10s %6d %7u.%02u %10u\n", mode, chunk,
+	       (uint32_t)(rate / 100), (uint32_t)(rate % 100),
+	       (uint32_t)((ns * 1024U) / TOTAL));
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	int listener, client, server;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	for (int i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = i;
+	}
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0 || client < 0 ||
+	    bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0 ||
+	    connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("ERROR: cannot connect: %d\n", errno);
+		return;
+	}
+
+	server = accept(listener, NULL, NULL);
+	if (server < 0) {
+		printk("ERROR: cannot accept: %d\n", errno);
+		return;
+	}
+
+	printk("TCP over loopback, %d KiB per run\n", TOTAL / 1024);
+	printk("%-10s %6s %10s %10s\n", "mode", "chunk", "MB/s", "ns/KiB");
+
+	for (int c = 0; c < ARRAY_SIZE(chunks); c++) {
+		uint64_t copy_ns, zc_ns;
+
+		copy_ns = measure(copy_chunk, client, server, chunks[c]);
+		zc_ns = measure(zerocopy_chunk, client, server, chunks[c]);
+		if (copy_ns == 0 || zc_ns == 0) {
+			printk("ERROR: transfer failed in chunks of %d bytes\n",
+			       chunks[c]);
+			return;
+		}
+
+		report("copy", chunks[c], copy_ns);
+		report("zero-copy", chunks[c], zc_ns);
+	}
+
+	(void)close(client);
+	(void)close(server);
+	(void)close(listener);
+
+	timing_stop();
+	printk("fin\n");
+}
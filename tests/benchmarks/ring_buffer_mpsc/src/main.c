@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+#include <timing/timing.h>
+
+/* Multi-producer ring buffer contention benchmark: see README.rst */
+
+#define MAX_PRODUCERS MAX(CONFIG_MP_NUM_CPUS, 2)
+#define N_RECORDS 20000
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+
+struct record {
+	uint32_t producer;
+	uint32_t seq;
+	uint32_t payload[2];
+};
+
+RING_BUF_DECLARE(locked_buf, 64 * sizeof(struct record));
+static struct k_spinlock lock;
+
+/* The same room for records, with their header words */
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, 8);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_PRODUCERS + 1, STACK_SIZE);
+static struct k_thread threads[MAX_PRODUCERS + 1];
+
+static volatile uint32_t sink;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static bool locked_put(const struct record *rec)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool ok = false;
+
+	if (ring_buf_space_get(&locked_buf) >= sizeof(*rec)) {
+		ok = ring_buf_put(&locked_buf, (const uint8_t *)rec,
+				  sizeof(*rec)) == sizeof(*rec);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return ok;
+}
+
+static bool locked_get(struct record *rec)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t len = ring_buf_get(&locked_buf, (uint8_t *)rec, sizeof(*rec));
+
+	k_spin_unlock(&lock, key);
+
+	return len == sizeof(*rec);
+}
+
+static bool mpsc_put(const struct record *rec)
+{
+	return ring_buf_mpsc_put(&mpsc_buf, (const uint8_t *)rec,
+				 sizeof(*rec)) == 0;
+}
+
+static bool mpsc_get(struct record *rec)
+{
+	return ring_buf_mpsc_get(&mpsc_buf, (uint8_t *)rec,
+				 sizeof(*rec)) == sizeof(*rec);
+}
+
+static const struct {
+	const char *name;
+	bool (*put)(const struct record *rec);
+	bool (*get)(struct record *rec);
+} variants[] = {
+	{ "locked", locked_put, locked_get },
+	{ "mpsc", mpsc_put, mpsc_get },
+};
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	bool (*put)(const struct record *rec) = p1;
+	struct record rec = { .producer = POINTER_TO_UINT(p2) };
+
+	for (rec.seq = 0; rec.seq < N_RECORDS; rec.seq++) {
+		while (!put(&rec)) {
+			k_yield();
+		}
+	}
+}
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	bool (*get)(struct record *rec) = p1;
+	uint32_t total = POINTER_TO_UINT(p2);
+	uint32_t acc = 0;
+	struct record rec;
+
+	for (uint32_t i = 0; i < total; i++) {
+		while (!get(&rec)) {
+			k_yield();
+		}
+		acc += rec.seq;
+	}
+
+	sink = acc;
+}
+
+static void run(int v, int producers)
+{
+	uint32_t total = producers * N_RECORDS;
+	uint64_t t0 = now_ns();
+	uint64_t ns;
+
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, consumer,
+			variants[v].get, UINT_TO_POINTER(total), NULL,
+			WORKER_PRIO, 0, K_NO_WAIT);
+	for (int p = 1; p <= producers; p++) {
+		k_thread_create(&threads[p], stacks[p], STACK_SIZE, producer,
+				variants[v].put, UINT_TO_POINTER(p), NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	for (int p = 0; p <= producers; p++) {
+		k_thread_join(&threads[p], K_FOREVER);
+	}
+
+	ns = now_ns() - t0;
+	printk("%-8s %d producer%s %6u ns/record\n", variants[v].name,
+	       producers, (producers > 1) ? "s" : " ", (uint32_t)(ns / total));
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	/* Stay cooperative so that the workers only run once all of them
+	 * are created
+	 */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	printk("Ring buffer benchmark, %d CPUs\n", CONFIG_MP_NUM_CPUS);
+
+	for (int producers = 1; producers <= MAX_PRODUCERS; producers++) {
+		for (int v = 0; v < ARRAY_SIZE(variants); v++) {
+			run(v, producers);
+		}
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
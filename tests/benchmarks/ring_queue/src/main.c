@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/ring_buffer.h>
+#include <timing/timing.h>
+#include <string.h>
+
+/* Ring queue benchmark: see README.rst */
+
+#define N_MSGS 100000
+#define Q_LEN 32
+#define BATCH 16
+#define STACK_SIZE 1024
+
+struct record {
+	uint32_t timestamp;
+	uint32_t seq;
+	int16_t value[4];
+};
+
+struct fifo_record {
+	void *fifo_reserved;
+	struct record rec;
+};
+
+K_RINGQ_DEFINE(spsc_q, sizeof(struct record), Q_LEN, 0);
+K_RINGQ_DEFINE(mpsc_q, sizeof(struct record), Q_LEN,
+	       K_RINGQ_FLAG_MULTI_PRODUCER);
+K_MSGQ_DEFINE(msgq, sizeof(struct record), Q_LEN, 4);
+K_FIFO_DEFINE(fifo);
+RING_BUF_DECLARE(ring_buf, Q_LEN * sizeof(struct record));
+
+static struct fifo_record fifo_records[BATCH];
+
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_thread consumer_thread;
+
+static volatile uint32_t sink;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static void report(const char *name, const char *pattern, uint64_t ns)
+{
+	printk("%-10s %-7s %5u ns/msg\n", name, pattern,
+	       (uint32_t)(ns / N_MSGS));
+}
+
+static void batch_ringq(const char *name, struct k_ringq *q)
+{
+	struct record rec = { 0 };
+	uint64_t t0 = now_ns();
+
+	for (int i = 0; i < N_MSGS; i += BATCH) {
+		for (int j = 0; j < BATCH; j++) {
+			rec.seq = i + j;
+			(void)k_ringq_put(q, &rec, K_NO_WAIT);
+		}
+		for (int j = 0; j < BATCH; j++) {
+			(void)k_ringq_get(q, &rec, K_NO_WAIT);
+			sink += rec.seq;
+		}
+	}
+
+	report(name, "batch", now_ns() - t0);
+}
+
+static void batch_msgq(void)
+{
+	struct record rec = { 0 };
+	uint64_t t0 = now_ns();
+
+	for (int i = 0; i < N_MSGS; i += BATCH) {
+		for (int j = 0; j < BATCH; j++) {
+			rec.seq = i + j;
+			(void)k_msgq_put(&msgq, &rec, K_NO_WAIT);
+		}
+		for (int j = 0; j < BATCH; j++) {
+			(void)k_msgq_get(&msgq, &rec, K_NO_WAIT);
+			sink += rec.seq;
+		}
+	}
+
+	report("msgq", "batch", now_ns() - t0);
+}
+
+static void batch_fifo(void)
+{
+	uint64_t t0 = now_ns();
+
+	/* Records are passed by reference, but still written by the
+	 * producer and read by the consumer
+	 */
+	for (int i = 0; i < N_MSGS; i += BATCH) {
+		for (int j = 0; j < BATCH; j++) {
+			fifo_records[j].rec.seq = i + j;
+			k_fifo_put(&fifo, &fifo_records[j]);
+		}
+		for (int j = 0; j < BATCH; j++) {
+			struct fifo_record *r = k_fifo_get(&fifo, K_NO_WAIT);
+
+			sink += r->rec.seq;
+		}
+	}
+
+	report("fifo", "batch", now_ns() - t0);
+}
+
+static void batch_ring_buf(void)
+{
+	struct record rec = { 0 };
+	uint64_t t0 = now_ns();
+
+	for (int i = 0; i < N_MSGS; i += BATCH) {
+		for (int j = 0; j < BATCH; j++) {
+			uint8_t *data;
+
+			rec.seq = i + j;
+			(void)ring_buf_put_claim(&ring_buf, &data, sizeof(rec));
+			memcpy(data, &rec, sizeof(rec));
+			(void)ring_buf_put_finish(&ring_buf, sizeof(rec));
+		}
+		for (int j = 0; j < BATCH; j++) {
+			uint8_t *data;
+
+			(void)ring_buf_get_claim(&ring_buf, &data, sizeof(rec));
+			memcpy(&rec, data, sizeof(rec));
+			(void)ring_buf_get_finish(&ring_buf, sizeof(rec));
+			sink += rec.seq;
+		}
+	}
+
+	report("ring_buf", "batch", now_ns() - t0);
+}
+
+static void ringq_producer(void *p1, void *p2, void *p3)
+{
+	struct record rec = { 0 };
+
+	for (int i = 0; i < N_MSGS; i++) {
+		rec.seq = i;
+		(void)k_ringq_put(p1, &rec, K_FOREVER);
+	}
+}
+
+static void ringq_consumer(void *p1, void *p2, void *p3)
+{
+	struct record rec;
+
+	for (int i = 0; i < N_MSGS; i++) {
+		(void)k_ringq_get(p1, &rec, K_FOREVER);
+		sink += rec.seq;
+	}
+}
+
+static void msgq_producer(void *p1, void *p2, void *p3)
+{
+	struct record rec = { 0 };
+
+	for (int i = 0; i < N_MSGS; i++) {
+		rec.seq = i;
+		(void)k_msgq_put(p1, &rec, K_FOREVER);
+	}
+}
+
+static void msgq_consumer(void *p1, void *p2, void *p3)
+{
+	struct record rec;
+
+	for (int i = 0; i < N_MSGS; i++) {
+		(void)k_msgq_get(p1, &rec, K_FOREVER);
+		sink += rec.seq;
+	}
+}
+
+static void handoff(const char *name, k_thread_entry_t producer,
+		    k_thread_entry_t consumer, void *q)
+{
+	uint64_t t0 = now_ns();
+
+	/* The consumer outranks the producer, so it is woken up (and
+	 * switched to) for every record
+	 */
+	k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE,
+			consumer, q, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+			K_NO_WAIT);
+	k_thread_create(&producer_thread, producer_stack, STACK_SIZE,
+			producer, q, NULL, NULL, K_PRIO_PREEMPT(2), 0,
+			K_NO_WAIT);
+
+	k_thread_join(&consumer_thread, K_FOREVER);
+	k_thread_join(&producer_thread, K_FOREVER);
+
+	report(name, "handoff", now_ns() - t0);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	printk("Ring queue benchmark, %d records of %u bytes\n",
+	       N_MSGS, (uint32_t)sizeof(struct record));
+
+	batch_msgq();
+	batch_fifo();
+	batch_ring_buf();
+	batch_ringq("ringq", &spsc_q);
+	batch_ringq("ringq_mpsc", &mpsc_q);
+
+	handoff("msgq", msgq_producer, msgq_consumer, &msgq);
+	handoff("ringq", ringq_producer, ringq_consumer, &spsc_q);
+
+	timing_stop();
+	printk("fin\n");
+}
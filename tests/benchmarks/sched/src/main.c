@@ -49,20 +49,31 @@ enum {
 
 uint32_t stamps[NUM_STAMP_STATES];
 
-static inline int _stamp(int state)
+static inline uint32_t cycles(void)
 {
 	uint32_t t;
 
 	/* In theory the TSC has much lower overhead and higher
 	 * precision.  In practice it's VERY jittery in recent qemu
-	 * versions and frankly too noisy to trust.
+	 * versions and frankly too noisy to trust.  On native_posix
+	 * the simulated cycle count doesn't advance with the code
+	 * being measured, so the host's TSC is the only option.
 	 */
-#ifdef CONFIG_X86
+#if defined(CONFIG_X86) || \
+	(defined(CONFIG_ARCH_POSIX) && \
+	 (defined(__x86_64__) || defined(__i386__)))
 	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
 #else
 	t = k_cycle_get_32();
 #endif
 
+	return t;
+}
+
+static inline int _stamp(int state)
+{
+	uint32_t t = cycles();
+
 	stamps[state] = t;
 	return t;
 }
@@ -86,6 +97,90 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
+/* Many waiters: dummy threads at random priorities across the whole
+ * range are pended on one wait queue (unlike real threads, they can
+ * be pended without switching to them), then unpended again in
+ * priority order, and each operation is timed.  In between, with all
+ * but one pended, the spare one is pended at a new random priority
+ * and the best one unpended to become the spare, over and over, which
+ * is the steady state of a busy IPC object.
+ */
+#define N_WAITERS 256
+
+static struct k_thread waiters[N_WAITERS];
+static _wait_q_t many_waitq;
+static uint32_t rand_state = 0x5eed0009;
+
+struct op_stats {
+	uint32_t tot;
+	uint32_t max;
+};
+
+static int rand_prio(void)
+{
+	int nprio = K_LOWEST_APPLICATION_THREAD_PRIO -
+		    K_HIGHEST_APPLICATION_THREAD_PRIO + 1;
+
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return K_HIGHEST_APPLICATION_THREAD_PRIO + (rand_state % nprio);
+}
+
+static void op_done(struct op_stats *st, uint32_t t0)
+{
+	uint32_t dt = cycles() - t0;
+
+	st->tot += dt;
+	st->max = MAX(st->max, dt);
+}
+
+static void waiters_bench(void)
+{
+	struct op_stats pend = { 0 }, unpend = { 0 }, steady = { 0 };
+	struct k_thread *spare;
+	uint32_t t0;
+
+	z_waitq_init(&many_waitq);
+
+	for (int i = 0; i < N_WAITERS; i++) {
+		z_init_thread_base(&waiters[i].base, rand_prio(),
+				   _THREAD_DUMMY, 0);
+	}
+
+	for (int i = 0; i < N_WAITERS; i++) {
+		t0 = cycles();
+		z_pend_thread(&waiters[i], &many_waitq, K_FOREVER);
+		op_done(&pend, t0);
+	}
+
+	spare = z_unpend_first_thread(&many_waitq);
+	for (int i = 0; i < N_WAITERS; i++) {
+		spare->base.prio = rand_prio();
+
+		t0 = cycles();
+		z_pend_thread(spare, &many_waitq, K_FOREVER);
+		op_done(&steady, t0);
+
+		t0 = cycles();
+		spare = z_unpend_first_thread(&many_waitq);
+		op_done(&steady, t0);
+	}
+	z_pend_thread(spare, &many_waitq, K_FOREVER);
+
+	for (int i = 0; i < N_WAITERS; i++) {
+		t0 = cycles();
+		(void)z_unpend_first_thread(&many_waitq);
+		op_done(&unpend, t0);
+	}
+
+	printk("waiters %d pend avg %4u max %5u unpend avg %4u max %5u "
+	       "steady avg %4u max %5u\n", N_WAITERS,
+	       pend.tot / N_WAITERS, pend.max, unpend.tot / N_WAITERS,
+	       unpend.max, steady.tot / (2 * N_WAITERS), steady.max);
+}
+
 void main(void)
 {
 	z_waitq_init(&waitq);
@@ -148,5 +243,7 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+	waiters_bench();
 	printk("fin\n");
 }
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP context switch throughput benchmark: see README.rst.  Each
+ * "pair" is two threads bouncing a pair of semaphores back and forth.
+ * The main thread runs cooperatively at a higher priority and only
+ * wakes up to start and stop the measurement windows.
+ */
+
+#define N_PAIRS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+#define SETTLE_MS 100
+#define WINDOW_MS 1000
+
+struct pair {
+	struct k_sem ping_sem;
+	struct k_sem pong_sem;
+	struct k_thread ping_thread;
+	struct k_thread pong_thread;
+	volatile uint32_t roundtrips;
+};
+
+static struct pair pairs[N_PAIRS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(ping_stacks, N_PAIRS, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(pong_stacks, N_PAIRS, STACK_SIZE);
+
+static void ping_fn(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_give(&p->pong_sem);
+		k_sem_take(&p->ping_sem, K_FOREVER);
+		p->roundtrips++;
+	}
+}
+
+static void pong_fn(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_take(&p->pong_sem, K_FOREVER);
+		k_sem_give(&p->ping_sem);
+	}
+}
+
+static void run(int npairs)
+{
+	uint64_t total = 0U;
+	uint32_t start, cycles;
+
+	for (int i = 0; i < npairs; i++) {
+		struct pair *p = &pairs[i];
+
+		k_sem_init(&p->ping_sem, 0, 1);
+		k_sem_init(&p->pong_sem, 0, 1);
+		p->roundtrips = 0U;
+
+		k_thread_create(&p->ping_thread, ping_stacks[i], STACK_SIZE,
+				ping_fn, p, NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+		k_thread_create(&p->pong_thread, pong_stacks[i], STACK_SIZE,
+				pong_fn, p, NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(SETTLE_MS);
+
+	for (int i = 0; i < npairs; i++) {
+		pairs[i].roundtrips = 0U;
+	}
+	start = k_cycle_get_32();
+
+	k_msleep(WINDOW_MS);
+
+	cycles = k_cycle_get_32() - start;
+	for (int i = 0; i < npairs; i++) {
+		total += pairs[i].roundtrips;
+	}
+
+	for (int i = 0; i < npairs; i++) {
+		k_thread_abort(&pairs[i].ping_thread);
+		k_thread_abort(&pairs[i].pong_thread);
+	}
+
+	printk("cpus %d pairs %d roundtrips %u avg %u\n",
+	       CONFIG_MP_NUM_CPUS, npairs, (uint32_t)total,
+	       total ? (uint32_t)(((uint64_t)cycles * npairs) / total) : 0U);
+}
+
+void main(void)
+{
+	/* Stay cooperative so the workers never preempt the
+	 * measurement control logic
+	 */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	printk("SMP scheduler benchmark (%s)\n",
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "per-CPU ready queues"
+						 : "shared ready queue");
+
+	for (int npairs = 1; npairs <= N_PAIRS; npairs++) {
+		run(npairs);
+	}
+
+	printk("fin\n");
+}
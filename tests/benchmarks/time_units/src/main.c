@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/time_units.h>
+#include <timing/timing.h>
+
+/* Time unit conversion benchmark: see README.rst */
+
+#define CONVERSIONS 100000
+#define ROUNDS 5
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* Divisor the compiler can't see, for comparison */
+static volatile uint32_t runtime_hz = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
+
+static uint64_t cyc_to_ns_floor64(uint64_t t)
+{
+	return k_cyc_to_ns_floor64(t);
+}
+
+static uint64_t cyc_to_us_near64(uint64_t t)
+{
+	return k_cyc_to_us_near64(t);
+}
+
+static uint64_t cyc_to_ticks_floor64(uint64_t t)
+{
+	return k_cyc_to_ticks_floor64(t);
+}
+
+static uint64_t ticks_to_ms_near64(uint64_t t)
+{
+	return k_ticks_to_ms_near64(t);
+}
+
+static uint64_t ns_to_cyc_ceil64(uint64_t t)
+{
+	return k_ns_to_cyc_ceil64(t);
+}
+
+static uint64_t ms_to_ticks_ceil32(uint64_t t)
+{
+	return k_ms_to_ticks_ceil32((uint32_t)t);
+}
+
+static uint64_t cyc_to_ms_floor32(uint64_t t)
+{
+	return k_cyc_to_ms_floor32((uint32_t)t);
+}
+
+static uint64_t runtime_div64(uint64_t t)
+{
+	return t / runtime_hz;
+}
+
+static const struct {
+	const char *name;
+	uint64_t (*fn)(uint64_t t);
+	/* Inputs are spread above this, to get past any 32 bit shortcut */
+	uint64_t base;
+} convs[] = {
+	{ "k_cyc_to_ns_floor64", cyc_to_ns_floor64, BIT64(40) },
+	{ "k_cyc_to_us_near64", cyc_to_us_near64, BIT64(40) },
+	{ "k_cyc_to_ticks_floor64", cyc_to_ticks_floor64, BIT64(40) },
+	{ "k_ticks_to_ms_near64", ticks_to_ms_near64, BIT64(36) },
+	{ "k_ns_to_cyc_ceil64", ns_to_cyc_ceil64, BIT64(40) },
+	{ "k_ms_to_ticks_ceil32", ms_to_ticks_ceil32, 0 },
+	{ "k_cyc_to_ms_floor32", cyc_to_ms_floor32, BIT64(31) },
+	{ "runtime division", runtime_div64, BIT64(40) },
+};
+
+static volatile uint64_t sink;
+
+/* Best time per conversion over a few rounds, in hundredths of ns */
+static uint32_t measure(uint64_t (*fn)(uint64_t t), uint64_t base)
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+		uint64_t acc = 0;
+
+		for (int i = 0; i < CONVERSIONS; i++) {
+			acc = fn(base + (acc & 0xffffU) + i);
+		}
+
+		best = MIN(best, now_ns() - t0);
+		sink = acc;
+	}
+
+	return (uint32_t)((100U * best) / CONVERSIONS);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	printk("Time unit conversions, %u Hz cycles, %u Hz ticks, %s\n",
+	       sys_clock_hw_cycles_per_sec(), CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+	       IS_ENABLED(CONFIG_TIME_UNITS_RECIPROCAL) ?
+	       "reciprocals" : "divisions");
+	printk("ns per conversion\n");
+
+	for (int c = 0; c < ARRAY_SIZE(convs); c++) {
+		uint32_t ns = measure(convs[c].fn, convs[c].base);
+
+		printk("%-24s %6u.%02u\n", convs[c].name, ns / 100, ns % 100);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* Timeout queue benchmark: see README.rst.  Timestamps come from the
+ * host clock, which (unlike k_cycle_get_32() on native_posix)
+ * advances with the CPU time actually spent in the kernel.
+ */
+BUILD_ASSERT(IS_ENABLED(CONFIG_ARCH_POSIX), "needs the native_posix host clock");
+
+extern uint64_t get_host_us_time(void);
+
+#define MAX_TIMEOUTS 10000
+#define MAX_DELAY_TICKS 1000
+
+static struct _timeout timeouts[MAX_TIMEOUTS];
+static k_ticks_t delays[MAX_TIMEOUTS];
+static uint16_t order[MAX_TIMEOUTS];
+static volatile uint32_t expired;
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32, deterministic so runs are comparable */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void shuffle(int n)
+{
+	for (int i = 0; i < n; i++) {
+		order[i] = i;
+	}
+	for (int i = n - 1; i > 0; i--) {
+		int j = next_rand() % (i + 1);
+		uint16_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+static void expire_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+	expired++;
+}
+
+static void insert_all(int n)
+{
+	for (int i = 0; i < n; i++) {
+		int idx = order[i];
+
+		z_add_timeout(&timeouts[idx], expire_fn, K_TICKS(delays[idx]));
+	}
+}
+
+static uint32_t per_op_ns(uint64_t us, int n)
+{
+	return (uint32_t)((us * 1000U) / n);
+}
+
+static void run(int n)
+{
+	uint64_t t0, insert_us, abort_us, expire_us;
+
+	for (int i = 0; i < n; i++) {
+		delays[i] = 1 + (next_rand() % MAX_DELAY_TICKS);
+	}
+
+	/* Align to a tick boundary so nothing expires while inserting */
+	k_sleep(K_TICKS(1));
+
+	shuffle(n);
+	t0 = get_host_us_time();
+	insert_all(n);
+	insert_us = get_host_us_time() - t0;
+
+	shuffle(n);
+	t0 = get_host_us_time();
+	for (int i = 0; i < n; i++) {
+		z_abort_timeout(&timeouts[order[i]]);
+	}
+	abort_us = get_host_us_time() - t0;
+
+	k_sleep(K_TICKS(1));
+
+	shuffle(n);
+	insert_all(n);
+	expired = 0U;
+	t0 = get_host_us_time();
+	k_sleep(K_TICKS(MAX_DELAY_TICKS + 1));
+	expire_us = get_host_us_time() - t0;
+
+	if (expired != n) {
+		printk("ERROR: %u of %d timeouts expired\n", expired, n);
+	}
+
+	printk("n %5d insert %5u abort %5u expire %5u (ns/op)\n",
+	       n, per_op_ns(insert_us, n), per_op_ns(abort_us, n),
+	       per_op_ns(expire_us, n));
+}
+
+void main(void)
+{
+	printk("Timeout queue benchmark (%s)\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_QUEUE_SCALABLE) ? "red/black tree"
+							 : "sorted list");
+
+	for (int n = 10; n <= MAX_TIMEOUTS; n *= 10) {
+		run(n);
+	}
+
+	printk("fin\n");
+}
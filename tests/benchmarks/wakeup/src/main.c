@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timing/timing.h>
+
+/* Thundering herd wakeup benchmark: see README.rst */
+
+#define MAX_WAITERS 128
+#define STACK_SIZE 1024
+#define ROUNDS 50
+
+enum mode {
+	CONDVAR_SIGNAL,
+	CONDVAR_BROADCAST,
+#ifdef CONFIG_USERSPACE
+	FUTEX_WAKE,
+	FUTEX_WAKE_ALL,
+#endif
+	NUM_MODES
+};
+
+static const char *const mode_names[NUM_MODES] = {
+	[CONDVAR_SIGNAL] = "condvar signal",
+	[CONDVAR_BROADCAST] = "condvar bcast",
+#ifdef CONFIG_USERSPACE
+	[FUTEX_WAKE] = "futex wake",
+	[FUTEX_WAKE_ALL] = "futex wake_all",
+#endif
+};
+
+K_MUTEX_DEFINE(mutex);
+K_CONDVAR_DEFINE(condvar);
+K_SEM_DEFINE(all_woken, 0, 1);
+#ifdef CONFIG_USERSPACE
+static struct k_futex futex;
+#endif
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WAITERS, STACK_SIZE);
+static struct k_thread threads[MAX_WAITERS];
+
+static volatile enum mode mode;
+static int n_waiters;
+static atomic_t arrived;
+static atomic_t woken;
+static volatile uint64_t last_woken_ns;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		if (mode <= CONDVAR_BROADCAST) {
+			k_mutex_lock(&mutex, K_FOREVER);
+			atomic_inc(&arrived);
+			k_condvar_wait(&condvar, &mutex, K_FOREVER);
+			k_mutex_unlock(&mutex);
+		}
+#ifdef CONFIG_USERSPACE
+		else {
+			atomic_inc(&arrived);
+			k_futex_wait(&futex, 0, K_FOREVER);
+		}
+#endif
+
+		if (atomic_inc(&woken) + 1 == n_waiters) {
+			last_woken_ns = now_ns();
+			k_sem_give(&all_woken);
+		}
+	}
+}
+
+/* Waits for all the waiters to block again */
+static void wait_for_waiters(void)
+{
+	while (atomic_get(&arrived) < n_waiters) {
+		k_msleep(1);
+	}
+	/* The futex waiters count themselves just before blocking */
+	k_msleep(1);
+}
+
+static void wake(enum mode m)
+{
+	switch (m) {
+	case CONDVAR_SIGNAL:
+		for (int i = 0; i < n_waiters; i++) {
+			k_condvar_signal(&condvar);
+		}
+		break;
+	case CONDVAR_BROADCAST:
+		k_condvar_broadcast(&condvar);
+		break;
+#ifdef CONFIG_USERSPACE
+	case FUTEX_WAKE:
+		for (int i = 0; i < n_waiters; i++) {
+			k_futex_wake(&futex, false);
+		}
+		break;
+	case FUTEX_WAKE_ALL:
+		k_futex_wake(&futex, true);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+/* The waiters pick the primitive to block on when they wake up, so
+ * the last round already tells them the mode of the next run
+ */
+static void run(enum mode m, enum mode next)
+{
+	uint64_t call_ns = 0, last_ns = 0;
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0, t1;
+
+		wait_for_waiters();
+		atomic_set(&arrived, 0);
+		atomic_set(&woken, 0);
+		mode = (r == (ROUNDS - 1)) ? next : m;
+
+		/* This thread is cooperative: none of the waiters runs
+		 * until it blocks on all_woken
+		 */
+		t0 = now_ns();
+		wake(m);
+		t1 = now_ns();
+		k_sem_take(&all_woken, K_FOREVER);
+
+		call_ns += t1 - t0;
+		last_ns += last_woken_ns - t0;
+	}
+
+	printk("%-16s waiters %3d wake %7u ns last running %7u ns\n",
+	       mode_names[m], n_waiters, (uint32_t)(call_ns / ROUNDS),
+	       (uint32_t)(last_ns / ROUNDS));
+}
+
+static void run_all(int n)
+{
+	n_waiters = n;
+	atomic_set(&arrived, 0);
+	mode = CONDVAR_SIGNAL;
+
+	for (int i = 0; i < n; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, waiter,
+				NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+
+	for (enum mode m = 0; m < NUM_MODES; m++) {
+		run(m, (m + 1) % NUM_MODES);
+	}
+
+	/* The waiters are all blocked again by now */
+	wait_for_waiters();
+	for (int i = 0; i < n; i++) {
+		k_thread_abort(&threads[i]);
+	}
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	printk("Thundering herd wakeup benchmark\n");
+
+	run_all(MAX_WAITERS / 2);
+	run_all(MAX_WAITERS);
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/p4wq.h>
+#include <timing/timing.h>
+
+/* Work stealing pool scaling benchmark: see README.rst */
+
+#define MAX_WORKERS CONFIG_MP_NUM_CPUS
+#define STACK_SIZE 4096
+#define DATA_LEN (32 * 1024)
+#define LEAF_LEN 32
+#define ROUNDS 20
+
+struct node {
+	struct k_p4wq_work item;
+	uint32_t lo, hi;
+	uint32_t result;
+};
+
+static struct k_p4wq_ws pool;
+static struct k_p4wq_ws_worker workers[MAX_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_WORKERS, STACK_SIZE);
+
+static uint32_t data[DATA_LEN];
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_ns(void)
+{
+	return get_host_us_time() * 1000U;
+}
+#else
+static timing_t timing_base;
+
+static uint64_t now_ns(void)
+{
+	timing_t t = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&timing_base, &t));
+}
+#endif
+
+/* Some CPU-bound work per element, standing in for a checksum or a
+ * compression step
+ */
+static uint32_t leaf(uint32_t lo, uint32_t hi)
+{
+	uint32_t acc = 0;
+
+	for (uint32_t i = lo; i < hi; i++) {
+		uint32_t x = data[i];
+
+		for (int k = 0; k < 8; k++) {
+			x = (x * 2654435761U) ^ (x >> 13);
+		}
+		acc += x;
+	}
+	return acc;
+}
+
+static void node_handler(struct k_p4wq_work *item)
+{
+	struct node *n = CONTAINER_OF(item, struct node, item);
+
+	if ((n->hi - n->lo) <= LEAF_LEN) {
+		n->result = leaf(n->lo, n->hi);
+		return;
+	}
+
+	struct k_p4wq_ws_join join;
+	uint32_t mid = (n->lo + n->hi) / 2;
+	struct node kids[2] = {
+		{ .item.handler = node_handler, .lo = n->lo, .hi = mid },
+		{ .item.handler = node_handler, .lo = mid, .hi = n->hi },
+	};
+
+	k_p4wq_ws_join_init(&join);
+	k_p4wq_ws_fork(&pool, &join, &kids[0].item);
+	k_p4wq_ws_fork(&pool, &join, &kids[1].item);
+	k_p4wq_ws_join(&pool, &join);
+
+	n->result = kids[0].result + kids[1].result;
+}
+
+static uint32_t run_pool(uint32_t num_workers, uint64_t *ns)
+{
+	struct node root = {
+		.item.handler = node_handler, .lo = 0, .hi = DATA_LEN,
+	};
+	struct k_p4wq_ws_join join;
+
+	k_p4wq_ws_init(&pool, workers, num_workers);
+	k_p4wq_ws_start(&pool, (k_thread_stack_t *)stacks, STACK_SIZE,
+			K_PRIO_PREEMPT(1));
+
+	*ns = UINT64_MAX;
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+
+		k_p4wq_ws_join_init(&join);
+		k_p4wq_ws_fork(&pool, &join, &root.item);
+		k_p4wq_ws_join(&pool, &join);
+
+		*ns = MIN(*ns, now_ns() - t0);
+	}
+
+	/* The workers are all idle again once the join returns */
+	for (uint32_t i = 0; i < num_workers; i++) {
+		k_thread_abort(&workers[i].thread);
+	}
+
+	return root.result;
+}
+
+void main(void)
+{
+	uint64_t seq_ns = UINT64_MAX, one_ns = 0;
+	uint32_t expect = 0;
+
+	timing_init();
+	timing_start();
+#ifndef CONFIG_ARCH_POSIX
+	timing_base = timing_counter_get();
+#endif
+
+	for (uint32_t i = 0; i < DATA_LEN; i++) {
+		data[i] = i * 0x9e3779b9U;
+	}
+
+	printk("Work stealing pool benchmark, %u elements, %u per leaf, "
+	       "%u items\n", DATA_LEN, LEAF_LEN, 2 * DATA_LEN / LEAF_LEN - 1);
+
+	for (int r = 0; r < ROUNDS; r++) {
+		uint64_t t0 = now_ns();
+
+		expect = leaf(0, DATA_LEN);
+		seq_ns = MIN(seq_ns, now_ns() - t0);
+	}
+	printk("sequential  %8u ns\n", (uint32_t)seq_ns);
+
+	for (uint32_t n = 1; n <= MAX_WORKERS; n++) {
+		uint64_t ns;
+		uint32_t result = run_pool(n, &ns);
+
+		if (n == 1) {
+			one_ns = ns;
+		}
+
+		if (result != expect) {
+			printk("ERROR: wrong result with %u workers\n", n);
+		}
+
+		printk("workers %3u %8u ns speedup x%u.%02u overhead %3u%%\n",
+		       n, (uint32_t)ns, (uint32_t)(one_ns / ns),
+		       (uint32_t)((100 * one_ns / ns) % 100),
+		       (uint32_t)(ns * n > seq_ns
+				  ? (100 * (ns * n - seq_ns)) / seq_ns : 0));
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -111,3 +111,71 @@ void test_kheap_alloc_in_isr_nowait(void)
 {
 	irq_offload((irq_offload_routine_t)tIsr_kheap_alloc_nowait, NULL);
 }
+
+#ifdef CONFIG_KERNEL_HEAP_TRACE
+static struct {
+	struct k_heap *h;
+	enum k_heap_trace_op op;
+	void *mem;
+	size_t align;
+	size_t bytes;
+} traced[4];
+static int n_traced;
+
+static void trace_hook(struct k_heap *h, enum k_heap_trace_op op,
+		       void *mem, size_t align, size_t bytes)
+{
+	if (n_traced < ARRAY_SIZE(traced)) {
+		traced[n_traced].h = h;
+		traced[n_traced].op = op;
+		traced[n_traced].mem = mem;
+		traced[n_traced].align = align;
+		traced[n_traced].bytes = bytes;
+	}
+	n_traced++;
+}
+#endif
+
+/**
+ * @brief Test the k_heap trace hook
+ *
+ * @ingroup kernel_kheap_api_tests
+ *
+ * @details Installs a trace hook and checks it sees a successful
+ * allocation and its free, but neither a failed allocation nor a
+ * free of NULL, and that nothing is reported once it is removed.
+ *
+ * @see k_heap_trace_hook_set()
+ */
+void test_k_heap_trace_hook(void)
+{
+#ifdef CONFIG_KERNEL_HEAP_TRACE
+	char *p, *p1;
+
+	n_traced = 0;
+	k_heap_trace_hook_set(trace_hook);
+
+	p = k_heap_aligned_alloc(&k_heap_test, 64, ALLOC_SIZE_1, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_aligned_alloc operation failed");
+	zassert_is_null(k_heap_alloc(&k_heap_test, ALLOC_SIZE_3, K_NO_WAIT),
+			NULL);
+	k_heap_free(&k_heap_test, p);
+	p1 = p;
+	k_heap_free(&k_heap_test, NULL);
+
+	k_heap_trace_hook_set(NULL);
+	p = k_heap_alloc(&k_heap_test, ALLOC_SIZE_1, K_NO_WAIT);
+	k_heap_free(&k_heap_test, p);
+
+	zassert_equal(n_traced, 2, "%d operations traced", n_traced);
+	zassert_equal(traced[0].h, &k_heap_test, NULL);
+	zassert_equal(traced[0].op, K_HEAP_TRACE_ALLOC, NULL);
+	zassert_equal(traced[0].mem, p1, NULL);
+	zassert_equal(traced[0].align, 64, NULL);
+	zassert_equal(traced[0].bytes, ALLOC_SIZE_1, NULL);
+	zassert_equal(traced[1].op, K_HEAP_TRACE_FREE, NULL);
+	zassert_equal(traced[1].mem, traced[0].mem, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define Q_LEN 8
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_PRODUCERS 3
+#define MSGS_PER_PRODUCER 200
+#define TIMEOUT K_MSEC(100)
+
+struct msg {
+	uint32_t id;
+	uint32_t seq;
+	uint8_t pad[5];
+};
+
+K_RINGQ_DEFINE(spsc_q, sizeof(struct msg), Q_LEN, 0);
+K_RINGQ_DEFINE(mpsc_q, sizeof(struct msg), Q_LEN,
+	       K_RINGQ_FLAG_MULTI_PRODUCER);
+
+static char __aligned(sizeof(atomic_t))
+	dyn_buf[K_RINGQ_BUF_SIZE(sizeof(struct msg), Q_LEN)];
+static struct k_ringq dyn_q;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_PRODUCERS, STACK_SIZE);
+static struct k_thread threads[N_PRODUCERS];
+
+static void put_seq(struct k_ringq *q, uint32_t id, uint32_t seq)
+{
+	struct msg m = { .id = id, .seq = seq };
+
+	zassert_equal(k_ringq_put(q, &m, K_NO_WAIT), 0, "put failed");
+}
+
+static void get_seq(struct k_ringq *q, uint32_t id, uint32_t seq)
+{
+	struct msg m;
+
+	zassert_equal(k_ringq_get(q, &m, K_NO_WAIT), 0, "get failed");
+	zassert_equal(m.id, id, "wrong id");
+	zassert_equal(m.seq, seq, "wrong order: %u != %u", m.seq, seq);
+}
+
+static void check_fill_drain(struct k_ringq *q)
+{
+	struct msg m = { 0 };
+	uint32_t seq = 0;
+
+	/* Several laps, with the queue filled to a different level
+	 * each time
+	 */
+	for (int lap = 0; lap < 4 * Q_LEN; lap++) {
+		int n = (lap % Q_LEN) + 1;
+
+		for (int i = 0; i < n; i++) {
+			put_seq(q, 0, seq + i);
+		}
+		zassert_equal(k_ringq_num_used_get(q), n, NULL);
+		zassert_equal(k_ringq_num_free_get(q), Q_LEN - n, NULL);
+
+		for (int i = 0; i < n; i++) {
+			get_seq(q, 0, seq + i);
+		}
+		seq += n;
+	}
+
+	for (int i = 0; i < Q_LEN; i++) {
+		put_seq(q, 1, i);
+	}
+	zassert_equal(k_ringq_put(q, &m, K_NO_WAIT), -ENOMSG,
+		      "put to full queue");
+	zassert_equal(k_ringq_put(q, &m, K_MSEC(10)), -EAGAIN,
+		      "put to full queue did not time out");
+
+	for (int i = 0; i < Q_LEN; i++) {
+		get_seq(q, 1, i);
+	}
+	zassert_equal(k_ringq_get(q, &m, K_NO_WAIT), -ENOMSG,
+		      "get from empty queue");
+	zassert_equal(k_ringq_get(q, &m, K_MSEC(10)), -EAGAIN,
+		      "get from empty queue did not time out");
+}
+
+/**
+ * @brief Test FIFO order, full and empty conditions across laps
+ */
+void test_ringq_fill_drain(void)
+{
+	check_fill_drain(&spsc_q);
+	check_fill_drain(&mpsc_q);
+
+	k_ringq_init(&dyn_q, dyn_buf, sizeof(struct msg), Q_LEN, 0);
+	check_fill_drain(&dyn_q);
+}
+
+static void isr_put(const void *arg)
+{
+	for (int i = 0; i < Q_LEN; i++) {
+		put_seq((struct k_ringq *)arg, 2, i);
+	}
+}
+
+/**
+ * @brief Test putting from an ISR
+ */
+void test_ringq_isr(void)
+{
+	irq_offload(isr_put, &spsc_q);
+
+	for (int i = 0; i < Q_LEN; i++) {
+		get_seq(&spsc_q, 2, i);
+	}
+}
+
+static void delayed_put(void *p1, void *p2, void *p3)
+{
+	k_msleep(10);
+	put_seq(p1, 3, 0);
+}
+
+/**
+ * @brief Test a consumer blocking on an empty queue
+ */
+void test_ringq_get_blocks(void)
+{
+	struct msg m;
+
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, delayed_put,
+			&spsc_q, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_equal(k_ringq_get(&spsc_q, &m, TIMEOUT), 0, "get failed");
+	zassert_equal(m.id, 3, NULL);
+	k_thread_join(&threads[0], K_FOREVER);
+}
+
+static void blocking_put(void *p1, void *p2, void *p3)
+{
+	struct msg m = { .id = 4, .seq = Q_LEN };
+
+	zassert_equal(k_ringq_put(p1, &m, TIMEOUT), 0, "blocked put failed");
+}
+
+/**
+ * @brief Test a producer blocking on a full queue
+ */
+void test_ringq_put_blocks(void)
+{
+	for (int i = 0; i < Q_LEN; i++) {
+		put_seq(&spsc_q, 4, i);
+	}
+
+	/* Higher priority: runs until it blocks */
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, blocking_put,
+			&spsc_q, NULL, NULL, K_PRIO_COOP(0), 0, K_NO_WAIT);
+	zassert_equal(k_ringq_num_used_get(&spsc_q), Q_LEN, NULL);
+
+	for (int i = 0; i <= Q_LEN; i++) {
+		struct msg m;
+
+		zassert_equal(k_ringq_get(&spsc_q, &m, TIMEOUT), 0, NULL);
+		zassert_equal(m.seq, i, NULL);
+	}
+	k_thread_join(&threads[0], K_FOREVER);
+}
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	uint32_t id = POINTER_TO_UINT(p2);
+
+	for (uint32_t i = 0; i < MSGS_PER_PRODUCER; i++) {
+		struct msg m = { .id = id, .seq = i };
+
+		zassert_equal(k_ringq_put(p1, &m, K_FOREVER), 0, NULL);
+		if ((i % 7) == id) {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Test several producers against one consumer
+ *
+ * Every message must arrive exactly once, in order per producer.
+ */
+void test_ringq_multi_producer(void)
+{
+	uint32_t next[N_PRODUCERS] = { 0 };
+
+	for (int i = 0; i < N_PRODUCERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, producer,
+				&mpsc_q, UINT_TO_POINTER(i), NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int n = 0; n < N_PRODUCERS * MSGS_PER_PRODUCER; n++) {
+		struct msg m;
+
+		zassert_equal(k_ringq_get(&mpsc_q, &m, TIMEOUT), 0,
+			      "lost message after %d", n);
+		zassert_true(m.id < N_PRODUCERS, "bad id");
+		zassert_equal(m.seq, next[m.id], "producer %u out of order",
+			      m.id);
+		next[m.id]++;
+	}
+
+	for (int i = 0; i < N_PRODUCERS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	zassert_equal(k_ringq_num_used_get(&mpsc_q), 0, NULL);
+}
+
+/**
+ * @brief Test waiting for data with k_poll()
+ */
+void test_ringq_poll(void)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_RINGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+		&spsc_q);
+	struct msg m;
+
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN,
+		      "empty queue polled ready");
+
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE, delayed_put,
+			&spsc_q, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	event.state = K_POLL_STATE_NOT_READY;
+	zassert_equal(k_poll(&event, 1, TIMEOUT), 0, "poll failed");
+	zassert_equal(event.state, K_POLL_STATE_RINGQ_DATA_AVAILABLE, NULL);
+	k_thread_join(&threads[0], K_FOREVER);
+
+	/* Already non-empty: no need to wait */
+	event.state = K_POLL_STATE_NOT_READY;
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), 0, NULL);
+
+	zassert_equal(k_ringq_get(&spsc_q, &m, K_NO_WAIT), 0, NULL);
+	zassert_equal(spsc_q.waiters, 0, "poller registration leaked");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(ringq_api,
+			 ztest_unit_test(test_ringq_fill_drain),
+			 ztest_unit_test(test_ringq_isr),
+			 ztest_1cpu_unit_test(test_ringq_get_blocks),
+			 ztest_1cpu_unit_test(test_ringq_put_blocks),
+			 ztest_unit_test(test_ringq_multi_producer),
+			 ztest_unit_test(test_ringq_poll));
+	ztest_run_test_suite(ringq_api);
+}
@@ -59,9 +59,12 @@ void test_main(void)
 			 ztest_unit_test(test_lock_preemptible),
 			 ztest_unit_test(test_unlock_preemptible),
 			 ztest_unit_test(test_unlock_nested_sched_lock),
+			 ztest_1cpu_unit_test(test_slice_sched_lock),
 			 ztest_unit_test(test_sched_is_preempt_thread),
 			 ztest_unit_test(test_slice_reset),
 			 ztest_unit_test(test_slice_scheduling),
+			 ztest_1cpu_unit_test(test_slice_per_thread),
+			 ztest_1cpu_unit_test(test_cpu_budget),
 			 ztest_unit_test(test_priority_scheduling),
 			 ztest_unit_test(test_wakeup_expired_timer_thread),
 			 ztest_user_unit_test(test_user_k_wakeup),
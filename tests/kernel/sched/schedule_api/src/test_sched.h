@@ -39,9 +39,12 @@ void test_time_slicing_disable_preemptible(void);
 void test_lock_preemptible(void);
 void test_unlock_preemptible(void);
 void test_unlock_nested_sched_lock(void);
+void test_slice_sched_lock(void);
 void test_sched_is_preempt_thread(void);
 void test_slice_reset(void);
 void test_slice_scheduling(void);
+void test_slice_per_thread(void);
+void test_cpu_budget(void);
 void test_priority_scheduling(void);
 void test_wakeup_expired_timer_thread(void);
 void test_user_k_wakeup(void);
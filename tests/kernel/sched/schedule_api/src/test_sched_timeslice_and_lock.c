@@ -421,6 +421,51 @@ void test_unlock_nested_sched_lock(void)
 	teardown_threads();
 }
 
+/**
+ * @brief Check time slicing resumes once the scheduler is unlocked
+ *
+ * @details Lock the scheduler and create a thread of equal priority,
+ * then busy wait for several time slices, so that ticks arrive while
+ * the current thread can't be sliced.  Make sure the thread of equal
+ * priority gets to run within a couple of ticks of the unlock, the
+ * slice having run out meanwhile, without the current thread
+ * yielding.
+ *
+ * @see k_sched_lock(), k_sched_unlock(), k_sched_time_slice_set()
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_slice_sched_lock(void)
+{
+#ifdef CONFIG_TIMESLICING
+	/* set current thread to a preemptible priority */
+	init_prio = 0;
+	setup_threads();
+
+	k_sched_time_slice_set(50, 0); /* 50 ms */
+	k_sched_lock();
+	tdata[1].tid = k_thread_create(&tthread[1], tstacks[1], STACK_SIZE,
+				       thread_entry, INT_TO_POINTER(1),
+				       INT_TO_POINTER(0), NULL,
+				       tdata[1].priority, 0, K_NO_WAIT);
+	k_busy_wait(200000); /* 200 ms */
+	/* checkpoint: the thread of equal priority didn't run */
+	zassert_true(tdata[1].executed == 0, NULL);
+
+	k_sched_unlock();
+	k_busy_wait(2 * k_ticks_to_us_ceil32(1));
+	/* checkpoint: the slice that ran out ended at the next tick */
+	zassert_true(tdata[1].executed == 1, NULL);
+
+	/* restore environment */
+	k_sched_time_slice_set(0, 0); /* disable time slice */
+	k_thread_abort(tdata[1].tid);
+	k_thread_priority_set(k_current_get(), old_prio);
+#else /* CONFIG_TIMESLICING */
+	ztest_test_skip();
+#endif /* CONFIG_TIMESLICING */
+}
+
 /**
  * @brief validate k_wakeup() in some corner scenario
  * @details trigger a timer and after expiration of timer
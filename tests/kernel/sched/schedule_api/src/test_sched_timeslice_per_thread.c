@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include "test_sched.h"
+
+#ifdef CONFIG_TIMESLICE_PER_THREAD
+
+/* slice size in millisecond */
+#define SLICE_SIZE 50
+/* CPU budget and its period, in milliseconds */
+#define BUDGET_MS 20
+#define PERIOD_MS 100
+#define BUDGET_TEST_MS 500
+
+static struct k_thread threads[2];
+
+static volatile uint32_t spin_start, other_start;
+static volatile bool spin_done, other_before_done;
+static volatile bool budget_done;
+static volatile int budget_run_ms;
+
+static void sliced_spinner(void *p1, void *p2, void *p3)
+{
+	spin_start = k_cycle_get_32();
+	spin_for_ms(3 * SLICE_SIZE);
+	spin_done = true;
+}
+
+static void slice_other(void *p1, void *p2, void *p3)
+{
+	other_start = k_cycle_get_32();
+	other_before_done = !spin_done;
+}
+
+/**
+ * @brief Validate the time slice of a single thread
+ *
+ * @details With time slicing disabled for everybody else, give a
+ * thread a time slice of its own and check that another thread of
+ * the same priority gets to run once it has used it up, and not
+ * before.
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_slice_per_thread(void)
+{
+	uint32_t slice_cyc = k_ms_to_cyc_ceil32(SLICE_SIZE);
+	uint32_t tick_cyc = k_ticks_to_cyc_ceil32(1);
+	uint32_t elapsed;
+
+	k_sched_time_slice_set(0, K_PRIO_PREEMPT(0));
+	spin_done = false;
+
+	k_thread_create(&threads[0], tstacks[0], STACK_SIZE, sliced_spinner,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_FOREVER);
+	k_thread_time_slice_set(&threads[0], SLICE_SIZE);
+	k_thread_start(&threads[0]);
+	k_thread_create(&threads[1], tstacks[1], STACK_SIZE, slice_other,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+
+	k_thread_join(&threads[0], K_FOREVER);
+	k_thread_join(&threads[1], K_FOREVER);
+
+	elapsed = other_start - spin_start;
+	zassert_true(other_before_done, "thread was not sliced");
+	zassert_true(elapsed >= slice_cyc, "slice too short: %u cycles",
+		     elapsed);
+	zassert_true(elapsed <= slice_cyc + 2 * tick_cyc,
+		     "slice too long: %u cycles", elapsed);
+}
+
+static void budget_spinner(void *p1, void *p2, void *p3)
+{
+	int64_t start = k_uptime_get();
+
+	budget_run_ms = 0;
+	while (k_uptime_get() - start < BUDGET_TEST_MS) {
+		k_busy_wait(USEC_PER_MSEC);
+		budget_run_ms++;
+	}
+	budget_done = true;
+}
+
+static void budget_competitor(void *p1, void *p2, void *p3)
+{
+	while (!budget_done) {
+		k_busy_wait(100);
+	}
+}
+
+/**
+ * @brief Validate CPU budgets
+ *
+ * @details Give a busy thread a CPU budget, with a thread of lower
+ * priority busy too.  The budgeted thread must only get about its
+ * budget every period, the lower priority thread getting the rest
+ * while the budgeted one runs at background priority.
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_cpu_budget(void)
+{
+	int periods = BUDGET_TEST_MS / PERIOD_MS;
+	int tick_ms = k_ticks_to_ms_ceil32(1);
+
+	k_sched_time_slice_set(0, K_PRIO_PREEMPT(0));
+	budget_done = false;
+
+	k_thread_create(&threads[0], tstacks[0], STACK_SIZE, budget_spinner,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_FOREVER);
+	k_thread_cpu_budget_set(&threads[0], BUDGET_MS, PERIOD_MS,
+				K_LOWEST_APPLICATION_THREAD_PRIO);
+	k_thread_create(&threads[1], tstacks[1], STACK_SIZE,
+			budget_competitor, NULL, NULL, NULL, K_PRIO_PREEMPT(5),
+			0, K_NO_WAIT);
+	k_thread_start(&threads[0]);
+
+	k_thread_join(&threads[0], K_FOREVER);
+	k_thread_join(&threads[1], K_FOREVER);
+
+	/* Budgets expire on ticks, and a period may start mid-tick */
+	zassert_true(budget_run_ms >= periods * BUDGET_MS - tick_ms,
+		     "budgeted thread ran %d ms", budget_run_ms);
+	zassert_true(budget_run_ms <= (periods + 1) * (BUDGET_MS + 2 * tick_ms),
+		     "budgeted thread ran %d ms", budget_run_ms);
+}
+
+#else /* CONFIG_TIMESLICE_PER_THREAD */
+void test_slice_per_thread(void)
+{
+	ztest_test_skip();
+}
+
+void test_cpu_budget(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_TIMESLICE_PER_THREAD */
@@ -624,6 +624,103 @@ void test_smp_ipi(void)
 	}
 }
 
+static volatile bool hog_running;
+static volatile bool hog_stop;
+static volatile int stolen_cpu = -1;
+
+static void hog_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	hog_running = true;
+	while (!hog_stop) {
+		k_busy_wait(DELAY_US);
+	}
+}
+
+static void pinned_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+}
+
+static void migratable_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&sema, K_FOREVER);
+	stolen_cpu = curr_cpu();
+}
+
+static void start_pinned(struct k_thread *thread, int cpu)
+{
+	zassert_equal(k_thread_cpu_mask_clear(thread), 0, "");
+	zassert_equal(k_thread_cpu_mask_enable(thread, cpu), 0, "");
+	k_thread_start(thread);
+}
+
+/**
+ * @brief Test that a CPU runs threads queued behind a pinned one
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Keep the other CPU busy with a cooperative thread, then
+ * make a thread pinned to it runnable, and behind it a lower
+ * priority thread that may run anywhere.  Once the main thread
+ * blocks, its CPU must pick up the second thread rather than idle
+ * while the other CPU is busy.
+ */
+void test_steal_past_pinned_thread(void)
+{
+#if !defined(CONFIG_SCHED_CPU_MASK) || (CONFIG_MP_NUM_CPUS != 2)
+	ztest_test_skip();
+#else
+	volatile uint8_t *state = &tthread[1].base.thread_state;
+	int cpu = curr_cpu();
+	int other = 1 - cpu;
+
+	hog_running = false;
+	hog_stop = false;
+	stolen_cpu = -1;
+
+	k_thread_create(&t2, t2_stack, T2_STACK_SIZE, hog_fn,
+			NULL, NULL, NULL, K_PRIO_COOP(2), 0, K_FOREVER);
+	k_thread_create(&tthread[0], tstack[0], STACK_SIZE, pinned_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_FOREVER);
+	k_thread_create(&tthread[1], tstack[1], STACK_SIZE, migratable_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(2), 0, K_FOREVER);
+
+	/* Run the migratable thread on the other CPU first so that it
+	 * is queued there again when woken up, then let it run anywhere
+	 */
+	start_pinned(&tthread[1], other);
+	while ((*state & _THREAD_PENDING) == 0U) {
+	}
+	zassert_equal(k_thread_cpu_mask_enable_all(&tthread[1]), 0, "");
+
+	start_pinned(&t2, other);
+	while (!hog_running) {
+	}
+
+	start_pinned(&tthread[0], other);
+	k_sem_give(&sema);
+
+	k_msleep(100);
+
+	zassert_equal(stolen_cpu, cpu, "thread behind a pinned one not run");
+
+	hog_stop = true;
+	k_thread_join(&t2, K_FOREVER);
+	k_thread_join(&tthread[0], K_FOREVER);
+	k_thread_join(&tthread[1], K_FOREVER);
+#endif
+}
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -641,7 +738,8 @@ void test_main(void)
 			 ztest_unit_test(test_sleep_threads),
 			 ztest_unit_test(test_wakeup_threads),
 			 ztest_unit_test(test_smp_ipi),
-			 ztest_unit_test(test_get_cpu)
+			 ztest_unit_test(test_get_cpu),
+			 ztest_unit_test(test_steal_past_pinned_thread)
 			 );
 	ztest_run_test_suite(smp);
 }
@@ -612,6 +612,107 @@ void test_strtok_r(void)
 	test_strtok_r_do("1|2|3,4|5",           "| ", 5, tc01, false);
 }
 
+/**
+ *
+ * @brief Test memory routines over sizes and alignments
+ *
+ * @details Compares memcpy(), memmove() both ways, memset(), memcmp(),
+ * memchr() and strlen() against byte by byte results, for every
+ * length up to a few words and every pair of alignments, checking
+ * that the bytes around the destination are left alone.
+ */
+
+#define SWEEP_LEN 80
+#define SWEEP_BUF (SWEEP_LEN + 2 * 16)
+
+static uint8_t sweep_src[SWEEP_BUF], sweep_dst[SWEEP_BUF];
+static uint8_t sweep_ref[SWEEP_BUF];
+
+static void sweep_fill(uint8_t *buf, uint8_t seed)
+{
+	for (int i = 0; i < SWEEP_BUF; i++) {
+		buf[i] = seed + i * 37U;
+	}
+}
+
+void test_mem_sweep(void)
+{
+	for (size_t len = 0; len <= SWEEP_LEN; len++) {
+		for (int so = 0; so < 16; so++) {
+			for (int doff = 0; doff < 16; doff++) {
+				uint8_t *src = sweep_src + so;
+				uint8_t *dst = sweep_dst + doff;
+
+				sweep_fill(sweep_src, 1);
+				sweep_fill(sweep_dst, 2);
+				memcpy(sweep_ref, sweep_dst, SWEEP_BUF);
+				for (size_t i = 0; i < len; i++) {
+					sweep_ref[doff + i] = src[i];
+				}
+				zassert_equal(memcpy(dst, src, len), dst, NULL);
+				zassert_equal(memcmp(sweep_dst, sweep_ref,
+						     SWEEP_BUF), 0,
+					      "memcpy len %zu src %d dst %d",
+					      len, so, doff);
+
+				/* Overlapping, both ways */
+				sweep_fill(sweep_dst, 3);
+				for (size_t i = 0; i < SWEEP_BUF; i++) {
+					sweep_ref[i] = sweep_dst[i];
+				}
+				for (size_t i = 0; i < len; i++) {
+					sweep_ref[doff + i] = sweep_dst[so + i];
+				}
+				memmove(dst, sweep_dst + so, len);
+				zassert_equal(memcmp(sweep_dst, sweep_ref,
+						     SWEEP_BUF), 0,
+					      "memmove len %zu src %d dst %d",
+					      len, so, doff);
+			}
+
+			sweep_fill(sweep_dst, 4);
+			memcpy(sweep_ref, sweep_dst, SWEEP_BUF);
+			for (size_t i = 0; i < len; i++) {
+				sweep_ref[so + i] = 0xa5;
+			}
+			zassert_equal(memset(sweep_dst + so, 0xa5, len),
+				      sweep_dst + so, NULL);
+			zassert_equal(memcmp(sweep_dst, sweep_ref, SWEEP_BUF),
+				      0, "memset len %zu at %d", len, so);
+		}
+
+		/* The first difference decides, as unsigned bytes */
+		for (size_t diff = 0; diff < len; diff++) {
+			int so = (diff + len) % 16, doff = diff % 16;
+
+			sweep_fill(sweep_src, 5);
+			memcpy(sweep_dst + doff, sweep_src + so, len);
+			zassert_equal(memcmp(sweep_dst + doff, sweep_src + so,
+					     len), 0, NULL);
+			sweep_dst[doff + diff] = 0x80;
+			sweep_src[so + diff] = 0x7f;
+			if (diff + 1 < len) {
+				sweep_src[so + diff + 1] = 0xff;
+			}
+			zassert_true(memcmp(sweep_dst + doff, sweep_src + so,
+					    len) > 0, "memcmp len %zu at %zu",
+				     len, diff);
+			zassert_true(memcmp(sweep_src + so, sweep_dst + doff,
+					    len) < 0, "memcmp len %zu at %zu",
+				     len, diff);
+
+			memset(sweep_dst, 1, SWEEP_BUF);
+			sweep_dst[doff + diff] = 0;
+			zassert_equal(memchr(sweep_dst + doff, 0, len),
+				      sweep_dst + doff + diff, NULL);
+			zassert_is_null(memchr(sweep_dst + doff, 0, diff),
+					NULL);
+			zassert_equal(strlen((char *)sweep_dst + doff), diff,
+				      "strlen %zu at %d", diff, doff);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_c_lib,
@@ -635,7 +736,8 @@ void test_main(void)
 			 ztest_unit_test(test_memstr),
 			 ztest_unit_test(test_str_operate),
 			 ztest_unit_test(test_tolower_toupper),
-			 ztest_unit_test(test_strtok_r)
+			 ztest_unit_test(test_strtok_r),
+			 ztest_unit_test(test_mem_sweep)
 			 );
 	ztest_run_test_suite(test_c_lib);
 }
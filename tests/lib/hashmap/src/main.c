@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/hashmap.h>
+#include <sys/sys_heap.h>
+
+/**
+ * @defgroup lib_hashmap_tests Hash map
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#define N_ENTRIES 512
+
+struct entry {
+	uint32_t key;
+	bool in_map;
+};
+
+static struct entry entries[N_ENTRIES];
+
+static uint32_t hash_u32(const void *key)
+{
+	return sys_hash32_u32(*(const uint32_t *)key);
+}
+
+/* Only a few distinct hashes, for long clusters */
+static uint32_t hash_poor(const void *key)
+{
+	return *(const uint32_t *)key % 7U;
+}
+
+static bool match_u32(const void *entry, const void *key)
+{
+	return ((const struct entry *)entry)->key == *(const uint32_t *)key;
+}
+
+static char heap_mem[64 * 1024];
+static struct sys_heap heap;
+static int allocated;
+
+static void *test_alloc(void *ptr, size_t size)
+{
+	if (size == 0) {
+		sys_heap_free(&heap, ptr);
+		allocated--;
+		return NULL;
+	}
+
+	ptr = sys_heap_alloc(&heap, size);
+	if (ptr != NULL) {
+		allocated++;
+	}
+
+	return ptr;
+}
+
+static void reset_entries(void)
+{
+	for (uint32_t i = 0; i < N_ENTRIES; i++) {
+		/* Spread the keys, as they would be in real maps */
+		entries[i].key = i * 2654435761U;
+		entries[i].in_map = false;
+	}
+}
+
+static void count_entry(void *entry, void *cookie)
+{
+	zassert_true(((struct entry *)entry)->in_map, "stray entry");
+	(*(uint32_t *)cookie)++;
+}
+
+/* Checks that the map has exactly the entries flagged in_map */
+static void check_map(struct sys_hashmap *map)
+{
+	uint32_t size = 0, visited = 0;
+
+	for (int i = 0; i < N_ENTRIES; i++) {
+		struct entry *e = sys_hashmap_get(map, &entries[i].key);
+
+		zassert_equal(e, entries[i].in_map ? &entries[i] : NULL,
+			      "wrong lookup of entry %d", i);
+		size += entries[i].in_map ? 1 : 0;
+	}
+
+	zassert_equal(sys_hashmap_size(map), size, NULL);
+	sys_hashmap_foreach(map, count_entry, &visited);
+	zassert_equal(visited, size, NULL);
+}
+
+static void insert_entry(struct sys_hashmap *map, int i)
+{
+	zassert_equal(sys_hashmap_insert(map, &entries[i].key, &entries[i]),
+		      0, "failed to insert entry %d", i);
+	entries[i].in_map = true;
+}
+
+static void remove_entry(struct sys_hashmap *map, int i)
+{
+	zassert_equal(sys_hashmap_remove(map, &entries[i].key), &entries[i],
+		      "failed to remove entry %d", i);
+	entries[i].in_map = false;
+}
+
+SYS_HASHMAP_DEFINE_STATIC(static_map, 16, hash_u32, match_u32);
+
+/**
+ * @brief Test a hash map with static storage
+ *
+ * @details Fills the map up to its capacity of 7/8 of its slots, then
+ * checks that it refuses more entries and duplicate keys, and that
+ * lookups and removals find the right entries.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see SYS_HASHMAP_DEFINE_STATIC(), sys_hashmap_insert(),
+ * sys_hashmap_get(), sys_hashmap_remove()
+ */
+void test_hashmap_static(void)
+{
+	reset_entries();
+	check_map(&static_map);
+
+	for (int i = 0; i < 14; i++) {
+		insert_entry(&static_map, i);
+		check_map(&static_map);
+	}
+
+	zassert_equal(sys_hashmap_insert(&static_map, &entries[14].key,
+					 &entries[14]), -ENOSPC, NULL);
+	zassert_equal(sys_hashmap_insert(&static_map, &entries[3].key,
+					 &entries[14]), -EEXIST, NULL);
+	zassert_is_null(sys_hashmap_remove(&static_map, &entries[14].key),
+			NULL);
+
+	for (int i = 0; i < 14; i += 2) {
+		remove_entry(&static_map, i);
+		check_map(&static_map);
+	}
+
+	insert_entry(&static_map, 14);
+	check_map(&static_map);
+
+	sys_hashmap_clear(&static_map);
+	reset_entries();
+	check_map(&static_map);
+}
+
+/**
+ * @brief Test the growth of a hash map with allocated storage
+ *
+ * @details Inserts entries one by one, checking the whole map after
+ * each insert, so that lookups and removals are also checked while the
+ * entries are being migrated to a bigger table.
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see sys_hashmap_init(), sys_hashmap_clear()
+ */
+void test_hashmap_grow(void)
+{
+	struct sys_hashmap map;
+	int migrations = 0;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_hashmap_init(&map, hash_u32, match_u32, test_alloc);
+	reset_entries();
+	check_map(&map);
+	zassert_equal(allocated, 0, "table allocated before use");
+
+	for (int i = 0; i < N_ENTRIES; i++) {
+		insert_entry(&map, i);
+		if (map.old_slots != NULL) {
+			migrations++;
+
+			/* Removal of a not yet migrated entry */
+			if (i % 8 == 0) {
+				remove_entry(&map, i / 2);
+			}
+		}
+		check_map(&map);
+	}
+
+	zassert_true(migrations > 0, "map never grew");
+	zassert_true(allocated <= 2, "%d tables allocated", allocated);
+
+	for (int i = 0; i < N_ENTRIES; i++) {
+		if (entries[i].in_map) {
+			remove_entry(&map, i);
+		}
+	}
+	check_map(&map);
+
+	sys_hashmap_clear(&map);
+	zassert_equal(allocated, 0, "tables leaked");
+}
+
+static uint32_t next_rand_mod(uint32_t mod)
+{
+	static uint32_t state = 123456789U;
+
+	state = state * 1664525U + 1013904223U;
+
+	return (state >> 8) % mod;
+}
+
+static void spam(struct sys_hashmap *map, int n)
+{
+	reset_entries();
+
+	for (int j = 0; j < 8 * n; j++) {
+		int i = next_rand_mod(n);
+
+		if (entries[i].in_map) {
+			remove_entry(map, i);
+		} else {
+			insert_entry(map, i);
+		}
+
+		if (j % 16 == 0) {
+			check_map(map);
+		}
+	}
+
+	check_map(map);
+	sys_hashmap_clear(map);
+}
+
+/**
+ * @brief Test random inserts and removals
+ *
+ * @details Randomly inserts and removes entries in maps with a good
+ * and a poor hash function, checking that the map contents always
+ * match the inserted entries.
+ *
+ * @ingroup lib_hashmap_tests
+ */
+void test_hashmap_spam(void)
+{
+	static struct sys_hashmap_slot slots[N_ENTRIES];
+	struct sys_hashmap map;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	sys_hashmap_init(&map, hash_u32, match_u32, test_alloc);
+	spam(&map, N_ENTRIES);
+	sys_hashmap_init(&map, hash_poor, match_u32, test_alloc);
+	spam(&map, 64);
+	zassert_equal(allocated, 0, "tables leaked");
+
+	/* Static storage filled up to its capacity */
+	sys_hashmap_init_static(&map, hash_u32, match_u32, slots,
+				ARRAY_SIZE(slots));
+	spam(&map, ARRAY_SIZE(slots) - ARRAY_SIZE(slots) / 8);
+}
+
+struct conn_key {
+	uint8_t addr[4];
+	uint16_t local_port;
+	uint16_t remote_port;
+} __packed;
+
+struct conn {
+	struct conn_key key;
+	int id;
+};
+
+static uint32_t hash_conn(const void *key)
+{
+	return sys_hash32(key, sizeof(struct conn_key));
+}
+
+static bool match_conn(const void *entry, const void *key)
+{
+	return memcmp(&((const struct conn *)entry)->key, key,
+		      sizeof(struct conn_key)) == 0;
+}
+
+/**
+ * @brief Test a hash map keyed by tuples
+ *
+ * @details Looks up connections by address and ports, hashed with
+ * sys_hash32().
+ *
+ * @ingroup lib_hashmap_tests
+ *
+ * @see sys_hash32()
+ */
+void test_hashmap_tuple(void)
+{
+	static struct conn conns[64];
+	static struct sys_hashmap_slot slots[128];
+	struct sys_hashmap map;
+	struct conn_key key = { .addr = { 192, 0, 2, 1 }, .local_port = 80 };
+
+	sys_hashmap_init_static(&map, hash_conn, match_conn, slots,
+				ARRAY_SIZE(slots));
+
+	for (int i = 0; i < ARRAY_SIZE(conns); i++) {
+		conns[i].key = key;
+		conns[i].key.remote_port = 49152 + i;
+		conns[i].id = i;
+		zassert_equal(sys_hashmap_insert(&map, &conns[i].key,
+						 &conns[i]), 0, NULL);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(conns); i++) {
+		struct conn *c;
+
+		key.remote_port = 49152 + i;
+		c = sys_hashmap_get(&map, &key);
+		zassert_not_null(c, NULL);
+		zassert_equal(c->id, i, NULL);
+	}
+
+	key.remote_port = 49151;
+	zassert_is_null(sys_hashmap_get(&map, &key), NULL);
+	key.addr[3] = 2;
+	key.remote_port = 49152;
+	zassert_is_null(sys_hashmap_get(&map, &key), NULL);
+
+	/* Different tuples must not all collide */
+	zassert_not_equal(hash_conn(&conns[0].key), hash_conn(&conns[1].key),
+			  NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hashmap,
+			 ztest_unit_test(test_hashmap_static),
+			 ztest_unit_test(test_hashmap_grow),
+			 ztest_unit_test(test_hashmap_spam),
+			 ztest_unit_test(test_hashmap_tuple)
+		);
+	ztest_run_test_suite(test_hashmap);
+}
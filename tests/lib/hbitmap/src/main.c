@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/hbitmap.h>
+
+/**
+ * @defgroup lib_hbitmap_tests Hierarchical bitmap
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#define MAX_BITS (40 * 1024)
+
+static atomic_t words[SYS_HBITMAP_WORDS(MAX_BITS)];
+static struct sys_hbitmap bm;
+
+/* Reference state, true if free */
+static bool ref[MAX_BITS];
+
+SYS_HBITMAP_DEFINE_STATIC(static_bm, 100);
+
+/* Sizes around the word and level boundaries */
+static const uint32_t sizes[] = {
+	1, 2, 31, 32, 33, 63, 64, 65, 1023, 1024, 1025, 2000, 32 * 1024,
+	32 * 1024 + 1, MAX_BITS,
+};
+
+static uint32_t next_rand(void)
+{
+	static uint32_t state = 123456789;
+
+	state = state * 1103515245U + 12345U;
+
+	return state >> 8;
+}
+
+/* Lowest run of count free indexes in the reference */
+static int ref_find(uint32_t n, uint32_t count)
+{
+	uint32_t run = 0;
+
+	for (uint32_t i = 0; i < n; i++) {
+		run = ref[i] ? run + 1 : 0;
+		if (run == count) {
+			return i + 1 - count;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+static void check_ref(uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		zassert_equal(sys_hbitmap_is_free(&bm, i), ref[i],
+			      "index %u of %u", i, n);
+	}
+}
+
+void test_hbitmap_words(void)
+{
+	zassert_equal(SYS_HBITMAP_WORDS(1), 1, NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(32), 1, NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(33), 2 + 1, NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(1024), 32 + 1, NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(1025), 33 + 2 + 1, NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(1 << 20), 32768 + 1024 + 32 + 1,
+		      NULL);
+	zassert_equal(SYS_HBITMAP_WORDS(SYS_HBITMAP_MAX_BITS),
+		      (1 << 20) + 32768 + 1024 + 32 + 1, NULL);
+}
+
+void test_hbitmap_static(void)
+{
+	/* Starts all allocated */
+	zassert_equal(sys_hbitmap_alloc(&static_bm), -ENOSPC, NULL);
+
+	sys_hbitmap_free(&static_bm, 99);
+	sys_hbitmap_free(&static_bm, 42);
+	zassert_equal(sys_hbitmap_alloc(&static_bm), 42, NULL);
+	zassert_equal(sys_hbitmap_alloc(&static_bm), 99, NULL);
+	zassert_equal(sys_hbitmap_alloc(&static_bm), -ENOSPC, NULL);
+
+	sys_hbitmap_free_range(&static_bm, 0, 100);
+	zassert_equal(sys_hbitmap_alloc_range(&static_bm, 100), 0, NULL);
+	zassert_equal(sys_hbitmap_alloc_range(&static_bm, 1), -ENOSPC, NULL);
+}
+
+/* Fill and empty bitmaps of all sizes, in order */
+void test_hbitmap_fill(void)
+{
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		uint32_t n = sizes[s];
+
+		sys_hbitmap_init(&bm, words, n);
+		zassert_equal(sys_hbitmap_alloc(&bm), -ENOSPC, NULL);
+
+		sys_hbitmap_free_range(&bm, 0, n);
+		for (uint32_t i = 0; i < n; i++) {
+			zassert_equal(sys_hbitmap_alloc(&bm), i, "size %u", n);
+		}
+		zassert_equal(sys_hbitmap_alloc(&bm), -ENOSPC, "size %u", n);
+
+		/* Free from the end, take back the lowest each time */
+		for (uint32_t i = n; i-- > 0; ) {
+			sys_hbitmap_free(&bm, i);
+			zassert_equal(sys_hbitmap_alloc(&bm), i, "size %u", n);
+			sys_hbitmap_free(&bm, i);
+		}
+
+		zassert_equal(sys_hbitmap_alloc_range(&bm, n), 0, NULL);
+		zassert_equal(sys_hbitmap_alloc(&bm), -ENOSPC, NULL);
+	}
+}
+
+/* Random allocations and frees checked against a linear first fit */
+void test_hbitmap_random(void)
+{
+	static int allocs[MAX_BITS];
+	static uint32_t counts[MAX_BITS];
+
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		uint32_t n = sizes[s];
+		uint32_t n_allocs = 0;
+
+		sys_hbitmap_init(&bm, words, n);
+		sys_hbitmap_free_range(&bm, 0, n);
+		for (uint32_t i = 0; i < n; i++) {
+			ref[i] = true;
+		}
+
+		for (int op = 0; op < 4000; op++) {
+			uint32_t r = next_rand();
+
+			if (n_allocs > 0 && (r % 8) < 3) {
+				uint32_t k = (r / 8) % n_allocs;
+
+				sys_hbitmap_free_range(&bm, allocs[k],
+						       counts[k]);
+				for (uint32_t i = 0; i < counts[k]; i++) {
+					ref[allocs[k] + i] = true;
+				}
+				n_allocs--;
+				allocs[k] = allocs[n_allocs];
+				counts[k] = counts[n_allocs];
+			} else {
+				/* Mostly single indexes, some ranges
+				 * spanning words
+				 */
+				uint32_t count = ((r % 8) < 6) ? 1 :
+						 1 + (r / 8) % 100;
+				int ret = (count == 1) ?
+					  sys_hbitmap_alloc(&bm) :
+					  sys_hbitmap_alloc_range(&bm, count);
+				int expected = ref_find(n, count);
+
+				zassert_equal(ret, expected,
+					      "size %u, count %u", n, count);
+				if (ret < 0) {
+					continue;
+				}
+
+				for (uint32_t i = 0; i < count; i++) {
+					ref[ret + i] = false;
+				}
+				allocs[n_allocs] = ret;
+				counts[n_allocs] = count;
+				n_allocs++;
+			}
+		}
+
+		check_ref(n);
+	}
+}
+
+/* Ranges find their way around the holes of an almost full bitmap */
+void test_hbitmap_range(void)
+{
+	uint32_t n = MAX_BITS;
+
+	sys_hbitmap_init(&bm, words, n);
+
+	/* Free every other index, then fill the gaps of 30000..30062 */
+	for (uint32_t i = 0; i < n; i += 2) {
+		sys_hbitmap_free(&bm, i);
+	}
+	for (uint32_t i = 30001; i < 30062; i += 2) {
+		sys_hbitmap_free(&bm, i);
+	}
+
+	zassert_equal(sys_hbitmap_alloc_range(&bm, 64), -ENOSPC, NULL);
+	zassert_equal(sys_hbitmap_alloc_range(&bm, 2), 30000, NULL);
+	zassert_equal(sys_hbitmap_alloc_range(&bm, 61), 30002, NULL);
+	zassert_equal(sys_hbitmap_alloc_range(&bm, 2), -ENOSPC, NULL);
+	zassert_equal(sys_hbitmap_alloc(&bm), 0, NULL);
+
+	sys_hbitmap_free_range(&bm, 30000, 63);
+	zassert_equal(sys_hbitmap_alloc_range(&bm, 63), 30000, NULL);
+}
+
+#define STRESS_BITS 4096
+#define STRESS_FREE 48
+#define STRESS_THREADS 4
+#define STRESS_ROUNDS 2000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_ARRAY_DEFINE(stress_stacks, STRESS_THREADS,
+				   STACK_SIZE);
+static struct k_thread stress_threads[STRESS_THREADS];
+static ATOMIC_DEFINE(stress_owned, STRESS_BITS);
+static atomic_t stress_errors;
+
+static void stress_thread(void *p1, void *p2, void *p3)
+{
+	for (int r = 0; r < STRESS_ROUNDS; r++) {
+		int pos = sys_hbitmap_alloc(&bm);
+
+		/* Threads hold at most one index each, so there is always
+		 * a free one
+		 */
+		if (pos < 0 || atomic_test_and_set_bit(stress_owned, pos)) {
+			atomic_inc(&stress_errors);
+			continue;
+		}
+
+		if (r % 8 == 0) {
+			k_yield();
+		}
+
+		atomic_clear_bit(stress_owned, pos);
+		sys_hbitmap_free(&bm, pos);
+	}
+}
+
+/* Threads allocating and freeing concurrently, each free index in its
+ * own word so that words keep getting empty and free again, on three
+ * levels of summary words.  Bits set back by one thread while another
+ * clears the summary bits above them must not get lost.
+ */
+void test_hbitmap_concurrent(void)
+{
+	uint32_t stride = STRESS_BITS / STRESS_FREE;
+
+	sys_hbitmap_init(&bm, words, STRESS_BITS);
+	zassert_equal(bm.levels, 3, NULL);
+
+	for (uint32_t i = 0; i < STRESS_FREE; i++) {
+		sys_hbitmap_free(&bm, i * stride);
+	}
+
+	for (int t = 0; t < STRESS_THREADS; t++) {
+		k_thread_create(&stress_threads[t], stress_stacks[t],
+				STACK_SIZE, stress_thread, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int t = 0; t < STRESS_THREADS; t++) {
+		k_thread_join(&stress_threads[t], K_FOREVER);
+	}
+
+	zassert_equal(atomic_get(&stress_errors), 0, NULL);
+
+	/* All indexes are still free and can all be found */
+	for (uint32_t i = 0; i < STRESS_FREE; i++) {
+		zassert_true(sys_hbitmap_is_free(&bm, i * stride), NULL);
+		zassert_equal(sys_hbitmap_alloc(&bm), i * stride, NULL);
+	}
+	zassert_equal(sys_hbitmap_alloc(&bm), -ENOSPC, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hbitmap,
+			 ztest_unit_test(test_hbitmap_words),
+			 ztest_unit_test(test_hbitmap_static),
+			 ztest_unit_test(test_hbitmap_fill),
+			 ztest_unit_test(test_hbitmap_random),
+			 ztest_unit_test(test_hbitmap_range),
+			 ztest_unit_test(test_hbitmap_concurrent)
+		);
+	ztest_run_test_suite(test_hbitmap);
+}
@@ -323,13 +323,64 @@ static void test_realloc(void)
 		     "Realloc should have moved %p", p2);
 }
 
+static volatile bool valid_assert;
+
+#ifdef CONFIG_ASSERT_NO_FILE_INFO
+void assert_post_action(void)
+#else
+void assert_post_action(const char *file, unsigned int line)
+#endif
+{
+#ifndef CONFIG_ASSERT_NO_FILE_INFO
+	ARG_UNUSED(file);
+	ARG_UNUSED(line);
+#endif
+
+	if (valid_assert) {
+		valid_assert = false;
+		ztest_test_pass();
+	} else {
+		k_panic();
+	}
+}
+
+/* Blocks cached on a quick list are still marked used, make sure
+ * freeing one again is caught anyway, also when it is not the most
+ * recently freed block of its size.
+ */
+static void test_quick_double_free(void)
+{
+#if !defined(CONFIG_SYS_HEAP_QUICK_LISTS) || !defined(CONFIG_ASSERT)
+	ztest_test_skip();
+#else
+	struct sys_heap heap;
+	void *p1, *p2;
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+	p1 = sys_heap_alloc(&heap, 8);
+	p2 = sys_heap_alloc(&heap, 8);
+	zassert_true(p1 != NULL && p2 != NULL, "allocation failed");
+
+	sys_heap_free(&heap, p1);
+	sys_heap_free(&heap, p2);
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+
+	valid_assert = true;
+	sys_heap_free(&heap, p1);
+	valid_assert = false;
+
+	zassert_unreachable("double free of a quick list block not caught");
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_heap_test,
 			 ztest_unit_test(test_realloc),
 			 ztest_unit_test(test_small_heap),
 			 ztest_unit_test(test_fragmentation),
-			 ztest_unit_test(test_big_heap)
+			 ztest_unit_test(test_big_heap),
+			 ztest_unit_test(test_quick_double_free)
 			 );
 
 	ztest_run_test_suite(lib_heap_test);
@@ -539,6 +539,405 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+struct stream_log {
+	char buf[512];
+	size_t len;
+};
+
+static void log_append(struct stream_log *log, const char *str, size_t len)
+{
+	zassert_true(log->len + len < sizeof(log->buf), "log overflow");
+	memcpy(log->buf + log->len, str, len);
+	log->len += len;
+	log->buf[log->len] = '\0';
+}
+
+static int log_token(const struct json_stream_token *token, void *user_data)
+{
+	struct stream_log *log = user_data;
+	char prefix[2] = { '0' + token->depth, (char)token->type };
+
+	log_append(log, prefix, sizeof(prefix));
+	if (token->key != NULL) {
+		log_append(log, token->key, token->key_len);
+		log_append(log, "=", 1);
+	}
+	if (token->value != NULL) {
+		log_append(log, token->value, token->value_len);
+	}
+	log_append(log, "|", 1);
+
+	return 0;
+}
+
+/* Feeds the document in chunks of the given size */
+static int stream_feed_chunks(struct json_stream *stream, const char *doc,
+			      size_t chunk)
+{
+	size_t len = strlen(doc);
+	int ret = 0;
+
+	for (size_t pos = 0; pos < len && ret == 0; pos += chunk) {
+		ret = json_stream_feed(stream, doc + pos,
+				       MIN(chunk, len - pos));
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return json_stream_finish(stream);
+}
+
+static void test_json_stream_chunks(void)
+{
+	const char doc[] = " {\"str\":\"zephyr \\\"123\\uABCD\\n\","
+		"\"num\":-1234, \"exp\":6.02e+23,\n"
+		"\"bools\":[true,false,null],\"\":{},"
+		"\"nested\":{\"list\":[[1],{\"a\":[]},\"x\"],\"n\":0}}\r\n";
+	const char expected[] = "0{|1\"str=zephyr \\\"123\\uABCD\\n|"
+		"10num=-1234|10exp=6.02e+23|1[bools=|2t|2f|2n|1]|"
+		"1{=|1}|1{nested=|2[list=|3[|401|3]|3{|4[a=|4]|3}|3\"x|"
+		"2]|20n=0|1}|0}|";
+	static struct stream_log log;
+	struct json_stream stream;
+	char buf[24];
+
+	for (size_t chunk = 1; chunk <= sizeof(doc); chunk++) {
+		log.len = 0;
+		log.buf[0] = '\0';
+
+		json_stream_init(&stream, buf, sizeof(buf), log_token, &log);
+		zassert_equal(stream_feed_chunks(&stream, doc, chunk), 0,
+			      "Parsing in chunks of %zu failed", chunk);
+		zassert_true(!strcmp(log.buf, expected),
+			     "Chunks of %zu parsed as %s", chunk, log.buf);
+	}
+}
+
+static void test_json_stream_scalar(void)
+{
+	static struct stream_log log;
+	struct json_stream stream;
+	char buf[8];
+
+	json_stream_init(&stream, buf, sizeof(buf), log_token, &log);
+	zassert_equal(stream_feed_chunks(&stream, "-12", 2), 0,
+		      "Top level number not parsed");
+	zassert_true(!strcmp(log.buf, "00-12|"), "Number reported at finish");
+
+	memset(&log, 0, sizeof(log));
+	json_stream_init(&stream, buf, sizeof(buf), log_token, &log);
+	zassert_equal(stream_feed_chunks(&stream, "[0,-0.5e+3]", 3), 0,
+		      "Numbers not parsed");
+	zassert_true(!strcmp(log.buf, "0[|100|10-0.5e+3|0]|"),
+		     "Numbers reported: %s", log.buf);
+}
+
+static int ignore_token(const struct json_stream_token *token,
+			void *user_data)
+{
+	return 0;
+}
+
+static int fail_token(const struct json_stream_token *token, void *user_data)
+{
+	return (token->type == JSON_TOK_NUMBER) ? -ECANCELED : 0;
+}
+
+static void test_json_stream_invalid(void)
+{
+	const char *const docs[] = {
+		"", "{", "{\"a\":}", "{\"a\" 1}", "{\"a\":1,}", "[1,]", "[1 2]",
+		"{,}", "{\"a\":1}}", "[}", "{]", "tru", "nul1", "-", "[-x]",
+		"\"abc", "[\"\\x\"]", "[\"\\u12G4\"]", "{1:2}", "[1]x", "[:]",
+		"1.2.3", "01", "[-01]", "1.", "[.5]", "1e", "1e+", "[1-2]",
+		"[\"a\tb\"]", "\"\n\"",
+	};
+	struct json_stream stream;
+	char buf[16];
+
+	for (size_t chunk = 1; chunk <= 16; chunk *= 4) {
+		for (int i = 0; i < ARRAY_SIZE(docs); i++) {
+			json_stream_init(&stream, buf, sizeof(buf),
+					 ignore_token, NULL);
+			zassert_equal(stream_feed_chunks(&stream, docs[i],
+							 chunk),
+				      -EINVAL, "'%s' has to fail", docs[i]);
+		}
+	}
+
+	json_stream_init(&stream, buf, sizeof(buf), fail_token, NULL);
+	zassert_equal(stream_feed_chunks(&stream, "[true,1]", 3), -ECANCELED,
+		      "Callback error not returned");
+	zassert_equal(json_stream_feed(&stream, "]", 1), -EINVAL,
+		      "Errors have to be sticky");
+}
+
+static void test_json_stream_bounds(void)
+{
+	const char value[] = "[\"0123456789abcdef\"]";
+	const char key[] = "{\"0123456789abcdef\":1}";
+	char deep[CONFIG_JSON_STREAM_MAX_DEPTH + 2];
+	struct json_stream stream;
+	char buf[8];
+
+	/* Values in a single chunk are reported in place */
+	json_stream_init(&stream, buf, sizeof(buf), ignore_token, NULL);
+	zassert_equal(stream_feed_chunks(&stream, value, sizeof(value)), 0,
+		      "In place value rejected");
+
+	json_stream_init(&stream, buf, sizeof(buf), ignore_token, NULL);
+	zassert_equal(stream_feed_chunks(&stream, value, 4), -ENOMEM,
+		      "Spilled value has to overflow");
+
+	json_stream_init(&stream, buf, sizeof(buf), ignore_token, NULL);
+	zassert_equal(stream_feed_chunks(&stream, key, sizeof(key)), -ENOMEM,
+		      "Key has to overflow");
+
+	memset(deep, '[', sizeof(deep) - 1);
+	deep[sizeof(deep) - 1] = '\0';
+	json_stream_init(&stream, buf, sizeof(buf), ignore_token, NULL);
+	zassert_equal(stream_feed_chunks(&stream, deep, 1), -E2BIG,
+		      "Nesting has to be bounded");
+}
+
+static void test_json_stream_obj(void)
+{
+	const char encoded[] = "{\"some_string\":\"zephyr 123\\uABCD456\","
+		"\"some_int\":\t42\n,"
+		"\"unknown\":{\"some_int\":[1,{\"x\":2}],\"y\":\"z\"},"
+		"\"some_bool\":true    \t  \n\r   ,"
+		"\"some_nested_struct\":{    "
+		"\"nested_int\":-1234,\n\n"
+		"\"nested_bool\":false,\t"
+		"\"nested_string\":\"this should be escaped: \\t\"},"
+		"\"some_array\":[11,22, 33,\t45,\n299],"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}\n";
+	const int expected_array[] = { 11, 22, 33, 45, 299 };
+	const int expected_other_array[] = { 2, 3, 5, 7 };
+	static struct json_stream_obj obj;
+	const size_t len = sizeof(encoded) - 1;
+	struct test_struct ts;
+	char buf[128];
+	int ret;
+
+	for (size_t chunk = 1; chunk <= len; chunk++) {
+		memset(&ts, 0, sizeof(ts));
+		json_stream_obj_init(&obj, test_descr, ARRAY_SIZE(test_descr),
+				     &ts, buf, sizeof(buf));
+
+		for (size_t pos = 0; pos < len; pos += chunk) {
+			ret = json_stream_obj_feed(&obj, encoded + pos,
+						   MIN(chunk, len - pos));
+			zassert_equal(ret, 0, "Chunk at %zu failed", pos);
+		}
+
+		ret = json_stream_obj_finish(&obj);
+		zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+			      "Chunks of %zu decoded as %d", chunk, ret);
+
+		zassert_true(!strcmp(ts.some_string, "zephyr 123\\uABCD456"),
+			     "String decoded correctly");
+		zassert_equal(ts.some_int, 42, "Integer decoded correctly");
+		zassert_equal(ts.some_bool, true, "Boolean decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_int, -1234,
+			      "Nested negative integer decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_bool, false,
+			      "Nested boolean value decoded correctly");
+		zassert_true(!strcmp(ts.some_nested_struct.nested_string,
+				     "this should be escaped: \\t"),
+			     "Nested string decoded correctly");
+		zassert_equal(ts.some_array_len, 5,
+			      "Array has correct number of items");
+		zassert_true(!memcmp(ts.some_array, expected_array,
+				     sizeof(expected_array)),
+			     "Array decoded with expected values");
+		zassert_true(ts.another_bxxl,
+			     "Named boolean decoded correctly");
+		zassert_false(ts.if_, "Reserved word decoded correctly");
+		zassert_equal(ts.another_array_len, 4,
+			      "Named array has correct number of items");
+		zassert_true(!memcmp(ts.another_array, expected_other_array,
+				     sizeof(expected_other_array)),
+			     "Decoded named array with expected values");
+		zassert_equal(ts.xnother_nexx.nested_int, 1234,
+			      "Named nested integer decoded correctly");
+		zassert_true(!strcmp(ts.xnother_nexx.nested_string,
+				     "no escape necessary"),
+			     "Named nested string decoded correctly");
+	}
+}
+
+static int stream_obj_parse(const char *doc, size_t chunk,
+			    const struct json_obj_descr *descr,
+			    size_t descr_len, void *val, char *buf,
+			    size_t buf_size)
+{
+	static struct json_stream_obj obj;
+	int ret;
+
+	json_stream_obj_init(&obj, descr, descr_len, val, buf, buf_size);
+	ret = stream_feed_chunks(&obj.stream, doc, chunk);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return json_stream_obj_finish(&obj);
+}
+
+static void test_json_stream_obj_arrays(void)
+{
+	const char array_array[] = "{\"objects_array\":["
+		"[{\"height\":168,\"name\":\"Simón Bolívar\"}],"
+		"[{\"height\":173,\"name\":\"Pelé\"}],"
+		"[{\"height\":195,\"name\":\"Usain Bolt\"}]]"
+		"}";
+	struct obj_array_array oaa;
+	struct test_struct ts;
+	char buf[64];
+	int ret;
+
+	ret = stream_obj_parse(array_array, 5, array_array_descr,
+			       ARRAY_SIZE(array_array_descr), &oaa,
+			       buf, sizeof(buf));
+	zassert_equal(ret, 1, "Array of arrays decoded");
+	zassert_equal(oaa.objects_array_len, 3, "Array of arrays length");
+	zassert_true(!strcmp(oaa.objects_array[1].objects.name, "Pelé"),
+		     "String decoded correctly");
+	zassert_equal(oaa.objects_array[2].objects.height, 195,
+		      "Usain Bolt height decoded correctly");
+
+	ret = stream_obj_parse("{\"another-array\":[1,2,3,4,5,6,7,8,9,10,11]}",
+			       3, test_descr, ARRAY_SIZE(test_descr), &ts,
+			       buf, sizeof(buf));
+	zassert_equal(ret, -ENOSPC, "Array overflow has to fail");
+
+	ret = stream_obj_parse("{\"some_string\":false}", 3, test_descr,
+			       ARRAY_SIZE(test_descr), &ts, buf, sizeof(buf));
+	zassert_equal(ret, -EINVAL, "Wrong type has to fail");
+
+	ret = stream_obj_parse("{\"some_int\":1.5}", 3, test_descr,
+			       ARRAY_SIZE(test_descr), &ts, buf, sizeof(buf));
+	zassert_equal(ret, -EINVAL, "Fractional number has to fail");
+
+	ret = stream_obj_parse("{\"some_int\":9876543210}", 3, test_descr,
+			       ARRAY_SIZE(test_descr), &ts, buf, sizeof(buf));
+	zassert_equal(ret, -ERANGE, "Out of range number has to fail");
+
+	ret = stream_obj_parse("{\"some_string\":\"0123456789\"}", 3,
+			       test_descr, ARRAY_SIZE(test_descr), &ts,
+			       buf, 10);
+	zassert_equal(ret, -ENOMEM, "String storage has to overflow");
+}
+
+struct appender {
+	char buf[160];
+	size_t len;
+	size_t calls;
+};
+
+static int append_bytes(const char *bytes, size_t len, void *data)
+{
+	struct appender *appender = data;
+
+	if (appender->len + len >= sizeof(appender->buf)) {
+		return -ENOMEM;
+	}
+
+	memcpy(appender->buf + appender->len, bytes, len);
+	appender->len += len;
+	appender->buf[appender->len] = '\0';
+	appender->calls++;
+
+	return 0;
+}
+
+static void test_json_enc(void)
+{
+	const char expected[] = "{\"str\":\"say \\\"hi\\\"\\n\","
+		"\"num\":-9223372036854775808,\"max\":9223372036854775807,"
+		"\"zero\":0,\"list\":[true,false,null,{},[]],"
+		"\"esc\\t\":{\"a\":\"b\"}}";
+	static struct appender appender;
+	struct json_enc enc;
+	static struct stream_log log;
+	struct json_stream stream;
+	char buf[32];
+
+	json_enc_init(&enc, append_bytes, &appender);
+	json_enc_obj_start(&enc, NULL);
+	json_enc_str(&enc, "str", "say \"hi\"\n", 9);
+	json_enc_num(&enc, "num", INT64_MIN);
+	json_enc_num(&enc, "max", INT64_MAX);
+	json_enc_num(&enc, "zero", 0);
+	json_enc_arr_start(&enc, "list");
+	json_enc_bool(&enc, NULL, true);
+	json_enc_bool(&enc, NULL, false);
+	json_enc_null(&enc, NULL);
+	json_enc_obj_start(&enc, NULL);
+	json_enc_obj_end(&enc);
+	json_enc_arr_start(&enc, NULL);
+	json_enc_arr_end(&enc);
+	json_enc_arr_end(&enc);
+	json_enc_obj_start(&enc, "esc\t");
+	zassert_equal(json_enc_finish(&enc), -EINVAL, "Unbalanced document");
+	json_enc_str(&enc, "a", "b", 1);
+	json_enc_obj_end(&enc);
+	json_enc_obj_end(&enc);
+
+	zassert_equal(json_enc_finish(&enc), 0, "Encoding failed");
+	zassert_true(!strcmp(appender.buf, expected), "Encoded as %s",
+		     appender.buf);
+
+	/* What is encoded parses back */
+	json_stream_init(&stream, buf, sizeof(buf), log_token, &log);
+	zassert_equal(stream_feed_chunks(&stream, appender.buf, 7), 0,
+		      "Encoded document does not parse");
+
+	/* Errors are sticky */
+	memset(&appender, 0, sizeof(appender));
+	json_enc_init(&enc, append_bytes, &appender);
+	json_enc_arr_start(&enc, NULL);
+	for (int i = 0; i < 100; i++) {
+		json_enc_str(&enc, NULL, "0123456789", 10);
+	}
+	zassert_equal(json_enc_arr_end(&enc), -ENOMEM, "Overflow not sticky");
+	zassert_equal(json_enc_finish(&enc), -ENOMEM, "Overflow not reported");
+
+	/* Nesting too deep writes nothing */
+	memset(&appender, 0, sizeof(appender));
+	json_enc_init(&enc, append_bytes, &appender);
+	for (int i = 0; i < 32; i++) {
+		json_enc_arr_start(&enc, NULL);
+	}
+	json_enc_null(&enc, NULL);
+	zassert_equal(json_enc_arr_start(&enc, NULL), -E2BIG,
+		      "Nesting not bounded");
+	zassert_true(appender.buf[appender.len - 1] == 'l',
+		     "Separator written: %s", appender.buf);
+}
+
+static void test_json_escape_runs(void)
+{
+	static struct appender appender;
+	struct json_enc enc;
+
+	/* Characters needing no escape are appended in runs */
+	json_enc_init(&enc, append_bytes, &appender);
+	json_enc_str(&enc, NULL, "abc\tdef", 7);
+	zassert_equal(json_enc_finish(&enc), 0, "Encoding failed");
+	zassert_true(!strcmp(appender.buf, "\"abc\\tdef\""), "Escaped string");
+	zassert_equal(appender.calls, 5, "Appended in %zu calls",
+		      appender.calls);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -560,7 +959,15 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_stream_chunks),
+			 ztest_unit_test(test_json_stream_scalar),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_stream_bounds),
+			 ztest_unit_test(test_json_stream_obj),
+			 ztest_unit_test(test_json_stream_obj_arrays),
+			 ztest_unit_test(test_json_enc),
+			 ztest_unit_test(test_json_escape_runs)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
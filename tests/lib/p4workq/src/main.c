@@ -270,13 +270,188 @@ static void test_p4wq_simple(void)
 	zassert_true(has_run, "high-priority item didn't run");
 }
 
+#ifdef CONFIG_P4WQ_WORK_STEALING
+#define NUM_WS_WORKERS CONFIG_MP_NUM_CPUS
+#define WS_STACK_SIZE 4096
+#define SUM_LEN 2048
+#define SUM_LEAF 16
+
+static struct k_p4wq_ws ws_pool;
+static struct k_p4wq_ws_worker ws_workers[NUM_WS_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(ws_stacks, NUM_WS_WORKERS, WS_STACK_SIZE);
+
+static struct k_p4wq_work ws_items[MAX_ITEMS];
+static atomic_t ws_count;
+static K_SEM_DEFINE(ws_release, 0, NUM_WS_WORKERS);
+
+static uint32_t sum_data[SUM_LEN];
+
+struct sum_node {
+	struct k_p4wq_work item;
+	int lo, hi;
+	uint32_t sum;
+};
+
+static void ws_setup(void)
+{
+	static bool started;
+
+	if (!started) {
+		k_p4wq_ws_init(&ws_pool, ws_workers, NUM_WS_WORKERS);
+		k_p4wq_ws_start(&ws_pool, (k_thread_stack_t *)ws_stacks,
+				WS_STACK_SIZE, K_PRIO_PREEMPT(2));
+		started = true;
+	}
+	atomic_set(&ws_count, 0);
+}
+
+static void count_handler(struct k_p4wq_work *item)
+{
+	atomic_inc(&ws_count);
+}
+
+static void block_handler(struct k_p4wq_work *item)
+{
+	atomic_inc(&ws_count);
+	k_sem_take(&ws_release, K_FOREVER);
+}
+
+/* Validate that submitted items all run, and run once */
+static void test_ws_submit(void)
+{
+	ws_setup();
+
+	for (int i = 0; i < MAX_ITEMS; i++) {
+		ws_items[i] = (struct k_p4wq_work){ .handler = count_handler };
+		k_p4wq_ws_submit(&ws_pool, &ws_items[i]);
+	}
+
+	k_msleep(100);
+	zassert_equal(atomic_get(&ws_count), MAX_ITEMS,
+		      "wrong run count: %d", (int)atomic_get(&ws_count));
+}
+
+/* Validate cancellation, including of items forked into a group */
+static void test_ws_cancel(void)
+{
+	struct k_p4wq_ws_join join;
+
+	ws_setup();
+
+	/* Occupy all the workers so that nothing else gets to run */
+	for (int i = 0; i < NUM_WS_WORKERS; i++) {
+		ws_items[i] = (struct k_p4wq_work){ .handler = block_handler };
+		k_p4wq_ws_submit(&ws_pool, &ws_items[i]);
+	}
+	while (atomic_get(&ws_count) < NUM_WS_WORKERS) {
+		k_msleep(1);
+	}
+
+	zassert_false(k_p4wq_ws_cancel(&ws_pool, &ws_items[0]),
+		      "running item should not be cancelable");
+
+	k_p4wq_ws_join_init(&join);
+	for (int i = NUM_WS_WORKERS; i < NUM_WS_WORKERS + 4; i++) {
+		ws_items[i] = (struct k_p4wq_work){ .handler = count_handler };
+		k_p4wq_ws_fork(&ws_pool, &join, &ws_items[i]);
+	}
+
+	zassert_true(k_p4wq_ws_cancel(&ws_pool, &ws_items[NUM_WS_WORKERS]),
+		     "queued item should be cancelable");
+	zassert_false(k_p4wq_ws_cancel(&ws_pool, &ws_items[NUM_WS_WORKERS]),
+		      "item should not be cancelable twice");
+
+	for (int i = 0; i < NUM_WS_WORKERS; i++) {
+		k_sem_give(&ws_release);
+	}
+
+	/* The cancelled item must not hold up the join */
+	k_p4wq_ws_join(&ws_pool, &join);
+	zassert_equal(atomic_get(&ws_count), NUM_WS_WORKERS + 3,
+		      "wrong run count: %d", (int)atomic_get(&ws_count));
+}
+
+static void sum_handler(struct k_p4wq_work *item)
+{
+	struct sum_node *n = CONTAINER_OF(item, struct sum_node, item);
+
+	n->sum = 0;
+	if ((n->hi - n->lo) <= SUM_LEAF) {
+		for (int i = n->lo; i < n->hi; i++) {
+			n->sum += sum_data[i];
+		}
+		return;
+	}
+
+	/* Children live on this stack: the join must not return
+	 * before both have completed
+	 */
+	struct k_p4wq_ws_join join;
+	int mid = (n->lo + n->hi) / 2;
+	struct sum_node kids[2] = {
+		{ .item.handler = sum_handler, .lo = n->lo, .hi = mid },
+		{ .item.handler = sum_handler, .lo = mid, .hi = n->hi },
+	};
+
+	k_p4wq_ws_join_init(&join);
+	k_p4wq_ws_fork(&ws_pool, &join, &kids[0].item);
+	k_p4wq_ws_fork(&ws_pool, &join, &kids[1].item);
+	k_p4wq_ws_join(&ws_pool, &join);
+
+	n->sum = kids[0].sum + kids[1].sum;
+}
+
+/* Validate recursive fork/join from the handlers */
+static void test_ws_fork_join(void)
+{
+	struct k_p4wq_ws_join join;
+	struct sum_node root = {
+		.item.handler = sum_handler, .lo = 0, .hi = SUM_LEN,
+	};
+	uint32_t expect = 0;
+
+	ws_setup();
+
+	for (int i = 0; i < SUM_LEN; i++) {
+		sum_data[i] = sys_rand32_get() & 0xffff;
+		expect += sum_data[i];
+	}
+
+	for (int r = 0; r < 10; r++) {
+		k_p4wq_ws_join_init(&join);
+		k_p4wq_ws_fork(&ws_pool, &join, &root.item);
+		k_p4wq_ws_join(&ws_pool, &join);
+		zassert_equal(root.sum, expect, "wrong sum %u, expected %u",
+			      root.sum, expect);
+	}
+}
+#else
+static void test_ws_submit(void)
+{
+	ztest_test_skip();
+}
+
+static void test_ws_cancel(void)
+{
+	ztest_test_skip();
+}
+
+static void test_ws_fork_join(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(lib_p4wq_test,
 			 ztest_1cpu_unit_test(test_p4wq_simple),
 			 ztest_unit_test(test_resubmit),
 			 ztest_unit_test(test_fill_queue),
-			 ztest_unit_test(test_stress));
+			 ztest_unit_test(test_stress),
+			 ztest_unit_test(test_ws_submit),
+			 ztest_unit_test(test_ws_cancel),
+			 ztest_unit_test(test_ws_fork_join));
 
 	ztest_run_test_suite(lib_p4wq_test);
 }
@@ -907,6 +907,194 @@ void test_ringbuffer_performance(void)
 	PRINT("5 byte get claim-finish, avg cycles: %d\n", timestamp/loop);
 }
 
+RING_BUF_DECLARE(ringbuf_wrap, 16);
+RING_BUF_ITEM_DECLARE_POW2(ringbuf_item_wrap, 3);
+
+/* Indexes of power of 2 sized ring buffers are not rewound: they wrap at
+ * 2^32, which has to be transparent.
+ */
+void test_ringbuffer_pow2_wrap(void)
+{
+	uint8_t indata[11], outdata[11];
+	uint32_t item[3] = { 1, 2, 3 }, outitem[3];
+	uint8_t size32, value;
+	uint16_t type;
+	uint32_t start = UINT32_MAX - 20;
+
+	ringbuf_wrap.head = ringbuf_wrap.tail = start;
+	ringbuf_wrap.misc.byte_mode.tmp_head = start;
+	ringbuf_wrap.misc.byte_mode.tmp_tail = start;
+
+	for (int i = 0; i < 10; i++) {
+		memset(indata, i, sizeof(indata));
+		zassert_equal(ring_buf_put(&ringbuf_wrap, indata,
+					   sizeof(indata)),
+			      sizeof(indata), NULL);
+		zassert_equal(ring_buf_space_get(&ringbuf_wrap),
+			      16 - sizeof(indata), NULL);
+		zassert_equal(ring_buf_get(&ringbuf_wrap, outdata,
+					   sizeof(outdata)),
+			      sizeof(outdata), NULL);
+		zassert_equal(memcmp(indata, outdata, sizeof(outdata)), 0,
+			      NULL);
+	}
+	zassert_true(ringbuf_wrap.head < start, "indexes did not wrap");
+	zassert_true(ring_buf_is_empty(&ringbuf_wrap), NULL);
+
+	ringbuf_item_wrap.head = ringbuf_item_wrap.tail = start;
+	for (int i = 0; i < 10; i++) {
+		item[0] = i;
+		zassert_equal(ring_buf_item_put(&ringbuf_item_wrap, i, i, item,
+						ARRAY_SIZE(item)), 0, NULL);
+		size32 = ARRAY_SIZE(outitem);
+		zassert_equal(ring_buf_item_get(&ringbuf_item_wrap, &type,
+						&value, outitem, &size32), 0,
+			      NULL);
+		zassert_equal(type, i, NULL);
+		zassert_equal(memcmp(item, outitem, sizeof(item)), 0, NULL);
+	}
+	zassert_true(ringbuf_item_wrap.head < start, "indexes did not wrap");
+}
+
+RING_BUF_MPSC_DECLARE_POW2(mpsc_buf, 4);
+
+static void mpsc_put_isr(const void *p)
+{
+	zassert_equal(ring_buf_mpsc_put(&mpsc_buf, p, strlen(p)), 0, NULL);
+}
+
+void test_ringbuffer_mpsc(void)
+{
+	static uint32_t data32[8];
+	static atomic_t committed[RING_BUF_MPSC_BITMAP_SIZE(8)];
+	struct ring_buf_mpsc buf;
+	uint8_t outdata[64];
+	uint8_t *claimed, *rx;
+	int len;
+
+	zassert_true(ring_buf_mpsc_is_empty(&mpsc_buf), NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, outdata, sizeof(outdata)),
+		      -EAGAIN, NULL);
+
+	/* A record claimed first holds back those finished after it */
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc_buf, &claimed, 5), 0,
+		      NULL);
+	irq_offload(mpsc_put_isr, "from isr");
+	zassert_false(ring_buf_mpsc_is_empty(&mpsc_buf), NULL);
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc_buf, &rx), -EAGAIN, NULL);
+
+	memcpy(claimed, "first", 5);
+	ring_buf_mpsc_put_finish(&mpsc_buf, claimed);
+	zassert_equal(ring_buf_mpsc_get(&mpsc_buf, outdata, 4), -EMSGSIZE,
+		      NULL);
+	len = ring_buf_mpsc_get(&mpsc_buf, outdata, sizeof(outdata));
+	zassert_equal(len, 5, NULL);
+	zassert_equal(memcmp(outdata, "first", len), 0, NULL);
+
+	len = ring_buf_mpsc_get_claim(&mpsc_buf, &rx);
+	zassert_equal(len, 8, NULL);
+	zassert_equal(memcmp(rx, "from isr", len), 0, NULL);
+	ring_buf_mpsc_get_finish(&mpsc_buf);
+	zassert_true(ring_buf_mpsc_is_empty(&mpsc_buf), NULL);
+
+	/* Records of 2 to 4 words in 8 words, so many of them wrap after
+	 * some padding
+	 */
+	ring_buf_mpsc_init(&buf, ARRAY_SIZE(data32), data32, committed);
+	for (int i = 0; i < 40; i++) {
+		memset(outdata, i, sizeof(outdata));
+		zassert_equal(ring_buf_mpsc_put(&buf, outdata, 1 + i % 12), 0,
+			      "put %d", i);
+		len = ring_buf_mpsc_get_claim(&buf, &rx);
+		zassert_equal(len, 1 + i % 12, "get %d", i);
+		zassert_equal(rx[0], i, NULL);
+		zassert_equal(rx[len - 1], i, NULL);
+		ring_buf_mpsc_get_finish(&buf);
+	}
+	zassert_true(ring_buf_mpsc_is_empty(&buf), NULL);
+
+	/* 4 words, then 5 words that do not fit */
+	zassert_equal(ring_buf_mpsc_put(&buf, outdata, 12), 0, NULL);
+	zassert_equal(ring_buf_mpsc_put(&buf, outdata, 16), -EMSGSIZE, NULL);
+	zassert_equal(ring_buf_mpsc_get(&buf, outdata, sizeof(outdata)), 12,
+		      NULL);
+
+	/* Records larger than the buffer can never fit */
+	zassert_equal(ring_buf_mpsc_put(&buf, outdata, 29), -EMSGSIZE, NULL);
+	zassert_equal(atomic_get(&buf.dropped_put_count), 2, NULL);
+}
+
+#define MPSC_PRODUCERS 3
+#define MPSC_RECORDS 2000
+#define MPSC_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_ARRAY_DEFINE(mpsc_stacks, MPSC_PRODUCERS,
+				   MPSC_STACK_SIZE);
+static struct k_thread mpsc_threads[MPSC_PRODUCERS];
+
+struct mpsc_record {
+	uint32_t producer;
+	uint32_t seq;
+	uint8_t extra[3];
+};
+
+/* Vary the sizes so that records wrap at various places */
+#define MPSC_RECORD_SIZE(seq) \
+	(offsetof(struct mpsc_record, extra) + (seq) % 4U)
+
+static void mpsc_producer(void *p1, void *p2, void *p3)
+{
+	struct mpsc_record rec = { .producer = POINTER_TO_UINT(p1) };
+
+	for (rec.seq = 0; rec.seq < MPSC_RECORDS; rec.seq++) {
+		while (ring_buf_mpsc_put(&mpsc_buf, (uint8_t *)&rec,
+					 MPSC_RECORD_SIZE(rec.seq)) != 0) {
+			k_yield();
+		}
+		if ((rec.seq % 3U) == rec.producer) {
+			k_yield();
+		}
+	}
+}
+
+/* Records of each producer come out in order, none lost or duplicated */
+void test_ringbuffer_mpsc_threads(void)
+{
+	uint32_t next[MPSC_PRODUCERS] = { 0 };
+	struct mpsc_record rec;
+	int prio = k_thread_priority_get(k_current_get());
+	int received = 0;
+	int len;
+
+	for (int i = 0; i < MPSC_PRODUCERS; i++) {
+		k_thread_create(&mpsc_threads[i], mpsc_stacks[i],
+				MPSC_STACK_SIZE, mpsc_producer,
+				UINT_TO_POINTER(i), NULL, NULL, prio, 0,
+				K_NO_WAIT);
+	}
+
+	while (received < MPSC_PRODUCERS * MPSC_RECORDS) {
+		len = ring_buf_mpsc_get(&mpsc_buf, (uint8_t *)&rec,
+					sizeof(rec));
+		if (len < 0) {
+			zassert_equal(len, -EAGAIN, NULL);
+			k_yield();
+			continue;
+		}
+
+		zassert_true(rec.producer < MPSC_PRODUCERS, NULL);
+		zassert_equal(len, MPSC_RECORD_SIZE(next[rec.producer]), NULL);
+		zassert_equal(rec.seq, next[rec.producer], NULL);
+		next[rec.producer]++;
+		received++;
+	}
+
+	for (int i = 0; i < MPSC_PRODUCERS; i++) {
+		k_thread_join(&mpsc_threads[i], K_FOREVER);
+	}
+	zassert_true(ring_buf_mpsc_is_empty(&mpsc_buf), NULL);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -929,6 +1117,9 @@ void test_main(void)
 		       ztest_unit_test(test_ringbuffer_equal_bufs),
 		       ztest_unit_test(test_capacity),
 		       ztest_unit_test(test_reset),
+		       ztest_unit_test(test_ringbuffer_pow2_wrap),
+		       ztest_unit_test(test_ringbuffer_mpsc),
+		       ztest_unit_test(test_ringbuffer_mpsc_threads),
 		       ztest_unit_test(test_ringbuffer_performance)
 		);
 	ztest_run_test_suite(test_ringbuffer_api);
@@ -12,6 +12,7 @@
 #include <sys/printk.h>
 
 #include <net/buf.h>
+#include <sys/base64.h>
 
 #include <ztest.h>
 
@@ -66,6 +67,8 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, var_destroy);
+/* Fragments that don't hold a whole number of base64 groups */
+NET_BUF_POOL_FIXED_DEFINE(base64_pool, 8, 30, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -680,6 +683,42 @@ static void test_net_buf_byte_order(void)
 	net_buf_unref(buf);
 }
 
+static void test_net_buf_append_base64(void)
+{
+	static const size_t pieces[] = { 1, 1, 5, 2, 3, 20, 4 };
+	uint8_t expected[64], out[64];
+	struct base64_encoder enc;
+	struct net_buf *buf;
+	size_t off = 0, len;
+
+	zassert_ok(base64_encode(expected, sizeof(expected), &len,
+				 example_data, 36), NULL);
+
+	buf = net_buf_alloc_len(&base64_pool, 30, K_NO_WAIT);
+	zassert_not_null(buf, "Failed to get buffer");
+	net_buf_add_u8(buf, '[');
+
+	base64_encoder_init(&enc);
+	for (int i = 0; i < ARRAY_SIZE(pieces); i++) {
+		zassert_equal(net_buf_append_base64(buf, &enc, pieces[i],
+						    &example_data[off],
+						    K_NO_WAIT, NULL, NULL),
+			      pieces[i], "Failed to append piece %d", i);
+		off += pieces[i];
+	}
+
+	zassert_ok(net_buf_append_base64_finish(buf, &enc, K_NO_WAIT, NULL,
+						NULL), NULL);
+	zassert_equal(off, 36, NULL);
+	zassert_equal(net_buf_frags_len(buf), 1 + len, "Invalid length");
+	zassert_not_null(buf->frags, "No fragment added");
+
+	net_buf_linearize(out, sizeof(out), buf, 1, len);
+	zassert_mem_equal(out, expected, len, "Invalid encoding");
+
+	net_buf_unref(buf);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_net_buf,
@@ -692,7 +731,8 @@ void test_main(void)
 			 ztest_unit_test(test_net_buf_clone),
 			 ztest_unit_test(test_net_buf_fixed_pool),
 			 ztest_unit_test(test_net_buf_var_pool),
-			 ztest_unit_test(test_net_buf_byte_order)
+			 ztest_unit_test(test_net_buf_byte_order),
+			 ztest_unit_test(test_net_buf_append_base64)
 			 );
 
 	ztest_run_test_suite(test_net_buf);
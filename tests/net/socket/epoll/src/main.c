@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+static int delayed_sock;
+static struct k_delayed_work delayed_send;
+
+static void delayed_send_handler(struct k_work *work)
+{
+	ssize_t len;
+
+	len = send(delayed_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void send_small(int sock)
+{
+	ssize_t len;
+
+	len = send(sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(int sock)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = recv(sock, buf, sizeof(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+void test_epoll_udp(void)
+{
+	int res;
+	int ep;
+	int c_sock;
+	int s_sock;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	uint32_t tstamp;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	res = epoll_create1(1);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	ep = epoll_create1(0);
+	zassert_true(ep >= 0, "epoll_create1 failed");
+
+	ev.events = EPOLLIN;
+	ev.data.u32 = 42U;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	res = epoll_ctl(ep, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	/* Only sockets can be watched */
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, ep, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EPERM, "");
+
+
+	/* Wait with no events, with timeouts of 0 and 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+
+	/* Level-triggered: reported as long as there is data */
+	send_small(c_sock);
+	send_small(c_sock);
+
+	/* Let the network stack run */
+	k_msleep(10);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.u32, 42U, "");
+
+	recv_small(s_sock);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+
+	recv_small(s_sock);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+
+	/* Edge-triggered: reported once per reception */
+	ev.events = EPOLLIN | EPOLLET;
+	res = epoll_ctl(ep, EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	send_small(c_sock);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	send_small(c_sock);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 30);
+	zassert_equal(res, 1, "");
+
+	recv_small(s_sock);
+	recv_small(s_sock);
+
+
+	/* A blocked wait is woken up by the reception */
+	delayed_sock = c_sock;
+	k_delayed_work_init(&delayed_send, delayed_send_handler);
+	k_delayed_work_submit(&delayed_send, K_MSEC(20));
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), -1);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 20U && tstamp <= 20 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+
+	recv_small(s_sock);
+
+
+	/* Sockets are always writable */
+	ev.events = EPOLLOUT;
+	ev.data.fd = c_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLOUT, "");
+	zassert_equal(events[0].data.fd, c_sock, "");
+
+
+	/* Removed sockets are not reported */
+	res = epoll_ctl(ep, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+	res = epoll_ctl(ep, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+
+	/* Closing a socket removes it */
+	send_small(c_sock);
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(ep);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EBADF, "");
+}
+
+void test_epoll_tcp(void)
+{
+	int res;
+	int ep;
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct epoll_event ev;
+	struct epoll_event events[2];
+	char buf[10];
+
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+	res = listen(s_sock, 0);
+	zassert_equal(res, 0, "listen failed");
+
+	ep = epoll_create1(0);
+	zassert_true(ep >= 0, "epoll_create1 failed");
+
+	ev.events = EPOLLIN;
+	ev.data.fd = s_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+
+	/* A pending connection is reported on the listening socket */
+	res = connect(c_sock, (const struct sockaddr *)&s_addr,
+		      sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	new_sock = accept(s_sock, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.fd = new_sock;
+	res = epoll_ctl(ep, EPOLL_CTL_ADD, new_sock, &ev);
+	zassert_equal(res, 0, "epoll_ctl failed");
+
+
+	/* Data, then the end of the stream */
+	send_small(c_sock);
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, new_sock, "");
+
+	recv_small(new_sock);
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(ep, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, new_sock, "");
+
+	res = recv(new_sock, buf, sizeof(buf), 0);
+	zassert_equal(res, 0, "no end of stream");
+
+	res = close(new_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(ep);
+	zassert_equal(res, 0, "close failed");
+
+	/* Let the network stack run */
+	k_msleep(10);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_udp),
+			 ztest_unit_test(test_epoll_tcp));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <ztest_assert.h>
 #include <fcntl.h>
 #include <net/socket.h>
+#include <net/net_pkt.h>
 
 #include "../../socket_helpers.h"
 
@@ -651,6 +652,81 @@ void test_v6_so_rcvtimeo(void)
 	k_sleep(TCP_TEARDOWN_TIMEOUT);
 }
 
+void test_v4_zerocopy(void)
+{
+	/* Test zero-copy send and receive on a ipv4 stream socket */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct net_buf *frags, *held;
+	struct iovec iov[4];
+	int handle;
+	ssize_t ret;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, NULL, NULL);
+
+	frags = net_pkt_get_reserve_tx_data(K_FOREVER);
+	zassert_not_null(frags, "cannot allocate buffer");
+	net_buf_add_mem(frags, TEST_STR_SMALL, strlen(TEST_STR_SMALL));
+
+	ret = zsock_send_zc(c_sock, frags, 0);
+	zassert_equal(ret, strlen(TEST_STR_SMALL), "send_zc failed");
+
+	ret = zsock_recv_zc(new_sock, &frags, 0);
+	zassert_equal(ret, strlen(TEST_STR_SMALL), "recv_zc failed");
+	zassert_equal(frags->len, ret, "data not in one buffer");
+	zassert_mem_equal(frags->data, TEST_STR_SMALL, ret, "unexpected data");
+	zsock_recv_zc_done(new_sock, frags);
+
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+
+	ret = zsock_recv_zc_iov(new_sock, iov, ARRAY_SIZE(iov), &handle, 0);
+	zassert_equal(ret, 1, "recv_zc_iov failed");
+	zassert_equal(iov[0].iov_len, strlen(TEST_STR_SMALL), "wrong length");
+	zassert_mem_equal(iov[0].iov_base, TEST_STR_SMALL, iov[0].iov_len,
+			  "unexpected data");
+	zassert_equal(zsock_recv_zc_release(new_sock, handle), 0,
+		      "release failed");
+	zassert_equal(zsock_recv_zc_release(new_sock, handle), -1,
+		      "released twice");
+	zassert_equal(errno, EINVAL, "wrong errno");
+
+	ret = zsock_recv_zc(new_sock, &frags, ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "no data expected");
+	zassert_equal(errno, EAGAIN, "wrong errno");
+
+	/* Data still held when the socket gets closed */
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+
+	ret = zsock_recv_zc(new_sock, &held, 0);
+	zassert_equal(ret, strlen(TEST_STR_SMALL), "recv_zc failed");
+
+	test_close(c_sock);
+
+	ret = zsock_recv_zc(new_sock, &frags, 0);
+	zassert_equal(ret, 0, "EOF expected");
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	errno = 0;
+	zsock_recv_zc_done(new_sock, held);
+	zassert_equal(errno, 0, "errno changed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 #ifdef CONFIG_USERSPACE
 #define CHILD_STACK_SZ		(2048 + CONFIG_TEST_EXTRA_STACKSIZE)
 struct k_thread child_thread;
@@ -739,6 +815,7 @@ void test_main(void)
 		ztest_user_unit_test(test_v4_accept_timeout),
 		ztest_unit_test(test_v4_so_rcvtimeo),
 		ztest_unit_test(test_v6_so_rcvtimeo),
+		ztest_unit_test(test_v4_zerocopy),
 		ztest_user_unit_test(test_socket_permission)
 		);
 
@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/net_pkt.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -704,6 +705,129 @@ void test_v6_sendmsg_recvfrom_connected(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+void test_v4_zerocopy(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct net_buf *frags = NULL;
+	struct net_buf *buf;
+	struct iovec iov[8];
+	char rx_buf[sizeof(TEST_STR2)];
+	size_t len = 0;
+	int handle;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = connect(client_sock, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+	zassert_equal(rv, 0, "connect failed");
+
+	/* The data spans several buffers */
+	while (len < STRLEN(TEST_STR2)) {
+		buf = net_pkt_get_reserve_tx_data(K_FOREVER);
+		zassert_not_null(buf, "cannot allocate buffer");
+
+		rv = MIN(net_buf_tailroom(buf), STRLEN(TEST_STR2) - len);
+		net_buf_add_mem(buf, TEST_STR2 + len, rv);
+		len += rv;
+
+		if (frags) {
+			net_buf_frag_add(frags, buf);
+		} else {
+			frags = buf;
+		}
+	}
+
+	zassert_not_null(frags->frags, "data in one buffer");
+
+	rv = zsock_send_zc(client_sock, frags, 0);
+	zassert_equal(rv, STRLEN(TEST_STR2), "send_zc failed");
+
+	rv = zsock_recv_zc_iov(server_sock, iov, 1, &handle, 0);
+	zassert_equal(rv, -1, "data in one buffer");
+	zassert_equal(errno, EMSGSIZE, "wrong errno");
+
+	rv = zsock_recv_zc_iov(server_sock, iov, ARRAY_SIZE(iov), &handle, 0);
+	zassert_true(rv > 1, "recv_zc_iov failed");
+
+	len = 0;
+	for (int i = 0; i < rv; i++) {
+		zassert_true(len + iov[i].iov_len <= STRLEN(TEST_STR2),
+			     "too much data");
+		memcpy(rx_buf + len, iov[i].iov_base, iov[i].iov_len);
+		len += iov[i].iov_len;
+	}
+
+	zassert_equal(len, STRLEN(TEST_STR2), "wrong length");
+	zassert_mem_equal(rx_buf, TEST_STR2, len, "unexpected data");
+
+	rv = zsock_recv_zc_release(server_sock, handle);
+	zassert_equal(rv, 0, "release failed");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+/* A user thread with no access to the network buffers can't receive
+ * by address, and the data stays queued for zsock_recv()
+ */
+void test_v4_zerocopy_user(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct iovec iov[8];
+	char rx_buf[sizeof(TEST_STR_SMALL)];
+	int handle;
+
+	if (!_is_user_context()) {
+		ztest_test_skip();
+	}
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = sendto(client_sock, TEST_STR_SMALL, STRLEN(TEST_STR_SMALL), 0,
+		    (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	rv = zsock_recv_zc_iov(server_sock, iov, ARRAY_SIZE(iov), &handle, 0);
+	zassert_equal(rv, -1, "network buffers readable from user mode");
+	zassert_equal(errno, EACCES, "wrong errno");
+	zassert_equal(handle, -1, "data held");
+
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "data not kept queued");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, rv, "unexpected data");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_so_txtime(void)
 {
 	struct sockaddr_in bind_addr4;
@@ -1041,6 +1165,8 @@ void test_main(void)
 			 ztest_user_unit_test(test_v4_sendmsg_recvfrom_connected),
 			 ztest_unit_test(test_v6_sendmsg_recvfrom_connected),
 			 ztest_user_unit_test(test_v6_sendmsg_recvfrom_connected),
+			 ztest_unit_test(test_v4_zerocopy),
+			 ztest_user_unit_test(test_v4_zerocopy_user),
 			 ztest_unit_test(test_setup_eth),
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime)
@@ -119,6 +119,9 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_sack_test(struct net_pkt *pkt, struct tcphdr *th);
+static void handle_client_newreno_test(struct net_pkt *pkt,
+				       struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -207,6 +210,13 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Options added to the segments of the tester, if any */
+static const uint8_t *tester_options;
+static size_t tester_options_len;
+
+/* Window advertised by the tester */
+static uint16_t tester_win = NET_IPV6_MTU;
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -217,10 +227,12 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct net_pkt *pkt;
 	struct tcphdr *th;
-	uint8_t opts_len = 0;
+	const uint8_t *opts = tester_options;
+	uint8_t opts_len = tester_options_len;
 	int ret = -EINVAL;
 
 	if ((test_case_no == 4U) && (flags & SYN)) {
+		opts = tcp_options;
 		opts_len = sizeof(tcp_options);
 	}
 
@@ -256,14 +268,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
-	} else {
-		th->th_off = 5U;
-	}
-
+	th->th_off = 5U + opts_len / 4U;
 	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
+	th->th_win = htons(tester_win);
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -275,9 +282,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (opts_len) {
 		/* Add TCP Options */
-		ret = net_pkt_write(pkt, tcp_options, opts_len);
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -414,6 +421,12 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_sack_test(pkt, &th);
+		break;
+	case 11:
+		handle_client_newreno_test(pkt, &th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -641,6 +654,15 @@ static void handle_server_test(sa_family_t af, struct tcphdr *th)
 		break;
 	case T_SYN_ACK:
 		test_verify_flags(th, SYN | ACK);
+
+		/* Window scale and SACK permitted answered, 4 bytes each */
+		if (test_case_no == 4U) {
+			zassert_equal(th->th_off, 5U +
+				      IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) +
+				      IS_ENABLED(CONFIG_NET_TCP_SACK),
+				      "Options not answered");
+		}
+
 		seq++;
 		ack = ntohs(th->th_seq) + 1U;
 		reply = prepare_ack_packet(af, htons(MY_PORT),
@@ -1478,6 +1500,435 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+#define SACK_SEG_LEN 100
+#define SACK_SEGS 5
+
+/* What the stack offers in its SYN */
+static const uint8_t sack_syn_options[] = {
+	0x01, 0x03, 0x03, 0x00, /* NOP, Win scale 0 */
+	0x01, 0x01, 0x04, 0x02, /* NOP, NOP, SACK permitted */
+};
+
+static const uint8_t sack_syn_ack_options[] = {
+	0x02, 0x04, 0x00, SACK_SEG_LEN, /* Max segment */
+	0x01, 0x03, 0x03, 0x00, /* NOP, Win scale 0 */
+	0x01, 0x01, 0x04, 0x02, /* NOP, NOP, SACK permitted */
+};
+
+/* SACK blocks of the replies, in segments */
+static const int sack_seg1[][2] = { { 1, 2 } };
+static const int sack_seg3[][2] = { { 1, 2 }, { 3, 4 } };
+static const int sack_seg4[][2] = { { 1, 2 }, { 3, 5 } };
+static const int sack_rexmit0[][2] = { { 3, 5 } };
+
+static uint8_t sack_options[4 + 2 * 8];
+static uint32_t sack_data_seq;
+static int sack_sent[SACK_SEGS];
+
+/* ACK of the data up to segment acked, with the SACK blocks of the
+ * segments [first, last) given, in segments
+ */
+static struct net_pkt *prepare_sack_packet(sa_family_t af, uint16_t dst_port,
+					   int acked, const int (*blocks)[2],
+					   int count)
+{
+	struct net_pkt *pkt;
+
+	sack_options[0] = 0x01;
+	sack_options[1] = 0x01;
+	sack_options[2] = 0x05;
+	sack_options[3] = 2 + 8 * count;
+
+	for (int i = 0; i < count; i++) {
+		UNALIGNED_PUT(htonl(sack_data_seq +
+				    blocks[i][0] * SACK_SEG_LEN),
+			      (uint32_t *)&sack_options[4 + 8 * i]);
+		UNALIGNED_PUT(htonl(sack_data_seq +
+				    blocks[i][1] * SACK_SEG_LEN),
+			      (uint32_t *)&sack_options[8 + 8 * i]);
+	}
+
+	ack = sack_data_seq + acked * SACK_SEG_LEN;
+	tester_options = sack_options;
+	tester_options_len = count ? 4 + 8 * count : 0;
+
+	pkt = prepare_ack_packet(af, htons(MY_PORT), dst_port);
+
+	tester_options = NULL;
+	tester_options_len = 0;
+
+	return pkt;
+}
+
+static void verify_syn_options(struct net_pkt *pkt, struct tcphdr *th)
+{
+	uint8_t options[sizeof(sack_syn_options)];
+
+	zassert_equal(th->th_off, 5U + sizeof(options) / 4U,
+		      "Unexpected options length");
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	zassert_ok(net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ip_opts_len(pkt) +
+				sizeof(struct tcphdr)), "");
+	zassert_ok(net_pkt_read(pkt, options, sizeof(options)), "");
+	net_pkt_cursor_init(pkt);
+
+	zassert_mem_equal(options, sack_syn_options, sizeof(options),
+			  "Unexpected SYN options");
+}
+
+/* The tester loses the segments 0 and 2 of 5. With the SACK blocks of
+ * the three duplicate ACKs that follow, only the segment 0 is sent
+ * again, then the segment 2 on the partial ACK that follows.
+ */
+static void handle_client_sack_test(struct net_pkt *pkt, struct tcphdr *th)
+{
+	sa_family_t af = net_pkt_family(pkt);
+	struct net_pkt *reply;
+	int seg, ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		verify_syn_options(pkt, th);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		tester_options = sack_syn_ack_options;
+		tester_options_len = sizeof(sack_syn_ack_options);
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		tester_options = NULL;
+		tester_options_len = 0;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		seq++;
+		sack_data_seq = ack;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+		seg = (ntohl(th->th_seq) - sack_data_seq) / SACK_SEG_LEN;
+		zassert_true(seg < SACK_SEGS, "Unexpected seq");
+		sack_sent[seg]++;
+
+		if (sack_sent[seg] == 1 && (seg == 0 || seg == 2)) {
+			/* Lost */
+			return;
+		} else if (sack_sent[seg] == 1 && seg == 1) {
+			reply = prepare_sack_packet(af, th->th_sport, 0,
+						    sack_seg1,
+						    ARRAY_SIZE(sack_seg1));
+		} else if (sack_sent[seg] == 1 && seg == 3) {
+			reply = prepare_sack_packet(af, th->th_sport, 0,
+						    sack_seg3,
+						    ARRAY_SIZE(sack_seg3));
+		} else if (sack_sent[seg] == 1 && seg == 4) {
+			reply = prepare_sack_packet(af, th->th_sport, 0,
+						    sack_seg4,
+						    ARRAY_SIZE(sack_seg4));
+		} else if (sack_sent[seg] == 2 && seg == 0) {
+			reply = prepare_sack_packet(af, th->th_sport, 2,
+						    sack_rexmit0,
+						    ARRAY_SIZE(sack_rexmit0));
+		} else if (sack_sent[seg] == 2 && seg == 2) {
+			reply = prepare_sack_packet(af, th->th_sport, SACK_SEGS,
+						    NULL, 0);
+			t_state = T_FIN;
+			test_sem_give();
+		} else {
+			zassert_true(false, "Segment %d sent %d times", seg,
+				     sack_sent[seg]);
+			return;
+		}
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   expect SYN with window scale and SACK permitted,
+ *   send SYN ACK with MSS, window scale and SACK permitted,
+ *   expect ACK,
+ *   expect 5 data segments, drop the 1st and 3rd,
+ *   send 3 duplicate ACKs with SACK blocks,
+ *   expect the 1st segment again only,
+ *   send partial ACK,
+ *   expect the 3rd segment again only,
+ *   send ACK,
+ *   expect FIN ACK,
+ *   send FIN ACK,
+ *   expect ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_sack_ipv4(void)
+{
+	struct net_context *ctx;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) ||
+	    !IS_ENABLED(CONFIG_NET_TCP_SACK)) {
+		ztest_test_skip();
+	}
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	ret = net_context_send(ctx, lorem_ipsum, SACK_SEGS * SACK_SEG_LEN,
+			       NULL, K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphone after it acks all the data */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	for (int i = 0; i < SACK_SEGS; i++) {
+		zassert_equal(sack_sent[i], (i == 0 || i == 2) ? 2 : 1,
+			      "Segment %d sent %d times", i, sack_sent[i]);
+	}
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
+/* The peer of the NewReno test only sends the MSS, so no SACK */
+static const uint8_t newreno_syn_ack_options[] = {
+	0x02, 0x04, 0x00, SACK_SEG_LEN, /* Max segment */
+};
+
+static uint16_t newreno_port;
+
+/* The tester loses the segments 0 and 2 of 5 and lets the test case
+ * acknowledge them
+ */
+static void handle_client_newreno_test(struct net_pkt *pkt,
+				       struct tcphdr *th)
+{
+	sa_family_t af = net_pkt_family(pkt);
+	struct net_pkt *reply;
+	int seg, ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		newreno_port = th->th_sport;
+		tester_options = newreno_syn_ack_options;
+		tester_options_len = sizeof(newreno_syn_ack_options);
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		tester_options = NULL;
+		tester_options_len = 0;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		seq++;
+		sack_data_seq = ack;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(th->th_off, 5U, "Unexpected options");
+		seg = (ntohl(th->th_seq) - sack_data_seq) / SACK_SEG_LEN;
+		zassert_true(seg < SACK_SEGS, "Unexpected seq");
+		sack_sent[seg]++;
+
+		/* Once all is sent, and on each retransmission */
+		if (seg == SACK_SEGS - 1 || sack_sent[seg] > 1) {
+			test_sem_give();
+		}
+		return;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* ACK of the data up to segment acked, from the test case */
+static void newreno_ack(int acked)
+{
+	struct net_pkt *reply;
+
+	reply = prepare_sack_packet(AF_INET, newreno_port, acked, NULL, 0);
+	zassert_not_null(reply, "Cannot create pkt");
+	zassert_ok(net_recv_data(iface, reply), "recv data failed");
+}
+
+/* Test case scenario IPv4
+ *   expect SYN,
+ *   send SYN ACK with MSS only,
+ *   expect ACK,
+ *   expect 5 data segments, drop the 1st and 3rd,
+ *   send a duplicate ACK, a window update and another duplicate ACK,
+ *   expect no retransmission,
+ *   send a third duplicate ACK,
+ *   expect the 1st segment again only,
+ *   send partial ACK,
+ *   expect the 3rd segment again only, before any timeout,
+ *   send ACK,
+ *   expect FIN ACK,
+ *   send FIN ACK,
+ *   expect ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_newreno_ipv4(void)
+{
+	struct net_context *ctx;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 11;
+	seq = ack = 0;
+	memset(sack_sent, 0, sizeof(sack_sent));
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	ret = net_context_send(ctx, lorem_ipsum, SACK_SEGS * SACK_SEG_LEN,
+			       NULL, K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* A window update is not a duplicate ACK */
+	newreno_ack(0);
+	tester_win = NET_IPV6_MTU - SACK_SEG_LEN;
+	newreno_ack(0);
+	newreno_ack(0);
+	k_sleep(K_MSEC(10));
+	zassert_equal(sack_sent[0], 1, "Retransmitted on a window update");
+
+	/* Fast retransmit on the third duplicate ACK */
+	newreno_ack(0);
+	test_sem_take(K_MSEC(100), __LINE__);
+	zassert_equal(sack_sent[0], 2, "No fast retransmit");
+
+	/* The partial ACK shows the 3rd segment is lost too */
+	newreno_ack(2);
+	test_sem_take(K_MSEC(100), __LINE__);
+	zassert_equal(sack_sent[2], 2, "No retransmit on partial ACK");
+
+	t_state = T_FIN;
+	newreno_ack(SACK_SEGS);
+	tester_win = NET_IPV6_MTU;
+
+	for (int i = 0; i < SACK_SEGS; i++) {
+		zassert_equal(sack_sent[i], (i == 0 || i == 2) ? 2 : 1,
+			      "Segment %d sent %d times", i, sack_sent[i]);
+	}
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1493,7 +1944,9 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_client_sack_ipv4),
+			 ztest_unit_test(test_client_newreno_ipv4)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
@@ -433,7 +433,7 @@ void test_udp(void)
 	struct net_conn_handle *handlers[CONFIG_NET_MAX_CONN];
 	struct net_if *iface = net_if_get_default();
 	struct net_if_addr *ifaddr;
-	struct ud *ud;
+	struct ud *ud, *ud2;
 	int ret, i = 0;
 	bool st;
 
@@ -643,6 +643,17 @@ void test_udp(void)
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 	TEST_IPV6_LONG_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 
+	/* A handler bound to a port and one connected on the same port,
+	 * which are looked up in different tables.
+	 */
+	ud = REGISTER(AF_INET6, NULL, &any_addr6, 0, 4250);
+	ud2 = REGISTER(AF_INET6, &peer_addr6, NULL, 1234, 4250);
+	TEST_IPV6_OK(ud2, &in6addr_peer, &in6addr_my, 1234, 4250);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1235, 4250);
+	UNREGISTER(ud2);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1234, 4250);
+	UNREGISTER(ud);
+
 	/* Remote addr same as local addr, these two will never match */
 	REGISTER(AF_INET6, &my_addr6, NULL, 1234, 4242);
 	REGISTER(AF_INET, &my_addr4, NULL, 1234, 4242);
@@ -130,10 +130,132 @@ static void test_base64_codec(void)
 	zassert_equal(rc, -ENOMEM, "Error: dst NULL: decode test return value");
 }
 
+static uint32_t next_rand(void)
+{
+	static uint32_t state = 123456789U;
+
+	state = state * 1664525U + 1013904223U;
+
+	return state >> 8;
+}
+
+static void fill_random(uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		buf[i] = next_rand();
+	}
+}
+
+static void test_base64_roundtrip(void)
+{
+	uint8_t data[200], enc[300], dec[200], lines[400];
+	size_t len, elen, dlen;
+	int rc;
+
+	for (size_t slen = 1; slen <= sizeof(data); slen++) {
+		fill_random(data, slen);
+
+		rc = base64_encode(enc, sizeof(enc), &elen, data, slen);
+		zassert_equal(rc, 0, "encode %zu", slen);
+
+		/* Whole groups, decoded in one pass */
+		rc = base64_decode(dec, sizeof(dec), &len, enc, elen);
+		zassert_equal(rc, 0, "decode %zu", slen);
+		zassert_equal(len, slen, "decoded length %zu", slen);
+		zassert_mem_equal(dec, data, slen, "decoded data %zu", slen);
+
+		/* Exact and short destination buffers */
+		rc = base64_decode(dec, slen, &len, enc, elen);
+		zassert_equal(rc, 0, "decode exact %zu", slen);
+		rc = base64_decode(dec, slen - 1, &len, enc, elen);
+		zassert_equal(rc, -ENOMEM, "decode short %zu", slen);
+		zassert_equal(len, slen, "decode short length %zu", slen);
+
+		/* Line breaks every 8 characters */
+		dlen = 0;
+		for (size_t i = 0; i < elen; i++) {
+			lines[dlen++] = enc[i];
+			if (i % 8 == 7) {
+				lines[dlen++] = '\r';
+				lines[dlen++] = '\n';
+			}
+		}
+
+		memset(dec, 0, sizeof(dec));
+		rc = base64_decode(dec, sizeof(dec), &len, lines, dlen);
+		zassert_equal(rc, 0, "decode lines %zu", slen);
+		zassert_equal(len, slen, "decoded lines length %zu", slen);
+		zassert_mem_equal(dec, data, slen, "decoded lines %zu", slen);
+
+		/* Invalid characters anywhere */
+		for (size_t i = 0; i < elen; i++) {
+			uint8_t c = enc[i];
+
+			enc[i] = c | 0x80;
+			rc = base64_decode(dec, sizeof(dec), &len, enc, elen);
+			zassert_equal(rc, -EINVAL, "high bit %zu/%zu", i, slen);
+
+			if (i < elen - 3) {
+				enc[i] = '=';
+				rc = base64_decode(dec, sizeof(dec), &len, enc,
+						   elen);
+				zassert_equal(rc, -EINVAL, "padding %zu/%zu",
+					      i, slen);
+			}
+
+			enc[i] = c;
+		}
+	}
+}
+
+static void test_base64_stream(void)
+{
+	uint8_t data[200], enc[300], out[300];
+	struct base64_encoder enc_state;
+	size_t elen, olen, off, n;
+	int rc;
+
+	for (size_t slen = 0; slen <= sizeof(data); slen++) {
+		/* Random pieces of data into random pieces of buffer */
+		size_t room = 4 + next_rand() % 16;
+
+		fill_random(data, slen);
+		rc = base64_encode(enc, sizeof(enc), &elen, data, slen);
+		zassert_equal(rc, 0, NULL);
+
+		base64_encoder_init(&enc_state);
+		off = 0;
+		n = 0;
+		while (off < slen) {
+			size_t piece = next_rand() % 8;
+
+			piece = MIN(piece, slen - off);
+
+			off += base64_encode_update(&enc_state, &out[n],
+						    MIN(room, sizeof(out) - n),
+						    &olen, &data[off], piece);
+			zassert_equal(olen % 4, 0, NULL);
+			n += olen;
+		}
+
+		rc = base64_encode_finish(&enc_state, out, 3, &olen);
+		zassert_equal(rc, (slen % 3 != 0) ? -ENOMEM : 0, NULL);
+		rc = base64_encode_finish(&enc_state, &out[n],
+					  sizeof(out) - n, &olen);
+		zassert_equal(rc, 0, NULL);
+		n += olen;
+
+		zassert_equal(n, elen, "length %zu", slen);
+		zassert_mem_equal(out, enc, elen, "stream %zu", slen);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_base64_test,
-			 ztest_unit_test(test_base64_codec));
+			 ztest_unit_test(test_base64_codec),
+			 ztest_unit_test(test_base64_roundtrip),
+			 ztest_unit_test(test_base64_stream));
 
 	ztest_run_test_suite(lib_base64_test);
 }
@@ -104,6 +104,8 @@
 #include "../../../lib/os/cbprintf_nano.c"
 #endif
 
+#include "../../../lib/os/cbprintf_packaged.c"
+
 /* We can't determine at build-time whether int is 64-bit, so assume
  * it is.  If not the values are truncated at build time, and the str
  * pointers will be updated during test initialization.
@@ -1090,6 +1092,123 @@ static void test_libc_substs(void)
 	}
 }
 
+static uint8_t package[256] __aligned(CBPRINTF_PACKAGE_ALIGNMENT);
+
+/* Checks that rendering a package matches formatting immediately */
+__printf_like(2, 3)
+static void check_package(unsigned int line, const char *format, ...)
+{
+	char expected[sizeof(buf)];
+	size_t expected_len;
+	va_list ap;
+	int len;
+	int rc;
+
+	va_start(ap, format);
+	reset_out();
+	rc = cbvprintf(out, NULL, format, ap);
+	va_end(ap);
+	expected_len = bp - buf;
+	memcpy(expected, buf, expected_len);
+
+	va_start(ap, format);
+	len = cbvprintf_package(package, sizeof(package), 0, format, ap);
+	va_end(ap);
+	zassert_true(len > 0, "line %u: package failed %d", line, len);
+
+	reset_out();
+	zassert_equal(cbpprintf(out, NULL, package), rc, "line %u", line);
+	zassert_equal(bp - buf, expected_len, "line %u", line);
+	zassert_equal(memcmp(buf, expected, expected_len), 0,
+		      "line %u: got %.*s", line, (int)(bp - buf), buf);
+}
+
+#define CHECK_PACKAGE(...) check_package(__LINE__, __VA_ARGS__)
+
+static void test_package(void)
+{
+	uintptr_t uip = 0xcafe21;
+	void *ptr = (void *)uip;
+	char str[] = "stack";
+	struct {
+		char chars[3];
+		char next;
+	} unterminated = { { 'a', 'b', 'c' }, 'd' };
+	int len;
+	int rc;
+
+	CHECK_PACKAGE("no conversion");
+	CHECK_PACKAGE("%d%%%u|%x", -42, 42U, 0x2a);
+	CHECK_PACKAGE("%c%5c%-3c|", 'a', 'b', 'c');
+	CHECK_PACKAGE("%hhd %hd %ld %lu", 1, -2, -3L, 4UL);
+	CHECK_PACKAGE("%lld %llx", -5LL, 0x1234567890abcdefULL);
+	CHECK_PACKAGE("%jd %zu %td", (intmax_t)-6, (size_t)7, (ptrdiff_t)-8);
+	CHECK_PACKAGE("%08x|%-8d|%+d|%.3d", 9, 10, 11, 12);
+	CHECK_PACKAGE("%*d|%.*d|%*.*x", 5, 13, 4, 14, 6, 3, 15);
+	CHECK_PACKAGE("%p %s %.2s", ptr, "rodata", str);
+	CHECK_PACKAGE("%s:%d %s", str, 16, str);
+
+	if (!IS_ENABLED(CONFIG_CBPRINTF_NANO)) {
+		CHECK_PACKAGE("%*d|%.*d|", -5, 17, -1, 18);
+	}
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT)) {
+		CHECK_PACKAGE("%g %.*f %e", 1.5, 2, 3.25, -4e10);
+	} else {
+		len = cbprintf_package(package, sizeof(package), 0, "%f", 1.0);
+		zassert_equal(len, -ENOTSUP, NULL);
+	}
+
+	/* Strings outside of read-only memory are copied by default */
+	len = cbprintf_package(package, sizeof(package), 0, "%s", str);
+	zassert_true(len > 0, NULL);
+	str[0] = 'S';
+	reset_out();
+	rc = cbpprintf(out, NULL, package);
+	zassert_equal(rc, 5, NULL);
+	zassert_equal(strncmp(buf, "stack", rc), 0, NULL);
+
+	len = cbprintf_package(package, sizeof(package),
+			       CBPRINTF_PACKAGE_COPY_NO_STR, "%s", str);
+	zassert_true(len > 0, NULL);
+	str[0] = 's';
+	reset_out();
+	rc = cbpprintf(out, NULL, package);
+	zassert_equal(strncmp(buf, "stack", rc), 0, NULL);
+
+	len = cbprintf_package(package, sizeof(package),
+			       CBPRINTF_PACKAGE_COPY_ALL_STR, "%s", str);
+	str[0] = 'S';
+	reset_out();
+	rc = cbpprintf(out, NULL, package);
+	zassert_equal(strncmp(buf, "stack", rc), 0, NULL);
+
+	/* Only as much of a string as its precision allows is copied */
+	len = cbprintf_package(package, sizeof(package), 0, "%s", str);
+	zassert_equal(cbprintf_package(package, sizeof(package), 0, "%.2s",
+				       str), len - 3, NULL);
+	zassert_equal(cbprintf_package(package, sizeof(package), 0, "%.*s",
+				       1, str), len - 4 + sizeof(int), NULL);
+	zassert_equal(cbprintf_package(package, sizeof(package), 0, "%.*s",
+				       -1, str), len + sizeof(int), NULL);
+
+	/* Which need not be terminated then */
+	CHECK_PACKAGE("%.3s|%.*s", unterminated.chars, 2, unterminated.chars);
+	zassert_equal(cbprintf_package(NULL, 0, 0, "%.3s", unterminated.chars),
+		      cbprintf_package(NULL, 0, 0, "%s", "abc"), NULL);
+
+	/* Size only, and too small a buffer */
+	len = cbprintf_package(package, sizeof(package), 0, "%s %lld %d",
+			       str, 1LL, 2);
+	zassert_equal(cbprintf_package(NULL, 0, 0, "%s %lld %d", str, 1LL, 2),
+		      len, NULL);
+	zassert_equal(cbprintf_package(package, len - 1, 0, "%s %lld %d",
+				       str, 1LL, 2), -ENOSPC, NULL);
+
+	zassert_equal(cbprintf_package(package, sizeof(package), 0, "%n",
+				       &rc), -EINVAL, NULL);
+}
+
 static void test_nop(void)
 {
 }
@@ -1153,6 +1272,7 @@ void test_main(void)
 			 ztest_unit_test(test_n),
 			 ztest_unit_test(test_p),
 			 ztest_unit_test(test_libc_substs),
+			 ztest_unit_test(test_package),
 			 ztest_unit_test(test_nop)
 			 );
 	ztest_run_test_suite(test_prf);
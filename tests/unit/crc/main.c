@@ -5,6 +5,21 @@
  */
 
 #include <ztest.h>
+
+#ifdef CRC_ENGINE
+/* Set by twister to pick the engine, as Kconfig would */
+#if CRC_ENGINE == 1
+#define CONFIG_CRC_ENGINE_TABLE 1
+#elif CRC_ENGINE == 2
+#define CONFIG_CRC_ENGINE_SLICE_BY_8 1
+#elif CRC_ENGINE == 3
+#define CONFIG_CRC_ENGINE_HW 1
+#if defined(__x86_64__) || defined(__i386__)
+#define CONFIG_CRC_X86_PCLMUL 1
+#endif
+#endif
+#endif /* CRC_ENGINE */
+
 #include <sys/crc.h>
 #include "../../../lib/os/crc8_sw.c"
 #include "../../../lib/os/crc16_sw.c"
@@ -202,6 +217,112 @@ void test_crc8(void)
 	zassert_equal(fcs, expected, "0x%02x vs 0x%02x", fcs, expected);
 }
 
+/* Bit by bit references for the engines */
+static uint32_t ref_crc32_ieee(const uint8_t *data, size_t len)
+{
+	uint32_t crc = ~0U;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+		}
+	}
+	return ~crc;
+}
+
+static uint16_t ref_crc16(const uint8_t *src, size_t len, uint16_t polynomial,
+			  uint16_t initial_value, bool pad)
+{
+	uint16_t crc = initial_value;
+	size_t padding = pad ? sizeof(crc) : 0;
+
+	for (size_t i = 0; i < len + padding; i++) {
+		for (int b = 0; b < 8; b++) {
+			uint16_t divide = crc & 0x8000UL;
+
+			crc = (crc << 1U);
+			if (i < len) {
+				crc |= !!(src[i] & (0x80U >> b));
+			}
+			if (divide != 0U) {
+				crc = crc ^ polynomial;
+			}
+		}
+	}
+	return crc;
+}
+
+static uint16_t ref_crc16_reflected(uint16_t crc, const uint8_t *src,
+				    size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= src[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0x8408 : 0);
+		}
+	}
+	return crc;
+}
+
+static uint16_t ref_crc16_normal(uint16_t crc, const uint8_t *src, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= (uint16_t)src[i] << 8;
+		for (int b = 0; b < 8; b++) {
+			crc = (crc << 1) ^ ((crc & 0x8000) ? 0x1021 : 0);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Check the selected CRC engine against bitwise computations
+ *
+ * @details Covers every length up to a few folds of the larger
+ * engines, at every alignment, and split updates.
+ */
+void test_crc_engine(void)
+{
+	static uint8_t buf[300 + 8];
+	uint32_t x = 0x12345678;
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		x = x * 1103515245U + 12345U;
+		buf[i] = x >> 24;
+	}
+
+	for (size_t off = 0; off < 8; off++) {
+		for (size_t len = 0; len <= 300; len++) {
+			const uint8_t *p = buf + off;
+			size_t half = len / 3;
+
+			zassert_equal(crc32_ieee(p, len),
+				      ref_crc32_ieee(p, len),
+				      "crc32 off %zu len %zu", off, len);
+			zassert_equal(crc32_ieee_update(crc32_ieee(p, half),
+							p + half, len - half),
+				      ref_crc32_ieee(p, len),
+				      "crc32 update off %zu len %zu", off, len);
+			zassert_equal(crc16_ccitt(0x1d0f, p, len),
+				      ref_crc16_reflected(0x1d0f, p, len),
+				      "crc16_ccitt len %zu", len);
+			zassert_equal(crc16_itu_t(0x1d0f, p, len),
+				      ref_crc16_normal(0x1d0f, p, len),
+				      "crc16_itu_t len %zu", len);
+			zassert_equal(crc8_ccitt(0x5a, p, len),
+				      crc8(p, len, 0x07, 0x5a, false),
+				      "crc8_ccitt len %zu", len);
+			zassert_equal(crc16(p, len, 0x8005, 0xa5c3, true),
+				      ref_crc16(p, len, 0x8005, 0xa5c3, true),
+				      "crc16 padded len %zu", len);
+			zassert_equal(crc16(p, len, 0x1021, 0xa5c3, false),
+				      ref_crc16(p, len, 0x1021, 0xa5c3, false),
+				      "crc16 len %zu", len);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -213,6 +334,7 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
 			 ztest_unit_test(test_crc7_be),
-			 ztest_unit_test(test_crc8));
+			 ztest_unit_test(test_crc8),
+			 ztest_unit_test(test_crc_engine));
 	ztest_run_test_suite(test_crc);
 }
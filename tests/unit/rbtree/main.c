@@ -89,10 +89,13 @@ void visit_node(struct rbnode *node, void *cookie)
  */
 static int last_black_height;
 
-void check_rbnode(struct rbnode *node, int blacks_above)
+void check_rbnode(struct rbnode *node, int blacks_above, int depth)
 {
 	int side, bheight = blacks_above + z_rb_is_black(node);
 
+	/* The stacks of the tree operations must be deep enough */
+	_CHECK(depth <= tree.max_depth);
+
 	for (side = 0; side < 2; side++) {
 		struct rbnode *ch = z_rb_child(node, side);
 
@@ -108,7 +111,7 @@ void check_rbnode(struct rbnode *node, int blacks_above)
 			_CHECK(z_rb_is_black(node) || z_rb_is_black(ch));
 
 			/* Recurse */
-			check_rbnode(ch, bheight);
+			check_rbnode(ch, bheight, depth + 1);
 		} else {
 			/* All leaf nodes must be at the same black height */
 			if (last_black_height) {
@@ -126,7 +129,7 @@ void check_rb(void)
 	_CHECK(tree.root);
 	_CHECK(z_rb_is_black(tree.root));
 
-	check_rbnode(tree.root, 0);
+	check_rbnode(tree.root, 0, 1);
 }
 
 /* First validates the external API behavior via a walk, then checks
@@ -174,6 +177,11 @@ void _check_tree(int size, int use_foreach)
 
 	_CHECK(ni == nwalked);
 
+	/* The cached extremes must be the ones found by walking */
+	_CHECK(rb_get_min(&tree) == z_rb_get_minmax(&tree, 0));
+	_CHECK(rb_get_max(&tree) == z_rb_get_minmax(&tree, 1));
+	_CHECK(rb_get_min(&tree) == (nwalked ? walked_nodes[0] : NULL));
+
 	if (tree.root) {
 		check_rb();
 	}
@@ -245,9 +253,46 @@ void test_rbtree_spam(void)
 	} while (size < MAX_NODES);
 }
 
+/* Builds trees of every size from sorted nodes, then keeps inserting
+ * and removing nodes to check that they are fully usable.
+ */
+void test_rbtree_build(void)
+{
+	static struct rbnode *sorted[MAX_NODES];
+
+	for (int size = 0; size <= MAX_NODES / 2; size++) {
+		(void)memset(&tree, 0, sizeof(tree));
+		tree.lessthan_fn = node_lessthan;
+		(void)memset(node_mask, 0, sizeof(node_mask));
+
+		/* Every other node, so that there is room between them */
+		for (int i = 0; i < size; i++) {
+			sorted[i] = &nodes[2 * i];
+			set_node_mask(2 * i, 1);
+		}
+
+		rb_build(&tree, sorted, size);
+		check_tree(size);
+
+		for (int i = 0; i < size; i++) {
+			int node = next_rand_mod(MAX_NODES);
+
+			if (!get_node_mask(node)) {
+				checked_insert(&tree, &nodes[node]);
+				set_node_mask(node, 1);
+			} else {
+				rb_remove(&tree, &nodes[node]);
+				set_node_mask(node, 0);
+			}
+		}
+		check_tree(size);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_rbtree,
-			 ztest_unit_test(test_rbtree_spam));
+			 ztest_unit_test(test_rbtree_spam),
+			 ztest_unit_test(test_rbtree_build));
 	ztest_run_test_suite(test_rbtree);
 }
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Checks that the time unit conversions by reciprocal multiplication
+ * give exactly the same results as divisions.  The host has 128 bit
+ * integers: hide them to test the 32 bit multiplication that 32 bit
+ * targets use, the type is still there for the reference.  The kernel
+ * headers pulled in by ztest.h include sys/time_units.h, so this comes
+ * first.
+ */
+#undef __SIZEOF_INT128__
+#define CONFIG_TIME_UNITS_RECIPROCAL 1
+
+#include <ztest.h>
+#include <sys/util.h>
+#include <sys/time_units.h>
+
+#define CYC_HZ ((uint64_t)CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC)
+#define TICK_HZ ((uint64_t)CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+
+#define N_RANDOM 20000
+
+/* Frequencies of real timers and of the time units, and some that
+ * make for unusual reciprocals
+ */
+static const uint32_t freqs[] = {
+	100, 128, 1000, 10000, 32768, 32000, 1000000, 1000000000,
+	3, 7, 641, 6700417, 12000000, 16000000, 19200000, 24000000,
+	26000000, 32000000, 38400000, 48000000, 64000000, 72000000,
+	80000000, 84000000, 96000000, 100000000, 120000000, 125000000,
+	168000000, 180000000, 216000000, 240000000, 400000000, 480000000,
+	600000000, 0x7fffffff, 0x80000001, 0xfffffffb, 0xffffffff,
+};
+
+/* Simple LCRNG, for repeatability across platforms */
+static uint64_t next_rand(void)
+{
+	static uint64_t state = 123456789;
+
+	state = state * 2862933555777941757ULL + 3037000493ULL;
+
+	return state;
+}
+
+static void check_div(uint64_t n, uint32_t d)
+{
+	uint64_t q = z_tmcvt_divu64(n, d);
+
+	zassert_equal(q, n / d, "%llu / %u: got %llu", n, d, q);
+}
+
+static void check_divisor(uint32_t d)
+{
+	for (uint64_t n = 0; n < 0x10000; n++) {
+		check_div(n, d);
+	}
+
+	for (uint64_t n = 0; n < 256; n++) {
+		check_div(UINT64_MAX - n, d);
+	}
+
+	/* Around multiples of d, where rounding errors would show */
+	for (int i = 0; i < N_RANDOM / 4; i++) {
+		uint64_t k = next_rand() / d;
+
+		check_div(k * d, d);
+		check_div(k * d - 1, d);
+		check_div(k * d + d - 1, d);
+	}
+
+	for (int i = 0; i < N_RANDOM; i++) {
+		check_div(next_rand(), d);
+		check_div(next_rand() >> (i % 64), d);
+	}
+}
+
+void test_mulhi64(void)
+{
+	for (int i = 0; i < N_RANDOM; i++) {
+		uint64_t a = next_rand() >> (i % 64), b = next_rand();
+		unsigned __int128 p = (unsigned __int128)a * b;
+
+		zassert_equal(z_tmcvt_mulhi64(a, b), (uint64_t)(p >> 64),
+			      "%llx * %llx", a, b);
+	}
+
+	zassert_equal(z_tmcvt_mulhi64(UINT64_MAX, UINT64_MAX),
+		      UINT64_MAX - 1, NULL);
+}
+
+void test_divu64(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(freqs); i++) {
+		check_divisor(freqs[i]);
+	}
+
+	for (int i = 0; i < 200; i++) {
+		uint32_t d = (uint32_t)(next_rand() >> (32 + i % 32));
+
+		check_divisor(MAX(d, 1U));
+	}
+}
+
+/* z_tmcvt() as it is without CONFIG_TIME_UNITS_RECIPROCAL */
+static uint64_t ref_tmcvt(uint64_t t, uint32_t from_hz, uint32_t to_hz,
+			  bool result32, bool round_up, bool round_off)
+{
+	bool mul_ratio = (to_hz > from_hz) && ((to_hz % from_hz) == 0U);
+	bool div_ratio = (from_hz > to_hz) && ((from_hz % to_hz) == 0U);
+	uint64_t off = 0;
+
+	if (from_hz == to_hz) {
+		return result32 ? ((uint32_t)t) : t;
+	}
+
+	if (!mul_ratio) {
+		uint32_t rdivisor = div_ratio ? (from_hz / to_hz) : from_hz;
+
+		if (round_up) {
+			off = rdivisor - 1U;
+		} else if (round_off) {
+			off = rdivisor / 2U;
+		}
+	}
+
+	if (div_ratio) {
+		t += off;
+		if (result32 && (t < BIT64(32))) {
+			return ((uint32_t)t) / (from_hz / to_hz);
+		}
+		return t / (from_hz / to_hz);
+	} else if (mul_ratio) {
+		if (result32) {
+			return ((uint32_t)t) * (to_hz / from_hz);
+		}
+		return t * (to_hz / from_hz);
+	}
+
+	if (result32) {
+		return (uint32_t)((t * to_hz + off) / from_hz);
+	}
+	return (t * to_hz + off) / from_hz;
+}
+
+static void check_tmcvt(uint64_t t, uint32_t from_hz, uint32_t to_hz)
+{
+	for (int mode = 0; mode < 6; mode++) {
+		bool result32 = mode & 1;
+		bool round_up = mode == 2 || mode == 3;
+		bool round_off = mode == 4 || mode == 5;
+		uint64_t in = result32 ? (uint32_t)t : t;
+		uint64_t r = z_tmcvt(in, from_hz, to_hz, true, result32,
+				     round_up, round_off);
+		uint64_t ref = ref_tmcvt(in, from_hz, to_hz, result32,
+					 round_up, round_off);
+
+		if (result32) {
+			r = (uint32_t)r;
+			ref = (uint32_t)ref;
+		}
+
+		zassert_equal(r, ref, "%llu from %u Hz to %u Hz, mode %d: "
+			      "got %llu, expected %llu", in, from_hz, to_hz,
+			      mode, r, ref);
+	}
+}
+
+void test_tmcvt(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(freqs); i++) {
+		for (int j = 0; j < ARRAY_SIZE(freqs); j++) {
+			for (uint64_t t = 0; t < 0x1000; t++) {
+				check_tmcvt(t, freqs[i], freqs[j]);
+			}
+
+			for (int k = 0; k < 1000; k++) {
+				check_tmcvt(next_rand() >> (k % 64), freqs[i],
+					    freqs[j]);
+			}
+		}
+	}
+}
+
+/* The generated API, with the frequencies the unit tests are built with */
+void test_api(void)
+{
+	for (int i = 0; i < N_RANDOM; i++) {
+		/* Small enough for t * 10^9 not to overflow */
+		uint64_t t = next_rand() >> (30 + i % 34);
+		uint32_t t32 = (uint32_t)t;
+
+		zassert_equal(k_cyc_to_ns_floor64(t), t * 1000000000U / CYC_HZ,
+			      NULL);
+		zassert_equal(k_cyc_to_us_ceil64(t),
+			      (t * 1000000U + CYC_HZ - 1U) / CYC_HZ, NULL);
+		zassert_equal(k_ticks_to_ms_near64(t),
+			      (t * 1000U + TICK_HZ / 2U) / TICK_HZ, NULL);
+		zassert_equal(k_ns_to_ticks_floor64(t),
+			      t * TICK_HZ / 1000000000U, NULL);
+		zassert_equal(k_cyc_to_ticks_near32(t32),
+			      (uint32_t)((t32 + CYC_HZ / TICK_HZ / 2U) /
+					 (CYC_HZ / TICK_HZ)), NULL);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(time_units,
+			 ztest_unit_test(test_mulhi64),
+			 ztest_unit_test(test_divu64),
+			 ztest_unit_test(test_tmcvt),
+			 ztest_unit_test(test_api)
+			 );
+	ztest_run_test_suite(time_units);
+}